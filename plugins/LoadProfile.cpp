@@ -0,0 +1,321 @@
+#include "LoadProfile.h"
+#include "PluginLogger.h"
+#include <osg/NodeVisitor>
+#include <osg/Geometry>
+#include <osg/StateSet>
+#include <osg/UserDataContainer>
+#include <osg/ValueObject>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_set>
+
+const char *const LoadProfile::UserObjectName = "LoadProfile";
+const char *const LoadProfile::TraceEnvironmentVariable = "OSG_PLUGIN_TRACE";
+
+namespace
+{
+    // 当前线程上最内层的 Scope，用于从父阶段中扣除嵌套阶段的耗时
+    thread_local LoadProfile::Scope *currentScope = nullptr;
+
+    double Milliseconds(LoadProfile::Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    std::string JsonEscape(const std::string &text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+                    escaped += buffer;
+                }
+                else
+                {
+                    escaped += c;
+                }
+            }
+        }
+        return escaped;
+    }
+
+    class SceneObjectCounter : public osg::NodeVisitor
+    {
+    public:
+        SceneObjectCounter() : osg::NodeVisitor(osg::NodeVisitor::TRAVERSE_ALL_CHILDREN) {}
+
+        void apply(osg::Node &node) override
+        {
+            if (seen(&node))
+            {
+                ++objects.nodes;
+                countStateSet(node.getStateSet());
+                if (osg::Geometry *geometry = node.asGeometry())
+                    countGeometry(*geometry);
+            }
+            traverse(node);
+        }
+
+        LoadProfile::SceneObjects objects;
+
+    private:
+        bool seen(const osg::Referenced *object)
+        {
+            return object && visited_.insert(object).second;
+        }
+
+        void countArray(const osg::Array *array)
+        {
+            if (seen(array))
+                ++objects.arrays;
+        }
+
+        void countGeometry(osg::Geometry &geometry)
+        {
+            ++objects.geometries;
+            countArray(geometry.getVertexArray());
+            countArray(geometry.getNormalArray());
+            countArray(geometry.getColorArray());
+            for (unsigned i = 0; i < geometry.getNumTexCoordArrays(); ++i)
+                countArray(geometry.getTexCoordArray(i));
+            for (unsigned i = 0; i < geometry.getNumVertexAttribArrays(); ++i)
+                countArray(geometry.getVertexAttribArray(i));
+            for (unsigned i = 0; i < geometry.getNumPrimitiveSets(); ++i)
+            {
+                if (seen(geometry.getPrimitiveSet(i)))
+                    ++objects.primitiveSets;
+            }
+        }
+
+        void countStateSet(const osg::StateSet *stateSet)
+        {
+            if (!seen(stateSet))
+                return;
+            ++objects.stateSets;
+            for (const auto &attribute : stateSet->getAttributeList())
+            {
+                if (seen(attribute.second.first.get()))
+                    ++objects.stateAttributes;
+            }
+            for (const auto &unitAttributes : stateSet->getTextureAttributeList())
+            {
+                for (const auto &attribute : unitAttributes)
+                {
+                    if (seen(attribute.second.first.get()))
+                        ++objects.stateAttributes;
+                }
+            }
+        }
+
+        std::unordered_set<const osg::Referenced *> visited_;
+    };
+}
+
+LoadProfile::Scope::Scope(LoadProfile *profile, const std::string &stageName)
+    : profile_(profile)
+{
+    if (!profile_)
+        return;
+    stage_ = &profile_->stage(stageName);
+    parent_ = currentScope;
+    currentScope = this;
+    begin_ = Clock::now();
+}
+
+LoadProfile::Scope::~Scope()
+{
+    end();
+}
+
+void LoadProfile::Scope::end()
+{
+    if (!profile_)
+        return;
+    const Clock::time_point end = Clock::now();
+    const double elapsed = Milliseconds(end - begin_);
+    stage_->milliseconds += elapsed - childMilliseconds_;
+    if (parent_)
+        parent_->childMilliseconds_ += elapsed;
+    currentScope = parent_;
+    profile_->addEvent(stage_->name, 0, begin_, end);
+    profile_ = nullptr;
+}
+
+LoadProfile::LoadProfile(const std::string &plugin, const std::string &source, bool recordEvents)
+    : plugin_(plugin), source_(source), recordEvents_(recordEvents), start_(Clock::now()), end_(start_)
+{
+}
+
+LoadProfile::Stage &LoadProfile::stage(const std::string &name)
+{
+    for (Stage &stage : stages_)
+    {
+        if (stage.name == name)
+            return stage;
+    }
+    stages_.emplace_back();
+    stages_.back().name = name;
+    return stages_.back();
+}
+
+void LoadProfile::addEvent(const std::string &name, unsigned thread, Clock::time_point begin, Clock::time_point end,
+                           int64_t item)
+{
+    if (!recordEvents_)
+        return;
+    const int64_t beginMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(begin - start_).count();
+    const int64_t durationMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+
+    std::lock_guard<std::mutex> lock(eventMutex_);
+    if (events_.size() >= MaxEvents)
+    {
+        ++droppedEvents_;
+        return;
+    }
+    events_.push_back(Event{name, thread, beginMicroseconds, durationMicroseconds, item});
+}
+
+void LoadProfile::finish()
+{
+    if (finished_)
+        return;
+    end_ = Clock::now();
+    finished_ = true;
+}
+
+double LoadProfile::totalMilliseconds() const
+{
+    return Milliseconds((finished_ ? end_ : Clock::now()) - start_);
+}
+
+std::string LoadProfile::summary() const
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << "Load profile: " << totalMilliseconds() << " ms total";
+    for (const Stage &stage : stages_)
+    {
+        oss << " | " << stage.name;
+        if (stage.milliseconds > 0.0 || stage.workerMilliseconds == 0.0)
+            oss << " " << stage.milliseconds << " ms";
+        if (stage.workerMilliseconds > 0.0)
+            oss << (stage.milliseconds > 0.0 ? " + " : " ") << stage.workerMilliseconds << " ms cpu";
+        if (stage.bytes > 0)
+            oss << ", " << stage.bytes / 1024 << " KB";
+        if (stage.elements > 0)
+            oss << ", " << stage.elements << " " << (stage.unit.empty() ? "elements" : stage.unit);
+        if (stage.allocations > 0)
+            oss << ", " << stage.allocations << " allocs";
+    }
+    return oss.str();
+}
+
+bool LoadProfile::writeChromeTrace(const std::string &path) const
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+        return false;
+
+    // Trace Event Format：完整事件（ph "X"）以微秒计，线程名用元数据事件（ph "M"）标注
+    std::lock_guard<std::mutex> lock(eventMutex_);
+    unsigned maxThread = 0;
+    for (const Event &event : events_)
+        maxThread = std::max(maxThread, event.thread);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\""
+        << JsonEscape(plugin_ + " load " + source_) << "\"}}";
+    for (unsigned thread = 0; thread <= maxThread; ++thread)
+    {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread << ",\"args\":{\"name\":\""
+            << (thread == 0 ? std::string("loader") : "worker " + std::to_string(thread)) << "\"}}";
+    }
+    for (const Event &event : events_)
+    {
+        out << ",\n{\"name\":\"" << JsonEscape(event.name) << "\",\"cat\":\"" << JsonEscape(plugin_)
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":" << event.begin
+            << ",\"dur\":" << event.duration;
+        if (event.item >= 0)
+            out << ",\"args\":{\"item\":" << event.item << "}";
+        out << "}";
+    }
+    out << "\n],\"otherData\":{\"source\":\"" << JsonEscape(source_) << "\",\"summary\":\"" << JsonEscape(summary())
+        << "\",\"droppedEvents\":\"" << droppedEvents_ << "\"}}\n";
+    out.close();
+    return static_cast<bool>(out);
+}
+
+void LoadProfile::attachTo(osg::Node &root) const
+{
+    osg::ref_ptr<osg::DefaultUserDataContainer> values = new osg::DefaultUserDataContainer;
+    values->setName(UserObjectName);
+    values->setUserValue("total.ms", totalMilliseconds());
+    for (const Stage &stage : stages_)
+    {
+        values->setUserValue(stage.name + ".ms", stage.milliseconds);
+        values->setUserValue(stage.name + ".cpuMs", stage.workerMilliseconds);
+        values->setUserValue(stage.name + ".bytes", static_cast<double>(stage.bytes));
+        values->setUserValue(stage.name + ".elements", static_cast<double>(stage.elements));
+        values->setUserValue(stage.name + ".allocations", static_cast<double>(stage.allocations));
+    }
+    root.getOrCreateUserDataContainer()->addUserObject(values.get());
+}
+
+void LoadProfile::publish(osg::Node &root, const std::string &tracePath)
+{
+    finish();
+    PluginLogger::logInfo(plugin_, summary());
+    attachTo(root);
+    if (tracePath.empty())
+        return;
+    if (writeChromeTrace(tracePath))
+        PluginLogger::logInfo(plugin_, "Wrote load trace " + tracePath);
+    else
+        PluginLogger::logWarning(plugin_, "Could not write load trace " + tracePath);
+}
+
+std::string LoadProfile::TracePath(const std::string &optionPath, const std::string &source)
+{
+    if (!optionPath.empty())
+        return optionPath;
+
+    const char *environment = std::getenv(TraceEnvironmentVariable);
+    if (!environment || !*environment)
+        return std::string();
+    const std::string target = environment;
+    // 以 .json 结尾时就是输出文件，否则视为目录，按模型文件名生成 "<name>.trace.json"
+    if (target.size() > 5 && target.compare(target.size() - 5, 5, ".json") == 0)
+        return target;
+    const size_t slash = source.find_last_of("/\\");
+    const std::string baseName = slash == std::string::npos ? source : source.substr(slash + 1);
+    return target + "/" + (baseName.empty() ? std::string("stream") : baseName) + ".trace.json";
+}
+
+LoadProfile::SceneObjects LoadProfile::CountSceneObjects(osg::Node &root)
+{
+    SceneObjectCounter counter;
+    root.accept(counter);
+    return counter.objects;
+}
@@ -0,0 +1,158 @@
+#ifndef LOADPROFILE_H
+#define LOADPROFILE_H
+
+#include <osg/Referenced>
+#include <osg/Node>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Per-stage timings of one model load, shared by the mesh plugins
+ *
+ * A load is split into named stages (I/O, decompression, decode, validation,
+ * geometry build, state creation, scene assembly). Time spent on the loading
+ * thread is measured with Scope; nested scopes are subtracted from their parent,
+ * so the stage times add up to the total. Work done on pool threads is summed per
+ * stage into workerMilliseconds (CPU time across threads, not wall time).
+ * Each stage also carries byte, element and allocation counts.
+ *
+ * The result is attached to the loaded root node (attachTo) as a user object named
+ * UserObjectName whose user values are "<stage>.ms", "<stage>.cpuMs",
+ * "<stage>.bytes", "<stage>.elements" and "<stage>.allocations" (all double),
+ * plus "total.ms". When events are recorded, every scope and every worker item
+ * is also written as a Chrome trace (chrome://tracing, Perfetto).
+ */
+class LoadProfile : public osg::Referenced
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static const char *const UserObjectName;
+    // Environment variable naming a directory (or a .json file) that receives a trace of every load
+    static const char *const TraceEnvironmentVariable;
+    // Trace events kept per load; later events are counted but dropped
+    static const size_t MaxEvents = 200000;
+
+    struct Stage
+    {
+        std::string name;
+        std::string unit;                // 元素的含义，例如 "vertices"
+        double milliseconds = 0.0;       // 加载线程上的耗时（不含嵌套的子阶段）
+        double workerMilliseconds = 0.0; // 工作线程上的累计耗时（各线程之和）
+        uint64_t bytes = 0;
+        uint64_t elements = 0;
+        uint64_t allocations = 0;
+
+        void add(uint64_t byteCount, uint64_t elementCount, const char *elementUnit)
+        {
+            bytes += byteCount;
+            elements += elementCount;
+            if (elementUnit && unit.empty())
+                unit = elementUnit;
+        }
+    };
+
+    struct Event
+    {
+        std::string name;
+        unsigned thread;     // 0 = 加载线程，其余为线程池的 worker 序号
+        int64_t begin;       // 相对加载开始的微秒数
+        int64_t duration;    // 微秒
+        int64_t item;        // 条目序号（节点、网格等），-1 = 无
+    };
+
+    /**
+     * @brief Objects reachable from a loaded scene, counted once each
+     */
+    struct SceneObjects
+    {
+        uint64_t nodes = 0;
+        uint64_t geometries = 0;
+        uint64_t arrays = 0;
+        uint64_t primitiveSets = 0;
+        uint64_t stateSets = 0;
+        uint64_t stateAttributes = 0; // 材质、纹理等状态属性
+    };
+
+    /**
+     * @brief Time the enclosing block on the loading thread as (part of) a stage
+     */
+    class Scope
+    {
+    public:
+        // profile 为空时不计时
+        Scope(LoadProfile *profile, const std::string &stageName);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        Stage *stage() { return stage_; }
+        // 提前结束计时（只能结束当前线程上最内层的 Scope），析构时不再重复记录
+        void end();
+
+    private:
+        LoadProfile *profile_;
+        Stage *stage_ = nullptr;
+        Scope *parent_ = nullptr;
+        Clock::time_point begin_;
+        double childMilliseconds_ = 0.0;
+    };
+
+    /**
+     * @param plugin Plugin name for logs and the trace category
+     * @param source File or stream name
+     * @param recordEvents Keep individual scopes and worker items for a Chrome trace
+     */
+    LoadProfile(const std::string &plugin, const std::string &source, bool recordEvents);
+
+    // 查找或新增阶段；只能在加载线程上调用（工作线程先各自累计，结束后再合并）
+    Stage &stage(const std::string &name);
+    const std::deque<Stage> &stages() const { return stages_; }
+
+    bool recordsEvents() const { return recordEvents_; }
+    // 记录一个事件（线程安全），recordsEvents() 为 false 时忽略
+    void addEvent(const std::string &name, unsigned thread, Clock::time_point begin, Clock::time_point end,
+                  int64_t item = -1);
+
+    // 结束计时，此后 totalMilliseconds() 固定
+    void finish();
+    double totalMilliseconds() const;
+
+    std::string summary() const;
+    bool writeChromeTrace(const std::string &path) const;
+    // 以用户对象的形式挂到加载结果上
+    void attachTo(osg::Node &root) const;
+
+    /**
+     * @brief Finish timing, log the summary, attach the profile to root and write the trace (if tracePath is set)
+     */
+    void publish(osg::Node &root, const std::string &tracePath);
+
+    /**
+     * @brief Trace file for a load: the "trace=<file>" option if given, else one derived from
+     *        TraceEnvironmentVariable, else empty (no trace)
+     */
+    static std::string TracePath(const std::string &optionPath, const std::string &source);
+
+    static SceneObjects CountSceneObjects(osg::Node &root);
+
+private:
+    std::string plugin_;
+    std::string source_;
+    bool recordEvents_;
+    Clock::time_point start_;
+    Clock::time_point end_;
+    bool finished_ = false;
+    std::deque<Stage> stages_; // 嵌套的 Scope 持有阶段指针，新增阶段不能使其失效
+
+    mutable std::mutex eventMutex_;
+    std::vector<Event> events_;
+    uint64_t droppedEvents_ = 0;
+};
+
+#endif // LOADPROFILE_H
@@ -0,0 +1,391 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+
+const float MeshOptimizer::OverdrawThreshold = 1.05f;
+
+namespace
+{
+    // Forsyth 算法模拟的 LRU 缓存大小及评分参数
+    const unsigned ScoredCacheSize = 32;
+    const float LastTriangleScore = 0.75f;
+    const float CacheDecayPower = 1.5f;
+    const float ValenceBoostScale = 2.0f;
+    const unsigned ValenceTableSize = 32;
+
+    struct ScoreTables
+    {
+        float cache[ScoredCacheSize];
+        float valence[ValenceTableSize];
+
+        ScoreTables()
+        {
+            for (unsigned i = 0; i < ScoredCacheSize; ++i)
+            {
+                // 最近一个三角形的三个顶点得分固定，避免总是优先选择刚用过的同一条边
+                cache[i] = i < 3 ? LastTriangleScore
+                                 : std::pow(1.0f - float(i - 3) / float(ScoredCacheSize - 3), CacheDecayPower);
+            }
+            valence[0] = 0.0f;
+            for (unsigned i = 1; i < ValenceTableSize; ++i)
+                valence[i] = ValenceBoostScale / std::sqrt(float(i));
+        }
+    };
+
+    float VertexScore(const ScoreTables &tables, int cachePosition, uint32_t remaining)
+    {
+        // 没有剩余三角形的顶点不再参与评分
+        if (remaining == 0)
+            return -1.0f;
+        const float valence = remaining < ValenceTableSize ? tables.valence[remaining]
+                                                           : ValenceBoostScale / std::sqrt(float(remaining));
+        return (cachePosition >= 0 ? tables.cache[cachePosition] : 0.0f) + valence;
+    }
+
+    // FIFO 缓存模拟：时间戳相差不超过缓存大小即命中，重置只需推进时间
+    class FifoCache
+    {
+    public:
+        FifoCache(size_t vertexCount, unsigned cacheSize)
+            : stamps_(vertexCount, 0), size_(cacheSize), time_(cacheSize + 1) {}
+
+        unsigned misses(uint32_t a, uint32_t b, uint32_t c)
+        {
+            return miss(a) + miss(b) + miss(c);
+        }
+
+        void reset() { time_ += size_ + 1; }
+
+    private:
+        unsigned miss(uint32_t v)
+        {
+            if (time_ - stamps_[v] <= size_)
+                return 0;
+            stamps_[v] = time_++;
+            return 1;
+        }
+
+        std::vector<uint64_t> stamps_;
+        uint64_t size_;
+        uint64_t time_;
+    };
+
+    void PermuteArray(osg::Array *array, const std::vector<uint32_t> &remap)
+    {
+        const size_t elementSize = array->getElementSize();
+        uint8_t *data = static_cast<uint8_t *>(const_cast<void *>(array->getDataPointer()));
+        if (!data)
+            return;
+        const std::vector<uint8_t> original(data, data + remap.size() * elementSize);
+        for (size_t i = 0; i < remap.size(); ++i)
+            std::memcpy(data + remap[i] * elementSize, &original[i * elementSize], elementSize);
+        array->dirty();
+    }
+}
+
+void MeshOptimizer::Result::add(const Result &other)
+{
+    triangles += other.triangles;
+    transformsBefore += other.transformsBefore;
+    transformsAfter += other.transformsAfter;
+}
+
+bool MeshOptimizer::Optimize(osg::Geometry *geometry, osg::Vec3Array *positions, Result &result)
+{
+    result = Result();
+    if (!geometry || !geometry->getVertexArray() || geometry->getNumPrimitiveSets() != 1)
+        return false;
+    osg::DrawElements *elements = geometry->getPrimitiveSet(0)->getDrawElements();
+    if (!elements || elements->getMode() != GL_TRIANGLES || elements->getNumIndices() < 3)
+        return false;
+
+    // 所有逐顶点数组必须等长，否则无法一起重排
+    const size_t vertexCount = geometry->getVertexArray()->getNumElements();
+    osg::Geometry::ArrayList arrays;
+    geometry->getArrayList(arrays);
+    for (const auto &array : arrays)
+    {
+        if (array->getBinding() == osg::Array::BIND_PER_VERTEX && array->getNumElements() != vertexCount)
+            return false;
+    }
+    if (!positions)
+        positions = dynamic_cast<osg::Vec3Array *>(geometry->getVertexArray());
+    if (positions && positions->getNumElements() != vertexCount)
+        positions = nullptr;
+
+    std::vector<uint32_t> indices(elements->getNumIndices() / 3 * 3);
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        indices[i] = elements->index(static_cast<unsigned int>(i));
+        if (indices[i] >= vertexCount)
+            return false;
+    }
+
+    result.triangles = indices.size() / 3;
+    result.transformsBefore = CountTransforms(indices, vertexCount);
+    result.transformsAfter = result.transformsBefore;
+
+    std::vector<uint32_t> optimized = indices;
+    OptimizeVertexCache(optimized, vertexCount);
+    if (positions)
+        OptimizeOverdraw(optimized, *positions, OverdrawThreshold);
+    const uint64_t transformsAfter = CountTransforms(optimized, vertexCount);
+    if (transformsAfter >= result.transformsBefore)
+        return false;
+    result.transformsAfter = transformsAfter;
+
+    // 顶点重排不改变缓存命中，只改善顶点读取的局部性
+    const std::vector<uint32_t> remap = OptimizeVertexFetch(optimized, vertexCount);
+    bool positionsPermuted = false;
+    for (const auto &array : arrays)
+    {
+        if (array->getBinding() != osg::Array::BIND_PER_VERTEX)
+            continue;
+        PermuteArray(array.get(), remap);
+        positionsPermuted = positionsPermuted || array.get() == positions;
+    }
+    if (positions && !positionsPermuted)
+        PermuteArray(positions, remap);
+
+    for (size_t i = 0; i < optimized.size(); ++i)
+        elements->setElement(static_cast<unsigned int>(i), optimized[i]);
+    elements->dirty();
+    return true;
+}
+
+uint64_t MeshOptimizer::CountTransforms(const std::vector<uint32_t> &indices, size_t vertexCount, unsigned cacheSize)
+{
+    FifoCache cache(vertexCount, cacheSize);
+    uint64_t transforms = 0;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        transforms += cache.misses(indices[i], indices[i + 1], indices[i + 2]);
+    return transforms;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount)
+{
+    static const ScoreTables tables;
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2)
+        return;
+
+    // 顶点 -> 未输出三角形的邻接表（CSR），每个顶点的前 remaining[v] 项有效
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+        ++remaining[indices[i]];
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + remaining[v];
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; ++i)
+            adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        vertexScores[v] = VertexScore(tables, -1, remaining[v]);
+    size_t best = 0;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        const float score = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                            vertexScores[indices[t * 3 + 2]];
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = t;
+        }
+    }
+
+    std::vector<char> emitted(triangleCount, 0);
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    std::vector<uint32_t> cache, nextCache;
+    cache.reserve(ScoredCacheSize + 3);
+    nextCache.reserve(ScoredCacheSize + 3);
+    size_t cursor = 0;
+    const size_t none = triangleCount;
+
+    while (output.size() < triangleCount * 3)
+    {
+        if (best == none)
+        {
+            // 缓存中的顶点已无剩余三角形：按原顺序取下一个未输出的三角形
+            while (emitted[cursor])
+                ++cursor;
+            best = cursor;
+        }
+        const uint32_t *triangle = &indices[best * 3];
+        emitted[best] = 1;
+        output.insert(output.end(), triangle, triangle + 3);
+
+        nextCache.assign(triangle, triangle + 3);
+        for (uint32_t v : cache)
+        {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                nextCache.push_back(v);
+        }
+        for (int k = 0; k < 3; ++k)
+        {
+            // 从邻接表的有效区间中移除该三角形（与末尾交换）
+            const uint32_t v = triangle[k];
+            uint32_t *begin = &adjacency[offsets[v]];
+            uint32_t *end = begin + remaining[v];
+            uint32_t *it = std::find(begin, end, static_cast<uint32_t>(best));
+            if (it != end)
+            {
+                std::swap(*it, *(end - 1));
+                --remaining[v];
+            }
+        }
+
+        for (size_t i = 0; i < nextCache.size(); ++i)
+            cachePosition[nextCache[i]] = i < ScoredCacheSize ? static_cast<int>(i) : -1;
+        for (uint32_t v : nextCache)
+            vertexScores[v] = VertexScore(tables, cachePosition[v], remaining[v]);
+
+        // 只有缓存内（及刚被挤出）顶点的三角形得分会变化，下一个三角形从中选取
+        best = none;
+        bestScore = -1.0f;
+        for (uint32_t v : nextCache)
+        {
+            for (uint32_t k = 0; k < remaining[v]; ++k)
+            {
+                const uint32_t t = adjacency[offsets[v] + k];
+                const float score = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                                    vertexScores[indices[t * 3 + 2]];
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+        if (nextCache.size() > ScoredCacheSize)
+            nextCache.resize(ScoredCacheSize);
+        cache.swap(nextCache);
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t> &indices, const osg::Vec3Array &positions, float threshold)
+{
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2)
+        return;
+
+    // 硬边界：三个顶点全部未命中的三角形开始新的簇
+    std::vector<size_t> hardStarts;
+    FifoCache cache(positions.size(), FifoCacheSize);
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        if (cache.misses(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]) == 3 || t == 0)
+            hardStarts.push_back(t);
+    }
+    hardStarts.push_back(triangleCount);
+
+    // 软边界：簇内从头模拟的 ACMR 已不高于簇整体 ACMR * threshold 时就地切分
+    std::vector<size_t> starts;
+    for (size_t c = 0; c + 1 < hardStarts.size(); ++c)
+    {
+        const size_t begin = hardStarts[c], end = hardStarts[c + 1];
+        cache.reset();
+        uint64_t clusterMisses = 0;
+        for (size_t t = begin; t < end; ++t)
+            clusterMisses += cache.misses(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]);
+        const float clusterThreshold = threshold * float(clusterMisses) / float(end - begin);
+
+        cache.reset();
+        size_t start = begin;
+        uint64_t misses = 0;
+        starts.push_back(begin);
+        for (size_t t = begin; t + 1 < end; ++t)
+        {
+            misses += cache.misses(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]);
+            if (float(misses) / float(t - start + 1) <= clusterThreshold)
+            {
+                start = t + 1;
+                misses = 0;
+                starts.push_back(start);
+                cache.reset();
+            }
+        }
+    }
+    starts.push_back(triangleCount);
+    const size_t clusterCount = starts.size() - 1;
+    if (clusterCount < 2)
+        return;
+
+    // 按面积加权的簇中心与平均法线排序：越朝外（沿法线离网格中心越远）的簇越先绘制
+    std::vector<osg::Vec3> centroids(clusterCount), normals(clusterCount);
+    osg::Vec3 meshCentroid;
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; ++c)
+    {
+        float area = 0.0f;
+        for (size_t t = starts[c]; t < starts[c + 1]; ++t)
+        {
+            const osg::Vec3 &a = positions[indices[t * 3]];
+            const osg::Vec3 &b = positions[indices[t * 3 + 1]];
+            const osg::Vec3 &p = positions[indices[t * 3 + 2]];
+            const osg::Vec3 normal = (b - a) ^ (p - a);
+            const float weight = normal.length();
+            centroids[c] += (a + b + p) * (weight / 3.0f);
+            normals[c] += normal;
+            area += weight;
+        }
+        meshCentroid += centroids[c];
+        meshArea += area;
+        if (area > 0.0f)
+            centroids[c] /= area;
+        normals[c].normalize();
+    }
+    if (meshArea > 0.0f)
+        meshCentroid /= meshArea;
+
+    std::vector<float> keys(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c)
+        keys[c] = (centroids[c] - meshCentroid) * normals[c];
+    std::vector<size_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c)
+        order[c] = c;
+    std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] > keys[b]; });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (size_t c : order)
+        sorted.insert(sorted.end(), indices.begin() + starts[c] * 3, indices.begin() + starts[c + 1] * 3);
+    std::copy(sorted.begin(), sorted.end(), indices.begin());
+}
+
+std::vector<uint32_t> MeshOptimizer::OptimizeVertexFetch(std::vector<uint32_t> &indices, size_t vertexCount)
+{
+    const uint32_t unused = ~0u;
+    std::vector<uint32_t> remap(vertexCount, unused);
+    uint32_t next = 0;
+    for (uint32_t &index : indices)
+    {
+        if (remap[index] == unused)
+            remap[index] = next++;
+        index = remap[index];
+    }
+    for (uint32_t &target : remap)
+    {
+        if (target == unused)
+            target = next++;
+    }
+    return remap;
+}
+
+std::string MeshOptimizer::Describe(const Result &result)
+{
+    char acmr[64];
+    std::snprintf(acmr, sizeof(acmr), "ACMR %.3f -> %.3f", result.acmrBefore(), result.acmrAfter());
+    return std::to_string(result.triangles) + " triangles, " + acmr;
+}
@@ -0,0 +1,83 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include <osg/Array>
+#include <osg/Geometry>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Index buffer optimization shared by the mesh plugins (the "optimize" load option)
+ *
+ * Three passes over an indexed triangle list, in this order:
+ * 1. Triangle order for the post-transform vertex cache (Forsyth's linear-speed algorithm);
+ * 2. Overdraw: the cache-friendly order is cut into clusters, which are sorted so that
+ *    outward-facing clusters draw first, without raising ACMR by more than OverdrawThreshold;
+ * 3. Vertex order for fetch locality: vertices are renumbered in first-use order and all
+ *    per-vertex arrays of the geometry are permuted to match.
+ *
+ * ACMR (average cache miss ratio: vertex shader invocations per triangle) is simulated
+ * with a FifoCacheSize-entry FIFO cache.
+ */
+class MeshOptimizer
+{
+public:
+    static const unsigned FifoCacheSize = 16;
+    static const float OverdrawThreshold;
+
+    /**
+     * @brief Simulated vertex transforms before and after optimization; summed over meshes for load stats
+     */
+    struct Result
+    {
+        uint64_t triangles = 0;
+        uint64_t transformsBefore = 0;
+        uint64_t transformsAfter = 0;
+
+        float acmrBefore() const { return triangles ? float(transformsBefore) / float(triangles) : 0.0f; }
+        float acmrAfter() const { return triangles ? float(transformsAfter) / float(triangles) : 0.0f; }
+        void add(const Result &other);
+    };
+
+    /**
+     * @brief Optimize a geometry drawn with a single GL_TRIANGLES DrawElements, in place
+     * @param geometry Geometry whose index buffer and per-vertex arrays are reordered
+     * @param positions Float positions of the vertices for the overdraw pass; may be the geometry's own
+     *                  vertex array or a decoded copy (which is then permuted too). Null = the vertex
+     *                  array if it is an osg::Vec3Array, otherwise the overdraw pass is skipped
+     * @param result Filled whenever the geometry is eligible (result.triangles > 0)
+     * @return true if the geometry was changed; an order that would not lower ACMR is not applied
+     */
+    static bool Optimize(osg::Geometry *geometry, osg::Vec3Array *positions, Result &result);
+
+    /**
+     * @brief Vertex transforms of a triangle list through a FIFO post-transform cache
+     */
+    static uint64_t CountTransforms(const std::vector<uint32_t> &indices, size_t vertexCount,
+                                    unsigned cacheSize = FifoCacheSize);
+
+    /**
+     * @brief Reorder triangles for the post-transform vertex cache
+     */
+    static void OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount);
+
+    /**
+     * @brief Reorder clusters of a cache-optimized triangle list to reduce overdraw
+     * @param threshold Allowed ACMR growth factor from cutting the list into clusters
+     */
+    static void OptimizeOverdraw(std::vector<uint32_t> &indices, const osg::Vec3Array &positions, float threshold);
+
+    /**
+     * @brief Renumber vertices in first-use order; unreferenced vertices keep their relative order at the end
+     * @return Old-to-new vertex remap, already applied to indices
+     */
+    static std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t> &indices, size_t vertexCount);
+
+    /**
+     * @brief One-line description for logs, e.g. "1200 triangles, ACMR 1.52 -> 0.68"
+     */
+    static std::string Describe(const Result &result);
+};
+
+#endif // MESHOPTIMIZER_H
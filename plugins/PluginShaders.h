@@ -0,0 +1,26 @@
+#ifndef PLUGINSHADERS_H
+#define PLUGINSHADERS_H
+
+/**
+ * @brief GLSL shared by the shader render paths of the plugins
+ *
+ * The LMB instancing / GPU dequantization program and the glTF
+ * EXT_mesh_gpu_instancing program replace fixed-function lighting, so the
+ * GL_LIGHTING mode has no effect on them. Both read the bool uniform
+ * LightingUniform instead (on unless set): a viewer that switches GL_LIGHTING
+ * off should set it to false with OVERRIDE on the same StateSet, and the
+ * shaders then pass the material color through unlit, as fixed function does.
+ *
+ * Both programs add up all gl_MaxLights light sources like fixed function.
+ * GLSL cannot tell whether a light is enabled; lights that were never set up
+ * keep their black default colors and contribute nothing.
+ */
+namespace PluginShaders
+{
+    inline const char *const LightingUniform = "pluginLighting";
+
+    // Declaration to insert after the #version line of a shader source, with the default value
+    inline const char *const LightingDeclaration = "uniform bool pluginLighting = true;\n";
+}
+
+#endif // PLUGINSHADERS_H
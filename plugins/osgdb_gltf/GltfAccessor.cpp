@@ -0,0 +1,364 @@
+#include "GltfAccessor.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace
+{
+    // Extra output components are filled from (0, 0, 0, 1), e.g. RGB colors read as RGBA
+    const float FillComponents[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+
+    inline float FillComponent(int component)
+    {
+        return component < 4 ? FillComponents[component] : 0.0f;
+    }
+
+    // Byte range of a bufferView within its buffer
+    bool ViewRange(const tinygltf::Model &model, int viewIndex, const uint8_t *&begin, size_t &length)
+    {
+        if (viewIndex < 0 || viewIndex >= static_cast<int>(model.bufferViews.size()))
+            return false;
+        const tinygltf::BufferView &view = model.bufferViews[viewIndex];
+        if (view.buffer < 0 || view.buffer >= static_cast<int>(model.buffers.size()))
+            return false;
+        const std::vector<unsigned char> &data = model.buffers[view.buffer].data;
+        if (view.byteOffset > data.size() || view.byteLength > data.size() - view.byteOffset)
+            return false;
+        begin = data.data() + view.byteOffset;
+        length = view.byteLength;
+        return true;
+    }
+
+    // Whether count elements of elementSize bytes, stride apart from offset, fit in length bytes (without overflowing the multiplication)
+    bool Fits(size_t offset, size_t stride, size_t count, size_t elementSize, size_t length)
+    {
+        if (offset > length)
+            return false;
+        if (count == 0)
+            return true;
+        if (elementSize > length - offset)
+            return false;
+        return count - 1 <= (length - offset - elementSize) / stride;
+    }
+
+    bool IsIndexType(int componentType)
+    {
+        return componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE ||
+               componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT ||
+               componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+    }
+
+    // Integer component to float: normalized values are scaled by the type maximum, signed ones clamped to -1 (as the glTF spec defines)
+    template <typename Src>
+    struct Converter
+    {
+        explicit Converter(bool normalized)
+            : scale(normalized ? 1.0f / static_cast<float>(std::numeric_limits<Src>::max()) : 1.0f),
+              minimum(normalized && std::is_signed<Src>::value ? -1.0f : std::numeric_limits<float>::lowest())
+        {
+        }
+
+        float operator()(Src value) const { return std::max(static_cast<float>(value) * scale, minimum); }
+
+        float scale;
+        float minimum;
+    };
+
+    template <>
+    struct Converter<float>
+    {
+        explicit Converter(bool) {}
+        float operator()(float value) const { return value; }
+    };
+
+    // The component count is a compile-time constant and the per-element memcpy ignores alignment, so the inner loop vectorizes
+    template <typename Src, int Components>
+    void Gather(const uint8_t *src, size_t stride, size_t count, bool normalized, float *out, int outComponents)
+    {
+        const Converter<Src> convert(normalized);
+        if (outComponents == Components)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                Src element[Components];
+                std::memcpy(element, src + i * stride, sizeof(element));
+                float *dst = out + i * Components;
+                for (int c = 0; c < Components; ++c)
+                    dst[c] = convert(element[c]);
+            }
+            return;
+        }
+
+        const int converted = std::min(Components, outComponents);
+        for (size_t i = 0; i < count; ++i)
+        {
+            Src element[Components];
+            std::memcpy(element, src + i * stride, sizeof(element));
+            float *dst = out + i * outComponents;
+            for (int c = 0; c < converted; ++c)
+                dst[c] = convert(element[c]);
+            for (int c = converted; c < outComponents; ++c)
+                dst[c] = FillComponent(c);
+        }
+    }
+
+    // Types with more than 4 components, such as matrices
+    template <typename Src>
+    void GatherAny(const uint8_t *src, size_t stride, size_t count, int components, bool normalized, float *out,
+                   int outComponents)
+    {
+        const Converter<Src> convert(normalized);
+        const int converted = std::min(components, outComponents);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint8_t *element = src + i * stride;
+            float *dst = out + i * outComponents;
+            for (int c = 0; c < converted; ++c)
+            {
+                Src value;
+                std::memcpy(&value, element + c * sizeof(Src), sizeof(Src));
+                dst[c] = convert(value);
+            }
+            for (int c = converted; c < outComponents; ++c)
+                dst[c] = FillComponent(c);
+        }
+    }
+
+    template <typename Src>
+    void GatherComponents(const uint8_t *src, size_t stride, size_t count, int components, bool normalized,
+                          float *out, int outComponents)
+    {
+        switch (components)
+        {
+        case 1:
+            Gather<Src, 1>(src, stride, count, normalized, out, outComponents);
+            break;
+        case 2:
+            Gather<Src, 2>(src, stride, count, normalized, out, outComponents);
+            break;
+        case 3:
+            Gather<Src, 3>(src, stride, count, normalized, out, outComponents);
+            break;
+        case 4:
+            Gather<Src, 4>(src, stride, count, normalized, out, outComponents);
+            break;
+        default:
+            GatherAny<Src>(src, stride, count, components, normalized, out, outComponents);
+            break;
+        }
+    }
+
+    void GatherFloats(int componentType, const uint8_t *src, size_t stride, size_t count, int components,
+                      bool normalized, float *out, int outComponents)
+    {
+        switch (componentType)
+        {
+        case TINYGLTF_COMPONENT_TYPE_BYTE:
+            GatherComponents<int8_t>(src, stride, count, components, normalized, out, outComponents);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            GatherComponents<uint8_t>(src, stride, count, components, normalized, out, outComponents);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_SHORT:
+            GatherComponents<int16_t>(src, stride, count, components, normalized, out, outComponents);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+            GatherComponents<uint16_t>(src, stride, count, components, normalized, out, outComponents);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+            GatherComponents<uint32_t>(src, stride, count, components, normalized, out, outComponents);
+            break;
+        default:
+            GatherComponents<float>(src, stride, count, components, false, out, outComponents);
+            break;
+        }
+    }
+
+    template <typename Src>
+    void GatherUInts(const uint8_t *src, size_t stride, size_t count, uint32_t *out)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            Src value;
+            std::memcpy(&value, src + i * stride, sizeof(Src));
+            out[i] = value;
+        }
+    }
+
+    void GatherIndices(int componentType, const uint8_t *src, size_t stride, size_t count, uint32_t *out)
+    {
+        switch (componentType)
+        {
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            GatherUInts<uint8_t>(src, stride, count, out);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+            GatherUInts<uint16_t>(src, stride, count, out);
+            break;
+        default:
+            if (stride == sizeof(uint32_t))
+                std::memcpy(out, src, count * sizeof(uint32_t));
+            else
+                GatherUInts<uint32_t>(src, stride, count, out);
+            break;
+        }
+    }
+}
+
+GltfAccessorView::GltfAccessorView(const tinygltf::Model &model, int accessorIndex)
+{
+    if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size()))
+        return;
+
+    const tinygltf::Accessor &accessor = model.accessors[accessorIndex];
+    const int componentSize = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType));
+    const int components = tinygltf::GetNumComponentsInType(static_cast<uint32_t>(accessor.type));
+    if (componentSize <= 0 || components <= 0)
+        return;
+    // MAT2/MAT3 with 1- or 2-byte components pad every column to 4 bytes; vertex attributes and indices never use them
+    if ((accessor.type == TINYGLTF_TYPE_MAT2 || accessor.type == TINYGLTF_TYPE_MAT3) && componentSize < 4)
+        return;
+
+    componentType_ = accessor.componentType;
+    components_ = components;
+    count_ = accessor.count;
+    normalized_ = accessor.normalized;
+    const size_t elementSize = static_cast<size_t>(components) * static_cast<size_t>(componentSize);
+    elementSize_ = elementSize;
+
+    // Without a bufferView the base data is all zeros (as the spec defines; usually combined with sparse substitution)
+    if (accessor.bufferView >= 0)
+    {
+        const uint8_t *view = nullptr;
+        size_t viewLength = 0;
+        if (!ViewRange(model, accessor.bufferView, view, viewLength))
+            return;
+        const int stride = accessor.ByteStride(model.bufferViews[accessor.bufferView]);
+        if (stride <= 0 || static_cast<size_t>(stride) < elementSize)
+            return;
+        if (!Fits(accessor.byteOffset, static_cast<size_t>(stride), count_, elementSize, viewLength))
+            return;
+        data_ = view + accessor.byteOffset;
+        stride_ = static_cast<size_t>(stride);
+    }
+
+    if (accessor.sparse.isSparse && accessor.sparse.count > 0)
+    {
+        const size_t sparseCount = static_cast<size_t>(accessor.sparse.count);
+        const int indexType = accessor.sparse.indices.componentType;
+        if (!IsIndexType(indexType))
+            return;
+        const size_t indexSize = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(indexType)));
+
+        const uint8_t *indices = nullptr;
+        const uint8_t *values = nullptr;
+        size_t indicesLength = 0;
+        size_t valuesLength = 0;
+        if (!ViewRange(model, accessor.sparse.indices.bufferView, indices, indicesLength) ||
+            !Fits(accessor.sparse.indices.byteOffset, indexSize, sparseCount, indexSize, indicesLength) ||
+            !ViewRange(model, accessor.sparse.values.bufferView, values, valuesLength) ||
+            !Fits(accessor.sparse.values.byteOffset, elementSize, sparseCount, elementSize, valuesLength))
+            return;
+
+        sparseCount_ = sparseCount;
+        sparseIndexType_ = indexType;
+        sparseIndexSize_ = indexSize;
+        sparseIndices_ = indices + accessor.sparse.indices.byteOffset;
+        sparseValues_ = values + accessor.sparse.values.byteOffset;
+    }
+
+    valid_ = true;
+}
+
+uint32_t GltfAccessorView::sparseIndex(size_t i) const
+{
+    uint32_t index = 0;
+    GatherIndices(sparseIndexType_, sparseIndices_ + i * sparseIndexSize_, sparseIndexSize_, 1, &index);
+    return index;
+}
+
+size_t GltfAccessorView::byteSize() const
+{
+    if (!valid_)
+        return 0;
+    return (data_ ? count_ * elementSize_ : 0) + sparseCount_ * (sparseIndexSize_ + elementSize_);
+}
+
+bool GltfAccessorView::readFloats(float *out, int outComponents) const
+{
+    if (!valid_ || outComponents <= 0)
+        return false;
+
+    if (!data_)
+    {
+        for (size_t i = 0; i < count_; ++i)
+        {
+            for (int c = 0; c < outComponents; ++c)
+                out[i * outComponents + c] = c < components_ ? 0.0f : FillComponent(c);
+        }
+    }
+    else if (componentType_ == TINYGLTF_COMPONENT_TYPE_FLOAT && outComponents == components_ && stride_ == elementSize_)
+    {
+        // Tightly packed float data with a matching layout: one copy
+        std::memcpy(out, data_, count_ * elementSize_);
+    }
+    else
+    {
+        GatherFloats(componentType_, data_, stride_, count_, components_, normalized_, out, outComponents);
+    }
+
+    // Sparse substitution: tightly packed values overwrite the indexed elements (out-of-range indices are ignored)
+    for (size_t i = 0; i < sparseCount_; ++i)
+    {
+        const uint32_t target = sparseIndex(i);
+        if (target < count_)
+            GatherFloats(componentType_, sparseValues_ + i * elementSize_, elementSize_, 1, components_, normalized_,
+                         out + static_cast<size_t>(target) * outComponents, outComponents);
+    }
+    return true;
+}
+
+bool GltfAccessorView::readUInts(uint32_t *out) const
+{
+    if (!valid_ || !IsIndexType(componentType_))
+        return false;
+
+    if (data_)
+        GatherIndices(componentType_, data_, stride_, count_, out);
+    else
+        std::fill(out, out + count_, 0u);
+
+    for (size_t i = 0; i < sparseCount_; ++i)
+    {
+        const uint32_t target = sparseIndex(i);
+        if (target < count_)
+            GatherIndices(componentType_, sparseValues_ + i * elementSize_, elementSize_, 1, out + target);
+    }
+    return true;
+}
+
+bool GltfAccessorView::readPacked(void *out) const
+{
+    if (!valid_)
+        return false;
+
+    uint8_t *dst = static_cast<uint8_t *>(out);
+    if (!data_)
+        std::memset(dst, 0, count_ * elementSize_);
+    else if (stride_ == elementSize_)
+        std::memcpy(dst, data_, count_ * elementSize_);
+    else
+    {
+        for (size_t i = 0; i < count_; ++i)
+            std::memcpy(dst + i * elementSize_, data_ + i * stride_, elementSize_);
+    }
+
+    for (size_t i = 0; i < sparseCount_; ++i)
+    {
+        const uint32_t target = sparseIndex(i);
+        if (target < count_)
+            std::memcpy(dst + static_cast<size_t>(target) * elementSize_, sparseValues_ + i * elementSize_, elementSize_);
+    }
+    return true;
+}
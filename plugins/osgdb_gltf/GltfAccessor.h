@@ -0,0 +1,113 @@
+#ifndef GLTFACCESSOR_H
+#define GLTFACCESSOR_H
+
+#include <tiny_gltf.h>
+#include <osg/Array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Bounds-checked, typed view of one glTF accessor
+ *
+ * Resolves the accessor's buffer view once and converts all of its elements
+ * in bulk into caller-provided storage. Every component type is supported, as
+ * are interleaved buffer views (byteStride), normalized integer data and
+ * sparse accessors (the sparse values are written over the base data, or over
+ * zeros when the accessor has no buffer view).
+ *
+ * Tightly packed data that already has the requested layout is copied with a
+ * single memcpy. Everything else goes through gather loops that are
+ * specialized per component type and count, so the compiler can vectorize
+ * the conversion.
+ */
+class GltfAccessorView
+{
+public:
+    GltfAccessorView(const tinygltf::Model &model, int accessorIndex);
+
+    // false if the accessor, its buffer view or buffer is invalid, or the elements would overrun the buffer view
+    bool valid() const { return valid_; }
+    size_t count() const { return count_; }
+    int components() const { return components_; }     // 1 (SCALAR) .. 16 (MAT4)
+    int componentType() const { return componentType_; } // TINYGLTF_COMPONENT_TYPE_*
+    bool normalized() const { return normalized_; }
+    bool sparse() const { return sparseCount_ > 0; }
+    // Bytes of accessor data the conversion reads (base elements plus sparse indices and values)
+    size_t byteSize() const;
+
+    /**
+     * @brief Convert all elements to floats
+     * @param out count() * outComponents floats
+     * @param outComponents Floats written per element; extra ones are filled with 0, the fourth with 1
+     * @return false if the view is invalid
+     */
+    bool readFloats(float *out, int outComponents) const;
+
+    /**
+     * @brief Convert the first component of all elements to unsigned integers (index data)
+     * @param out count() values
+     * @return false if the view is invalid or the component type is not an integer type
+     */
+    bool readUInts(uint32_t *out) const;
+
+    /**
+     * @brief Copy all elements without conversion, tightly packed (e.g. to keep quantized data as is)
+     * @param out count() * components() values of componentType()
+     * @return false if the view is invalid
+     */
+    bool readPacked(void *out) const;
+
+    /**
+     * @brief Create an array of the accessor's own component type (e.g. Vec3bArray for normalized BYTE VEC3)
+     * @return nullptr if the view is invalid, empty, or its elements are not the size of ArrayT's
+     */
+    template <typename ArrayT>
+    osg::ref_ptr<ArrayT> toPackedArray() const
+    {
+        typedef typename ArrayT::ElementDataType Element;
+        if (!valid_ || count_ == 0 || sizeof(Element) != elementSize_)
+            return nullptr;
+        osg::ref_ptr<ArrayT> array = new ArrayT(static_cast<unsigned int>(count_));
+        if (!readPacked(&(*array)[0]))
+            return nullptr;
+        array->setNormalize(normalized_);
+        return array;
+    }
+
+    /**
+     * @brief Create a float array (FloatArray, Vec2Array, Vec3Array or Vec4Array) holding the accessor's elements
+     * @return nullptr if the view is invalid or empty
+     */
+    template <typename ArrayT>
+    osg::ref_ptr<ArrayT> toArray() const
+    {
+        typedef typename ArrayT::ElementDataType Element;
+        if (!valid_ || count_ == 0)
+            return nullptr;
+        osg::ref_ptr<ArrayT> array = new ArrayT(static_cast<unsigned int>(count_));
+        if (!readFloats(reinterpret_cast<float *>(&(*array)[0]), static_cast<int>(sizeof(Element) / sizeof(float))))
+            return nullptr;
+        return array;
+    }
+
+private:
+    uint32_t sparseIndex(size_t i) const;
+
+    const uint8_t *data_ = nullptr; // First element; null for a sparse accessor without a bufferView
+    size_t stride_ = 0;
+    size_t elementSize_ = 0;
+    size_t count_ = 0;
+    int components_ = 0;
+    int componentType_ = -1;
+    bool normalized_ = false;
+    bool valid_ = false;
+
+    // Sparse substitution: sparseCount_ indices of sparseIndexType_ and tightly packed element values
+    size_t sparseCount_ = 0;
+    const uint8_t *sparseIndices_ = nullptr;
+    int sparseIndexType_ = -1;
+    size_t sparseIndexSize_ = 0;
+    const uint8_t *sparseValues_ = nullptr;
+};
+
+#endif // GLTFACCESSOR_H
@@ -0,0 +1,291 @@
+#include "GltfInstancing.h"
+#include "GltfAccessor.h"
+#include "../PluginLogger.h"
+#include "../PluginShaders.h"
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+#include <osg/Shader>
+#include <osg/UserDataContainer>
+#include <osg/VertexAttribDivisor>
+#include <cmath>
+
+const char *const GltfInstancing::ExtensionName = "EXT_mesh_gpu_instancing";
+// Same name as in the LMB plugin, so the viewer picks instances of both formats the same way
+const char *const GltfInstancing::InstanceMatricesName = "LmbInstanceMatrices";
+
+namespace
+{
+    // Vertex attribute locations of the three instance matrix columns. On NVIDIA 0/2/3/4/5/8-15 alias
+    // fixed-function attributes, and 6/7 hold the LMB dequantization parameters (LmbShaders::BaseAttribute /
+    // InvScaleAttribute; both formats can share a scene). 10-12 alias texture coordinate sets 2-4: the
+    // instanced copies drop those sets and the shader only passes sets 0/1 on
+    const unsigned int FirstInstanceAttribute = 10;
+    const unsigned int FirstAliasedTexCoord = FirstInstanceAttribute - 8;
+    const char *const InstanceAttributeNames[3] = {"gltfInstance0", "gltfInstance1", "gltfInstance2"};
+
+    // Replaces only the vertex transform and per-vertex lighting (all light sources, as fixed function); the
+    // fragment stage stays fixed-function, so materials and textures are unchanged. CreateSharedState prepends
+    // the #version line and the lighting switch declaration
+    const char *VertexShaderBody =
+        "attribute vec4 gltfInstance0;\n"
+        "attribute vec4 gltfInstance1;\n"
+        "attribute vec4 gltfInstance2;\n"
+        "void main()\n"
+        "{\n"
+        "    vec4 vertex = vec4(dot(gltfInstance0, gl_Vertex), dot(gltfInstance1, gl_Vertex),\n"
+        "                       dot(gltfInstance2, gl_Vertex), 1.0);\n"
+        "    vec4 eyePosition = gl_ModelViewMatrix * vertex;\n"
+        "    if (pluginLighting)\n"
+        "    {\n"
+        // Normals use the cofactor matrix of the 3x3 part, equivalent to the inverse transpose (normalized afterwards)
+        "        vec3 c0 = cross(gltfInstance1.xyz, gltfInstance2.xyz);\n"
+        "        vec3 c1 = cross(gltfInstance2.xyz, gltfInstance0.xyz);\n"
+        "        vec3 c2 = cross(gltfInstance0.xyz, gltfInstance1.xyz);\n"
+        "        float detSign = dot(gltfInstance0.xyz, c0) < 0.0 ? -1.0 : 1.0;\n"
+        "        vec3 normal = detSign * vec3(dot(c0, gl_Normal), dot(c1, gl_Normal), dot(c2, gl_Normal));\n"
+        "        vec3 N = normalize(gl_NormalMatrix * normal);\n"
+        "        vec4 color = gl_FrontLightModelProduct.sceneColor;\n"
+        "        for (int i = 0; i < gl_MaxLights; ++i)\n"
+        "        {\n"
+        "            vec4 lightPosition = gl_LightSource[i].position;\n"
+        "            vec3 L = lightPosition.w == 0.0 ? normalize(lightPosition.xyz)\n"
+        "                                            : normalize(lightPosition.xyz - eyePosition.xyz);\n"
+        "            float NdotL = max(dot(N, L), 0.0);\n"
+        "            color += gl_FrontLightProduct[i].ambient + gl_FrontLightProduct[i].diffuse * NdotL;\n"
+        "            if (NdotL > 0.0)\n"
+        "            {\n"
+        "                vec3 H = normalize(L + vec3(0.0, 0.0, 1.0));\n"
+        "                color += gl_FrontLightProduct[i].specular * pow(max(dot(N, H), 1e-4), gl_FrontMaterial.shininess);\n"
+        "            }\n"
+        "        }\n"
+        "        color.a = gl_FrontMaterial.diffuse.a;\n"
+        "        gl_FrontColor = color;\n"
+        "        gl_BackColor = color;\n"
+        "    }\n"
+        "    else\n"
+        "    {\n"
+        // Like fixed function with GL_LIGHTING off: the current color (vertex color, or the osg::Material diffuse)
+        "        gl_FrontColor = gl_Color;\n"
+        "        gl_BackColor = gl_Color;\n"
+        "    }\n"
+        "    gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+        "    gl_TexCoord[1] = gl_MultiTexCoord1;\n"
+        // Units 2-4 get the default, as in fixed function without those sets
+        "    gl_TexCoord[2] = vec4(0.0, 0.0, 0.0, 1.0);\n"
+        "    gl_TexCoord[3] = vec4(0.0, 0.0, 0.0, 1.0);\n"
+        "    gl_TexCoord[4] = vec4(0.0, 0.0, 0.0, 1.0);\n"
+        "    gl_ClipVertex = eyePosition;\n"
+        "    gl_Position = gl_ProjectionMatrix * eyePosition;\n"
+        "}\n";
+
+    struct InstanceData
+    {
+        osg::ref_ptr<osg::Vec4Array> columns[3]; // One element per instance, divisor 1
+        osg::ref_ptr<osg::MatrixfArray> matrices;
+        std::vector<std::string> names;
+    };
+
+    // Read one instance attribute; a missing one returns true with values empty
+    bool ReadInstanceAttribute(const tinygltf::Model &model, const tinygltf::Value &attributes, const char *semantic,
+                               int components, std::vector<float> &values, size_t &count)
+    {
+        if (!attributes.Has(semantic))
+            return true;
+        const tinygltf::Value &index = attributes.Get(semantic);
+        GltfAccessorView view(model, index.IsNumber() ? index.GetNumberAsInt() : -1);
+        if (!view.valid() || view.components() != components || view.count() == 0 ||
+            (count != 0 && view.count() != count))
+        {
+            PluginLogger::logWarning("GLTF", std::string(GltfInstancing::ExtensionName) + ": " + semantic +
+                                                 " accessor is invalid or its count differs from the other attributes");
+            return false;
+        }
+        count = view.count();
+        values.resize(count * components);
+        return view.readFloats(values.data(), components);
+    }
+
+    osg::ref_ptr<osg::Geometry> CreateInstancedGeometry(const osg::Geometry &source, const InstanceData &instances)
+    {
+        const unsigned int instanceCount = static_cast<unsigned int>(instances.matrices->size());
+
+        // Vertex arrays are shared; the primitive sets are copied so the instance count applies to the copy only
+        osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry(source, osg::CopyOp::SHALLOW_COPY);
+        for (unsigned int i = 0; i < source.getNumPrimitiveSets(); ++i)
+        {
+            osg::ref_ptr<osg::PrimitiveSet> primitives = osg::clone(source.getPrimitiveSet(i), osg::CopyOp::SHALLOW_COPY);
+            primitives->setNumInstances(static_cast<int>(instanceCount));
+            geometry->setPrimitiveSet(i, primitives.get());
+        }
+        for (unsigned int column = 0; column < 3; ++column)
+        {
+            if (geometry->getTexCoordArray(FirstAliasedTexCoord + column))
+                geometry->setTexCoordArray(FirstAliasedTexCoord + column, nullptr);
+            geometry->setVertexAttribArray(FirstInstanceAttribute + column, instances.columns[column].get(),
+                                           osg::Array::BIND_PER_VERTEX);
+        }
+
+        // One draw for all instances; display lists cannot record instanced draws
+        geometry->setUseDisplayList(false);
+        geometry->setUseVertexBufferObjects(true);
+
+        // The bound must cover all instances, or view frustum culling would use the single copy at the origin
+        const osg::BoundingBox localBox = source.getBoundingBox();
+        osg::BoundingBox instancesBox;
+        for (const osg::Matrixf &m : *instances.matrices)
+        {
+            for (unsigned int corner = 0; corner < 8; ++corner)
+                instancesBox.expandBy(localBox.corner(corner) * m);
+        }
+        geometry->setInitialBound(instancesBox);
+        geometry->dirtyBound();
+        return geometry;
+    }
+
+    // Copy the groups and Geodes with the same structure, with instanced copies of the geometries; state sets are shared
+    osg::ref_ptr<osg::Node> CreateInstancedNode(osg::Node *node, const InstanceData &instances)
+    {
+        if (osg::Geode *source = node->asGeode())
+        {
+            osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+            geode->setName(source->getName());
+            geode->setStateSet(source->getStateSet());
+            for (unsigned int i = 0; i < source->getNumDrawables(); ++i)
+            {
+                osg::Drawable *drawable = source->getDrawable(i);
+                if (osg::Geometry *geometry = drawable->asGeometry())
+                    geode->addDrawable(CreateInstancedGeometry(*geometry, instances).get());
+                else
+                    geode->addDrawable(drawable);
+            }
+
+            // For picking: instance matrices and names
+            geode->getOrCreateUserDataContainer()->addUserObject(instances.matrices.get());
+            geode->setDescriptions(instances.names);
+            return geode;
+        }
+        if (osg::Group *source = node->asGroup())
+        {
+            osg::ref_ptr<osg::Group> group = new osg::Group;
+            group->setName(source->getName());
+            group->setStateSet(source->getStateSet());
+            for (unsigned int i = 0; i < source->getNumChildren(); ++i)
+                group->addChild(CreateInstancedNode(source->getChild(i), instances).get());
+            return group;
+        }
+        return node;
+    }
+}
+
+bool GltfInstancing::HasInstancing(const tinygltf::Node &node)
+{
+    return node.extensions.find(ExtensionName) != node.extensions.end();
+}
+
+bool GltfInstancing::ReadInstanceMatrices(const tinygltf::Model &model, const tinygltf::Node &node,
+                                          std::vector<osg::Matrixf> &matrices)
+{
+    matrices.clear();
+    auto extension = node.extensions.find(ExtensionName);
+    if (extension == node.extensions.end() || !extension->second.Has("attributes") ||
+        !extension->second.Get("attributes").IsObject())
+    {
+        PluginLogger::logWarning("GLTF", std::string(ExtensionName) + ": node has no attributes object");
+        return false;
+    }
+    const tinygltf::Value &attributes = extension->second.Get("attributes");
+
+    // ROTATION may be normalized byte/short; readFloats denormalizes it
+    std::vector<float> translations, rotations, scales;
+    size_t count = 0;
+    if (!ReadInstanceAttribute(model, attributes, "TRANSLATION", 3, translations, count) ||
+        !ReadInstanceAttribute(model, attributes, "ROTATION", 4, rotations, count) ||
+        !ReadInstanceAttribute(model, attributes, "SCALE", 3, scales, count))
+    {
+        return false;
+    }
+    if (count == 0)
+    {
+        PluginLogger::logWarning("GLTF", std::string(ExtensionName) + ": node has no instance attributes");
+        return false;
+    }
+
+    // Instance transform = T * R * S (OSG uses row vectors, so multiply in S, R, T order)
+    matrices.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        osg::Matrixf &m = matrices[i];
+        if (!scales.empty())
+            m.makeScale(scales[i * 3], scales[i * 3 + 1], scales[i * 3 + 2]);
+        if (!rotations.empty())
+        {
+            const float *q = &rotations[i * 4];
+            const float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+            if (length > 0.0f)
+                m.postMultRotate(osg::Quat(q[0] / length, q[1] / length, q[2] / length, q[3] / length));
+        }
+        if (!translations.empty())
+            m.postMultTranslate(osg::Vec3f(translations[i * 3], translations[i * 3 + 1], translations[i * 3 + 2]));
+    }
+    return true;
+}
+
+osg::ref_ptr<osg::StateSet> GltfInstancing::CreateSharedState()
+{
+    osg::ref_ptr<osg::Program> program = new osg::Program;
+    program->setName("GltfInstancing");
+    const std::string source = std::string("#version 120\n") + PluginShaders::LightingDeclaration + VertexShaderBody;
+    program->addShader(new osg::Shader(osg::Shader::VERTEX, source));
+    for (unsigned int column = 0; column < 3; ++column)
+        program->addBindAttribLocation(InstanceAttributeNames[column], FirstInstanceAttribute + column);
+
+    osg::ref_ptr<osg::StateSet> stateSet = new osg::StateSet;
+    stateSet->setAttributeAndModes(program.get(), osg::StateAttribute::ON);
+    for (unsigned int column = 0; column < 3; ++column)
+        stateSet->setAttribute(new osg::VertexAttribDivisor(FirstInstanceAttribute + column, 1));
+    return stateSet;
+}
+
+osg::ref_ptr<osg::Group> GltfInstancing::CreateInstancedGroup(osg::Group *meshGroup,
+                                                              const std::vector<osg::Matrixf> &matrices,
+                                                              const std::vector<std::string> &instanceNames,
+                                                              osg::StateSet *sharedState)
+{
+    // One element per instance: the three matrix columns (x' = dot(c0, v) ...), the texel layout of LmbInstancing
+    InstanceData instances;
+    for (unsigned int column = 0; column < 3; ++column)
+    {
+        instances.columns[column] = new osg::Vec4Array(static_cast<unsigned int>(matrices.size()));
+        instances.columns[column]->setBinding(osg::Array::BIND_PER_VERTEX);
+        for (size_t i = 0; i < matrices.size(); ++i)
+        {
+            const osg::Matrixf &m = matrices[i];
+            (*instances.columns[column])[i].set(m(0, column), m(1, column), m(2, column), m(3, column));
+        }
+    }
+    instances.matrices = new osg::MatrixfArray(matrices.begin(), matrices.end());
+    instances.matrices->setName(InstanceMatricesName);
+    instances.names = instanceNames;
+
+    osg::ref_ptr<osg::Group> group = new osg::Group;
+    group->setName(meshGroup->getName() + "_instanced");
+    group->setStateSet(sharedState);
+    group->addChild(CreateInstancedNode(meshGroup, instances).get());
+    return group;
+}
+
+osg::ref_ptr<osg::Group> GltfInstancing::ExpandInstances(osg::Group *meshGroup, const std::vector<osg::Matrixf> &matrices,
+                                                         const std::vector<std::string> &instanceNames)
+{
+    osg::ref_ptr<osg::Group> group = new osg::Group;
+    group->setName(meshGroup->getName() + "_instances");
+    for (size_t i = 0; i < matrices.size(); ++i)
+    {
+        osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform(osg::Matrix(matrices[i]));
+        transform->setName(instanceNames[i]);
+        transform->addChild(meshGroup);
+        group->addChild(transform.get());
+    }
+    return group;
+}
@@ -0,0 +1,74 @@
+#ifndef GLTFINSTANCING_H
+#define GLTFINSTANCING_H
+
+#include <tiny_gltf.h>
+#include <osg/Group>
+#include <osg/Matrix>
+#include <osg/Program>
+#include <osg/StateSet>
+#include <string>
+#include <vector>
+
+/**
+ * @brief EXT_mesh_gpu_instancing: one mesh drawn at many per-instance transforms
+ *
+ * GPU path: the mesh is drawn once per primitive with glDrawElementsInstanced.
+ * The per-instance 3x4 transforms are three vertex attributes with divisor 1
+ * at locations 10-12, clear of the LMB dequantization attributes 6/7, and the
+ * vertex shader from CreateSharedState applies them. Those locations alias
+ * texture coordinate sets 2-4 on NVIDIA, so instanced meshes draw with sets
+ * 0/1 only. The shader lights with every light source like fixed function,
+ * or passes gl_Color through when PluginShaders::LightingUniform is off. The
+ * fragment stage stays fixed-function, so glTF materials and textures work
+ * unchanged.
+ *
+ * CPU path: every instance becomes a MatrixTransform over the shared mesh group.
+ *
+ * For picking, the instanced Geodes keep the per-instance matrices as an
+ * osg::MatrixfArray user object named InstanceMatricesName and the instance
+ * names as node descriptions, the same layout the LMB plugin uses.
+ */
+class GltfInstancing
+{
+public:
+    static const char *const ExtensionName;
+    static const char *const InstanceMatricesName;
+
+    static bool HasInstancing(const tinygltf::Node &node);
+
+    /**
+     * @brief Read the TRANSLATION / ROTATION / SCALE instance accessors of a node
+     * @param matrices Per-instance transforms (relative to the node)
+     * @return false (with a warning logged) if the accessors are invalid or their counts differ
+     */
+    static bool ReadInstanceMatrices(const tinygltf::Model &model, const tinygltf::Node &node,
+                                     std::vector<osg::Matrixf> &matrices);
+
+    /**
+     * @brief State shared by every instanced group of a load: program and attribute divisors
+     */
+    static osg::ref_ptr<osg::StateSet> CreateSharedState();
+
+    /**
+     * @brief Copy of meshGroup whose geometries draw themselves once per instance
+     *
+     * Vertex arrays and state sets are shared with meshGroup; the geometries and
+     * primitive sets are copied, since their instance count is per node.
+     * @param meshGroup Converted mesh (left unchanged)
+     * @param matrices Per-instance transforms
+     * @param instanceNames Per-instance names, stored for picking
+     * @param sharedState State from CreateSharedState()
+     */
+    static osg::ref_ptr<osg::Group> CreateInstancedGroup(osg::Group *meshGroup,
+                                                         const std::vector<osg::Matrixf> &matrices,
+                                                         const std::vector<std::string> &instanceNames,
+                                                         osg::StateSet *sharedState);
+
+    /**
+     * @brief CPU fallback: one MatrixTransform per instance, all sharing meshGroup
+     */
+    static osg::ref_ptr<osg::Group> ExpandInstances(osg::Group *meshGroup, const std::vector<osg::Matrixf> &matrices,
+                                                    const std::vector<std::string> &instanceNames);
+};
+
+#endif // GLTFINSTANCING_H
@@ -0,0 +1,928 @@
+#include "GltfMeshopt.h"
+#include "../PluginLogger.h"
+#include <json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#ifdef GLTF_USE_MESHOPTIMIZER
+#include <meshoptimizer.h>
+#endif
+
+const char *const GltfMeshopt::ExtensionName = "EXT_meshopt_compression";
+
+namespace
+{
+    // Placeholder for fallback buffers: 4 zero bytes (TinyGLTF rejects an empty data URI)
+    const char *const PlaceholderUri = "data:application/octet-stream;base64,AAAAAA==";
+    const size_t PlaceholderLength = 4;
+
+    const uint32_t GlbMagic = 0x46546C67;     // "glTF"
+    const uint32_t GlbJsonChunk = 0x4E4F534A; // "JSON"
+    const size_t GlbHeaderSize = 12;
+    const size_t GlbChunkHeaderSize = 8;
+
+    // Vertex codec: data is split into byte planes in groups of 16 bytes, stored as 0/2/4/8-bit deltas
+    const unsigned char VertexHeader = 0xa0;
+    const size_t VertexBlockSizeBytes = 8192;
+    const size_t VertexBlockMaxSize = 256;
+    const size_t ByteGroupSize = 16;
+    const size_t ByteGroupDecodeLimit = 24; // Most bytes one group reads (4-bit mode: 8 header bytes + 16 literal bytes)
+    const size_t TailMaxSize = 32;
+
+    // Index codec: triangles are coded by edge/vertex FIFO hits; version 1 adds +-1 delta codes
+    const unsigned char IndexHeader = 0xe0;
+    const unsigned char SequenceHeader = 0xd0;
+    const int IndexVersion = 1;
+
+    uint32_t ReadU32(const unsigned char *data)
+    {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    void WriteU32(unsigned char *data, uint32_t value)
+    {
+        std::memcpy(data, &value, sizeof(value));
+    }
+
+    bool Contains(const unsigned char *begin, const unsigned char *end, const char *text)
+    {
+        const size_t length = std::strlen(text);
+        return std::search(begin, end, text, text + length) != end;
+    }
+
+    // Replace buffers marked as fallback with placeholder data; false if there are none
+    bool PatchJson(std::string &json)
+    {
+        nlohmann::json document = nlohmann::json::parse(json, nullptr, false);
+        if (document.is_discarded() || !document.is_object())
+            return false; // TinyGLTF reports the JSON error
+
+        auto buffers = document.find("buffers");
+        if (buffers == document.end() || !buffers->is_array())
+            return false;
+
+        bool patched = false;
+        for (nlohmann::json &buffer : *buffers)
+        {
+            if (!buffer.is_object())
+                continue;
+            auto extensions = buffer.find("extensions");
+            if (extensions == buffer.end() || !extensions->is_object())
+                continue;
+            auto extension = extensions->find(GltfMeshopt::ExtensionName);
+            if (extension == extensions->end() || !extension->is_object())
+                continue;
+            auto fallback = extension->find("fallback");
+            if (fallback == extension->end() || !fallback->is_boolean() || !fallback->get<bool>())
+                continue;
+            // Fallback buffers with a uri are replaced too, which saves reading the uncompressed data
+            buffer["uri"] = PlaceholderUri;
+            buffer["byteLength"] = PlaceholderLength;
+            patched = true;
+        }
+        if (patched)
+            json = document.dump();
+        return patched;
+    }
+
+#ifndef GLTF_USE_MESHOPTIMIZER
+    // Built-in decoder, used without third-party/meshoptimizer; follows the meshoptimizer reference bit for bit
+    inline unsigned char Unzigzag8(unsigned char v)
+    {
+        return static_cast<unsigned char>(-(v & 1) ^ (v >> 1));
+    }
+
+    size_t VertexBlockSize(size_t vertexSize)
+    {
+        size_t result = VertexBlockSizeBytes / vertexSize;
+        result &= ~(ByteGroupSize - 1);
+        return result < VertexBlockMaxSize ? result : VertexBlockMaxSize;
+    }
+
+    // One group of 16 bytes; bits 0/1/2/3 store each value in 0/2/4/8 bits, and an all-ones 2/4-bit value
+    // means a literal byte follows
+    const unsigned char *DecodeBytesGroup(const unsigned char *data, unsigned char *buffer, int bits)
+    {
+        switch (bits)
+        {
+        case 0:
+            std::memset(buffer, 0, ByteGroupSize);
+            return data;
+        case 1:
+        case 2:
+        {
+            const int width = bits == 1 ? 2 : 4;
+            const unsigned int sentinel = (1u << width) - 1;
+            const int perByte = 8 / width;
+            const unsigned char *raw = data + ByteGroupSize / perByte;
+            for (size_t i = 0; i < ByteGroupSize; ++i)
+            {
+                // Each byte holds its values starting from the high bits
+                const unsigned int shift = 8 - width * (static_cast<int>(i % perByte) + 1);
+                const unsigned int value = (data[i / perByte] >> shift) & sentinel;
+                buffer[i] = value == sentinel ? *raw++ : static_cast<unsigned char>(value);
+            }
+            return raw;
+        }
+        default:
+            std::memcpy(buffer, data, ByteGroupSize);
+            return data + ByteGroupSize;
+        }
+    }
+
+    const unsigned char *DecodeBytes(const unsigned char *data, const unsigned char *dataEnd, unsigned char *buffer,
+                                     size_t bufferSize)
+    {
+        // Each group mode takes 2 bits, 4 groups per byte
+        const unsigned char *header = data;
+        const size_t headerSize = (bufferSize / ByteGroupSize + 3) / 4;
+        if (static_cast<size_t>(dataEnd - data) < headerSize)
+            return nullptr;
+        data += headerSize;
+
+        for (size_t i = 0; i < bufferSize; i += ByteGroupSize)
+        {
+            // At least 32 bytes remain at the end, so this check before each group keeps reads in bounds
+            if (static_cast<size_t>(dataEnd - data) < ByteGroupDecodeLimit)
+                return nullptr;
+            const size_t group = i / ByteGroupSize;
+            const int bits = (header[group / 4] >> ((group % 4) * 2)) & 3;
+            data = DecodeBytesGroup(data, buffer + i, bits);
+        }
+        return data;
+    }
+
+    // A block holds up to 256 vertices; byte planes are decoded, then the deltas to the previous vertex undone
+    const unsigned char *DecodeVertexBlock(const unsigned char *data, const unsigned char *dataEnd,
+                                           unsigned char *vertexData, size_t vertexCount, size_t vertexSize,
+                                           unsigned char lastVertex[256])
+    {
+        unsigned char buffer[VertexBlockMaxSize];
+        const size_t alignedCount = (vertexCount + ByteGroupSize - 1) & ~(ByteGroupSize - 1);
+
+        for (size_t k = 0; k < vertexSize; ++k)
+        {
+            data = DecodeBytes(data, dataEnd, buffer, alignedCount);
+            if (!data)
+                return nullptr;
+
+            unsigned char previous = lastVertex[k];
+            unsigned char *out = vertexData + k;
+            for (size_t i = 0; i < vertexCount; ++i)
+            {
+                previous = static_cast<unsigned char>(Unzigzag8(buffer[i]) + previous);
+                *out = previous;
+                out += vertexSize;
+            }
+            lastVertex[k] = previous;
+        }
+        return data;
+    }
+
+    unsigned int DecodeVByte(const unsigned char *&data)
+    {
+        unsigned char lead = *data++;
+        if (lead < 128)
+            return lead;
+
+        unsigned int result = lead & 127;
+        unsigned int shift = 7;
+        for (int i = 0; i < 4; ++i)
+        {
+            unsigned char group = *data++;
+            result |= static_cast<unsigned int>(group & 127) << shift;
+            shift += 7;
+            if (group < 128)
+                break;
+        }
+        return result;
+    }
+
+    // Free index: zigzag delta to the previous free index
+    unsigned int DecodeIndex(const unsigned char *&data, unsigned int last)
+    {
+        const unsigned int v = DecodeVByte(data);
+        const unsigned int d = (v >> 1) ^ (0u - (v & 1));
+        return last + d;
+    }
+
+    void WriteIndex(unsigned char *destination, size_t index, size_t indexSize, unsigned int value)
+    {
+        if (indexSize == 2)
+        {
+            const uint16_t narrow = static_cast<uint16_t>(value);
+            std::memcpy(destination + index * 2, &narrow, 2);
+        }
+        else
+        {
+            std::memcpy(destination + index * 4, &value, 4);
+        }
+    }
+
+    struct IndexDecoder
+    {
+        unsigned int edges[16][2];
+        unsigned int vertices[16];
+        size_t edgeOffset = 0;
+        size_t vertexOffset = 0;
+
+        IndexDecoder()
+        {
+            std::memset(edges, -1, sizeof(edges));
+            std::memset(vertices, -1, sizeof(vertices));
+        }
+
+        void pushEdge(unsigned int a, unsigned int b)
+        {
+            edges[edgeOffset][0] = a;
+            edges[edgeOffset][1] = b;
+            edgeOffset = (edgeOffset + 1) & 15;
+        }
+
+        void pushVertex(unsigned int v, bool advance = true)
+        {
+            vertices[vertexOffset] = v;
+            vertexOffset = (vertexOffset + (advance ? 1 : 0)) & 15;
+        }
+
+        unsigned int vertex(size_t back) const { return vertices[(vertexOffset - back) & 15]; }
+    };
+#endif
+
+    enum class Mode
+    {
+        Attributes,
+        Triangles,
+        Indices
+    };
+
+    enum class Filter
+    {
+        None,
+        Octahedral,
+        Quaternion,
+        Exponential
+    };
+
+    // One compressed bufferView: the source data is in the source buffer, decoded to the bufferView's own location
+    struct Job
+    {
+        int view = -1;
+        size_t sourceBuffer = 0;
+        size_t sourceOffset = 0;
+        const unsigned char *source = nullptr;
+        size_t sourceSize = 0;
+        unsigned char *destination = nullptr;
+        size_t count = 0;
+        size_t stride = 0;
+        Mode mode = Mode::Attributes;
+        Filter filter = Filter::None;
+        bool ok = false;
+    };
+
+    size_t NumberProperty(const tinygltf::Value &object, const char *name, size_t fallback)
+    {
+        const tinygltf::Value &value = object.Get(name);
+        if (!value.IsNumber())
+            return fallback;
+        const double number = value.GetNumberAsDouble();
+        return number >= 0.0 ? static_cast<size_t>(number) : fallback;
+    }
+
+    std::string StringProperty(const tinygltf::Value &object, const char *name, const char *fallback)
+    {
+        const tinygltf::Value &value = object.Get(name);
+        return value.IsString() ? value.Get<std::string>() : std::string(fallback);
+    }
+
+    // Parse the extension object and check the source and target ranges; error explains a failure
+    bool PrepareJob(const tinygltf::Model &model, int viewIndex, const tinygltf::Value &extension, Job &job,
+                    size_t &required, std::string &error)
+    {
+        const tinygltf::BufferView &view = model.bufferViews[viewIndex];
+        job.view = viewIndex;
+
+        const size_t sourceBuffer = job.sourceBuffer = NumberProperty(extension, "buffer", SIZE_MAX);
+        const size_t sourceOffset = job.sourceOffset = NumberProperty(extension, "byteOffset", 0);
+        job.sourceSize = NumberProperty(extension, "byteLength", SIZE_MAX);
+        job.stride = NumberProperty(extension, "byteStride", 0);
+        job.count = NumberProperty(extension, "count", SIZE_MAX);
+
+        const std::string mode = StringProperty(extension, "mode", "");
+        const std::string filter = StringProperty(extension, "filter", "NONE");
+        if (mode == "ATTRIBUTES")
+            job.mode = Mode::Attributes;
+        else if (mode == "TRIANGLES")
+            job.mode = Mode::Triangles;
+        else if (mode == "INDICES")
+            job.mode = Mode::Indices;
+        else
+        {
+            error = "unknown mode '" + mode + "'";
+            return false;
+        }
+
+        if (filter == "NONE")
+            job.filter = Filter::None;
+        else if (filter == "OCTAHEDRAL")
+            job.filter = Filter::Octahedral;
+        else if (filter == "QUATERNION")
+            job.filter = Filter::Quaternion;
+        else if (filter == "EXPONENTIAL")
+            job.filter = Filter::Exponential;
+        else
+        {
+            error = "unknown filter '" + filter + "'";
+            return false;
+        }
+
+        // Spec constraints: attribute stride a multiple of 4 up to 256, indices 2 or 4 bytes, triangle index count
+        // a multiple of 3
+        if (job.mode == Mode::Attributes && (job.stride == 0 || job.stride % 4 != 0 || job.stride > 256))
+        {
+            error = "invalid byteStride " + std::to_string(job.stride) + " for ATTRIBUTES";
+            return false;
+        }
+        if (job.mode != Mode::Attributes && job.stride != 2 && job.stride != 4)
+        {
+            error = "invalid byteStride " + std::to_string(job.stride) + " for " + mode;
+            return false;
+        }
+        if ((job.mode != Mode::Attributes && job.filter != Filter::None) || (job.mode == Mode::Triangles && job.count % 3 != 0))
+        {
+            error = "invalid filter or count for " + mode;
+            return false;
+        }
+
+        if (sourceBuffer >= model.buffers.size() || view.buffer < 0 || view.buffer >= static_cast<int>(model.buffers.size()))
+        {
+            error = "invalid buffer index";
+            return false;
+        }
+        const std::vector<unsigned char> &source = model.buffers[sourceBuffer].data;
+        if (sourceOffset > source.size() || job.sourceSize > source.size() - sourceOffset)
+        {
+            error = "compressed data overruns buffer " + std::to_string(sourceBuffer);
+            return false;
+        }
+        if (job.count == SIZE_MAX || job.count > view.byteLength / job.stride)
+        {
+            error = "count * byteStride exceeds the buffer view length";
+            return false;
+        }
+
+        // The source pointer is only taken after the target buffers have grown, see DecompressBufferViews
+        required = view.byteOffset + view.byteLength;
+        return true;
+    }
+
+    // Byte range in a buffer, for checking that the views do not read and write overlapping bytes
+    struct Range
+    {
+        size_t buffer;
+        size_t begin;
+        size_t end;
+        int view;
+
+        bool operator<(const Range &other) const
+        {
+            return buffer != other.buffer ? buffer < other.buffer : begin < other.begin;
+        }
+    };
+
+    // Workers write their target ranges concurrently: targets must not overlap each other or any source;
+    // error explains a failure
+    bool CheckOverlaps(const tinygltf::Model &model, const std::vector<Job> &jobs, std::string &error)
+    {
+        std::vector<Range> destinations;
+        for (const Job &job : jobs)
+        {
+            const tinygltf::BufferView &view = model.bufferViews[job.view];
+            const size_t size = job.count * job.stride;
+            if (size > 0)
+                destinations.push_back({static_cast<size_t>(view.buffer), view.byteOffset, view.byteOffset + size, job.view});
+        }
+        std::sort(destinations.begin(), destinations.end());
+        for (size_t i = 1; i < destinations.size(); ++i)
+        {
+            const Range &previous = destinations[i - 1];
+            if (destinations[i].buffer == previous.buffer && destinations[i].begin < previous.end)
+            {
+                error = "buffer view " + std::to_string(destinations[i].view) + ": decoded range overlaps buffer view " +
+                        std::to_string(previous.view);
+                return false;
+            }
+        }
+
+        // Targets are sorted and disjoint, so their ends are sorted too: only the last target starting before the
+            // source ends needs checking
+        for (const Job &job : jobs)
+        {
+            if (job.sourceSize == 0)
+                continue;
+            const Range source = {job.sourceBuffer, job.sourceOffset, job.sourceOffset + job.sourceSize, job.view};
+            const Range key = {source.buffer, source.end, source.end, -1};
+            auto found = std::lower_bound(destinations.begin(), destinations.end(), key);
+            if (found == destinations.begin())
+                continue;
+            --found;
+            if (found->buffer == source.buffer && found->end > source.begin)
+            {
+                error = "buffer view " + std::to_string(job.view) + ": compressed range overlaps the decoded range of buffer view " +
+                        std::to_string(found->view);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool RunJob(Job &job)
+    {
+        bool ok = false;
+        switch (job.mode)
+        {
+        case Mode::Attributes:
+            ok = GltfMeshopt::DecodeVertexBuffer(job.destination, job.count, job.stride, job.source, job.sourceSize);
+            break;
+        case Mode::Triangles:
+            ok = GltfMeshopt::DecodeIndexBuffer(job.destination, job.count, job.stride, job.source, job.sourceSize);
+            break;
+        case Mode::Indices:
+            ok = GltfMeshopt::DecodeIndexSequence(job.destination, job.count, job.stride, job.source, job.sourceSize);
+            break;
+        }
+        if (!ok)
+            return false;
+
+        switch (job.filter)
+        {
+        case Filter::Octahedral:
+            return GltfMeshopt::DecodeFilterOctahedral(job.destination, job.count, job.stride);
+        case Filter::Quaternion:
+            return GltfMeshopt::DecodeFilterQuaternion(job.destination, job.count, job.stride);
+        case Filter::Exponential:
+            return GltfMeshopt::DecodeFilterExponential(job.destination, job.count, job.stride);
+        default:
+            return true;
+        }
+    }
+
+#ifndef GLTF_USE_MESHOPTIMIZER
+    // Filtered component: signed rounding, matching meshoptimizer
+    inline int RoundSigned(float value)
+    {
+        return static_cast<int>(value + (value >= 0.0f ? 0.5f : -0.5f));
+    }
+
+    template <typename T>
+    void DecodeOctahedral(unsigned char *data, size_t count, size_t stride)
+    {
+        const float maximum = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+        for (size_t i = 0; i < count; ++i)
+        {
+            T element[4];
+            std::memcpy(element, data + i * stride, sizeof(element));
+
+            // Rebuild z from x and y (the z component stores the encoding of 1.0); fold back for z < 0
+            float x = static_cast<float>(element[0]);
+            float y = static_cast<float>(element[1]);
+            const float z = static_cast<float>(element[2]) - std::fabs(x) - std::fabs(y);
+            const float t = z < 0.0f ? z : 0.0f;
+            x += x >= 0.0f ? t : -t;
+            y += y >= 0.0f ? t : -t;
+
+            const float scale = maximum / std::sqrt(x * x + y * y + z * z);
+            element[0] = static_cast<T>(RoundSigned(x * scale));
+            element[1] = static_cast<T>(RoundSigned(y * scale));
+            element[2] = static_cast<T>(RoundSigned(z * scale));
+            std::memcpy(data + i * stride, element, sizeof(element));
+        }
+    }
+#endif
+}
+
+bool GltfMeshopt::PatchFallbackBuffers(std::vector<unsigned char> &data, bool binary)
+{
+    if (!binary)
+    {
+        if (!Contains(data.data(), data.data() + data.size(), ExtensionName))
+            return false;
+        std::string json(data.begin(), data.end());
+        if (!PatchJson(json))
+            return false;
+        data.assign(json.begin(), json.end());
+        return true;
+    }
+
+    // GLB: replace the JSON chunk and keep the BIN chunk after it; TinyGLTF reports format errors
+    if (data.size() < GlbHeaderSize + GlbChunkHeaderSize || ReadU32(data.data()) != GlbMagic ||
+        ReadU32(data.data() + GlbHeaderSize + 4) != GlbJsonChunk)
+        return false;
+    const size_t jsonBegin = GlbHeaderSize + GlbChunkHeaderSize;
+    const size_t jsonLength = ReadU32(data.data() + GlbHeaderSize);
+    if (jsonLength > data.size() - jsonBegin ||
+        !Contains(data.data() + jsonBegin, data.data() + jsonBegin + jsonLength, ExtensionName))
+        return false;
+
+    std::string json(data.begin() + jsonBegin, data.begin() + jsonBegin + jsonLength);
+    if (!PatchJson(json))
+        return false;
+    // Chunk lengths are 4-byte aligned; the JSON chunk is padded with spaces
+    json.resize((json.size() + 3) & ~size_t(3), ' ');
+
+    std::vector<unsigned char> patched(jsonBegin + json.size() + (data.size() - jsonBegin - jsonLength));
+    std::memcpy(patched.data(), data.data(), GlbHeaderSize + 4 + 4);
+    WriteU32(patched.data() + 8, static_cast<uint32_t>(patched.size()));
+    WriteU32(patched.data() + GlbHeaderSize, static_cast<uint32_t>(json.size()));
+    std::memcpy(patched.data() + jsonBegin, json.data(), json.size());
+    std::memcpy(patched.data() + jsonBegin + json.size(), data.data() + jsonBegin + jsonLength,
+                data.size() - jsonBegin - jsonLength);
+    data.swap(patched);
+    return true;
+}
+
+int GltfMeshopt::DecompressBufferViews(tinygltf::Model &model, uint64_t &compressedBytes, uint64_t &decodedBytes,
+                                       std::string &error)
+{
+    compressedBytes = 0;
+    decodedBytes = 0;
+
+    // First check every compressed view and grow the target buffers to the decoded size (placeholder fallback
+    // buffers have 4 bytes), so no buffer changes while decoding; source and target pointers are taken after
+    // growing, since a source buffer can also be a grown target buffer
+    std::vector<Job> jobs;
+    std::vector<size_t> requiredSizes(model.buffers.size(), 0);
+    for (size_t i = 0; i < model.bufferViews.size(); ++i)
+    {
+        auto extension = model.bufferViews[i].extensions.find(ExtensionName);
+        if (extension == model.bufferViews[i].extensions.end())
+            continue;
+        if (!extension->second.IsObject())
+        {
+            error = "buffer view " + std::to_string(i) + ": extension is not an object";
+            return -1;
+        }
+
+        Job job;
+        size_t required = 0;
+        std::string reason;
+        if (!PrepareJob(model, static_cast<int>(i), extension->second, job, required, reason))
+        {
+            error = "buffer view " + std::to_string(i) + ": " + reason;
+            return -1;
+        }
+        const int target = model.bufferViews[i].buffer;
+        requiredSizes[target] = std::max(requiredSizes[target], required);
+        jobs.push_back(job);
+    }
+    if (jobs.empty())
+        return 0;
+    if (!CheckOverlaps(model, jobs, error))
+        return -1;
+
+    for (size_t i = 0; i < model.buffers.size(); ++i)
+    {
+        if (model.buffers[i].data.size() < requiredSizes[i])
+            model.buffers[i].data.resize(requiredSizes[i]);
+    }
+    for (Job &job : jobs)
+    {
+        const tinygltf::BufferView &view = model.bufferViews[job.view];
+        job.source = model.buffers[job.sourceBuffer].data.data() + job.sourceOffset;
+        job.destination = model.buffers[view.buffer].data.data() + view.byteOffset;
+        compressedBytes += job.sourceSize;
+        decodedBytes += job.count * job.stride;
+    }
+
+    // CheckOverlaps has confirmed the ranges do not conflict; hand views to the workers largest first, so the
+    // biggest one does not start last
+    std::vector<Job *> order;
+    for (Job &job : jobs)
+        order.push_back(&job);
+    std::sort(order.begin(), order.end(),
+              [](const Job *a, const Job *b) { return a->count * a->stride > b->count * b->stride; });
+
+    std::atomic<size_t> next(0);
+    auto worker = [&order, &next]()
+    {
+        for (size_t i = next++; i < order.size(); i = next++)
+            order[i]->ok = RunJob(*order[i]);
+    };
+    const size_t threadCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), order.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread &thread : threads)
+        thread.join();
+
+    for (const Job &job : jobs)
+    {
+        if (!job.ok)
+        {
+            error = "buffer view " + std::to_string(job.view) + ": compressed data is corrupted";
+            return -1;
+        }
+        model.bufferViews[job.view].extensions.erase(ExtensionName);
+    }
+
+    // Source buffers only referenced by compressed views (unreferenced after decoding) are dropped
+    std::vector<bool> referenced(model.buffers.size(), false);
+    for (const tinygltf::BufferView &view : model.bufferViews)
+    {
+        if (view.buffer >= 0 && view.buffer < static_cast<int>(model.buffers.size()))
+            referenced[view.buffer] = true;
+    }
+    for (size_t i = 0; i < model.buffers.size(); ++i)
+    {
+        if (!referenced[i])
+            std::vector<unsigned char>().swap(model.buffers[i].data);
+    }
+    return static_cast<int>(jobs.size());
+}
+
+bool GltfMeshopt::DecodeVertexBuffer(unsigned char *destination, size_t vertexCount, size_t vertexSize,
+                                     const unsigned char *buffer, size_t bufferSize)
+{
+    if (vertexSize == 0 || vertexSize > 256 || vertexSize % 4 != 0)
+        return false;
+    if (bufferSize < 1 + vertexSize)
+        return false;
+
+    // Only version 0 belongs to EXT_meshopt_compression (newer meshoptimizer also accepts version 1)
+    if ((buffer[0] & 0xf0) != VertexHeader || (buffer[0] & 0x0f) != 0)
+        return false;
+
+#ifdef GLTF_USE_MESHOPTIMIZER
+    return meshopt_decodeVertexBuffer(destination, vertexCount, vertexSize, buffer, bufferSize) == 0;
+#else
+    const unsigned char *data = buffer + 1;
+    const unsigned char *dataEnd = buffer + bufferSize;
+
+    // The last vertexSize bytes of the stream are the base vertex of the first delta
+    unsigned char lastVertex[256];
+    std::memcpy(lastVertex, dataEnd - vertexSize, vertexSize);
+
+    const size_t blockSize = VertexBlockSize(vertexSize);
+    for (size_t offset = 0; offset < vertexCount; offset += blockSize)
+    {
+        const size_t count = std::min(blockSize, vertexCount - offset);
+        data = DecodeVertexBlock(data, dataEnd, destination + offset * vertexSize, count, vertexSize, lastVertex);
+        if (!data)
+            return false;
+    }
+
+    const size_t tailSize = vertexSize < TailMaxSize ? TailMaxSize : vertexSize;
+    return static_cast<size_t>(dataEnd - data) == tailSize;
+#endif
+}
+
+bool GltfMeshopt::DecodeIndexBuffer(unsigned char *destination, size_t indexCount, size_t indexSize,
+                                    const unsigned char *buffer, size_t bufferSize)
+{
+    if (indexCount % 3 != 0 || (indexSize != 2 && indexSize != 4))
+        return false;
+
+#ifdef GLTF_USE_MESHOPTIMIZER
+    return meshopt_decodeIndexBuffer(destination, indexCount, indexSize, buffer, bufferSize) == 0;
+#else
+    // Shortest valid data: header byte, one code byte per triangle and the 16-byte codeaux table at the end
+    if (bufferSize < 1 + indexCount / 3 + 16)
+        return false;
+    if ((buffer[0] & 0xf0) != IndexHeader)
+        return false;
+    const int version = buffer[0] & 0x0f;
+    if (version > IndexVersion)
+        return false;
+
+    IndexDecoder fifo;
+    unsigned int next = 0;
+    unsigned int last = 0;
+    const int fecMax = version >= 1 ? 13 : 15;
+
+    const unsigned char *code = buffer + 1;
+    const unsigned char *data = code + indexCount / 3;
+    const unsigned char *dataSafeEnd = buffer + bufferSize - 16;
+    const unsigned char *codeauxTable = dataSafeEnd;
+
+    for (size_t i = 0; i < indexCount; i += 3)
+    {
+        // A triangle reads at most 16 bytes (1 codeaux byte + three 5-byte indices); the trailing codeaux table
+        // keeps this in bounds
+        if (data > dataSafeEnd)
+            return false;
+
+        const unsigned char codetri = *code++;
+        if (codetri < 0xf0)
+        {
+            // Shares an edge from the edge FIFO: only the third vertex is coded
+            const int fe = codetri >> 4;
+            const unsigned int a = fifo.edges[(fifo.edgeOffset - 1 - fe) & 15][0];
+            const unsigned int b = fifo.edges[(fifo.edgeOffset - 1 - fe) & 15][1];
+            const int fec = codetri & 15;
+
+            unsigned int c;
+            bool pushed = true;
+            if (fec < fecMax)
+            {
+                // 0 is the next new vertex, the others are positions in the vertex FIFO
+                c = fec == 0 ? next++ : fifo.vertex(1 + fec);
+                pushed = fec == 0;
+            }
+            else
+            {
+                // 13/14 are the previous free index -1/+1, 15 an explicitly coded free index
+                last = c = fec != 15 ? last + (fec - (fec ^ 3)) : DecodeIndex(data, last);
+            }
+
+            WriteIndex(destination, i + 0, indexSize, a);
+            WriteIndex(destination, i + 1, indexSize, b);
+            WriteIndex(destination, i + 2, indexSize, c);
+            fifo.pushVertex(c, pushed);
+            fifo.pushEdge(c, b);
+            fifo.pushEdge(a, c);
+        }
+        else
+        {
+            // No shared edge: all three vertices are coded, common combinations via the trailing codeaux table, the
+            // others with a full byte
+            unsigned int a, b, c;
+            bool pushB, pushC;
+            if (codetri < 0xfe)
+            {
+                const unsigned char codeaux = codeauxTable[codetri & 15];
+                const int feb = codeaux >> 4;
+                const int fec = codeaux & 15;
+
+                a = next++;
+                b = feb == 0 ? next++ : fifo.vertex(feb);
+                c = fec == 0 ? next++ : fifo.vertex(fec);
+                pushB = feb == 0;
+                pushC = fec == 0;
+            }
+            else
+            {
+                const unsigned char codeaux = *data++;
+                const int fea = codetri == 0xfe ? 0 : 15;
+                const int feb = codeaux >> 4;
+                const int fec = codeaux & 15;
+
+                // 0xfe followed by 0 restarts from vertex 0
+                if (codeaux == 0)
+                    next = 0;
+
+                a = fea == 0 ? next++ : 0;
+                b = feb == 0 ? next++ : fifo.vertex(feb);
+                c = fec == 0 ? next++ : fifo.vertex(fec);
+
+                if (fea == 15)
+                    last = a = DecodeIndex(data, last);
+                if (feb == 15)
+                    last = b = DecodeIndex(data, last);
+                if (fec == 15)
+                    last = c = DecodeIndex(data, last);
+                pushB = feb == 0 || feb == 15;
+                pushC = fec == 0 || fec == 15;
+            }
+
+            WriteIndex(destination, i + 0, indexSize, a);
+            WriteIndex(destination, i + 1, indexSize, b);
+            WriteIndex(destination, i + 2, indexSize, c);
+            fifo.pushVertex(a);
+            fifo.pushVertex(b, pushB);
+            fifo.pushVertex(c, pushC);
+            fifo.pushEdge(b, a);
+            fifo.pushEdge(c, b);
+            fifo.pushEdge(a, c);
+        }
+    }
+
+    // The data must end exactly where the codeaux table starts
+    return data == dataSafeEnd;
+#endif
+}
+
+bool GltfMeshopt::DecodeIndexSequence(unsigned char *destination, size_t indexCount, size_t indexSize,
+                                      const unsigned char *buffer, size_t bufferSize)
+{
+    if (indexSize != 2 && indexSize != 4)
+        return false;
+
+#ifdef GLTF_USE_MESHOPTIMIZER
+    return meshopt_decodeIndexSequence(destination, indexCount, indexSize, buffer, bufferSize) == 0;
+#else
+    // Shortest valid data: header byte, one byte per index and the 4-byte tail
+    if (bufferSize < 1 + indexCount + 4)
+        return false;
+    if ((buffer[0] & 0xf0) != SequenceHeader)
+        return false;
+    if ((buffer[0] & 0x0f) > IndexVersion)
+        return false;
+
+    const unsigned char *data = buffer + 1;
+    const unsigned char *dataSafeEnd = buffer + bufferSize - 4;
+
+    // Two bases in turn (chosen by the lowest bit); the other bits are a zigzag delta
+    unsigned int last[2] = {0, 0};
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        // An index takes at most 5 bytes; the 4-byte tail keeps this in bounds
+        if (data >= dataSafeEnd)
+            return false;
+
+        unsigned int v = DecodeVByte(data);
+        const unsigned int current = v & 1;
+        v >>= 1;
+        const unsigned int d = (v >> 1) ^ (0u - (v & 1));
+        const unsigned int index = last[current] + d;
+        last[current] = index;
+        WriteIndex(destination, i, indexSize, index);
+    }
+
+    return data == dataSafeEnd;
+#endif
+}
+
+bool GltfMeshopt::DecodeFilterOctahedral(unsigned char *data, size_t count, size_t stride)
+{
+    // 4 int8 or int16 components, the 4th left unchanged
+    if (stride != 4 && stride != 8)
+        return false;
+#ifdef GLTF_USE_MESHOPTIMIZER
+    meshopt_decodeFilterOct(data, count, stride);
+#else
+    if (stride == 4)
+        DecodeOctahedral<int8_t>(data, count, stride);
+    else
+        DecodeOctahedral<int16_t>(data, count, stride);
+#endif
+    return true;
+}
+
+bool GltfMeshopt::DecodeFilterQuaternion(unsigned char *data, size_t count, size_t stride)
+{
+    if (stride != 8)
+        return false;
+
+#ifdef GLTF_USE_MESHOPTIMIZER
+    meshopt_decodeFilterQuat(data, count, stride);
+#else
+    const float scale = 1.0f / std::sqrt(2.0f);
+    for (size_t i = 0; i < count; ++i)
+    {
+        int16_t element[4];
+        std::memcpy(element, data + i * stride, sizeof(element));
+
+        // 4th component: the high bits are the quantization scale, the low 2 bits the index of the omitted (largest)
+        // component
+        const int sf = element[3] | 3;
+        const float ss = scale / static_cast<float>(sf);
+        const float x = static_cast<float>(element[0]) * ss;
+        const float y = static_cast<float>(element[1]) * ss;
+        const float z = static_cast<float>(element[2]) * ss;
+        const float ww = 1.0f - x * x - y * y - z * z;
+        const float w = std::sqrt(ww >= 0.0f ? ww : 0.0f);
+
+        const int qc = element[3] & 3;
+        int16_t decoded[4];
+        decoded[(qc + 1) & 3] = static_cast<int16_t>(RoundSigned(x * 32767.0f));
+        decoded[(qc + 2) & 3] = static_cast<int16_t>(RoundSigned(y * 32767.0f));
+        decoded[(qc + 3) & 3] = static_cast<int16_t>(RoundSigned(z * 32767.0f));
+        decoded[qc] = static_cast<int16_t>(static_cast<int>(w * 32767.0f + 0.5f));
+        std::memcpy(data + i * stride, decoded, sizeof(decoded));
+    }
+#endif
+    return true;
+}
+
+bool GltfMeshopt::DecodeFilterExponential(unsigned char *data, size_t count, size_t stride)
+{
+    if (stride == 0 || stride % 4 != 0)
+        return false;
+
+#ifdef GLTF_USE_MESHOPTIMIZER
+    meshopt_decodeFilterExp(data, count, stride);
+#else
+    // Each 32-bit component: signed exponent in the high 8 bits, signed mantissa in the low 24, value = mantissa * 2^exponent
+    const size_t values = count * (stride / 4);
+    for (size_t i = 0; i < values; ++i)
+    {
+        uint32_t v;
+        std::memcpy(&v, data + i * 4, 4);
+        const int mantissa = static_cast<int32_t>(v << 8) >> 8;
+        const int exponent = static_cast<int32_t>(v) >> 24;
+
+        const uint32_t bits = static_cast<uint32_t>(exponent + 127) << 23;
+        float power;
+        std::memcpy(&power, &bits, 4);
+        const float value = power * static_cast<float>(mantissa);
+        std::memcpy(data + i * 4, &value, 4);
+    }
+#endif
+    return true;
+}
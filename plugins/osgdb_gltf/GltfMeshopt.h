@@ -0,0 +1,66 @@
+#ifndef GLTFMESHOPT_H
+#define GLTFMESHOPT_H
+
+#include <tiny_gltf.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief EXT_meshopt_compression: buffer views compressed with the meshoptimizer codecs
+ *
+ * Covers the formats the extension allows: the vertex codec (ATTRIBUTES,
+ * version 0), the index codec (TRIANGLES, versions 0 and 1), the index
+ * sequence codec (INDICES) and the OCTAHEDRAL, QUATERNION and EXPONENTIAL
+ * filters. When built with GLTF_USE_MESHOPTIMIZER (meshoptimizer sources in
+ * third-party/meshoptimizer) the Decode* functions call meshopt_decode*;
+ * otherwise a built-in decoder, bit-compatible with the reference one, is
+ * used. tools/gltfmeshopt checks the built-in decoder against streams
+ * encoded from the specification, byte for byte against meshoptimizer when
+ * its sources are present, and against a gltfpack -cc sample file.
+ *
+ * Compressed buffer views are decoded into their uncompressed location, which
+ * is usually a "fallback" buffer without data. TinyGLTF rejects such buffers,
+ * so PatchFallbackBuffers gives them a placeholder before parsing and
+ * DecompressBufferViews grows them to the decoded size afterwards. Afterwards
+ * the model reads like an uncompressed one.
+ */
+class GltfMeshopt
+{
+public:
+    static const char *const ExtensionName;
+
+    /**
+     * @brief Make a file that uses the extension loadable by TinyGLTF
+     * @param data Whole .gltf or .glb file; the JSON is rewritten if fallback buffers are found
+     * @param binary data is a GLB container
+     * @return true if fallback buffers were replaced; false leaves data unchanged
+     */
+    static bool PatchFallbackBuffers(std::vector<unsigned char> &data, bool binary);
+
+    /**
+     * @brief Decode every compressed buffer view, in parallel, and drop the extension from it
+     * @param compressedBytes Compressed bytes read
+     * @param decodedBytes Bytes written
+     * @param error Description of the first view that failed to decode
+     * @return Number of decoded views, or -1 on failure
+     */
+    static int DecompressBufferViews(tinygltf::Model &model, uint64_t &compressedBytes, uint64_t &decodedBytes,
+                                     std::string &error);
+
+    // The three meshoptimizer codecs; false means corrupt data or a count that does not match
+    static bool DecodeVertexBuffer(unsigned char *destination, size_t vertexCount, size_t vertexSize,
+                                   const unsigned char *buffer, size_t bufferSize);
+    static bool DecodeIndexBuffer(unsigned char *destination, size_t indexCount, size_t indexSize,
+                                  const unsigned char *buffer, size_t bufferSize);
+    static bool DecodeIndexSequence(unsigned char *destination, size_t indexCount, size_t indexSize,
+                                    const unsigned char *buffer, size_t bufferSize);
+
+    // Post-decode filters, applied in place to count elements of stride bytes
+    static bool DecodeFilterOctahedral(unsigned char *data, size_t count, size_t stride);
+    static bool DecodeFilterQuaternion(unsigned char *data, size_t count, size_t stride);
+    static bool DecodeFilterExponential(unsigned char *data, size_t count, size_t stride);
+};
+
+#endif // GLTFMESHOPT_H
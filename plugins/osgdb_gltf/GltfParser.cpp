@@ -1,4 +1,7 @@
 #include "GltfParser.h"
+#include "GltfAccessor.h"
+#include "GltfInstancing.h"
+#include "GltfMeshopt.h"
 #include <osg/Array>
 #include <osg/Geometry>
 #include <osg/PrimitiveSet>
@@ -18,16 +21,133 @@
 #include <chrono>
 #include <filesystem>
 
+namespace
+{
+    // Bytes and vertex count of the geometry stage
+    void CountGeometry(LoadProfile::Scope &scope, osg::Geometry *geometry)
+    {
+        if (!scope.stage() || !geometry || !geometry->getVertexArray())
+            return;
+        uint64_t bytes = geometry->getVertexArray()->getTotalDataSize();
+        if (geometry->getNormalArray())
+            bytes += geometry->getNormalArray()->getTotalDataSize();
+        for (unsigned i = 0; i < geometry->getNumTexCoordArrays(); ++i)
+        {
+            if (geometry->getTexCoordArray(i))
+                bytes += geometry->getTexCoordArray(i)->getTotalDataSize();
+        }
+        for (unsigned i = 0; i < geometry->getNumPrimitiveSets(); ++i)
+        {
+            if (const osg::DrawElements *elements = geometry->getPrimitiveSet(i)->getDrawElements())
+                bytes += elements->getTotalDataSize();
+        }
+        scope.stage()->add(bytes, geometry->getVertexArray()->getNumElements(), "vertices");
+    }
+
+    // Log a warning for an invalid accessor (out of range or wrong type)
+    bool CheckAttribute(const GltfAccessorView &view, int accessorIndex, const char *semantic, uint64_t &convertedBytes)
+    {
+        if (!view.valid())
+        {
+            PluginLogger::logWarning("GLTF", std::string("Skipping ") + semantic + ": accessor " +
+                                                 std::to_string(accessorIndex) + " is invalid or overruns its buffer");
+            return false;
+        }
+        convertedBytes += view.byteSize();
+        return true;
+    }
+
+    // Read one vertex attribute as float
+    template <typename ArrayT>
+    osg::ref_ptr<ArrayT> ReadAttribute(const tinygltf::Model &model, int accessorIndex, const char *semantic,
+                                       uint64_t &convertedBytes)
+    {
+        GltfAccessorView view(model, accessorIndex);
+        if (!CheckAttribute(view, accessorIndex, semantic, convertedBytes))
+            return nullptr;
+        return view.toArray<ArrayT>();
+    }
+
+    // KHR_mesh_quantization: normalized byte/short normals are uploaded as-is, glNormalPointer normalizes them
+    osg::ref_ptr<osg::Array> ReadNormals(const tinygltf::Model &model, int accessorIndex, uint64_t &convertedBytes)
+    {
+        GltfAccessorView view(model, accessorIndex);
+        if (!CheckAttribute(view, accessorIndex, "NORMAL", convertedBytes))
+            return nullptr;
+        if (view.normalized() && view.components() == 3)
+        {
+            if (view.componentType() == TINYGLTF_COMPONENT_TYPE_BYTE)
+                return view.toPackedArray<osg::Vec3bArray>();
+            if (view.componentType() == TINYGLTF_COMPONENT_TYPE_SHORT)
+                return view.toPackedArray<osg::Vec3sArray>();
+        }
+        return view.toArray<osg::Vec3Array>();
+    }
+
+    // Normalized ubyte/ushort colors are uploaded as-is too (glColorPointer normalizes; RGB gets alpha 1)
+    osg::ref_ptr<osg::Array> ReadColors(const tinygltf::Model &model, int accessorIndex, uint64_t &convertedBytes)
+    {
+        GltfAccessorView view(model, accessorIndex);
+        if (!CheckAttribute(view, accessorIndex, "COLOR_0", convertedBytes))
+            return nullptr;
+        if (view.normalized() && view.componentType() == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
+        {
+            if (view.components() == 4)
+                return view.toPackedArray<osg::Vec4ubArray>();
+            if (view.components() == 3)
+                return view.toPackedArray<osg::Vec3ubArray>();
+        }
+        if (view.normalized() && view.componentType() == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
+        {
+            if (view.components() == 4)
+                return view.toPackedArray<osg::Vec4usArray>();
+            if (view.components() == 3)
+                return view.toPackedArray<osg::Vec3usArray>();
+        }
+        return view.toArray<osg::Vec4Array>();
+    }
+
+    // Copy the groups and Geodes with the same structure, sharing geometries and state sets: every referencing
+    // node gets its own Geodes, so highlighting and picking affect that node only
+    osg::ref_ptr<osg::Node> CopyMeshNodes(osg::Node *node)
+    {
+        if (osg::Geode *source = node->asGeode())
+        {
+            osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+            geode->setName(source->getName());
+            geode->setStateSet(source->getStateSet());
+            for (unsigned int i = 0; i < source->getNumDrawables(); ++i)
+                geode->addDrawable(source->getDrawable(i));
+            return geode;
+        }
+        if (osg::Group *source = node->asGroup())
+        {
+            osg::ref_ptr<osg::Group> group = new osg::Group;
+            group->setName(source->getName());
+            group->setStateSet(source->getStateSet());
+            for (unsigned int i = 0; i < source->getNumChildren(); ++i)
+                group->addChild(CopyMeshNodes(source->getChild(i)).get());
+            return group;
+        }
+        return node;
+    }
+}
+
 GltfParser::GltfParser()
 {
 }
 
 osg::ref_ptr<osg::Group> GltfParser::parseFile(
-    const std::string &filePath)
+    const std::string &filePath,
+    const GltfLoadOptions &options)
 {
 
     auto startTime = std::chrono::high_resolution_clock::now();
 
+    // Per-stage timings; a Chrome trace is written when the trace option or environment variable is set
+    const std::string tracePath = LoadProfile::TracePath(options.tracePath, filePath);
+    osg::ref_ptr<LoadProfile> profile = new LoadProfile("GLTF", filePath, !tracePath.empty());
+
     try
     {
         // Validate file access first
@@ -57,15 +177,44 @@ osg::ref_ptr<osg::Group> GltfParser::parseFile(
 
         bool ret = false;
 
-        if (extension == "gltf")
-        {
-            // Load ASCII format GLTF file
-            ret = loader.LoadASCIIFromFile(&model, &err, &warn, filePath);
-        }
-        else if (extension == "glb")
         {
-            // Load binary format GLB file
-            ret = loader.LoadBinaryFromFile(&model, &err, &warn, filePath);
+            // File I/O, JSON parsing, buffer loading and image decoding; the file is read here rather than by
+            // TinyGLTF so that EXT_meshopt_compression files can be patched before parsing
+            LoadProfile::Scope scope(profile.get(), "read");
+            std::vector<unsigned char> fileData;
+            if (!tinygltf::ReadWholeFile(&fileData, &err, filePath, nullptr))
+            {
+                throw GltfParseException(GltfError(GltfErrorType::FILE_ACCESS_ERROR,
+                                                   "Failed to read file: " + err, filePath));
+            }
+
+            // EXT_meshopt_compression: fallback buffers have no data and are filled by decompression below
+            if (GltfMeshopt::PatchFallbackBuffers(fileData, extension == "glb"))
+            {
+                PluginLogger::logDebug("GLTF", "EXT_meshopt_compression fallback buffers replaced by placeholders");
+            }
+
+            const size_t baseDirEnd = filePath.find_last_of("/\\");
+            const std::string baseDir = baseDirEnd != std::string::npos ? filePath.substr(0, baseDirEnd) : std::string();
+            if (extension == "gltf")
+            {
+                // Load ASCII format GLTF file
+                ret = loader.LoadASCIIFromString(&model, &err, &warn, reinterpret_cast<const char *>(fileData.data()),
+                                                 static_cast<unsigned int>(fileData.size()), baseDir);
+            }
+            else if (extension == "glb")
+            {
+                // Load binary format GLB file
+                ret = loader.LoadBinaryFromMemory(&model, &err, &warn, fileData.data(),
+                                                  static_cast<unsigned int>(fileData.size()), baseDir);
+            }
+            uint64_t bytes = 0;
+            for (const auto &buffer : model.buffers)
+                bytes += buffer.data.size();
+            for (const auto &image : model.images)
+                bytes += image.image.size();
+            scope.stage()->add(bytes, model.buffers.size() + model.images.size(), "buffers and images");
+            scope.stage()->allocations += model.buffers.size() + model.images.size();
         }
 
         if (!warn.empty())
@@ -85,8 +234,36 @@ osg::ref_ptr<osg::Group> GltfParser::parseFile(
                                                "Failed to parse GLTF file", filePath));
         }
 
+        // Decode EXT_meshopt_compression buffer views in parallel; the rest of the loader sees plain data
+        if (std::find(model.extensionsUsed.begin(), model.extensionsUsed.end(), GltfMeshopt::ExtensionName) !=
+            model.extensionsUsed.end())
+        {
+            LoadProfile::Scope scope(profile.get(), "decompress");
+            uint64_t compressedBytes = 0;
+            uint64_t decodedBytes = 0;
+            std::string decodeError;
+            const int decodedViews = GltfMeshopt::DecompressBufferViews(model, compressedBytes, decodedBytes, decodeError);
+            if (decodedViews < 0)
+            {
+                throw GltfParseException(GltfError(GltfErrorType::CORRUPTED_DATA,
+                                                   std::string(GltfMeshopt::ExtensionName) + ": " + decodeError, filePath));
+            }
+            if (decodedViews > 0)
+            {
+                scope.stage()->add(decodedBytes, static_cast<uint64_t>(decodedViews), "buffer views");
+                std::ostringstream oss;
+                oss << GltfMeshopt::ExtensionName << ": decoded " << decodedViews << " buffer views, "
+                    << compressedBytes << " -> " << decodedBytes << " bytes";
+                PluginLogger::logInfo("GLTF", oss.str());
+            }
+        }
+
         // Validate loaded model
-        validateModel(model, filePath);
+        {
+            LoadProfile::Scope scope(profile.get(), "validate");
+            validateModel(model, filePath);
+            scope.stage()->add(0, model.accessors.size(), "accessors");
+        }
 
         // Extract filename without path and extension
         std::string fileName = filePath;
@@ -101,8 +278,13 @@ osg::ref_ptr<osg::Group> GltfParser::parseFile(
             fileName = fileName.substr(0, dotPos2);
         }
 
-        // Convert to OSG scene graph
-        osg::ref_ptr<osg::Group> rootGroup = convertGltfToOsg(model, fileName);
+        // Convert to OSG scene graph; geometry and material creation are timed as nested stages
+        osg::ref_ptr<osg::Group> rootGroup;
+        {
+            LoadProfile::Scope scope(profile.get(), "assemble");
+            rootGroup = convertGltfToOsg(model, fileName, options, profile.get());
+            scope.stage()->add(0, model.nodes.size(), "nodes");
+        }
 
         if (!rootGroup.valid())
         {
@@ -125,6 +307,13 @@ osg::ref_ptr<osg::Group> GltfParser::parseFile(
 
         PluginLogger::logInfo("GLTF", stats.str());
 
+        // Scene objects are counted once after the load instead of at every allocation site
+        const LoadProfile::SceneObjects objects = LoadProfile::CountSceneObjects(*rootGroup);
+        profile->stage("geometry").allocations += objects.geometries + objects.arrays + objects.primitiveSets;
+        profile->stage("states").allocations += objects.stateSets + objects.stateAttributes;
+        profile->stage("assemble").allocations += objects.nodes - objects.geometries;
+        profile->publish(*rootGroup, tracePath);
+
         return rootGroup;
     }
     catch (const GltfParseException &e)
@@ -148,25 +337,49 @@ osg::ref_ptr<osg::Group> GltfParser::parseFile(
 
 osg::ref_ptr<osg::Group> GltfParser::convertGltfToOsg(
     const tinygltf::Model &model,
-    const std::string &fileName)
+    const std::string &fileName,
+    const GltfLoadOptions &options,
+    LoadProfile *profile)
 {
 
     osg::ref_ptr<osg::Group> rootGroup = new osg::Group();
     rootGroup->setName(fileName);
 
+    // Meshes, materials, textures and images are converted once and shared across the model
+    GltfConversionCache cache;
+
     // Process default scene or first scene
     int sceneIndex = model.defaultScene >= 0 ? model.defaultScene : 0;
 
     if (sceneIndex >= 0 && sceneIndex < static_cast<int>(model.scenes.size()))
     {
 
-        osg::ref_ptr<osg::Group> sceneGroup = processScene(model, sceneIndex);
+        osg::ref_ptr<osg::Group> sceneGroup = processScene(model, sceneIndex, options, cache, profile);
         if (sceneGroup.valid())
         {
             rootGroup->addChild(sceneGroup);
         }
     }
 
+    if (!cache.meshes.empty())
+    {
+        PluginLogger::logInfo("GLTF", "Conversion cache: " + std::to_string(cache.meshes.size()) + " meshes (" +
+                                          std::to_string(cache.meshHits) + " hits), " +
+                                          std::to_string(cache.materials.size()) + " materials (" +
+                                          std::to_string(cache.materialHits) + " hits), " +
+                                          std::to_string(cache.textures.size()) + " textures (" +
+                                          std::to_string(cache.textureHits) + " hits), " +
+                                          std::to_string(cache.images.size()) + " images (" +
+                                          std::to_string(cache.imageHits) + " hits)");
+    }
+    if (cache.instancedNodes > 0)
+    {
+        PluginLogger::logInfo("GLTF", std::string(GltfInstancing::ExtensionName) + ": " +
+                                          std::to_string(cache.instancedNodes) + " nodes, " +
+                                          std::to_string(cache.instances) + " instances, " +
+                                          (options.cpuInstancing ? "expanded to transforms" : "instanced draws"));
+    }
+
     // Process animations
     if (!model.animations.empty())
     {
@@ -176,7 +389,9 @@ osg::ref_ptr<osg::Group> GltfParser::convertGltfToOsg(
     return rootGroup;
 }
 
-osg::ref_ptr<osg::Group> GltfParser::processScene(const tinygltf::Model &model, int sceneIndex)
+osg::ref_ptr<osg::Group> GltfParser::processScene(const tinygltf::Model &model, int sceneIndex,
+                                                  const GltfLoadOptions &options, GltfConversionCache &cache,
+                                                  LoadProfile *profile)
 {
     if (sceneIndex < 0 || sceneIndex >= static_cast<int>(model.scenes.size()))
     {
@@ -198,7 +413,7 @@ osg::ref_ptr<osg::Group> GltfParser::processScene(const tinygltf::Model &model,
     // Process root nodes in scene
     for (int nodeIndex : scene.nodes)
     {
-        osg::ref_ptr<osg::Node> node = processNode(model, nodeIndex);
+        osg::ref_ptr<osg::Node> node = processNode(model, nodeIndex, options, cache, profile);
         if (node.valid())
         {
             sceneGroup->addChild(node);
@@ -208,7 +423,9 @@ osg::ref_ptr<osg::Group> GltfParser::processScene(const tinygltf::Model &model,
     return sceneGroup;
 }
 
-osg::ref_ptr<osg::Node> GltfParser::processNode(const tinygltf::Model &model, int nodeIndex)
+osg::ref_ptr<osg::Node> GltfParser::processNode(const tinygltf::Model &model, int nodeIndex,
+                                                const GltfLoadOptions &options, GltfConversionCache &cache,
+                                                LoadProfile *profile)
 {
     if (nodeIndex < 0 || nodeIndex >= static_cast<int>(model.nodes.size()))
     {
@@ -236,8 +453,12 @@ osg::ref_ptr<osg::Node> GltfParser::processNode(const tinygltf::Model &model, in
     // Process mesh
     if (gltfNode.mesh >= 0)
     {
-        osg::ref_ptr<osg::Group> meshGroup = processMesh(model, gltfNode.mesh);
-        if (meshGroup.valid())
+        osg::ref_ptr<osg::Group> meshGroup = processMesh(model, gltfNode.mesh, options, cache, profile);
+        if (meshGroup.valid() && GltfInstancing::HasInstancing(gltfNode))
+        {
+            transform->addChild(processInstances(model, gltfNode, transform->getName(), meshGroup.get(), options, cache, profile));
+        }
+        else if (meshGroup.valid())
         {
             transform->addChild(meshGroup);
         }
@@ -246,7 +467,7 @@ osg::ref_ptr<osg::Node> GltfParser::processNode(const tinygltf::Model &model, in
     // Recursively process child nodes
     for (int childIndex : gltfNode.children)
     {
-        osg::ref_ptr<osg::Node> childNode = processNode(model, childIndex);
+        osg::ref_ptr<osg::Node> childNode = processNode(model, childIndex, options, cache, profile);
         if (childNode.valid())
         {
             transform->addChild(childNode);
@@ -255,15 +476,66 @@ osg::ref_ptr<osg::Node> GltfParser::processNode(const tinygltf::Model &model, in
 
     return transform;
 }
-osg::ref_ptr<osg::Group> GltfParser::processMesh(const tinygltf::Model &model, int meshIndex)
+osg::ref_ptr<osg::Group> GltfParser::processInstances(const tinygltf::Model &model, const tinygltf::Node &node,
+                                                      const std::string &nodeName, osg::Group *meshGroup,
+                                                      const GltfLoadOptions &options, GltfConversionCache &cache,
+                                                      LoadProfile *profile)
+{
+    LoadProfile::Scope instancingScope(profile, "instancing");
+
+    std::vector<osg::Matrixf> matrices;
+    if (!GltfInstancing::ReadInstanceMatrices(model, node, matrices))
+    {
+        PluginLogger::logWarning("GLTF", "Node " + nodeName + ": drawing the mesh once without instances");
+        return meshGroup;
+    }
+
+    std::vector<std::string> instanceNames(matrices.size());
+    for (size_t i = 0; i < matrices.size(); ++i)
+    {
+        instanceNames[i] = nodeName + "_inst_" + std::to_string(i);
+    }
+    ++cache.instancedNodes;
+    cache.instances += matrices.size();
+    if (instancingScope.stage())
+    {
+        instancingScope.stage()->add(matrices.size() * sizeof(osg::Matrixf), matrices.size(), "instances");
+    }
+
+    // CPU fallback: one transform per instance over the shared mesh
+    if (options.cpuInstancing)
+    {
+        return GltfInstancing::ExpandInstances(meshGroup, matrices, instanceNames);
+    }
+
+    if (!cache.instancingState.valid())
+    {
+        cache.instancingState = GltfInstancing::CreateSharedState();
+    }
+    return GltfInstancing::CreateInstancedGroup(meshGroup, matrices, instanceNames, cache.instancingState.get());
+}
+
+osg::ref_ptr<osg::Group> GltfParser::processMesh(const tinygltf::Model &model, int meshIndex,
+                                                 const GltfLoadOptions &options, GltfConversionCache &cache,
+                                                 LoadProfile *profile)
 {
     if (meshIndex < 0 || meshIndex >= static_cast<int>(model.meshes.size()))
     {
         return nullptr;
     }
 
+    // Every node referencing this mesh shares the converted geometries and state sets, under its own groups and geodes
+    auto cacheIt = cache.meshes.find(meshIndex);
+    if (cacheIt != cache.meshes.end())
+    {
+        ++cache.meshHits;
+        osg::ref_ptr<osg::Node> copy = CopyMeshNodes(cacheIt->second.get());
+        return copy->asGroup();
+    }
+
     const tinygltf::Mesh &mesh = model.meshes[meshIndex];
     osg::ref_ptr<osg::Group> meshGroup = new osg::Group();
+    cache.meshes[meshIndex] = meshGroup;
 
     if (!mesh.name.empty())
     {
@@ -274,14 +546,10 @@ osg::ref_ptr<osg::Group> GltfParser::processMesh(const tinygltf::Model &model, i
         meshGroup->setName("Mesh_" + std::to_string(meshIndex));
     }
 
-    // Create caches for this mesh processing
-    std::map<int, osg::ref_ptr<osg::StateSet>> materialCache;
-    std::map<int, osg::ref_ptr<osg::Texture2D>> textureCache;
-
     // Optimization: if primitive count is high, use batch processing
     if (mesh.primitives.size() > 5)
     {
-        osg::ref_ptr<osg::Group> batchedGroup = batchProcessGeometries(model, mesh.primitives, materialCache, textureCache);
+        osg::ref_ptr<osg::Group> batchedGroup = batchProcessGeometries(model, mesh.primitives, cache, meshGroup->getName(), options, profile);
         if (batchedGroup.valid())
         {
             meshGroup->addChild(batchedGroup);
@@ -294,11 +562,14 @@ osg::ref_ptr<osg::Group> GltfParser::processMesh(const tinygltf::Model &model, i
         {
             const tinygltf::Primitive &primitive = mesh.primitives[i];
 
-            osg::ref_ptr<osg::Geometry> geometry = createGeometryFromPrimitive(model, primitive);
+            LoadProfile::Scope geometryScope(profile, "geometry");
+            osg::ref_ptr<osg::Geometry> geometry = createGeometryFromPrimitive(model, primitive, profile);
             if (geometry.valid())
             {
                 // Apply geometry optimization
-                optimizeGeometry(geometry.get());
+                optimizeGeometry(geometry.get(), meshGroup->getName(), options);
+                CountGeometry(geometryScope, geometry.get());
+                geometryScope.end();
 
                 osg::ref_ptr<osg::Geode> geode = new osg::Geode();
                 geode->addDrawable(geometry);
@@ -306,7 +577,8 @@ osg::ref_ptr<osg::Group> GltfParser::processMesh(const tinygltf::Model &model, i
                 // Apply material
                 if (primitive.material >= 0)
                 {
-                    osg::ref_ptr<osg::StateSet> stateSet = createMaterialFromGltf(model, primitive.material, materialCache, textureCache);
+                    LoadProfile::Scope stateScope(profile, "states");
+                    osg::ref_ptr<osg::StateSet> stateSet = createMaterialFromGltf(model, primitive.material, cache);
                     if (stateSet.valid())
                     {
                         geode->setStateSet(stateSet);
@@ -323,121 +595,50 @@ osg::ref_ptr<osg::Group> GltfParser::processMesh(const tinygltf::Model &model, i
 
 osg::ref_ptr<osg::Geometry> GltfParser::createGeometryFromPrimitive(
     const tinygltf::Model &model,
-    const tinygltf::Primitive &primitive)
+    const tinygltf::Primitive &primitive,
+    LoadProfile *profile)
 {
 
     osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry();
 
-    // Process vertex positions
+    // Attribute and index conversion is timed as its own stage, so its throughput shows in the load profile
+    LoadProfile::Scope convertScope(profile, "convert");
+    uint64_t convertedBytes = 0;
+
+    // Process vertex positions (always float: OSG bounds and intersection need float vertex arrays, and
+    // glVertexPointer does not normalize quantized KHR_mesh_quantization positions)
     auto positionIt = primitive.attributes.find("POSITION");
     if (positionIt != primitive.attributes.end())
     {
-        int accessorIndex = positionIt->second;
-        auto [data, count] = getAccessorData(model, accessorIndex);
-        if (data && count > 0)
+        osg::ref_ptr<osg::Vec3Array> vertices = ReadAttribute<osg::Vec3Array>(model, positionIt->second, "POSITION", convertedBytes);
+        if (vertices.valid())
         {
-            osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array();
-            const float *floatData = static_cast<const float *>(data);
-
-            for (size_t i = 0; i < count; ++i)
-            {
-                vertices->push_back(osg::Vec3(
-                    floatData[i * 3 + 0],
-                    floatData[i * 3 + 1],
-                    floatData[i * 3 + 2]));
-            }
             geometry->setVertexArray(vertices.get());
         }
     }
 
-    // Process normals
+    // Process normals (quantized normals stay quantized, KHR_mesh_quantization)
     auto normalIt = primitive.attributes.find("NORMAL");
     if (normalIt != primitive.attributes.end())
     {
-        int accessorIndex = normalIt->second;
-        auto [data, count] = getAccessorData(model, accessorIndex);
-        if (data && count > 0)
+        osg::ref_ptr<osg::Array> normals = ReadNormals(model, normalIt->second, convertedBytes);
+        if (normals.valid())
         {
-            osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array();
-            const float *floatData = static_cast<const float *>(data);
-
-            for (size_t i = 0; i < count; ++i)
-            {
-                normals->push_back(osg::Vec3(
-                    floatData[i * 3 + 0],
-                    floatData[i * 3 + 1],
-                    floatData[i * 3 + 2]));
-            }
             geometry->setNormalArray(normals.get());
             geometry->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
         }
     }
 
     // Process multiple texture coordinate sets
-    processMultipleTexCoords(model, primitive, geometry.get());
+    processMultipleTexCoords(model, primitive, geometry.get(), convertedBytes);
 
-    // Process vertex colors
+    // Process vertex colors (RGB colors get alpha 1; normalized 8/16-bit colors stay quantized)
     auto colorIt = primitive.attributes.find("COLOR_0");
     if (colorIt != primitive.attributes.end())
     {
-        int accessorIndex = colorIt->second;
-        auto [data, count] = getAccessorData(model, accessorIndex);
-        if (data && count > 0)
+        osg::ref_ptr<osg::Array> colors = ReadColors(model, colorIt->second, convertedBytes);
+        if (colors.valid())
         {
-            const tinygltf::Accessor &accessor = model.accessors[accessorIndex];
-            osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array();
-
-            if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT)
-            {
-                const float *floatData = static_cast<const float *>(data);
-                int componentCount = (accessor.type == TINYGLTF_TYPE_VEC3) ? 3 : 4;
-
-                for (size_t i = 0; i < count; ++i)
-                {
-                    if (componentCount == 3)
-                    {
-                        colors->push_back(osg::Vec4(
-                            floatData[i * 3 + 0],
-                            floatData[i * 3 + 1],
-                            floatData[i * 3 + 2],
-                            1.0f));
-                    }
-                    else
-                    {
-                        colors->push_back(osg::Vec4(
-                            floatData[i * 4 + 0],
-                            floatData[i * 4 + 1],
-                            floatData[i * 4 + 2],
-                            floatData[i * 4 + 3]));
-                    }
-                }
-            }
-            else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
-            {
-                const unsigned char *byteData = static_cast<const unsigned char *>(data);
-                int componentCount = (accessor.type == TINYGLTF_TYPE_VEC3) ? 3 : 4;
-
-                for (size_t i = 0; i < count; ++i)
-                {
-                    if (componentCount == 3)
-                    {
-                        colors->push_back(osg::Vec4(
-                            byteData[i * 3 + 0] / 255.0f,
-                            byteData[i * 3 + 1] / 255.0f,
-                            byteData[i * 3 + 2] / 255.0f,
-                            1.0f));
-                    }
-                    else
-                    {
-                        colors->push_back(osg::Vec4(
-                            byteData[i * 4 + 0] / 255.0f,
-                            byteData[i * 4 + 1] / 255.0f,
-                            byteData[i * 4 + 2] / 255.0f,
-                            byteData[i * 4 + 3] / 255.0f));
-                    }
-                }
-            }
-
             geometry->setColorArray(colors.get());
             geometry->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
         }
@@ -446,12 +647,12 @@ osg::ref_ptr<osg::Geometry> GltfParser::createGeometryFromPrimitive(
     // Process indices
     if (primitive.indices >= 0)
     {
-        auto [indexData, indexCount] = getAccessorData(model, primitive.indices);
-        if (indexData && indexCount > 0)
+        GltfAccessorView indexView(model, primitive.indices);
+        osg::ref_ptr<osg::DrawElementsUInt> drawElements =
+            new osg::DrawElementsUInt(GL_TRIANGLES, static_cast<unsigned int>(indexView.count()));
+        if (indexView.count() > 0 && indexView.readUInts(&(*drawElements)[0]))
         {
-            const tinygltf::Accessor &indexAccessor = model.accessors[primitive.indices];
-
-            osg::ref_ptr<osg::DrawElementsUInt> drawElements = new osg::DrawElementsUInt();
+            convertedBytes += indexView.byteSize();
 
             // Set draw mode based on primitive mode
             GLenum mode = GL_TRIANGLES;
@@ -484,34 +685,13 @@ osg::ref_ptr<osg::Geometry> GltfParser::createGeometryFromPrimitive(
             }
             drawElements->setMode(mode);
 
-            // Read indices based on data type
-            if (indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
-            {
-                const unsigned short *shortData = static_cast<const unsigned short *>(indexData);
-                for (size_t i = 0; i < indexCount; ++i)
-                {
-                    drawElements->push_back(shortData[i]);
-                }
-            }
-            else if (indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT)
-            {
-                const unsigned int *intData = static_cast<const unsigned int *>(indexData);
-                for (size_t i = 0; i < indexCount; ++i)
-                {
-                    drawElements->push_back(intData[i]);
-                }
-            }
-            else if (indexAccessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE)
-            {
-                const unsigned char *byteData = static_cast<const unsigned char *>(indexData);
-                for (size_t i = 0; i < indexCount; ++i)
-                {
-                    drawElements->push_back(byteData[i]);
-                }
-            }
-
             geometry->addPrimitiveSet(drawElements.get());
         }
+        else
+        {
+            PluginLogger::logWarning("GLTF", "Skipping indices: accessor " + std::to_string(primitive.indices) +
+                                                 " is invalid, not an integer type or overruns its buffer");
+        }
     }
     else
     {
@@ -552,6 +732,12 @@ osg::ref_ptr<osg::Geometry> GltfParser::createGeometryFromPrimitive(
         }
     }
 
+    if (convertScope.stage())
+    {
+        convertScope.stage()->add(convertedBytes, 1, "primitives");
+    }
+    convertScope.end();
+
     // If no normals, automatically calculate normals
     if (!geometry->getNormalArray())
     {
@@ -564,24 +750,27 @@ osg::ref_ptr<osg::Geometry> GltfParser::createGeometryFromPrimitive(
 osg::ref_ptr<osg::StateSet> GltfParser::createMaterialFromGltf(
     const tinygltf::Model &model,
     int materialIndex,
-    std::map<int, osg::ref_ptr<osg::StateSet>> &materialCache,
-    std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache)
+    GltfConversionCache &cache)
 {
 
     if (materialIndex < 0 || materialIndex >= static_cast<int>(model.materials.size()))
     {
-        // Return default material
-        osg::ref_ptr<osg::StateSet> stateSet = new osg::StateSet();
-        osg::ref_ptr<osg::Material> material = new osg::Material();
-        material->setDiffuse(osg::Material::FRONT_AND_BACK, osg::Vec4(0.8f, 0.8f, 0.8f, 1.0f));
-        stateSet->setAttributeAndModes(material, osg::StateAttribute::ON);
-        return stateSet;
+        // Return default material, shared by all primitives without a valid material
+        if (!cache.defaultMaterial.valid())
+        {
+            cache.defaultMaterial = new osg::StateSet();
+            osg::ref_ptr<osg::Material> material = new osg::Material();
+            material->setDiffuse(osg::Material::FRONT_AND_BACK, osg::Vec4(0.8f, 0.8f, 0.8f, 1.0f));
+            cache.defaultMaterial->setAttributeAndModes(material, osg::StateAttribute::ON);
+        }
+        return cache.defaultMaterial;
     }
 
     // Check cache
-    auto cacheIt = materialCache.find(materialIndex);
-    if (cacheIt != materialCache.end())
+    auto cacheIt = cache.materials.find(materialIndex);
+    if (cacheIt != cache.materials.end())
     {
+        ++cache.materialHits;
         return cacheIt->second;
     }
 
@@ -596,11 +785,10 @@ osg::ref_ptr<osg::StateSet> GltfParser::createMaterialFromGltf(
     }
 
     // Use enhanced PBR material creation method
-    std::map<int, osg::ref_ptr<osg::Image>> imageCache;
-    osg::ref_ptr<osg::StateSet> stateSet = createPbrMaterial(model, gltfMaterial, materialIndex, textureCache);
+    osg::ref_ptr<osg::StateSet> stateSet = createPbrMaterial(model, gltfMaterial, materialIndex, cache);
 
     // Cache material
-    materialCache[materialIndex] = stateSet;
+    cache.materials[materialIndex] = stateSet;
 
     return stateSet;
 }
@@ -608,8 +796,7 @@ osg::ref_ptr<osg::StateSet> GltfParser::createMaterialFromGltf(
 osg::ref_ptr<osg::Texture2D> GltfParser::createTextureFromGltf(
     const tinygltf::Model &model,
     int textureIndex,
-    std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache,
-    std::map<int, osg::ref_ptr<osg::Image>> &imageCache)
+    GltfConversionCache &cache)
 {
 
     if (textureIndex < 0 || textureIndex >= static_cast<int>(model.textures.size()))
@@ -617,19 +804,21 @@ osg::ref_ptr<osg::Texture2D> GltfParser::createTextureFromGltf(
         return nullptr;
     }
 
-    // Check cache
-    auto cacheIt = textureCache.find(textureIndex);
-    if (cacheIt != textureCache.end())
+    // Check cache (a failed texture is cached as null and not retried)
+    auto cacheIt = cache.textures.find(textureIndex);
+    if (cacheIt != cache.textures.end())
     {
+        ++cache.textureHits;
         return cacheIt->second;
     }
 
     const tinygltf::Texture &gltfTexture = model.textures[textureIndex];
 
     // Create image (using cache)
-    osg::ref_ptr<osg::Image> image = createImageWithCache(model, gltfTexture.source, imageCache);
+    osg::ref_ptr<osg::Image> image = createImageWithCache(model, gltfTexture.source, cache);
     if (!image.valid())
     {
+        cache.textures[textureIndex] = nullptr;
         return nullptr;
     }
 
@@ -724,15 +913,14 @@ osg::ref_ptr<osg::Texture2D> GltfParser::createTextureFromGltf(
     }
 
     // Cache texture
-    textureCache[textureIndex] = texture;
+    cache.textures[textureIndex] = texture;
 
     return texture;
 }
 
 osg::ref_ptr<osg::Image> GltfParser::createImageFromGltf(
     const tinygltf::Model &model,
-    int imageIndex,
-    std::map<int, osg::ref_ptr<osg::Image>> &imageCache)
+    int imageIndex)
 {
 
     if (imageIndex < 0 || imageIndex >= static_cast<int>(model.images.size()))
@@ -845,52 +1033,6 @@ osg::ref_ptr<osg::Image> GltfParser::createImageFromGltf(
     return nullptr;
 }
 
-std::pair<const void *, size_t> GltfParser::getAccessorData(
-    const tinygltf::Model &model,
-    int accessorIndex)
-{
-
-    if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size()))
-    {
-        return {nullptr, 0};
-    }
-
-    const tinygltf::Accessor &accessor = model.accessors[accessorIndex];
-
-    if (accessor.bufferView < 0 || accessor.bufferView >= static_cast<int>(model.bufferViews.size()))
-    {
-        return {nullptr, 0};
-    }
-
-    const tinygltf::BufferView &bufferView = model.bufferViews[accessor.bufferView];
-
-    if (bufferView.buffer < 0 || bufferView.buffer >= static_cast<int>(model.buffers.size()))
-    {
-        return {nullptr, 0};
-    }
-
-    const tinygltf::Buffer &buffer = model.buffers[bufferView.buffer];
-
-    if (buffer.data.empty())
-    {
-        return {nullptr, 0};
-    }
-
-    // Calculate data offset
-    size_t offset = bufferView.byteOffset + accessor.byteOffset;
-
-    if (offset >= buffer.data.size())
-    {
-        return {nullptr, 0};
-    }
-
-    // Return data pointer and element count
-    const void *data = buffer.data.data() + offset;
-    size_t count = accessor.count;
-
-    return {data, count};
-}
-
 std::pair<const void *, size_t> GltfParser::getBufferViewData(
     const tinygltf::Model &model,
     int bufferViewIndex)
@@ -984,8 +1126,10 @@ void GltfParser::processAnimations(const tinygltf::Model &model, osg::Group *roo
 osg::ref_ptr<osg::Group> GltfParser::batchProcessGeometries(
     const tinygltf::Model &model,
     const std::vector<tinygltf::Primitive> &primitives,
-    std::map<int, osg::ref_ptr<osg::StateSet>> &materialCache,
-    std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache)
+    GltfConversionCache &cache,
+    const std::string &meshName,
+    const GltfLoadOptions &options,
+    LoadProfile *profile)
 {
 
     // For now, use simple processing instead of batching
@@ -996,17 +1140,21 @@ osg::ref_ptr<osg::Group> GltfParser::batchProcessGeometries(
     {
         const tinygltf::Primitive &primitive = primitives[i];
 
-        osg::ref_ptr<osg::Geometry> geometry = createGeometryFromPrimitive(model, primitive);
+        LoadProfile::Scope geometryScope(profile, "geometry");
+        osg::ref_ptr<osg::Geometry> geometry = createGeometryFromPrimitive(model, primitive, profile);
         if (geometry.valid())
         {
-            optimizeGeometry(geometry.get());
+            optimizeGeometry(geometry.get(), meshName, options);
+            CountGeometry(geometryScope, geometry.get());
+            geometryScope.end();
 
             osg::ref_ptr<osg::Geode> geode = new osg::Geode();
             geode->addDrawable(geometry);
 
             if (primitive.material >= 0)
             {
-                osg::ref_ptr<osg::StateSet> stateSet = createMaterialFromGltf(model, primitive.material, materialCache, textureCache);
+                LoadProfile::Scope stateScope(profile, "states");
+                osg::ref_ptr<osg::StateSet> stateSet = createMaterialFromGltf(model, primitive.material, cache);
                 if (stateSet.valid())
                 {
                     geode->setStateSet(stateSet);
@@ -1020,13 +1168,24 @@ osg::ref_ptr<osg::Group> GltfParser::batchProcessGeometries(
     return group;
 }
 
-void GltfParser::optimizeGeometry(osg::Geometry *geometry)
+void GltfParser::optimizeGeometry(osg::Geometry *geometry, const std::string &meshName,
+                                  const GltfLoadOptions &options)
 {
     if (!geometry)
         return;
 
+    // Reorder triangles for the post-transform cache and overdraw, then vertices for fetch locality
+    if (options.optimizeMeshes)
+    {
+        MeshOptimizer::Result result;
+        MeshOptimizer::Optimize(geometry, nullptr, result);
+        if (result.triangles > 0)
+        {
+            PluginLogger::logInfo("GLTF", "Optimized " + meshName + ": " + MeshOptimizer::Describe(result));
+        }
+    }
+
     // Basic geometry optimization
-    // More advanced optimizations can be added later
     geometry->setUseDisplayList(true);
     geometry->setUseVertexBufferObjects(true);
 }
@@ -1035,7 +1194,7 @@ osg::ref_ptr<osg::StateSet> GltfParser::createPbrMaterial(
     const tinygltf::Model &model,
     const tinygltf::Material &material,
     int materialIndex,
-    std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache)
+    GltfConversionCache &cache)
 {
 
     osg::ref_ptr<osg::StateSet> stateSet = new osg::StateSet();
@@ -1059,12 +1218,10 @@ osg::ref_ptr<osg::StateSet> GltfParser::createPbrMaterial(
         auto [isValid, errorMsg] = validateTexture(model, material.pbrMetallicRoughness.baseColorTexture.index);
         if (isValid)
         {
-            std::map<int, osg::ref_ptr<osg::Image>> imageCache;
             osg::ref_ptr<osg::Texture2D> baseColorTexture = createTextureFromGltf(
                 model,
                 material.pbrMetallicRoughness.baseColorTexture.index,
-                textureCache,
-                imageCache);
+                cache);
             if (baseColorTexture.valid())
             {
                 stateSet->setTextureAttributeAndModes(textureUnit, baseColorTexture, osg::StateAttribute::ON);
@@ -1082,21 +1239,21 @@ osg::ref_ptr<osg::StateSet> GltfParser::createPbrMaterial(
     {
         processMetallicRoughnessTexture(model,
                                         material.pbrMetallicRoughness.metallicRoughnessTexture.index,
-                                        stateSet.get(), textureUnit, textureCache);
+                                        stateSet.get(), textureUnit, cache);
         textureUnit++;
     }
 
     // Process normal map
     if (material.normalTexture.index >= 0)
     {
-        processNormalTexture(model, material.normalTexture, stateSet.get(), textureUnit, textureCache);
+        processNormalTexture(model, material.normalTexture, stateSet.get(), textureUnit, cache);
         textureUnit++;
     }
 
     // Process occlusion map
     if (material.occlusionTexture.index >= 0)
     {
-        processOcclusionTexture(model, material.occlusionTexture, stateSet.get(), textureUnit, textureCache);
+        processOcclusionTexture(model, material.occlusionTexture, stateSet.get(), textureUnit, cache);
         textureUnit++;
     }
 
@@ -1106,12 +1263,10 @@ osg::ref_ptr<osg::StateSet> GltfParser::createPbrMaterial(
         auto [isValid, errorMsg] = validateTexture(model, material.emissiveTexture.index);
         if (isValid)
         {
-            std::map<int, osg::ref_ptr<osg::Image>> imageCache;
             osg::ref_ptr<osg::Texture2D> emissiveTexture = createTextureFromGltf(
                 model,
                 material.emissiveTexture.index,
-                textureCache,
-                imageCache);
+                cache);
             if (emissiveTexture.valid())
             {
                 stateSet->setTextureAttributeAndModes(textureUnit, emissiveTexture, osg::StateAttribute::ON);
@@ -1204,48 +1359,24 @@ osg::ref_ptr<osg::StateSet> GltfParser::createPbrMaterial(
 void GltfParser::processMultipleTexCoords(
     const tinygltf::Model &model,
     const tinygltf::Primitive &primitive,
-    osg::Geometry *geometry)
+    osg::Geometry *geometry,
+    uint64_t &convertedBytes)
 {
 
-    // Process TEXCOORD_0
-    auto texCoord0It = primitive.attributes.find("TEXCOORD_0");
-    if (texCoord0It != primitive.attributes.end())
+    // Process TEXCOORD_0, TEXCOORD_1, ... until the first missing set
+    for (unsigned int unit = 0;; ++unit)
     {
-        int accessorIndex = texCoord0It->second;
-        auto [data, count] = getAccessorData(model, accessorIndex);
-        if (data && count > 0)
+        const std::string semantic = "TEXCOORD_" + std::to_string(unit);
+        auto texCoordIt = primitive.attributes.find(semantic);
+        if (texCoordIt == primitive.attributes.end())
         {
-            osg::ref_ptr<osg::Vec2Array> texCoords = new osg::Vec2Array();
-            const float *floatData = static_cast<const float *>(data);
-
-            for (size_t i = 0; i < count; ++i)
-            {
-                texCoords->push_back(osg::Vec2(
-                    floatData[i * 2 + 0],
-                    floatData[i * 2 + 1]));
-            }
-            geometry->setTexCoordArray(0, texCoords.get());
+            break;
         }
-    }
 
-    // Process TEXCOORD_1 if present
-    auto texCoord1It = primitive.attributes.find("TEXCOORD_1");
-    if (texCoord1It != primitive.attributes.end())
-    {
-        int accessorIndex = texCoord1It->second;
-        auto [data, count] = getAccessorData(model, accessorIndex);
-        if (data && count > 0)
+        osg::ref_ptr<osg::Vec2Array> texCoords = ReadAttribute<osg::Vec2Array>(model, texCoordIt->second, semantic.c_str(), convertedBytes);
+        if (texCoords.valid())
         {
-            osg::ref_ptr<osg::Vec2Array> texCoords = new osg::Vec2Array();
-            const float *floatData = static_cast<const float *>(data);
-
-            for (size_t i = 0; i < count; ++i)
-            {
-                texCoords->push_back(osg::Vec2(
-                    floatData[i * 2 + 0],
-                    floatData[i * 2 + 1]));
-            }
-            geometry->setTexCoordArray(1, texCoords.get());
+            geometry->setTexCoordArray(unit, texCoords.get());
         }
     }
 }
@@ -1291,24 +1422,22 @@ std::pair<bool, std::string> GltfParser::validateMaterial(const tinygltf::Materi
 osg::ref_ptr<osg::Image> GltfParser::createImageWithCache(
     const tinygltf::Model &model,
     int imageIndex,
-    std::map<int, osg::ref_ptr<osg::Image>> &imageCache)
+    GltfConversionCache &cache)
 {
 
-    // Check cache first
-    auto cacheIt = imageCache.find(imageIndex);
-    if (cacheIt != imageCache.end())
+    // Check cache first (a failed image is cached as null and not retried)
+    auto cacheIt = cache.images.find(imageIndex);
+    if (cacheIt != cache.images.end())
     {
+        ++cache.imageHits;
         return cacheIt->second;
     }
 
     // Create new image
-    osg::ref_ptr<osg::Image> image = createImageFromGltf(model, imageIndex, imageCache);
+    osg::ref_ptr<osg::Image> image = createImageFromGltf(model, imageIndex);
 
     // Cache the image
-    if (image.valid())
-    {
-        imageCache[imageIndex] = image;
-    }
+    cache.images[imageIndex] = image;
 
     return image;
 }
@@ -1318,7 +1447,7 @@ void GltfParser::processMetallicRoughnessTexture(
     int textureIndex,
     osg::StateSet *stateSet,
     int textureUnit,
-    std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache)
+    GltfConversionCache &cache)
 {
 
     auto [isValid, errorMsg] = validateTexture(model, textureIndex);
@@ -1328,8 +1457,7 @@ void GltfParser::processMetallicRoughnessTexture(
         return;
     }
 
-    std::map<int, osg::ref_ptr<osg::Image>> imageCache;
-    osg::ref_ptr<osg::Texture2D> texture = createTextureFromGltf(model, textureIndex, textureCache, imageCache);
+    osg::ref_ptr<osg::Texture2D> texture = createTextureFromGltf(model, textureIndex, cache);
     if (texture.valid())
     {
         stateSet->setTextureAttributeAndModes(textureUnit, texture, osg::StateAttribute::ON);
@@ -1353,7 +1481,7 @@ void GltfParser::processNormalTexture(
     const tinygltf::NormalTextureInfo &normalTexture,
     osg::StateSet *stateSet,
     int textureUnit,
-    std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache)
+    GltfConversionCache &cache)
 {
 
     auto [isValid, errorMsg] = validateTexture(model, normalTexture.index);
@@ -1363,8 +1491,7 @@ void GltfParser::processNormalTexture(
         return;
     }
 
-    std::map<int, osg::ref_ptr<osg::Image>> imageCache;
-    osg::ref_ptr<osg::Texture2D> texture = createTextureFromGltf(model, normalTexture.index, textureCache, imageCache);
+    osg::ref_ptr<osg::Texture2D> texture = createTextureFromGltf(model, normalTexture.index, cache);
     if (texture.valid())
     {
         stateSet->setTextureAttributeAndModes(textureUnit, texture, osg::StateAttribute::ON);
@@ -1387,7 +1514,7 @@ void GltfParser::processOcclusionTexture(
     const tinygltf::OcclusionTextureInfo &occlusionTexture,
     osg::StateSet *stateSet,
     int textureUnit,
-    std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache)
+    GltfConversionCache &cache)
 {
 
     auto [isValid, errorMsg] = validateTexture(model, occlusionTexture.index);
@@ -1397,8 +1524,7 @@ void GltfParser::processOcclusionTexture(
         return;
     }
 
-    std::map<int, osg::ref_ptr<osg::Image>> imageCache;
-    osg::ref_ptr<osg::Texture2D> texture = createTextureFromGltf(model, occlusionTexture.index, textureCache, imageCache);
+    osg::ref_ptr<osg::Texture2D> texture = createTextureFromGltf(model, occlusionTexture.index, cache);
     if (texture.valid())
     {
         stateSet->setTextureAttributeAndModes(textureUnit, texture, osg::StateAttribute::ON);
@@ -19,6 +19,8 @@
 #include <vector>
 #include <stdexcept>
 #include "../PluginLogger.h"
+#include "../MeshOptimizer.h"
+#include "../LoadProfile.h"
 
 /**
  * @brief Error types for GLTF parsing
@@ -72,6 +74,46 @@ private:
     GltfError error_;
 };
 
+/**
+ * @brief Load options, parsed from the ReaderWriterGLTF option string
+ */
+struct GltfLoadOptions
+{
+    bool optimizeMeshes = false; // Reorder triangles and vertices for the vertex cache, overdraw and fetch locality
+    bool cpuInstancing = false;  // Expand EXT_mesh_gpu_instancing into one transform per instance instead of instanced draws
+    std::string tracePath;       // Chrome trace of the per-stage load timings; empty = OSG_PLUGIN_TRACE decides
+};
+
+/**
+ * @brief Meshes, materials, textures and images converted during one load, keyed by glTF index
+ *
+ * One cache spans the whole model. Every node that references a mesh gets its own
+ * groups and geodes over the same converted geometries and state sets, so geometry is
+ * held once in RAM and VRAM however many nodes instance it, while picking and
+ * highlighting stay per node. A material shared by many meshes becomes a single StateSet (which
+ * lets OSG state sorting group them) and every image is converted once. Failed
+ * textures and images are cached as null and not retried.
+ */
+struct GltfConversionCache
+{
+    std::map<int, osg::ref_ptr<osg::Group>> meshes;
+    std::map<int, osg::ref_ptr<osg::StateSet>> materials;
+    std::map<int, osg::ref_ptr<osg::Texture2D>> textures;
+    std::map<int, osg::ref_ptr<osg::Image>> images;
+    osg::ref_ptr<osg::StateSet> defaultMaterial; // Shared by primitives with an invalid material index
+    osg::ref_ptr<osg::StateSet> instancingState; // Instancing program and attribute divisors, created by the first instanced node
+
+    // Hit counts; the miss counts are the sizes of the maps
+    uint64_t meshHits = 0;
+    uint64_t materialHits = 0;
+    uint64_t textureHits = 0;
+    uint64_t imageHits = 0;
+
+    // EXT_mesh_gpu_instancing counters
+    uint64_t instancedNodes = 0;
+    uint64_t instances = 0;
+};
+
 /**
  * @brief Independent GLTF/GLB format parser for OSG plugin
  *
@@ -87,104 +129,127 @@ public:
     /**
      * @brief Parse GLTF/GLB model file
      * @param filePath File path
+     * @param options Load options
      * @return OSG scene graph root node on success, nullptr on failure
      */
-    static osg::ref_ptr<osg::Group> parseFile(const std::string &filePath);
+    static osg::ref_ptr<osg::Group> parseFile(const std::string &filePath,
+                                              const GltfLoadOptions &options = GltfLoadOptions());
 
 private:
     /**
      * @brief Convert GLTF model to OSG scene graph
      * @param model tinygltf model object
      * @param fileName File name
+     * @param options Load options
+     * @param profile Load profile timing the conversion stages, or nullptr
      * @return OSG scene graph root node
      */
     static osg::ref_ptr<osg::Group> convertGltfToOsg(
         const tinygltf::Model &model,
-        const std::string &fileName);
+        const std::string &fileName,
+        const GltfLoadOptions &options,
+        LoadProfile *profile);
 
     /**
      * @brief Process GLTF scene
      * @param model tinygltf model object
      * @param sceneIndex Scene index
+     * @param options Load options
+     * @param cache Model-wide conversion cache
+     * @param profile Load profile, or nullptr
      * @return OSG scene graph node
      */
-    static osg::ref_ptr<osg::Group> processScene(const tinygltf::Model &model, int sceneIndex);
+    static osg::ref_ptr<osg::Group> processScene(const tinygltf::Model &model, int sceneIndex,
+                                                 const GltfLoadOptions &options, GltfConversionCache &cache,
+                                                 LoadProfile *profile);
 
     /**
      * @brief Process GLTF node
      * @param model tinygltf model object
      * @param nodeIndex Node index
+     * @param options Load options
+     * @param cache Model-wide conversion cache
+     * @param profile Load profile, or nullptr
      * @return OSG node
      */
-    static osg::ref_ptr<osg::Node> processNode(const tinygltf::Model &model, int nodeIndex);
+    static osg::ref_ptr<osg::Node> processNode(const tinygltf::Model &model, int nodeIndex,
+                                               const GltfLoadOptions &options, GltfConversionCache &cache,
+                                               LoadProfile *profile);
 
     /**
      * @brief Process GLTF mesh
      * @param model tinygltf model object
      * @param meshIndex Mesh index
+     * @param options Load options
+     * @param cache Model-wide cache; the same index always yields the same group
+     * @param profile Load profile timing the geometry and states stages, or nullptr
      * @return OSG geometry group
      */
-    static osg::ref_ptr<osg::Group> processMesh(const tinygltf::Model &model, int meshIndex);
+    static osg::ref_ptr<osg::Group> processMesh(const tinygltf::Model &model, int meshIndex,
+                                                const GltfLoadOptions &options, GltfConversionCache &cache,
+                                                LoadProfile *profile);
+
+    /**
+     * @brief Place a converted mesh at the EXT_mesh_gpu_instancing transforms of a node
+     * @param model tinygltf model object
+     * @param node GLTF node carrying the extension
+     * @param nodeName Node name, instance names are "<nodeName>_inst_<i>"
+     * @param meshGroup Converted mesh of the node (shared, left unchanged)
+     * @param options Load options; cpuInstancing expands the instances to transforms
+     * @param cache Model-wide conversion cache, holds the shared instancing state
+     * @param profile Load profile timing the instancing stage, or nullptr
+     * @return Instanced group, or meshGroup itself if the instance data is invalid
+     */
+    static osg::ref_ptr<osg::Group> processInstances(const tinygltf::Model &model, const tinygltf::Node &node,
+                                                     const std::string &nodeName, osg::Group *meshGroup,
+                                                     const GltfLoadOptions &options, GltfConversionCache &cache,
+                                                     LoadProfile *profile);
 
     /**
      * @brief Create OSG geometry from GLTF primitive
      * @param model tinygltf model object
      * @param primitive GLTF primitive
+     * @param profile Load profile timing the convert stage, or nullptr
      * @return OSG geometry
      */
     static osg::ref_ptr<osg::Geometry> createGeometryFromPrimitive(
         const tinygltf::Model &model,
-        const tinygltf::Primitive &primitive);
+        const tinygltf::Primitive &primitive,
+        LoadProfile *profile);
 
     /**
      * @brief Create OSG state set from GLTF material
      * @param model tinygltf model object
      * @param materialIndex Material index
-     * @param materialCache Material cache for reuse
-     * @param textureCache Texture cache for reuse
+     * @param cache Model-wide cache; the same index always yields the same state set
      * @return OSG state set
      */
     static osg::ref_ptr<osg::StateSet> createMaterialFromGltf(
         const tinygltf::Model &model,
         int materialIndex,
-        std::map<int, osg::ref_ptr<osg::StateSet>> &materialCache,
-        std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache);
+        GltfConversionCache &cache);
 
     /**
      * @brief Create OSG texture from GLTF texture
      * @param model tinygltf model object
      * @param textureIndex Texture index
-     * @param textureCache Texture cache for reuse
-     * @param imageCache Image cache for reuse
+     * @param cache Model-wide texture and image cache
      * @return OSG texture2D object
      */
     static osg::ref_ptr<osg::Texture2D> createTextureFromGltf(
         const tinygltf::Model &model,
         int textureIndex,
-        std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache,
-        std::map<int, osg::ref_ptr<osg::Image>> &imageCache);
+        GltfConversionCache &cache);
 
     /**
      * @brief Create OSG image from GLTF image
      * @param model tinygltf model object
      * @param imageIndex Image index
-     * @param imageCache Image cache for reuse
      * @return OSG image object
      */
     static osg::ref_ptr<osg::Image> createImageFromGltf(
         const tinygltf::Model &model,
-        int imageIndex,
-        std::map<int, osg::ref_ptr<osg::Image>> &imageCache);
-
-    /**
-     * @brief Get accessor data
-     * @param model tinygltf model object
-     * @param accessorIndex Accessor index
-     * @return Data pointer and size
-     */
-    static std::pair<const void *, size_t> getAccessorData(
-        const tinygltf::Model &model,
-        int accessorIndex);
+        int imageIndex);
 
     /**
      * @brief Get buffer view data
@@ -214,46 +279,55 @@ private:
      * @brief Batch process geometries for performance
      * @param model tinygltf model object
      * @param primitives Primitive list
-     * @param materialCache Material cache for reuse
-     * @param textureCache Texture cache for reuse
+     * @param cache Model-wide conversion cache
+     * @param meshName Mesh name for log messages
+     * @param options Load options
+     * @param profile Load profile, or nullptr
      * @return Merged OSG geometry group
      */
     static osg::ref_ptr<osg::Group> batchProcessGeometries(
         const tinygltf::Model &model,
         const std::vector<tinygltf::Primitive> &primitives,
-        std::map<int, osg::ref_ptr<osg::StateSet>> &materialCache,
-        std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache);
+        GltfConversionCache &cache,
+        const std::string &meshName,
+        const GltfLoadOptions &options,
+        LoadProfile *profile);
 
     /**
      * @brief Optimize geometry data to reduce memory usage
      * @param geometry OSG geometry
+     * @param meshName Mesh name for log messages
+     * @param options Load options; optimizeMeshes reorders the index buffer and vertex arrays (MeshOptimizer)
      */
-    static void optimizeGeometry(osg::Geometry *geometry);
+    static void optimizeGeometry(osg::Geometry *geometry, const std::string &meshName,
+                                 const GltfLoadOptions &options);
 
     /**
      * @brief Create complete PBR material state set
      * @param model tinygltf model object
      * @param material GLTF material object
      * @param materialIndex Material index
-     * @param textureCache Texture cache for reuse
+     * @param cache Model-wide texture and image cache
      * @return OSG state set
      */
     static osg::ref_ptr<osg::StateSet> createPbrMaterial(
         const tinygltf::Model &model,
         const tinygltf::Material &material,
         int materialIndex,
-        std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache);
+        GltfConversionCache &cache);
 
     /**
-     * @brief Process multiple texture coordinate sets
+     * @brief Process multiple texture coordinate sets (TEXCOORD_0, TEXCOORD_1, ...)
      * @param model tinygltf model object
      * @param primitive GLTF primitive
      * @param geometry OSG geometry
+     * @param convertedBytes Accessor bytes read, accumulated for the load profile
      */
     static void processMultipleTexCoords(
         const tinygltf::Model &model,
         const tinygltf::Primitive &primitive,
-        osg::Geometry *geometry);
+        osg::Geometry *geometry,
+        uint64_t &convertedBytes);
 
     /**
      * @brief Validate material parameters
@@ -266,13 +340,13 @@ private:
      * @brief Create image with cache
      * @param model tinygltf model object
      * @param imageIndex Image index
-     * @param imageCache Image cache for reuse
+     * @param cache Model-wide image cache
      * @return OSG image object
      */
     static osg::ref_ptr<osg::Image> createImageWithCache(
         const tinygltf::Model &model,
         int imageIndex,
-        std::map<int, osg::ref_ptr<osg::Image>> &imageCache);
+        GltfConversionCache &cache);
 
     /**
      * @brief Process metallic roughness texture
@@ -280,14 +354,14 @@ private:
      * @param textureIndex Texture index
      * @param stateSet State set
      * @param textureUnit Texture unit
-     * @param textureCache Texture cache for reuse
+     * @param cache Model-wide texture and image cache
      */
     static void processMetallicRoughnessTexture(
         const tinygltf::Model &model,
         int textureIndex,
         osg::StateSet *stateSet,
         int textureUnit,
-        std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache);
+        GltfConversionCache &cache);
 
     /**
      * @brief Process normal texture
@@ -295,14 +369,14 @@ private:
      * @param normalTexture Normal texture info
      * @param stateSet State set
      * @param textureUnit Texture unit
-     * @param textureCache Texture cache for reuse
+     * @param cache Model-wide texture and image cache
      */
     static void processNormalTexture(
         const tinygltf::Model &model,
         const tinygltf::NormalTextureInfo &normalTexture,
         osg::StateSet *stateSet,
         int textureUnit,
-        std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache);
+        GltfConversionCache &cache);
 
     /**
      * @brief Process occlusion texture
@@ -310,14 +384,14 @@ private:
      * @param occlusionTexture Occlusion texture info
      * @param stateSet State set
      * @param textureUnit Texture unit
-     * @param textureCache Texture cache for reuse
+     * @param cache Model-wide texture and image cache
      */
     static void processOcclusionTexture(
         const tinygltf::Model &model,
         const tinygltf::OcclusionTextureInfo &occlusionTexture,
         osg::StateSet *stateSet,
         int textureUnit,
-        std::map<int, osg::ref_ptr<osg::Texture2D>> &textureCache);
+        GltfConversionCache &cache);
 
     /**
      * @brief Validate texture parameters
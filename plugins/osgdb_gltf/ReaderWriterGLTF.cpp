@@ -38,7 +38,11 @@ ReaderWriterGLTF::ReaderWriterGLTF()
         "Progress callbacks",
         "Comprehensive error handling",
         "Multi-scene support",
-        "Node hierarchy processing"};
+        "Node hierarchy processing",
+        "Vertex cache / overdraw optimization (option)",
+        "EXT_mesh_gpu_instancing with instanced draws (CPU expansion as option)",
+        "EXT_meshopt_compression (parallel decode) and KHR_mesh_quantization",
+        "Per-stage load profiling and Chrome trace (option)"};
     PluginLogger::logPluginCapabilities("GLTF", capabilities);
 
     // Log system information in debug mode
@@ -80,6 +84,7 @@ osgDB::ReaderWriter::ReadResult ReaderWriterGLTF::readNode(const std::string &fi
     {
         // Extract progress callback from OSG options
         std::function<void(const char *)> progressCallback = nullptr;
+        GltfLoadOptions loadOptions;
 
         if (options)
         {
@@ -136,9 +141,37 @@ osgDB::ReaderWriter::ReadResult ReaderWriterGLTF::readNode(const std::string &fi
                     // This would be passed to the parser if it supported this option
                 }
 
+                // Check for index buffer optimization option
+                if (optionString.find("optimize") != std::string::npos)
+                {
+                    loadOptions.optimizeMeshes = true;
+                    PluginLogger::logInfo("GLTF", "Vertex cache / overdraw optimization enabled via options");
+                }
+
+                // Check for CPU instancing fallback (EXT_mesh_gpu_instancing expanded to transforms)
+                if (optionString.find("cpuinstancing") != std::string::npos)
+                {
+                    loadOptions.cpuInstancing = true;
+                    PluginLogger::logInfo("GLTF", "Mesh instances will be expanded to transforms via options");
+                }
+
+                // Check for load profiling trace option (trace=<file>)
+                {
+                    std::istringstream tokens(optionString);
+                    std::string token;
+                    while (tokens >> token)
+                    {
+                        if (token.compare(0, 6, "trace=") == 0)
+                        {
+                            loadOptions.tracePath = token.substr(6);
+                            PluginLogger::logInfo("GLTF", "Load trace will be written to " + loadOptions.tracePath);
+                        }
+                    }
+                }
+
                 // Check for unsupported options and warn
                 std::vector<std::string> knownOptions = {
-                    "debug", "verbose", "no_animations", "no_materials", "no_textures"};
+                    "debug", "verbose", "no_animations", "no_materials", "no_textures", "optimize", "cpuinstancing", "trace"};
                 std::istringstream iss(optionString);
                 std::string option;
                 while (iss >> option)
@@ -161,7 +194,7 @@ osgDB::ReaderWriter::ReadResult ReaderWriterGLTF::readNode(const std::string &fi
         }
 
         // Use the independent GltfParser to load file with progress callback
-        osg::ref_ptr<osg::Group> result = GltfParser::parseFile(localFileName);
+        osg::ref_ptr<osg::Group> result = GltfParser::parseFile(localFileName, loadOptions);
 
         if (result.valid())
         {
@@ -0,0 +1,202 @@
+#include "LmbArena.h"
+#include <algorithm>
+#include <optional>
+
+namespace LmbPlugin
+{
+
+    // 工作线程的堆统计：arena 向堆申请与归还的块都经过这里
+    class LmbArena::Counter : public std::pmr::memory_resource
+    {
+    public:
+        uint64_t allocations = 0;
+        uint64_t blocks = 0;
+        uint64_t bytes = 0;
+        uint64_t heldBytes = 0;
+        uint64_t peakBytes = 0;
+
+    private:
+        void *do_allocate(size_t size, size_t alignment) override
+        {
+            void *p = std::pmr::new_delete_resource()->allocate(size, alignment);
+            ++blocks;
+            bytes += size;
+            heldBytes += size;
+            peakBytes = std::max(peakBytes, heldBytes);
+            return p;
+        }
+        void do_deallocate(void *p, size_t size, size_t alignment) override
+        {
+            heldBytes -= size;
+            std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+    };
+
+    // 节点暂存区：单块缓冲区上的单调分配，节点结束时复位；溢出到堆时下次复位把缓冲区扩到峰值
+    class LmbArena::Scratch : public std::pmr::memory_resource
+    {
+    public:
+        Scratch(Counter &counter, size_t initialBytes) : counter_(counter), overflow_(&counter, &overflowBytes_)
+        {
+            allocateBuffer(initialBytes);
+        }
+        ~Scratch() override
+        {
+            arena_.reset();
+            counter_.deallocate(buffer_, bufferSize_, alignof(std::max_align_t));
+        }
+
+        void reset()
+        {
+            arena_.reset();
+            if (overflowBytes_ > 0)
+            {
+                const size_t size = bufferSize_ + overflowBytes_;
+                counter_.deallocate(buffer_, bufferSize_, alignof(std::max_align_t));
+                allocateBuffer(size);
+                return;
+            }
+            arena_.emplace(buffer_, bufferSize_, &overflow_);
+        }
+
+    private:
+        // 记录本轮溢出的字节数，作为下次扩容的依据
+        class Overflow : public std::pmr::memory_resource
+        {
+        public:
+            Overflow(Counter *counter, size_t *bytes) : counter_(counter), bytes_(bytes) {}
+
+        private:
+            void *do_allocate(size_t size, size_t alignment) override
+            {
+                *bytes_ += size;
+                return counter_->allocate(size, alignment);
+            }
+            void do_deallocate(void *p, size_t size, size_t alignment) override
+            {
+                counter_->deallocate(p, size, alignment);
+            }
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+            Counter *counter_;
+            size_t *bytes_;
+        };
+
+        void allocateBuffer(size_t size)
+        {
+            buffer_ = counter_.allocate(size, alignof(std::max_align_t));
+            bufferSize_ = size;
+            overflowBytes_ = 0;
+            arena_.emplace(buffer_, bufferSize_, &overflow_);
+        }
+
+        void *do_allocate(size_t size, size_t alignment) override
+        {
+            ++counter_.allocations;
+            return arena_->allocate(size, alignment);
+        }
+        void do_deallocate(void *, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+        Counter &counter_;
+        size_t overflowBytes_ = 0;
+        Overflow overflow_;
+        void *buffer_ = nullptr;
+        size_t bufferSize_ = 0;
+        std::optional<std::pmr::monotonic_buffer_resource> arena_;
+    };
+
+    // 保留区：普通单调分配，release() 时整体归还
+    class LmbArena::Retained : public std::pmr::memory_resource
+    {
+    public:
+        Retained(Counter &counter, size_t initialBytes) : counter_(counter), arena_(initialBytes, &counter) {}
+
+        void release() { arena_.release(); }
+
+    private:
+        void *do_allocate(size_t size, size_t alignment) override
+        {
+            ++counter_.allocations;
+            return arena_.allocate(size, alignment);
+        }
+        void do_deallocate(void *, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+        Counter &counter_;
+        std::pmr::monotonic_buffer_resource arena_;
+    };
+
+    struct LmbArena::Worker
+    {
+        explicit Worker(size_t initialBytes) : scratch(counter, initialBytes), retained(counter, initialBytes) {}
+
+        Counter counter;
+        Scratch scratch;
+        Retained retained;
+    };
+
+    LmbArena::LmbArena(unsigned workerCount, size_t initialBytes)
+    {
+        workers_.reserve(workerCount);
+        for (unsigned i = 0; i < workerCount; ++i)
+            workers_.emplace_back(new Worker(initialBytes));
+    }
+
+    LmbArena::~LmbArena() = default;
+
+    std::pmr::memory_resource *LmbArena::scratch(unsigned worker)
+    {
+        return &workers_[worker]->scratch;
+    }
+
+    std::pmr::memory_resource *LmbArena::resource(unsigned worker)
+    {
+        return &workers_[worker]->retained;
+    }
+
+    void LmbArena::resetScratch(unsigned worker)
+    {
+        workers_[worker]->scratch.reset();
+    }
+
+    void LmbArena::release()
+    {
+        for (const auto &worker : workers_)
+            worker->retained.release();
+    }
+
+    uint64_t LmbArena::allocations() const
+    {
+        uint64_t total = 0;
+        for (const auto &worker : workers_)
+            total += worker->counter.allocations;
+        return total;
+    }
+
+    uint64_t LmbArena::blocks() const
+    {
+        uint64_t total = 0;
+        for (const auto &worker : workers_)
+            total += worker->counter.blocks;
+        return total;
+    }
+
+    uint64_t LmbArena::bytes() const
+    {
+        uint64_t total = 0;
+        for (const auto &worker : workers_)
+            total += worker->counter.bytes;
+        return total;
+    }
+
+    uint64_t LmbArena::peakBytes() const
+    {
+        uint64_t total = 0;
+        for (const auto &worker : workers_)
+            total += worker->counter.peakBytes;
+        return total;
+    }
+
+} // namespace LmbPlugin
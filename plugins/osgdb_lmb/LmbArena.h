@@ -0,0 +1,85 @@
+#ifndef LMBARENA_H
+#define LMBARENA_H
+
+#include <memory_resource>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Per-load arenas for transient parse data, one pair per LmbThreadPool worker
+     *
+     * Each worker has two bump allocators:
+     * - a node scratch arena (scratch()) for data that dies with the node being
+     *   decoded, such as its instance list. A Scope resets it when the node is
+     *   done. The arena keeps one buffer sized to the largest node seen so far,
+     *   so once warmed up a node costs no heap allocation and the footprint is
+     *   one node per worker, not the whole file;
+     * - a retained arena (resource()) for data that outlives its node until a
+     *   later stage consumes it (batch index copies). release() frees it once
+     *   that stage is done.
+     *
+     * A worker only allocates from its own arenas, so no locking is needed;
+     * deallocation is a no-op and may happen on any thread.
+     */
+    class LmbArena
+    {
+    public:
+        /**
+         * @param workerCount Number of pool workers (LmbThreadPool::size())
+         * @param initialBytes Size of each worker's first block; later blocks grow geometrically
+         */
+        explicit LmbArena(unsigned workerCount, size_t initialBytes = 64 * 1024);
+        ~LmbArena();
+
+        LmbArena(const LmbArena &) = delete;
+        LmbArena &operator=(const LmbArena &) = delete;
+
+        /**
+         * @brief Node scope on a worker: resets the worker's scratch arena when it ends
+         *
+         * Declare it before the objects that allocate from scratch() so they are destroyed first.
+         */
+        class Scope
+        {
+        public:
+            Scope(LmbArena &arena, unsigned worker) : arena_(arena), worker_(worker) {}
+            ~Scope() { arena_.resetScratch(worker_); }
+
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            LmbArena &arena_;
+            unsigned worker_;
+        };
+
+        std::pmr::memory_resource *scratch(unsigned worker);
+        std::pmr::memory_resource *resource(unsigned worker);
+
+        // 释放全部工作线程的保留 arena（所有工作线程结束、引用的数据已不再使用后调用）
+        void release();
+
+        // 统计（在所有工作线程结束后读取）
+        uint64_t allocations() const; // 从 arena 分配的次数（原本各是一次堆分配）
+        uint64_t blocks() const;      // 实际向堆申请的块数
+        uint64_t bytes() const;       // 向堆申请的总字节数
+        uint64_t peakBytes() const;   // 各工作线程同时持有的堆内存峰值之和
+
+    private:
+        void resetScratch(unsigned worker);
+
+        class Counter;
+        class Scratch;
+        class Retained;
+        struct Worker;
+        std::vector<std::unique_ptr<Worker>> workers_;
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBARENA_H
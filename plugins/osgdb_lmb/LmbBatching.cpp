@@ -0,0 +1,164 @@
+#include "LmbBatching.h"
+#include "LmbThreadPool.h"
+#include <osg/UserDataContainer>
+#include <algorithm>
+#include <map>
+
+namespace LmbPlugin
+{
+
+    const char *const LmbBatching::TriangleStartsName = "LmbBatchTriangleStarts";
+
+    namespace
+    {
+        struct Cluster
+        {
+            uint32_t colorIndex = 0;
+            std::vector<size_t> parts;
+        };
+
+        // 顶点数超出预算时按中心点在最长轴上取中位数二分
+        void SplitCluster(const std::vector<LmbBatchSource> &sources, const std::vector<LmbBatchPart> &parts,
+                          std::vector<size_t> &items, size_t begin, size_t end, uint32_t colorIndex,
+                          uint32_t maxVertices, std::vector<Cluster> &out)
+        {
+            uint64_t vertexCount = 0;
+            osg::BoundingBox centers;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const LmbBatchPart &part = parts[items[i]];
+                vertexCount += sources[part.source].vertices->size();
+                centers.expandBy(part.center);
+            }
+            if (vertexCount <= maxVertices || end - begin == 1)
+            {
+                Cluster cluster;
+                cluster.colorIndex = colorIndex;
+                cluster.parts.assign(items.begin() + begin, items.begin() + end);
+                out.push_back(std::move(cluster));
+                return;
+            }
+
+            const osg::Vec3 extent = centers._max - centers._min;
+            const int axis = extent.x() >= extent.y() && extent.x() >= extent.z() ? 0 : (extent.y() >= extent.z() ? 1 : 2);
+            const size_t middle = begin + (end - begin) / 2;
+            std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end,
+                             [&parts, axis](size_t a, size_t b)
+                             { return parts[a].center[axis] < parts[b].center[axis]; });
+            SplitCluster(sources, parts, items, begin, middle, colorIndex, maxVertices, out);
+            SplitCluster(sources, parts, items, middle, end, colorIndex, maxVertices, out);
+        }
+
+        template <typename DrawElementsType>
+        osg::ref_ptr<osg::DrawElements> MergeIndices(const std::vector<LmbBatchSource> &sources,
+                                                     const std::vector<LmbBatchPart> &parts, const Cluster &cluster,
+                                                     size_t indexCount)
+        {
+            osg::ref_ptr<DrawElementsType> indices = new DrawElementsType(GL_TRIANGLES);
+            indices->reserve(indexCount);
+            uint32_t baseVertex = 0;
+            for (size_t partIndex : cluster.parts)
+            {
+                const LmbBatchSource &source = sources[parts[partIndex].source];
+                for (uint32_t index : source.indices)
+                    indices->push_back(static_cast<typename DrawElementsType::value_type>(baseVertex + index));
+                baseVertex += source.vertices->size();
+            }
+            return indices;
+        }
+
+        BuiltNode BuildBatch(const std::vector<LmbBatchSource> &sources, const std::vector<LmbBatchPart> &parts,
+                             const Cluster &cluster, const std::string &name)
+        {
+            size_t vertexCount = 0;
+            size_t indexCount = 0;
+            for (size_t partIndex : cluster.parts)
+            {
+                const LmbBatchSource &source = sources[parts[partIndex].source];
+                vertexCount += source.vertices->size();
+                indexCount += source.indices.size();
+            }
+
+            osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+            osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
+            vertices->reserve(vertexCount);
+            normals->reserve(vertexCount);
+            osg::ref_ptr<osg::UIntArray> triangleStarts = new osg::UIntArray;
+            triangleStarts->reserve(cluster.parts.size());
+            std::vector<std::string> names;
+            names.reserve(cluster.parts.size());
+
+            uint32_t triangleCount = 0;
+            for (size_t partIndex : cluster.parts)
+            {
+                const LmbBatchPart &part = parts[partIndex];
+                const LmbBatchSource &source = sources[part.source];
+
+                // 顶点预先变换到场景坐标；法线用逆转置矩阵，兼容非均匀缩放
+                const osg::Matrix normalMatrix = osg::Matrix::inverse(part.matrix);
+                for (const osg::Vec3 &v : *source.vertices)
+                    vertices->push_back(v * part.matrix);
+                for (const osg::Vec3 &n : *source.normals)
+                {
+                    osg::Vec3 normal = osg::Matrix::transform3x3(normalMatrix, n);
+                    normal.normalize();
+                    normals->push_back(normal);
+                }
+
+                triangleStarts->push_back(triangleCount);
+                triangleCount += static_cast<uint32_t>(source.indices.size() / 3);
+                names.push_back(part.name);
+            }
+
+            osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+            geometry->setVertexArray(vertices.get());
+            geometry->setNormalArray(normals.get(), osg::Array::BIND_PER_VERTEX);
+            if (vertexCount <= 0x10000)
+                geometry->addPrimitiveSet(MergeIndices<osg::DrawElementsUShort>(sources, parts, cluster, indexCount).get());
+            else
+                geometry->addPrimitiveSet(MergeIndices<osg::DrawElementsUInt>(sources, parts, cluster, indexCount).get());
+            geometry->setUseDisplayList(false);
+            geometry->setUseVertexBufferObjects(true);
+
+            BuiltNode built;
+            built.transform = new osg::MatrixTransform;
+            built.transform->setName(name);
+            built.geode = new osg::Geode;
+            built.geode->setName(name + "_Geode");
+            built.geode->addDrawable(geometry.get());
+            built.transform->addChild(built.geode.get());
+            built.colorIndex = cluster.colorIndex;
+
+            // 拾取用：每个部件的起始三角形与名称
+            triangleStarts->setName(LmbBatching::TriangleStartsName);
+            built.geode->getOrCreateUserDataContainer()->addUserObject(triangleStarts.get());
+            built.geode->setDescriptions(names);
+            return built;
+        }
+    }
+
+    std::vector<BuiltNode> LmbBatching::CreateBatches(const std::vector<LmbBatchSource> &sources,
+                                                      const std::vector<LmbBatchPart> &parts,
+                                                      uint32_t maxVertices, const LmbThreadPool &pool)
+    {
+        // 按颜色分组（有序，保证批次顺序确定），组内再做空间聚簇
+        std::map<uint32_t, std::vector<size_t>> byColor;
+        for (size_t i = 0; i < parts.size(); ++i)
+            byColor[parts[i].colorIndex].push_back(i);
+
+        std::vector<Cluster> clusters;
+        for (auto &group : byColor)
+            SplitCluster(sources, parts, group.second, 0, group.second.size(), group.first,
+                         std::max<uint32_t>(1, maxVertices), clusters);
+
+        std::vector<BuiltNode> batches(clusters.size());
+        pool.parallelFor(clusters.size(),
+                         [&](size_t i)
+                         {
+                             batches[i] = BuildBatch(sources, parts, clusters[i],
+                                                     "LmbBatch_" + std::to_string(clusters[i].colorIndex) + "_" + std::to_string(i));
+                         });
+        return batches;
+    }
+
+} // namespace LmbPlugin
@@ -0,0 +1,71 @@
+#ifndef LMBBATCHING_H
+#define LMBBATCHING_H
+
+#include "LmbParser.h"
+#include <osg/Array>
+#include <osg/Matrix>
+#include <osg/Vec3>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace LmbPlugin
+{
+
+    class LmbThreadPool;
+
+    /**
+     * @brief Decoded node geometry in its local space, shared by the node and its instances
+     */
+    struct LmbBatchSource
+    {
+        osg::ref_ptr<osg::Vec3Array> vertices;
+        osg::ref_ptr<osg::Vec3Array> normals;
+        Span<uint32_t> indices; // 分配在本次加载的 LmbArena 保留区中，合批完成后释放
+    };
+
+    /**
+     * @brief One placement of a source (a node or one of its instances) to be merged
+     */
+    struct LmbBatchPart
+    {
+        std::string name;        // 拾取时显示的节点/实例名
+        osg::Matrix matrix;      // 相对场景变换
+        uint32_t colorIndex = 0;
+        size_t source = 0;       // LmbBatchSource 下标
+        osg::Vec3 center;        // 变换后包围盒中心，用于空间聚簇
+    };
+
+    /**
+     * @brief Static batching of non-instanced LMB nodes (the "batch" load option)
+     *
+     * Parts sharing a color index are split into spatially compact clusters
+     * (median split on the longest axis) of at most maxVertices vertices.
+     * Each cluster becomes one Geometry with pre-transformed vertices and
+     * normals, so thousands of small nodes cost a handful of draw calls.
+     *
+     * For picking, the batch Geode keeps the first triangle of every part as an
+     * osg::UIntArray user object named TriangleStartsName and the part names
+     * as node descriptions (same order).
+     */
+    class LmbBatching
+    {
+    public:
+        static const char *const TriangleStartsName;
+
+        /**
+         * @brief Merge parts into batches, built in parallel on pool
+         * @param sources Decoded geometry, indexed by LmbBatchPart::source (empty entries are unused)
+         * @param parts Parts in scene order
+         * @param maxVertices Vertex budget per batch; a larger single part forms its own batch.
+         *                    Batches of up to 65536 vertices use 16-bit indices
+         * @return One identity transform per batch; color StateSets are attached by the caller
+         */
+        static std::vector<BuiltNode> CreateBatches(const std::vector<LmbBatchSource> &sources,
+                                                    const std::vector<LmbBatchPart> &parts,
+                                                    uint32_t maxVertices, const LmbThreadPool &pool);
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBBATCHING_H
@@ -0,0 +1,359 @@
+#include "LmbCompression.h"
+#include "LmbLz4.h"
+#include "LmbTempFile.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace LmbPlugin
+{
+
+    namespace
+    {
+        const char Magic[4] = {'L', 'M', 'B', 'Z'};
+        const uint32_t Version = 1;
+        const uint64_t HeaderSize = sizeof(Magic) + 3 * sizeof(uint32_t) + sizeof(uint64_t);
+        const uint64_t BlockEntrySize = sizeof(uint64_t) + sizeof(uint32_t);
+        // 块大小上限，防止损坏的头部导致超大分配
+        const uint32_t MaxBlockSize = 1u << 30;
+
+        struct BlockEntry
+        {
+            uint64_t offset;
+            uint32_t compressedSize;
+        };
+
+        struct Header
+        {
+            uint32_t blockSize = 0;
+            uint32_t blockCount = 0;
+            uint64_t rawSize = 0;
+        };
+
+        template <typename T>
+        void WriteValue(std::ofstream &out, const T &value)
+        {
+            out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        // 读取并检查头部；成功时 cursor 停在块表起始处
+        bool ReadHeader(ByteCursor &cursor, Header &header, std::string &error)
+        {
+            uint32_t version;
+            if (!cursor.skip(sizeof(Magic)) || !cursor.read(version) || !cursor.read(header.blockSize) ||
+                !cursor.read(header.blockCount) || !cursor.read(header.rawSize))
+            {
+                error = "Truncated .lmbz header";
+                return false;
+            }
+            if (version != Version)
+            {
+                error = "Unsupported .lmbz version " + std::to_string(version);
+                return false;
+            }
+            if (header.blockSize == 0 || header.blockSize > MaxBlockSize || header.rawSize == 0 ||
+                uint64_t(header.blockCount) != (header.rawSize + header.blockSize - 1) / header.blockSize ||
+                uint64_t(header.blockCount) * BlockEntrySize > cursor.remaining())
+            {
+                error = "Invalid .lmbz block layout";
+                return false;
+            }
+            return true;
+        }
+
+        bool ReadBlockEntry(ByteCursor &cursor, uint64_t fileSize, BlockEntry &block)
+        {
+            cursor.read(block.offset);
+            cursor.read(block.compressedSize);
+            return block.offset <= fileSize && block.compressedSize <= fileSize - block.offset;
+        }
+
+        // 解压第 index 块到 target（块的原始字节数由头部算出）
+        bool DecompressBlock(const LmbMappedFile &file, const Header &header, const BlockEntry &block, size_t index,
+                             uint8_t *target)
+        {
+            const uint64_t rawOffset = uint64_t(index) * header.blockSize;
+            const size_t rawBytes = static_cast<size_t>(std::min<uint64_t>(header.blockSize, header.rawSize - rawOffset));
+            const uint8_t *source = file.data() + block.offset;
+            bool ok;
+            if (block.compressedSize == rawBytes)
+            {
+                std::memcpy(target, source, rawBytes);
+                ok = true;
+            }
+            else
+            {
+                ok = LmbLz4::Decompress(source, block.compressedSize, target, rawBytes);
+            }
+            // 压缩数据用过一次即可丢弃
+            file.release(block.offset, block.compressedSize);
+            return ok;
+        }
+    }
+
+    bool LmbCompression::BlockReader::open(const LmbMappedFile &container, std::string &error)
+    {
+        ByteCursor cursor(container.data(), container.size());
+        Header header;
+        if (!ReadHeader(cursor, header, error))
+            return false;
+
+        container_ = &container;
+        blockSize_ = header.blockSize;
+        rawSize_ = header.rawSize;
+        buffer_.clear();
+        bufferBlock_ = UINT64_MAX;
+        position_ = 0;
+        failed_ = false;
+        corrupted_ = false;
+        return true;
+    }
+
+    bool LmbCompression::BlockReader::skip(uint64_t bytes)
+    {
+        // 只移动位置，跳过的块不解压
+        if (failed_ || bytes > rawSize_ - position_)
+        {
+            failed_ = true;
+            return false;
+        }
+        position_ += bytes;
+        return true;
+    }
+
+    bool LmbCompression::BlockReader::consume(void *out, uint64_t bytes)
+    {
+        if (failed_ || bytes > rawSize_ - position_)
+        {
+            failed_ = true;
+            return false;
+        }
+
+        uint8_t *target = static_cast<uint8_t *>(out);
+        while (bytes > 0)
+        {
+            const uint64_t block = position_ / blockSize_;
+            if (block != bufferBlock_)
+            {
+                // 块表按下标直接定位；块表已由 open 检查过长度
+                ByteCursor table(container_->data() + HeaderSize + block * BlockEntrySize, BlockEntrySize);
+                BlockEntry entry;
+                Header header;
+                header.blockSize = blockSize_;
+                header.rawSize = rawSize_;
+                buffer_.resize(static_cast<size_t>(std::min<uint64_t>(blockSize_, rawSize_ - block * blockSize_)));
+                if (!ReadBlockEntry(table, container_->size(), entry) ||
+                    !DecompressBlock(*container_, header, entry, static_cast<size_t>(block), buffer_.data()))
+                {
+                    failed_ = corrupted_ = true;
+                    bufferBlock_ = UINT64_MAX;
+                    return false;
+                }
+                bufferBlock_ = block;
+            }
+
+            const uint64_t inBlock = position_ - bufferBlock_ * blockSize_;
+            const uint64_t count = std::min<uint64_t>(bytes, buffer_.size() - inBlock);
+            std::memcpy(target, buffer_.data() + inBlock, static_cast<size_t>(count));
+            target += count;
+            position_ += count;
+            bytes -= count;
+        }
+        return true;
+    }
+
+    bool LmbCompression::IsCompressed(const uint8_t *data, uint64_t size)
+    {
+        return size >= sizeof(Magic) && std::memcmp(data, Magic, sizeof(Magic)) == 0;
+    }
+
+    bool LmbCompression::Decompress(LmbMappedFile &image, const LmbThreadPool &pool, std::string &error)
+    {
+        if (!IsCompressed(image.data(), image.size()))
+            return true;
+
+        // 接管压缩文件的映射，解压结果写回 image；函数返回时压缩文件随 file 解除映射
+        LmbMappedFile file;
+        file.swap(image);
+
+        ByteCursor cursor(file.data(), file.size());
+        Header header;
+        if (!ReadHeader(cursor, header, error))
+            return false;
+
+        std::vector<BlockEntry> blocks(header.blockCount);
+        for (auto &block : blocks)
+        {
+            if (!ReadBlockEntry(cursor, file.size(), block))
+            {
+                error = "Invalid .lmbz block table";
+                return false;
+            }
+        }
+
+        if (!image.allocate(header.rawSize))
+        {
+            error = "Cannot allocate " + std::to_string(header.rawSize / 1024) + " KB for the decompressed image";
+            return false;
+        }
+
+        // 各块互不依赖，直接解压到镜像中各自的位置
+        uint8_t *target = image.mutableData();
+        std::atomic<bool> corrupted(false);
+        pool.parallelFor(blocks.size(), [&](size_t i)
+                         {
+                             if (!DecompressBlock(file, header, blocks[i], i, target + uint64_t(i) * header.blockSize))
+                                 corrupted = true;
+                         });
+        if (corrupted)
+        {
+            image.close();
+            error = "Corrupted .lmbz block data";
+            return false;
+        }
+        return true;
+    }
+
+    bool LmbCompression::DecompressRange(const LmbMappedFile &container, uint64_t offset, uint64_t size,
+                                         LmbMappedFile &image, uint64_t &imageOffset, std::string &error)
+    {
+        ByteCursor cursor(container.data(), container.size());
+        Header header;
+        if (!ReadHeader(cursor, header, error))
+            return false;
+        if (size == 0 || offset > header.rawSize || size > header.rawSize - offset)
+        {
+            error = "Range outside the .lmbz image";
+            return false;
+        }
+
+        // 只解压覆盖 [offset, offset + size) 的块；块表按下标直接定位
+        const uint64_t firstBlock = offset / header.blockSize;
+        const uint64_t lastBlock = (offset + size - 1) / header.blockSize;
+        imageOffset = firstBlock * header.blockSize;
+        const uint64_t imageSize = std::min<uint64_t>((lastBlock + 1) * header.blockSize, header.rawSize) - imageOffset;
+        if (!image.allocate(imageSize))
+        {
+            error = "Cannot allocate " + std::to_string(imageSize / 1024) + " KB for decompressed blocks";
+            return false;
+        }
+
+        if (!cursor.skip(firstBlock * BlockEntrySize))
+        {
+            error = "Invalid .lmbz block table";
+            return false;
+        }
+        uint8_t *target = image.mutableData();
+        for (uint64_t i = firstBlock; i <= lastBlock; ++i)
+        {
+            BlockEntry block;
+            if (!ReadBlockEntry(cursor, container.size(), block))
+            {
+                image.close();
+                error = "Invalid .lmbz block table";
+                return false;
+            }
+            if (!DecompressBlock(container, header, block, static_cast<size_t>(i), target + (i - firstBlock) * header.blockSize))
+            {
+                image.close();
+                error = "Corrupted .lmbz block data";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool LmbCompression::CompressFile(const std::string &srcPath, const std::string &dstPath, uint32_t blockSize,
+                                      const LmbThreadPool &pool, Result &result, std::string &error)
+    {
+        if (blockSize == 0 || blockSize > MaxBlockSize)
+        {
+            error = "Block size must be between 1 and " + std::to_string(MaxBlockSize) + " bytes";
+            return false;
+        }
+
+        LmbMappedFile source;
+        if (!source.open(srcPath))
+        {
+            error = "Cannot map " + srcPath;
+            return false;
+        }
+        if (IsCompressed(source.data(), source.size()))
+        {
+            error = srcPath + " is already compressed";
+            return false;
+        }
+
+        const uint64_t rawSize = source.size();
+        const uint32_t blockCount = static_cast<uint32_t>((rawSize + blockSize - 1) / blockSize);
+        std::vector<std::vector<uint8_t>> compressed(blockCount);
+        pool.parallelFor(blockCount, [&](size_t i)
+                         {
+                             const uint64_t rawOffset = uint64_t(i) * blockSize;
+                             const size_t rawBytes = static_cast<size_t>(std::min<uint64_t>(blockSize, rawSize - rawOffset));
+                             std::vector<uint8_t> &block = compressed[i];
+                             block.resize(LmbLz4::CompressBound(rawBytes));
+                             const size_t size = LmbLz4::Compress(source.data() + rawOffset, rawBytes, block.data(), block.size());
+                             // 压缩后不变小的块原样存放，读取时按大小相等识别
+                             if (size == 0 || size >= rawBytes)
+                                 block.assign(source.data() + rawOffset, source.data() + rawOffset + rawBytes);
+                             else
+                                 block.resize(size);
+                             block.shrink_to_fit();
+                         });
+
+        result = Result();
+        result.rawSize = rawSize;
+        result.blockCount = blockCount;
+
+        // 经由临时文件改名写出，并发写同一目标时不会得到拼接的文件
+        const std::string tempPath = LmbTempFile::PathFor(dstPath);
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            error = "Cannot create " + tempPath;
+            return false;
+        }
+        out.write(Magic, sizeof(Magic));
+        WriteValue(out, Version);
+        WriteValue(out, blockSize);
+        WriteValue(out, blockCount);
+        WriteValue(out, rawSize);
+        uint64_t offset = HeaderSize + uint64_t(blockCount) * BlockEntrySize;
+        for (uint32_t i = 0; i < blockCount; ++i)
+        {
+            const uint32_t size = static_cast<uint32_t>(compressed[i].size());
+            WriteValue(out, offset);
+            WriteValue(out, size);
+            offset += size;
+            const uint64_t rawBytes = std::min<uint64_t>(blockSize, rawSize - uint64_t(i) * blockSize);
+            if (size == rawBytes)
+                ++result.storedBlocks;
+        }
+        for (const auto &block : compressed)
+            out.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(block.size()));
+        out.close();
+        if (!out)
+        {
+            std::remove(tempPath.c_str());
+            error = "Failed to write " + dstPath;
+            return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tempPath, dstPath, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            error = "Cannot replace " + dstPath + ": " + ec.message();
+            return false;
+        }
+
+        result.compressedSize = offset;
+        return true;
+    }
+
+} // namespace LmbPlugin
@@ -0,0 +1,133 @@
+#ifndef LMBCOMPRESSION_H
+#define LMBCOMPRESSION_H
+
+#include "LmbMappedFile.h"
+#include "LmbThreadPool.h"
+#include <string>
+#include <cstdint>
+#include <vector>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Block-compressed LMB container (.lmbz)
+     *
+     * Layout (little endian):
+     *   char[4] "LMBZ", u32 version, u32 blockSize, u32 blockCount, u64 rawSize,
+     *   blockCount x { u64 offset, u32 compressedSize }, block data.
+     * Every block holds blockSize bytes of the plain LMB file (the last one the
+     * remainder) and is LZ4-compressed on its own, so blocks decompress in
+     * parallel. A block whose compressedSize equals its raw size is stored as is.
+     */
+    class LmbCompression
+    {
+    public:
+        static const uint32_t DefaultBlockSize = 1u << 20;
+
+        /**
+         * @brief Summary of a CompressFile run
+         */
+        struct Result
+        {
+            uint64_t rawSize = 0;
+            uint64_t compressedSize = 0;
+            uint32_t blockCount = 0;
+            uint32_t storedBlocks = 0; // 不可压缩、原样存放的块
+        };
+
+        /**
+         * @brief Forward-only reader over the plain image of a mapped .lmbz container
+         *
+         * Decompresses one block at a time into a reused buffer; skipping over
+         * whole blocks does not decompress them. Exposes the same read / skip /
+         * alignTo4 / position interface as ByteCursor, so the header and node
+         * scan run over a container without decompressing the whole file.
+         */
+        class BlockReader
+        {
+        public:
+            /**
+             * @brief Start reading container, which must stay mapped while the reader is used
+             * @return false with error set if the header or block table is malformed
+             */
+            bool open(const LmbMappedFile &container, std::string &error);
+
+            template <typename T>
+            bool read(T &value)
+            {
+                return consume(&value, sizeof(T));
+            }
+
+            bool skip(uint64_t bytes);
+
+            bool alignTo4()
+            {
+                const uint64_t padding = (4 - (position_ % 4)) % 4;
+                return padding == 0 || skip(padding);
+            }
+
+            uint64_t position() const { return position_; }
+            uint64_t remaining() const { return rawSize_ - position_; }
+            bool good() const { return !failed_; }
+            // 失败是因为块数据损坏，而不是读到了镜像末尾
+            bool corrupted() const { return corrupted_; }
+            uint64_t rawSize() const { return rawSize_; }
+            uint32_t blockSize() const { return blockSize_; }
+
+        private:
+            bool consume(void *out, uint64_t bytes);
+
+            const LmbMappedFile *container_ = nullptr;
+            uint32_t blockSize_ = 0;
+            uint64_t rawSize_ = 0;
+            std::vector<uint8_t> buffer_;
+            uint64_t bufferBlock_ = UINT64_MAX;
+            uint64_t position_ = 0;
+            bool failed_ = false;
+            bool corrupted_ = false;
+        };
+
+        /**
+         * @brief True if data starts with the .lmbz magic
+         */
+        static bool IsCompressed(const uint8_t *data, uint64_t size);
+
+        /**
+         * @brief Replace a mapped .lmbz container with its decompressed image
+         *
+         * Used to convert a whole file (lmbzip -d). Loading never builds the
+         * whole image: it scans through BlockReader and decodes nodes from the
+         * ranges returned by DecompressRange.
+         * @param image In: a mapped file; out: unchanged if it is a plain LMB file, otherwise an anonymous image of the plain bytes
+         * @param pool Pool the blocks are decompressed on
+         * @param error Out: reason on failure
+         * @return false if the container is malformed; image is then left closed
+         */
+        static bool Decompress(LmbMappedFile &image, const LmbThreadPool &pool, std::string &error);
+
+        /**
+         * @brief Decompress only the blocks covering [offset, offset + size) of the plain image
+         *
+         * Used by loading and paged loading, so a group of nodes (or a page) needs
+         * its own blocks resident instead of the whole decompressed file.
+         * @param container Mapped .lmbz file
+         * @param image Out: anonymous image of the covering blocks
+         * @param imageOffset Out: offset in the plain file of image.data()[0]
+         * @return false with error set if the container is malformed or the range lies outside it
+         */
+        static bool DecompressRange(const LmbMappedFile &container, uint64_t offset, uint64_t size,
+                                    LmbMappedFile &image, uint64_t &imageOffset, std::string &error);
+
+        /**
+         * @brief Write srcPath (a plain LMB file) as a .lmbz container at dstPath
+         * @param blockSize Uncompressed bytes per block; larger blocks compress better, smaller ones spread over more threads
+         * @return false with error set on failure; dstPath is written through a temporary file and renamed, so it is never left partial
+         */
+        static bool CompressFile(const std::string &srcPath, const std::string &dstPath, uint32_t blockSize,
+                                 const LmbThreadPool &pool, Result &result, std::string &error);
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBCOMPRESSION_H
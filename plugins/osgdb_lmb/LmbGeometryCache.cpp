@@ -0,0 +1,127 @@
+#include "LmbGeometryCache.h"
+#include <cstring>
+
+namespace LmbPlugin
+{
+
+    namespace
+    {
+        const uint64_t HashMultiplier = 0x9E3779B97F4A7C15ull;
+
+        inline uint64_t Mix(uint64_t h, uint64_t word)
+        {
+            h = (h ^ word) * HashMultiplier;
+            return h ^ (h >> 29);
+        }
+
+        // 按 8 字节字处理，比逐字节的 FNV 快一个数量级；结果只在进程内使用
+        uint64_t HashBytes(uint64_t h, const void *data, size_t size)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t *>(data);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, bytes + i, sizeof(word));
+                h = Mix(h, word);
+            }
+            uint64_t tail = 0;
+            if (i < size)
+                std::memcpy(&tail, bytes + i, size - i);
+            return Mix(h, tail ^ (uint64_t(size) << 56));
+        }
+
+        bool SameBytes(const void *a, const void *b, size_t size)
+        {
+            return a == b || size == 0 || std::memcmp(a, b, size) == 0;
+        }
+    }
+
+    uint64_t LmbGeometryCache::Hash(const Node &node)
+    {
+        uint64_t h = HashBytes(0, &node.baseVertex, sizeof(node.baseVertex));
+        h = HashBytes(h, &node.vertexScale, sizeof(node.vertexScale));
+        h = HashBytes(h, node.compressVertices.data(), node.compressVertices.size() * sizeof(int16_t));
+        h = HashBytes(h, node.normals.data(), node.normals.size() * sizeof(int32_t));
+        return HashBytes(h, node.indices.data(), node.indices.size() * node.indices.width());
+    }
+
+    bool LmbGeometryCache::SamePayload(const Entry &entry, const Node &node)
+    {
+        return entry.compressVertices.size() == node.compressVertices.size() &&
+               entry.normals.size() == node.normals.size() &&
+               entry.indices.size() == node.indices.size() &&
+               entry.indices.width() == node.indices.width() &&
+               SameBytes(&entry.baseVertex, &node.baseVertex, sizeof(Vector3f)) &&
+               SameBytes(&entry.vertexScale, &node.vertexScale, sizeof(Vector3f)) &&
+               SameBytes(entry.compressVertices.data(), node.compressVertices.data(), node.compressVertices.size() * sizeof(int16_t)) &&
+               SameBytes(entry.normals.data(), node.normals.data(), node.normals.size() * sizeof(int32_t)) &&
+               SameBytes(entry.indices.data(), node.indices.data(), node.indices.size() * node.indices.width());
+    }
+
+    const MeshLevels *LmbGeometryCache::lookup(const Node &node, uint64_t hash)
+    {
+        auto range = entries_.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (!SamePayload(it->second, node))
+                continue;
+            ++sharedMeshes_;
+            sharedBytes_ += uint64_t(node.normals.size()) * vertexBytes_ +
+                            uint64_t(node.indices.size()) * node.indices.width();
+            return &it->second.levels;
+        }
+        return nullptr;
+    }
+
+    bool LmbGeometryCache::find(const Node &node, uint64_t hash, MeshLevels &levels)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const MeshLevels *existing = lookup(node, hash);
+        if (!existing)
+            return false;
+        levels = *existing;
+        return true;
+    }
+
+    void LmbGeometryCache::insert(const Node &node, uint64_t hash, MeshLevels &levels)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 两个线程可能同时构建了同一网格，以先插入的为准
+        if (const MeshLevels *existing = lookup(node, hash))
+        {
+            levels = *existing;
+            return;
+        }
+
+        Entry entry;
+        entry.baseVertex = node.baseVertex;
+        entry.vertexScale = node.vertexScale;
+        entry.compressVertices = node.compressVertices;
+        entry.normals = node.normals;
+        entry.indices = node.indices;
+        entry.levels = levels;
+        if (copyPayload_)
+        {
+            // 各数组按 4 字节对齐依次存放；vector 移入 map 时缓冲区不变，Span 仍然有效
+            const size_t vertexBytes = node.compressVertices.size() * sizeof(int16_t);
+            const size_t normalOffset = (vertexBytes + 3) & ~size_t(3);
+            const size_t normalBytes = node.normals.size() * sizeof(int32_t);
+            const size_t indexOffset = normalOffset + normalBytes;
+            const size_t indexBytes = node.indices.size() * node.indices.width();
+            entry.payload.resize(indexOffset + indexBytes);
+            uint8_t *payload = entry.payload.data();
+            if (vertexBytes)
+                std::memcpy(payload, node.compressVertices.data(), vertexBytes);
+            if (normalBytes)
+                std::memcpy(payload + normalOffset, node.normals.data(), normalBytes);
+            if (indexBytes)
+                std::memcpy(payload + indexOffset, node.indices.data(), indexBytes);
+            entry.compressVertices = Span<int16_t>(reinterpret_cast<const int16_t *>(payload), node.compressVertices.size());
+            entry.normals = Span<int32_t>(reinterpret_cast<const int32_t *>(payload + normalOffset), node.normals.size());
+            entry.indices = IndexSpan(payload + indexOffset, node.indices.size(), node.indices.width());
+        }
+        entries_.emplace(hash, std::move(entry));
+    }
+
+} // namespace LmbPlugin
@@ -0,0 +1,83 @@
+#ifndef LMBGEOMETRYCACHE_H
+#define LMBGEOMETRYCACHE_H
+
+#include "LmbParser.h"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Shares one osg::Geometry (and its LOD levels) between nodes with identical mesh payload
+     *
+     * Exporters often write the same mesh as separate nodes instead of using the
+     * instance list. Nodes are keyed by a hash of their quantization parameters
+     * and compressed vertex, normal and index arrays; on a hash match the arrays
+     * are compared byte for byte, so a collision never merges different meshes.
+     *
+     * Entries reference the nodes' arrays in place, so the cache must not
+     * outlive the LmbMappedFile they were decoded from, unless it is created with
+     * copyPayload (nodes decoded from .lmbz block ranges that are freed as soon as
+     * their nodes are built). Thread-safe.
+     */
+    class LmbGeometryCache
+    {
+    public:
+        /**
+         * @param vertexBytes Bytes per vertex of the built geometry, used for the saved-bytes counter
+         * @param copyPayload Entries keep their own copy of the compared arrays
+         */
+        explicit LmbGeometryCache(uint32_t vertexBytes, bool copyPayload = false)
+            : vertexBytes_(vertexBytes), copyPayload_(copyPayload) {}
+
+        LmbGeometryCache(const LmbGeometryCache &) = delete;
+        LmbGeometryCache &operator=(const LmbGeometryCache &) = delete;
+
+        static uint64_t Hash(const Node &node);
+
+        /**
+         * @brief Levels previously stored for a node with the same payload
+         * @return false if there are none
+         */
+        bool find(const Node &node, uint64_t hash, MeshLevels &levels);
+
+        /**
+         * @brief Store the levels built for node
+         * @param levels In: the built levels; out: the levels to use, which are the stored
+         *               ones if another thread stored an identical mesh first
+         */
+        void insert(const Node &node, uint64_t hash, MeshLevels &levels);
+
+        size_t sharedMeshes() const { return sharedMeshes_; }
+        uint64_t sharedBytes() const { return sharedBytes_; }
+
+    private:
+        struct Entry
+        {
+            Vector3f baseVertex;
+            Vector3f vertexScale;
+            Span<int16_t> compressVertices;
+            Span<int32_t> normals;
+            IndexSpan indices;
+            MeshLevels levels;
+            std::vector<uint8_t> payload; // copyPayload 时三个数组的拷贝，上面的 Span 指向这里
+        };
+
+        static bool SamePayload(const Entry &entry, const Node &node);
+        // 调用方需持有 mutex_
+        const MeshLevels *lookup(const Node &node, uint64_t hash);
+
+        uint32_t vertexBytes_;
+        bool copyPayload_;
+        std::mutex mutex_;
+        std::unordered_multimap<uint64_t, Entry> entries_;
+        size_t sharedMeshes_ = 0;
+        uint64_t sharedBytes_ = 0;
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBGEOMETRYCACHE_H
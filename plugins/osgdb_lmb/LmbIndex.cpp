@@ -0,0 +1,154 @@
+#include "LmbIndex.h"
+#include "LmbTempFile.h"
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+namespace LmbPlugin
+{
+
+    namespace
+    {
+        const char Magic[4] = {'L', 'M', 'B', 'I'};
+        const uint32_t Version = 1;
+
+        bool SourceStamp(const std::string &lmbPath, uint64_t &fileSize, int64_t &modifiedTime)
+        {
+            std::error_code ec;
+            const std::filesystem::path path(lmbPath);
+            fileSize = std::filesystem::file_size(path, ec);
+            if (ec)
+                return false;
+            const auto mtime = std::filesystem::last_write_time(path, ec);
+            if (ec)
+                return false;
+            modifiedTime = static_cast<int64_t>(mtime.time_since_epoch().count());
+            return true;
+        }
+
+        template <typename T>
+        bool ReadValue(std::istream &in, T &value)
+        {
+            return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+        }
+
+        template <typename T>
+        void WriteValue(std::ostream &out, const T &value)
+        {
+            out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+    }
+
+    std::string LmbIndex::PathFor(const std::string &lmbPath)
+    {
+        return lmbPath + "i";
+    }
+
+    bool LmbIndex::Load(const std::string &lmbPath, std::vector<LmbIndexEntry> &entries, uint64_t dataSize)
+    {
+        uint64_t fileSize;
+        int64_t modifiedTime;
+        if (!SourceStamp(lmbPath, fileSize, modifiedTime))
+            return false;
+        if (dataSize == 0)
+            dataSize = fileSize;
+
+        std::ifstream in(PathFor(lmbPath), std::ios::binary);
+        if (!in)
+            return false;
+
+        char magic[4];
+        uint32_t version, nodeCount;
+        uint64_t indexedSize;
+        int64_t indexedTime;
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(Magic)) != 0 ||
+            !ReadValue(in, version) || version != Version ||
+            !ReadValue(in, indexedSize) || !ReadValue(in, indexedTime) || !ReadValue(in, nodeCount))
+            return false;
+
+        // 源文件被修改过则索引作废
+        if (indexedSize != fileSize || indexedTime != modifiedTime)
+        {
+            PluginLogger::logDebug("LMB", "Ignoring stale node index for " + lmbPath);
+            return false;
+        }
+
+        std::vector<LmbIndexEntry> loaded;
+        loaded.reserve(std::min<uint32_t>(nodeCount, 1u << 20));
+        for (uint32_t i = 0; i < nodeCount; ++i)
+        {
+            LmbIndexEntry entry;
+            float bounds[6];
+            uint16_t nameLength;
+            if (!ReadValue(in, entry.record.offset) || !ReadValue(in, entry.record.byteSize) ||
+                !ReadValue(in, entry.record.vertexCount) || !ReadValue(in, entry.record.indexCount) ||
+                !ReadValue(in, entry.record.instanceCount) || !ReadValue(in, bounds) || !ReadValue(in, nameLength))
+                return false;
+            if (entry.record.offset + entry.record.byteSize > dataSize)
+                return false;
+            entry.name.resize(nameLength);
+            if (nameLength > 0 && !in.read(&entry.name[0], nameLength))
+                return false;
+            entry.bounds.set(bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]);
+            loaded.push_back(std::move(entry));
+        }
+
+        entries.swap(loaded);
+        return true;
+    }
+
+    bool LmbIndex::Save(const std::string &lmbPath, const std::vector<LmbIndexEntry> &entries)
+    {
+        uint64_t fileSize;
+        int64_t modifiedTime;
+        if (!SourceStamp(lmbPath, fileSize, modifiedTime))
+            return false;
+
+        // 先写临时文件再改名，避免并发加载读到写了一半的索引；多个进程/线程可能同时重建同一索引
+        const std::string indexPath = PathFor(lmbPath);
+        const std::string tempPath = LmbTempFile::PathFor(indexPath);
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out)
+                return false;
+
+            out.write(Magic, sizeof(Magic));
+            WriteValue(out, Version);
+            WriteValue(out, fileSize);
+            WriteValue(out, modifiedTime);
+            WriteValue(out, static_cast<uint32_t>(entries.size()));
+            for (const LmbIndexEntry &entry : entries)
+            {
+                const osg::BoundingBox &b = entry.bounds;
+                const float bounds[6] = {b.xMin(), b.yMin(), b.zMin(), b.xMax(), b.yMax(), b.zMax()};
+                const uint16_t nameLength = static_cast<uint16_t>(std::min<size_t>(entry.name.size(), 0xFFFF));
+                WriteValue(out, entry.record.offset);
+                WriteValue(out, entry.record.byteSize);
+                WriteValue(out, entry.record.vertexCount);
+                WriteValue(out, entry.record.indexCount);
+                WriteValue(out, entry.record.instanceCount);
+                WriteValue(out, bounds);
+                WriteValue(out, nameLength);
+                out.write(entry.name.data(), nameLength);
+            }
+            if (!out)
+            {
+                out.close();
+                std::error_code ec;
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, indexPath, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+} // namespace LmbPlugin
@@ -0,0 +1,49 @@
+#ifndef LMBINDEX_H
+#define LMBINDEX_H
+
+#include "LmbParser.h"
+#include <string>
+#include <vector>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Sidecar node index (<file>.lmbi) for random access into an LMB file
+     *
+     * LMB has no table of contents, so the index records, per node, the byte
+     * range found by the offset scan, the effective node name and the world
+     * AABB over the node and all of its instances. It is tied to the source
+     * file by size and modification time and silently ignored once stale.
+     *
+     * Binary layout (little-endian): "LMBI", u32 version, u64 file size,
+     * i64 mtime, u32 node count, then per node: u64 offset, u64 byte size,
+     * u32 vertex / index / instance count, 6 floats AABB (min, max),
+     * u16 name length, name bytes.
+     */
+    class LmbIndex
+    {
+    public:
+        /**
+         * @brief Sidecar path for an LMB file ("model.lmb" -> "model.lmbi")
+         */
+        static std::string PathFor(const std::string &lmbPath);
+
+        /**
+         * @brief Read the sidecar index of lmbPath
+         * @param dataSize Size of the decoded LMB data the record offsets refer to, 0 = the file's
+         *                 size (they differ for .lmbz files, whose index stores decompressed offsets)
+         * @return false if it is missing, unreadable or does not match the file's size/mtime
+         */
+        static bool Load(const std::string &lmbPath, std::vector<LmbIndexEntry> &entries, uint64_t dataSize = 0);
+
+        /**
+         * @brief Write the sidecar index next to lmbPath (via a temporary file and rename)
+         * @return false if the directory is not writable; callers treat this as non-fatal
+         */
+        static bool Save(const std::string &lmbPath, const std::vector<LmbIndexEntry> &entries);
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBINDEX_H
@@ -0,0 +1,132 @@
+#include "LmbInstancing.h"
+#include <osg/Image>
+#include <osg/Texture>
+#include <osg/TextureBuffer>
+#include <osg/Uniform>
+#include <osg/UserDataContainer>
+#include <cstring>
+
+namespace LmbPlugin
+{
+
+    const char *const LmbInstancing::InstanceMatricesName = "LmbInstanceMatrices";
+    const char *const LmbInstancing::InstanceColorsName = "LmbInstanceColors";
+    const char *const LmbInstancing::PaletteName = "LmbPalette";
+
+    namespace
+    {
+        // 每个实例 4 个 RGBA32F texel：矩阵的三列（x' = dot(c0, v) ...）+ (颜色下标, 0, 0, 0)
+        const unsigned int TexelsPerInstance = 4;
+        const int InstanceDataUnit = 0;
+        const int PaletteUnit = 1;
+
+        osg::ref_ptr<osg::TextureBuffer> CreateFloatBuffer(const std::vector<float> &texels)
+        {
+            const int texelCount = static_cast<int>(texels.size() / 4);
+            osg::ref_ptr<osg::Image> image = new osg::Image;
+            image->allocateImage(texelCount, 1, 1, GL_RGBA, GL_FLOAT);
+            image->setInternalTextureFormat(GL_RGBA32F_ARB);
+            std::memcpy(image->data(), texels.data(), texels.size() * sizeof(float));
+
+            osg::ref_ptr<osg::TextureBuffer> buffer = new osg::TextureBuffer;
+            buffer->setBufferData(image.get());
+            buffer->setInternalFormat(GL_RGBA32F_ARB);
+            buffer->setTextureWidth(texelCount);
+            return buffer;
+        }
+    }
+
+    osg::ref_ptr<osg::StateSet> LmbInstancing::CreateSharedState(const std::vector<uint32_t> &colors, osg::Program *program)
+    {
+        // 调色板：每种颜色一个 texel，颜色表为空时放一个白色占位
+        std::vector<float> palette;
+        palette.reserve((colors.empty() ? 1 : colors.size()) * 4);
+        for (uint32_t color : colors)
+        {
+            palette.push_back(((color >> 16) & 0xFF) / 255.0f);
+            palette.push_back(((color >> 8) & 0xFF) / 255.0f);
+            palette.push_back((color & 0xFF) / 255.0f);
+            palette.push_back(1.0f);
+        }
+        if (palette.empty())
+            palette.assign(4, 1.0f);
+
+        osg::ref_ptr<osg::StateSet> stateSet = new osg::StateSet;
+        stateSet->setAttributeAndModes(program, osg::StateAttribute::ON);
+        stateSet->setTextureAttribute(PaletteUnit, CreateFloatBuffer(palette).get());
+        stateSet->addUniform(new osg::Uniform("lmbInstanceData", InstanceDataUnit));
+        stateSet->addUniform(new osg::Uniform("lmbPalette", PaletteUnit));
+        stateSet->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
+        stateSet->setMode(GL_BLEND, osg::StateAttribute::OFF);
+        stateSet->setRenderingHint(osg::StateSet::OPAQUE_BIN);
+
+        // 导出用：颜色表（0xRRGGBB）
+        osg::ref_ptr<osg::UIntArray> table = new osg::UIntArray(colors.begin(), colors.end());
+        table->setName(PaletteName);
+        stateSet->getOrCreateUserDataContainer()->addUserObject(table.get());
+        return stateSet;
+    }
+
+    osg::ref_ptr<osg::Geode> LmbInstancing::CreateInstancedGeode(osg::Geometry *geometry, const std::string &name,
+                                                                 const std::vector<osg::Matrixf> &matrices,
+                                                                 const std::vector<uint32_t> &colorIndices,
+                                                                 const std::vector<std::string> &instanceNames)
+    {
+        const size_t instanceCount = matrices.size();
+
+        std::vector<float> texels;
+        texels.reserve(instanceCount * TexelsPerInstance * 4);
+        for (size_t i = 0; i < instanceCount; ++i)
+        {
+            const osg::Matrixf &m = matrices[i];
+            for (int column = 0; column < 3; ++column)
+            {
+                texels.push_back(m(0, column));
+                texels.push_back(m(1, column));
+                texels.push_back(m(2, column));
+                texels.push_back(m(3, column));
+            }
+            texels.push_back(static_cast<float>(colorIndices[i]));
+            texels.push_back(0.0f);
+            texels.push_back(0.0f);
+            texels.push_back(0.0f);
+        }
+
+        // 一次绘制所有实例；显示列表不能记录实例化绘制
+        for (unsigned int i = 0; i < geometry->getNumPrimitiveSets(); ++i)
+            geometry->getPrimitiveSet(i)->setNumInstances(static_cast<int>(instanceCount));
+        geometry->setUseDisplayList(false);
+        geometry->setUseVertexBufferObjects(true);
+
+        // 包围盒必须覆盖全部实例，否则视锥裁剪会按原点处的单份几何剔除
+        const osg::BoundingBox localBox = geometry->getBoundingBox();
+        osg::BoundingBox instancesBox;
+        for (const osg::Matrixf &m : matrices)
+        {
+            for (unsigned int corner = 0; corner < 8; ++corner)
+                instancesBox.expandBy(localBox.corner(corner) * m);
+        }
+        geometry->setInitialBound(instancesBox);
+        geometry->dirtyBound();
+
+        osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+        geode->setName(name);
+        geode->addDrawable(geometry);
+        osg::StateSet *stateSet = geode->getOrCreateStateSet();
+        stateSet->setDefine("LMB_INSTANCED");
+        stateSet->setTextureAttribute(InstanceDataUnit, CreateFloatBuffer(texels).get());
+
+        // 拾取用：实例矩阵与名称
+        osg::ref_ptr<osg::MatrixfArray> pickMatrices = new osg::MatrixfArray(matrices.begin(), matrices.end());
+        pickMatrices->setName(InstanceMatricesName);
+        geode->getOrCreateUserDataContainer()->addUserObject(pickMatrices.get());
+        geode->setDescriptions(instanceNames);
+
+        // 导出用：实例的颜色下标
+        osg::ref_ptr<osg::UIntArray> instanceColors = new osg::UIntArray(colorIndices.begin(), colorIndices.end());
+        instanceColors->setName(InstanceColorsName);
+        geode->getUserDataContainer()->addUserObject(instanceColors.get());
+        return geode;
+    }
+
+} // namespace LmbPlugin
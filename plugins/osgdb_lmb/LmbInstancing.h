@@ -0,0 +1,60 @@
+#ifndef LMBINSTANCING_H
+#define LMBINSTANCING_H
+
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Matrix>
+#include <osg/Program>
+#include <osg/StateSet>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Hardware instancing for LMB nodes that carry an Instance list
+     *
+     * The node and all of its instances are drawn with a single
+     * glDrawElementsInstanced call. Per-instance 3x4 transforms and color
+     * indices live in a texture buffer, the palette in a second one, and the
+     * LmbShaders program (LMB_INSTANCED variant) applies them.
+     *
+     * For picking, the instanced Geode keeps the per-instance matrices as an
+     * osg::MatrixfArray user object named InstanceMatricesName and the
+     * instance names as node descriptions (same order, instance 0 is the node itself).
+     * For export, it also keeps the color indices as an osg::UIntArray named
+     * InstanceColorsName; the shared state keeps the color table as PaletteName.
+     */
+    class LmbInstancing
+    {
+    public:
+        static const char *const InstanceMatricesName;
+        static const char *const InstanceColorsName;
+        static const char *const PaletteName;
+
+        /**
+         * @brief State shared by every instanced node: program, palette buffer and sampler uniforms
+         * @param colors LMB color table (0xRRGGBB)
+         * @param program Program from LmbShaders::CreateProgram()
+         */
+        static osg::ref_ptr<osg::StateSet> CreateSharedState(const std::vector<uint32_t> &colors, osg::Program *program);
+
+        /**
+         * @brief Wrap geometry into a Geode that draws it once per instance
+         * @param geometry Base geometry, switched to instanced draws in place
+         * @param name Geode name
+         * @param matrices Per-instance transforms (relative to the scene transform)
+         * @param colorIndices Per-instance color table indices
+         * @param instanceNames Per-instance names, stored for picking
+         */
+        static osg::ref_ptr<osg::Geode> CreateInstancedGeode(osg::Geometry *geometry, const std::string &name,
+                                                             const std::vector<osg::Matrixf> &matrices,
+                                                             const std::vector<uint32_t> &colorIndices,
+                                                             const std::vector<std::string> &instanceNames);
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBINSTANCING_H
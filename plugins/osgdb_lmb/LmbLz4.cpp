@@ -0,0 +1,181 @@
+#include "LmbLz4.h"
+#include <cstring>
+#include <vector>
+
+namespace LmbPlugin
+{
+
+    namespace
+    {
+        const size_t MinMatch = 4;
+        const size_t LastLiterals = 5;  // 块末尾至少 5 字节为字面量
+        const size_t MatchFindLimit = 12; // 最后一个匹配必须在距末尾 12 字节之前开始
+        const size_t MaxOffset = 65535;
+        const unsigned HashLog = 14;
+
+        inline uint32_t Read32(const uint8_t *p)
+        {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline uint32_t Hash(uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - HashLog);
+        }
+
+        // 长度 >= 15 时按 LZ4 规则追加 255 序列
+        inline uint8_t *WriteLength(uint8_t *op, size_t length)
+        {
+            for (; length >= 255; length -= 255)
+                *op++ = 255;
+            *op++ = static_cast<uint8_t>(length);
+            return op;
+        }
+
+        inline bool ReadLength(const uint8_t *&ip, const uint8_t *end, size_t &length)
+        {
+            uint8_t byte;
+            do
+            {
+                if (ip >= end)
+                    return false;
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        }
+
+        uint8_t *WriteSequence(uint8_t *op, const uint8_t *literals, size_t literalLength, size_t offset, size_t matchLength)
+        {
+            uint8_t *token = op++;
+            *token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+            if (literalLength >= 15)
+                op = WriteLength(op, literalLength - 15);
+            if (literalLength > 0)
+                std::memcpy(op, literals, literalLength);
+            op += literalLength;
+            if (matchLength == 0)
+                return op; // 最后一个序列只有字面量
+            *op++ = static_cast<uint8_t>(offset);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+            const size_t length = matchLength - MinMatch;
+            *token |= static_cast<uint8_t>(length >= 15 ? 15 : length);
+            if (length >= 15)
+                op = WriteLength(op, length - 15);
+            return op;
+        }
+    }
+
+    size_t LmbLz4::CompressBound(size_t size)
+    {
+        return size + size / 255 + 16;
+    }
+
+    size_t LmbLz4::Compress(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity)
+    {
+        if (capacity < CompressBound(size))
+            return 0;
+
+        uint8_t *op = dst;
+        size_t anchor = 0;
+        if (size > MatchFindLimit)
+        {
+            // 表中存 位置 + 1，0 表示空
+            std::vector<uint32_t> table(size_t(1) << HashLog, 0);
+            const size_t matchLimit = size - LastLiterals;
+            const size_t findLimit = size - MatchFindLimit;
+            size_t ip = 0;
+            while (ip < findLimit)
+            {
+                const uint32_t sequence = Read32(src + ip);
+                const uint32_t h = Hash(sequence);
+                const size_t candidate = table[h];
+                table[h] = static_cast<uint32_t>(ip + 1);
+                if (candidate == 0 || ip - (candidate - 1) > MaxOffset || Read32(src + candidate - 1) != sequence)
+                {
+                    // 长时间没有匹配时加大步长，不可压缩数据也能快速通过
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+
+                size_t ref = candidate - 1;
+                size_t start = ip;
+                // 向前扩展到上一个序列末尾
+                while (start > anchor && ref > 0 && src[start - 1] == src[ref - 1])
+                {
+                    --start;
+                    --ref;
+                }
+                size_t end = ip + MinMatch;
+                size_t refEnd = ref + (end - start);
+                while (end < matchLimit && src[end] == src[refEnd])
+                {
+                    ++end;
+                    ++refEnd;
+                }
+
+                op = WriteSequence(op, src + anchor, start - anchor, start - ref, end - start);
+                anchor = end;
+                ip = end;
+                if (ip >= 2 && ip < findLimit)
+                    table[Hash(Read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2 + 1);
+            }
+        }
+        op = WriteSequence(op, src + anchor, size - anchor, 0, 0);
+        return static_cast<size_t>(op - dst);
+    }
+
+    bool LmbLz4::Decompress(const uint8_t *src, size_t size, uint8_t *dst, size_t rawSize)
+    {
+        const uint8_t *ip = src;
+        const uint8_t *const iend = src + size;
+        uint8_t *op = dst;
+        uint8_t *const oend = dst + rawSize;
+
+        while (ip < iend)
+        {
+            const uint8_t token = *ip++;
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !ReadLength(ip, iend, literalLength))
+                return false;
+            if (literalLength > size_t(iend - ip) || literalLength > size_t(oend - op))
+                return false;
+            if (literalLength > 0)
+                std::memcpy(op, ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+            if (ip == iend)
+                break; // 最后一个序列
+
+            if (iend - ip < 2)
+                return false;
+            const size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > size_t(op - dst))
+                return false;
+            size_t matchLength = token & 15;
+            if (matchLength == 15 && !ReadLength(ip, iend, matchLength))
+                return false;
+            matchLength += MinMatch;
+            if (matchLength > size_t(oend - op))
+                return false;
+
+            const uint8_t *match = op - offset;
+            if (offset >= matchLength)
+            {
+                std::memcpy(op, match, matchLength);
+                op += matchLength;
+            }
+            else
+            {
+                // 重叠拷贝（游程）必须逐字节进行
+                for (size_t i = 0; i < matchLength; ++i)
+                    *op++ = *match++;
+            }
+        }
+        return op == oend;
+    }
+
+} // namespace LmbPlugin
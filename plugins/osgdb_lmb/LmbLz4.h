@@ -0,0 +1,41 @@
+#ifndef LMBLZ4_H
+#define LMBLZ4_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Self-contained codec for the LZ4 block format, used by .lmbz containers
+     *
+     * Blocks are bit-compatible with LZ4_compress_default / LZ4_decompress_safe,
+     * so external lz4 tooling can inspect them. The compressor is the greedy
+     * single-hash variant (fast, roughly lz4 level 1); the decompressor
+     * bounds-checks every read and write and never trusts the input.
+     */
+    class LmbLz4
+    {
+    public:
+        /**
+         * @brief Worst-case compressed size of size input bytes
+         */
+        static size_t CompressBound(size_t size);
+
+        /**
+         * @brief Compress src into dst
+         * @return Compressed size, or 0 if dst is smaller than needed
+         */
+        static size_t Compress(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity);
+
+        /**
+         * @brief Decompress a block of exactly rawSize bytes
+         * @return false on malformed input or size mismatch
+         */
+        static bool Decompress(const uint8_t *src, size_t size, uint8_t *dst, size_t rawSize);
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBLZ4_H
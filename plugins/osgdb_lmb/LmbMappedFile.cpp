@@ -0,0 +1,207 @@
+#include "LmbMappedFile.h"
+#include <algorithm>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace LmbPlugin
+{
+
+    namespace
+    {
+        uint64_t PageSize()
+        {
+#ifdef _WIN32
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return info.dwPageSize;
+#else
+            return static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+        }
+    }
+
+    LmbMappedFile::~LmbMappedFile()
+    {
+        close();
+    }
+
+#ifdef _WIN32
+
+    bool LmbMappedFile::open(const std::string &filepath)
+    {
+        close();
+
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        fileHandle_ = file;
+        mappingHandle_ = mapping;
+        data_ = static_cast<const uint8_t *>(view);
+        size_ = static_cast<uint64_t>(fileSize.QuadPart);
+        return true;
+    }
+
+    bool LmbMappedFile::allocate(uint64_t size)
+    {
+        close();
+        if (size == 0)
+            return false;
+
+        void *view = VirtualAlloc(nullptr, static_cast<SIZE_T>(size), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (!view)
+            return false;
+
+        data_ = static_cast<const uint8_t *>(view);
+        size_ = size;
+        anonymous_ = true;
+        return true;
+    }
+
+    void LmbMappedFile::close()
+    {
+        if (data_ && anonymous_)
+            VirtualFree(const_cast<uint8_t *>(data_), 0, MEM_RELEASE);
+        else if (data_)
+            UnmapViewOfFile(data_);
+        if (mappingHandle_)
+            CloseHandle(static_cast<HANDLE>(mappingHandle_));
+        if (fileHandle_)
+            CloseHandle(static_cast<HANDLE>(fileHandle_));
+        data_ = nullptr;
+        size_ = 0;
+        anonymous_ = false;
+        mappingHandle_ = nullptr;
+        fileHandle_ = nullptr;
+    }
+
+#else
+
+    bool LmbMappedFile::open(const std::string &filepath)
+    {
+        close();
+
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        void *view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // 映射建立后即可关闭文件描述符
+        ::close(fd);
+        if (view == MAP_FAILED)
+            return false;
+
+        madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+        data_ = static_cast<const uint8_t *>(view);
+        size_ = static_cast<uint64_t>(st.st_size);
+        return true;
+    }
+
+    bool LmbMappedFile::allocate(uint64_t size)
+    {
+        close();
+        if (size == 0)
+            return false;
+
+        void *view = mmap(nullptr, static_cast<size_t>(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (view == MAP_FAILED)
+            return false;
+
+        data_ = static_cast<const uint8_t *>(view);
+        size_ = size;
+        anonymous_ = true;
+        return true;
+    }
+
+    void LmbMappedFile::close()
+    {
+        if (data_)
+            munmap(const_cast<uint8_t *>(data_), static_cast<size_t>(size_));
+        data_ = nullptr;
+        size_ = 0;
+        anonymous_ = false;
+    }
+
+#endif
+
+    void LmbMappedFile::swap(LmbMappedFile &other)
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(anonymous_, other.anonymous_);
+#ifdef _WIN32
+        std::swap(fileHandle_, other.fileHandle_);
+        std::swap(mappingHandle_, other.mappingHandle_);
+#endif
+    }
+
+    void LmbMappedFile::release(uint64_t offset, uint64_t size) const
+    {
+        // 匿名内存丢弃后会变成零页而不是重新读取，不能按节点释放；.lmbz 的解压块由调用方按组整体释放
+        if (!data_ || anonymous_ || offset >= size_)
+            return;
+        size = std::min(size, size_ - offset);
+
+        // 只释放完全落在区间内的页，相邻节点共享的边界页保留
+        static const uint64_t pageSize = PageSize();
+        const uint64_t base = reinterpret_cast<uintptr_t>(data_);
+        const uint64_t begin = (base + offset + pageSize - 1) / pageSize * pageSize;
+        const uint64_t end = (base + offset + size) / pageSize * pageSize;
+        if (end <= begin)
+            return;
+
+#ifdef _WIN32
+        // 对未锁定的页调用 VirtualUnlock 会把它们移出工作集（只读文件映射，无需写回）
+        VirtualUnlock(reinterpret_cast<void *>(static_cast<uintptr_t>(begin)), static_cast<SIZE_T>(end - begin));
+#else
+        // 只读私有映射从未写入，丢弃后再次访问会从文件重新读取
+        madvise(reinterpret_cast<void *>(static_cast<uintptr_t>(begin)), static_cast<size_t>(end - begin), MADV_DONTNEED);
+#endif
+    }
+
+} // namespace LmbPlugin
@@ -0,0 +1,225 @@
+#ifndef LMBMAPPEDFILE_H
+#define LMBMAPPEDFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Read-only view over a contiguous run of elements
+     *
+     * Points into memory owned by someone else (normally the mapped LMB file),
+     * so it must not outlive the LmbMappedFile it was handed out from.
+     */
+    template <typename T>
+    class Span
+    {
+    public:
+        Span() = default;
+        Span(const T *data, size_t size) : data_(data), size_(size) {}
+
+        const T *data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const T *begin() const { return data_; }
+        const T *end() const { return data_ + size_; }
+        const T &operator[](size_t i) const { return data_[i]; }
+
+    private:
+        const T *data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    /**
+     * @brief Index buffer view that keeps the on-disk index width (1, 2 or 4 bytes)
+     */
+    class IndexSpan
+    {
+    public:
+        IndexSpan() = default;
+        IndexSpan(const void *data, size_t size, uint32_t width) : data_(data), size_(size), width_(width) {}
+
+        const void *data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        uint32_t width() const { return width_; }
+
+        uint32_t operator[](size_t i) const
+        {
+            switch (width_)
+            {
+            case 1:
+                return static_cast<const uint8_t *>(data_)[i];
+            case 2:
+                return static_cast<const uint16_t *>(data_)[i];
+            default:
+                return static_cast<const uint32_t *>(data_)[i];
+            }
+        }
+
+    private:
+        const void *data_ = nullptr;
+        size_t size_ = 0;
+        uint32_t width_ = 4;
+    };
+
+    /**
+     * @brief Read-only memory mapping of a whole file (mmap / MapViewOfFile)
+     *
+     * Can instead hold an anonymous image (allocate) that the caller fills in,
+     * e.g. a decompressed .lmbz file; spans are handed out the same way.
+     */
+    class LmbMappedFile
+    {
+    public:
+        LmbMappedFile() = default;
+        ~LmbMappedFile();
+
+        LmbMappedFile(const LmbMappedFile &) = delete;
+        LmbMappedFile &operator=(const LmbMappedFile &) = delete;
+
+        /**
+         * @brief Map the file into memory
+         * @param filepath File path
+         * @return true on success
+         */
+        bool open(const std::string &filepath);
+
+        /**
+         * @brief Replace the mapping with size bytes of zeroed anonymous memory
+         * @return true on success; fill the image through mutableData()
+         */
+        bool allocate(uint64_t size);
+
+        /**
+         * @brief Unmap the file; all spans handed out become invalid
+         */
+        void close();
+
+        /**
+         * @brief Drop the resident pages fully inside [offset, offset + size)
+         *
+         * The mapping stays valid; touching the range again re-reads it from the
+         * file. Used to free a node's raw data as soon as its geometry is built.
+         * No-op for anonymous images, whose pages have no backing file.
+         */
+        void release(uint64_t offset, uint64_t size) const;
+
+        /**
+         * @brief Exchange mappings; spans stay valid and follow their memory
+         */
+        void swap(LmbMappedFile &other);
+
+        bool isOpen() const { return data_ != nullptr; }
+        bool isAnonymous() const { return anonymous_; }
+        const uint8_t *data() const { return data_; }
+        uint8_t *mutableData() { return anonymous_ ? const_cast<uint8_t *>(data_) : nullptr; }
+        uint64_t size() const { return size_; }
+
+    private:
+        const uint8_t *data_ = nullptr;
+        uint64_t size_ = 0;
+        bool anonymous_ = false;
+#ifdef _WIN32
+        void *fileHandle_ = nullptr;
+        void *mappingHandle_ = nullptr;
+#endif
+    };
+
+    /**
+     * @brief Bounds-checked forward cursor over a byte range
+     *
+     * Positions are 64-bit absolute file offsets (origin + local offset) so that
+     * 4-byte alignment is computed the same way the LMB writer laid the file out.
+     * Any read past the end leaves the cursor in a failed state and returns false.
+     */
+    class ByteCursor
+    {
+    public:
+        ByteCursor(const uint8_t *data, uint64_t size, uint64_t origin = 0)
+            : data_(data), size_(size), origin_(origin) {}
+
+        template <typename T>
+        bool read(T &value)
+        {
+            if (!ensure(sizeof(T)))
+                return false;
+            std::memcpy(&value, data_ + pos_, sizeof(T));
+            pos_ += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        bool readSpan(uint64_t count, Span<T> &out)
+        {
+            const uint64_t bytes = count * sizeof(T);
+            if (!ensure(bytes))
+                return false;
+            out = Span<T>(reinterpret_cast<const T *>(data_ + pos_), static_cast<size_t>(count));
+            pos_ += bytes;
+            return true;
+        }
+
+        bool readIndices(uint64_t count, uint32_t width, IndexSpan &out)
+        {
+            const uint64_t bytes = count * width;
+            if (!ensure(bytes))
+                return false;
+            out = IndexSpan(data_ + pos_, static_cast<size_t>(count), width);
+            pos_ += bytes;
+            return true;
+        }
+
+        bool readString(uint64_t length, std::string_view &out)
+        {
+            if (!ensure(length))
+                return false;
+            out = std::string_view(reinterpret_cast<const char *>(data_ + pos_), static_cast<size_t>(length));
+            pos_ += length;
+            return true;
+        }
+
+        bool skip(uint64_t bytes)
+        {
+            if (!ensure(bytes))
+                return false;
+            pos_ += bytes;
+            return true;
+        }
+
+        bool alignTo4()
+        {
+            const uint64_t padding = (4 - (position() % 4)) % 4;
+            return padding == 0 || skip(padding);
+        }
+
+        uint64_t position() const { return origin_ + pos_; }
+        uint64_t remaining() const { return size_ - pos_; }
+        bool good() const { return !failed_; }
+
+    private:
+        bool ensure(uint64_t bytes)
+        {
+            if (failed_ || bytes > size_ - pos_)
+            {
+                failed_ = true;
+                return false;
+            }
+            return true;
+        }
+
+        const uint8_t *data_;
+        uint64_t size_;
+        uint64_t origin_;
+        uint64_t pos_ = 0;
+        bool failed_ = false;
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBMAPPEDFILE_H
@@ -0,0 +1,69 @@
+#include "LmbMemory.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+
+namespace LmbPlugin
+{
+
+#ifdef _WIN32
+
+    uint64_t LmbMemory::residentBytes()
+    {
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+            return 0;
+        return static_cast<uint64_t>(pmc.WorkingSetSize);
+    }
+
+    uint64_t LmbMemory::peakResidentBytes()
+    {
+        PROCESS_MEMORY_COUNTERS pmc;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+            return 0;
+        return static_cast<uint64_t>(pmc.PeakWorkingSetSize);
+    }
+
+#else
+
+    uint64_t LmbMemory::residentBytes()
+    {
+        // /proc/self/statm 第二列为常驻页数（仅 Linux）
+        FILE *statm = std::fopen("/proc/self/statm", "r");
+        if (!statm)
+            return 0;
+        unsigned long long totalPages = 0, residentPages = 0;
+        const int fields = std::fscanf(statm, "%llu %llu", &totalPages, &residentPages);
+        std::fclose(statm);
+        if (fields != 2)
+            return 0;
+        return static_cast<uint64_t>(residentPages) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    uint64_t LmbMemory::peakResidentBytes()
+    {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#ifdef __APPLE__
+        return static_cast<uint64_t>(usage.ru_maxrss); // macOS 以字节计
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024; // Linux 以 KB 计
+#endif
+    }
+
+#endif
+
+} // namespace LmbPlugin
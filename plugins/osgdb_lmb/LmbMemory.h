@@ -0,0 +1,30 @@
+#ifndef LMBMEMORY_H
+#define LMBMEMORY_H
+
+#include <cstdint>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Process memory counters used for the LMB load summary
+     *
+     * Both values are 0 where the platform does not expose them.
+     */
+    class LmbMemory
+    {
+    public:
+        /**
+         * @brief Current resident set / working set size in bytes
+         */
+        static uint64_t residentBytes();
+
+        /**
+         * @brief Peak resident set / working set size of the process in bytes
+         */
+        static uint64_t peakResidentBytes();
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBMEMORY_H
@@ -0,0 +1,148 @@
+#include "LmbPaging.h"
+#include <osg/PagedLOD>
+#include <osg/NodeVisitor>
+#include <algorithm>
+#include <cfloat>
+#include <cstdlib>
+
+namespace LmbPlugin
+{
+
+    const char *const LmbPaging::PageExtension = "lmbpage";
+
+    namespace
+    {
+        // 每个叶子簇最多包含的 PagedLOD 数
+        const size_t ClusterLeafSize = 64;
+
+        struct PagedItem
+        {
+            osg::ref_ptr<osg::PagedLOD> lod;
+            osg::Vec3 center;
+        };
+
+        // 按中心点在最长轴上取中位数二分，生成层次包围体
+        osg::ref_ptr<osg::Group> BuildCluster(std::vector<PagedItem> &items, size_t begin, size_t end)
+        {
+            osg::ref_ptr<osg::Group> group = new osg::Group;
+            group->setName("LmbCluster");
+            if (end - begin <= ClusterLeafSize)
+            {
+                for (size_t i = begin; i < end; ++i)
+                    group->addChild(items[i].lod.get());
+                return group;
+            }
+
+            osg::BoundingBox centers;
+            for (size_t i = begin; i < end; ++i)
+                centers.expandBy(items[i].center);
+            const osg::Vec3 extent = centers._max - centers._min;
+            const int axis = extent.x() >= extent.y() && extent.x() >= extent.z() ? 0 : (extent.y() >= extent.z() ? 1 : 2);
+
+            const size_t middle = begin + (end - begin) / 2;
+            std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end,
+                             [axis](const PagedItem &a, const PagedItem &b)
+                             { return a.center[axis] < b.center[axis]; });
+            group->addChild(BuildCluster(items, begin, middle).get());
+            group->addChild(BuildCluster(items, middle, end).get());
+            return group;
+        }
+
+        // 去掉子图中节点上的 StateSet 引用；分页几何自身不带状态
+        class StateSetDetacher : public osg::NodeVisitor
+        {
+        public:
+            StateSetDetacher() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+            void apply(osg::Node &node) override
+            {
+                node.setStateSet(nullptr);
+                traverse(node);
+            }
+
+            void apply(osg::Drawable &) override {}
+        };
+    }
+
+    LmbPage::~LmbPage()
+    {
+        // 子节点在本函数返回后才析构，届时已不再引用共享状态
+        std::lock_guard<std::mutex> lock(context_->attachMutex);
+        StateSetDetacher detacher;
+        for (unsigned int i = 0; i < getNumChildren(); ++i)
+            getChild(i)->accept(detacher);
+    }
+
+    osg::ref_ptr<osg::Group> LmbPaging::CreatePagedScene(const std::vector<LmbIndexEntry> &entries,
+                                                         const std::vector<size_t> &selected,
+                                                         const Vector3f &scenePosition,
+                                                         LmbPagedContext *context)
+    {
+        // 所有 PagedLOD 共用一个 Options，分页请求经由其 user data 取回上下文
+        osg::ref_ptr<osgDB::Options> pageOptions = new osgDB::Options;
+        pageOptions->setUserData(context);
+        pageOptions->setObjectCacheHint(osgDB::Options::CACHE_NONE);
+
+        const osg::Vec3 sceneOffset(scenePosition.x, scenePosition.y, scenePosition.z);
+        std::vector<PagedItem> items;
+        items.reserve(selected.size());
+        for (size_t nodeIndex : selected)
+        {
+            const LmbIndexEntry &entry = entries[nodeIndex];
+            // 索引中的包围盒含场景平移，PagedLOD 位于 SceneTransform 之下
+            const osg::Vec3 center = entry.bounds.center() - sceneOffset;
+
+            osg::ref_ptr<osg::PagedLOD> lod = new osg::PagedLOD;
+            lod->setName(entry.name);
+            lod->setCenterMode(osg::LOD::USER_DEFINED_CENTER);
+            lod->setCenter(center);
+            lod->setRadius(entry.bounds.radius());
+            lod->setRangeMode(osg::LOD::PIXEL_SIZE_ON_SCREEN);
+            lod->setFileName(0, std::to_string(nodeIndex) + "." + PageExtension);
+            lod->setRange(0, context->options.pagedMinPixels, FLT_MAX);
+            lod->setDatabaseOptions(pageOptions.get());
+
+            PagedItem item;
+            item.lod = lod;
+            item.center = center;
+            items.push_back(item);
+        }
+
+        osg::ref_ptr<osg::Group> root = BuildCluster(items, 0, items.size());
+        root->setName("LmbPagedNodes");
+        return root;
+    }
+
+    bool LmbPaging::ParsePageFileName(const std::string &fileName, size_t &nodeIndex)
+    {
+        // 去掉可能被加上的数据库路径
+        const size_t slash = fileName.find_last_of("/\\");
+        const std::string simpleName = slash == std::string::npos ? fileName : fileName.substr(slash + 1);
+        const char *begin = simpleName.c_str();
+        char *end = nullptr;
+        const unsigned long long value = std::strtoull(begin, &end, 10);
+        if (end == begin || *end != '.')
+            return false;
+        nodeIndex = static_cast<size_t>(value);
+        return true;
+    }
+
+    unsigned LmbPaging::TargetPageCount(const std::vector<LmbIndexEntry> &entries, const LmbLoadOptions &options)
+    {
+        if (options.pagedBudgetMB == 0 || entries.empty())
+            return 0;
+
+        // 几何由节点与其实例共享，按每个节点一份顶点 + 索引估算
+        const uint64_t vertexBytes = options.gpuDequantization ? LmbParser::QuantizedVertexBytes : LmbParser::FloatVertexBytes;
+        uint64_t totalBytes = 0;
+        for (const LmbIndexEntry &entry : entries)
+        {
+            totalBytes += uint64_t(entry.record.vertexCount) * vertexBytes +
+                          uint64_t(entry.record.indexCount) * LmbParser::IndexWidth(entry.record.vertexCount);
+        }
+        const uint64_t averageBytes = std::max<uint64_t>(1, totalBytes / entries.size());
+        const uint64_t budgetBytes = uint64_t(options.pagedBudgetMB) << 20;
+        return static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(budgetBytes / averageBytes, 0x7FFFFFFF)));
+    }
+
+} // namespace LmbPlugin
@@ -0,0 +1,100 @@
+#ifndef LMBPAGING_H
+#define LMBPAGING_H
+
+#include "LmbParser.h"
+#include <osg/Group>
+#include <osg/Referenced>
+#include <osgDB/Options>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Per-file state shared by every page of a paged LMB scene
+     *
+     * Attached as user data to the osgDB::Options of all PagedLODs of one load,
+     * so DatabasePager requests can decode a node straight from the mapped file
+     * and reuse the scene's color states. Lives as long as the scene graph.
+     */
+    class LmbPagedContext : public osg::Referenced
+    {
+    public:
+        std::string filepath;
+        LmbLoadOptions options;
+        uint32_t colorCount = 0;
+        SceneStates states;
+        std::vector<NodeRecord> records;
+        LmbMappedFile file;      // 文件映射；compressed 时为 .lmbz 容器本身，记录偏移指向解压后的内容
+        bool compressed = false; // 每页只解压节点记录所在的块（LmbCompression::DecompressRange）
+        mutable std::mutex attachMutex; // 挂接与释放共享状态（修改其父节点列表）时串行化，见 LmbPage
+    };
+
+    /**
+     * @brief Root of one paged-in node, returned by LmbParser::loadPage
+     *
+     * Page subgraphs reference the scene-wide color and instancing StateSets.
+     * Attaching a StateSet and destroying a node that holds it both modify the
+     * StateSet's parent list, and OSG does not synchronize either. Pages are
+     * built on DatabasePager threads and destroyed on whichever thread releases
+     * them (a database thread or the update thread), so both happen under
+     * context.attachMutex: the destructor detaches all StateSets in the page
+     * while holding it, before the children are released.
+     */
+    class LmbPage : public osg::Group
+    {
+    public:
+        explicit LmbPage(const LmbPagedContext *context) : context_(context) {}
+
+    protected:
+        ~LmbPage() override;
+
+    private:
+        osg::ref_ptr<const LmbPagedContext> context_;
+    };
+
+    /**
+     * @brief View-dependent paging for large LMB files (the "paged" load option)
+     *
+     * Every selected node becomes an osg::PagedLOD whose center/radius come from
+     * the sidecar index and whose only child is the pseudo file "<n>.lmbpage".
+     * The DatabasePager loads it through ReaderWriterLMB once the node covers
+     * options.pagedMinPixels on screen and expires it when it leaves view.
+     * PagedLODs are grouped into a bounding volume hierarchy so culling skips
+     * whole clusters instead of visiting every node.
+     */
+    class LmbPaging
+    {
+    public:
+        static const char *const PageExtension; // "lmbpage"
+
+        /**
+         * @brief Build the PagedLOD hierarchy for the given index entries
+         * @param entries Sidecar index entries (world bounds include the scene position)
+         * @param selected Node indices to page in
+         * @param scenePosition Translation of the SceneTransform the result is added to
+         * @param context Shared context, referenced by the generated PagedLODs
+         */
+        static osg::ref_ptr<osg::Group> CreatePagedScene(const std::vector<LmbIndexEntry> &entries,
+                                                         const std::vector<size_t> &selected,
+                                                         const Vector3f &scenePosition,
+                                                         LmbPagedContext *context);
+
+        /**
+         * @brief Parse the node index out of a "<n>.lmbpage" file name
+         */
+        static bool ParsePageFileName(const std::string &fileName, size_t &nodeIndex);
+
+        /**
+         * @brief DatabasePager target for the number of resident pages, 0 = pager default
+         *
+         * Derived from options.pagedBudgetMB and the average per-node geometry size.
+         */
+        static unsigned TargetPageCount(const std::vector<LmbIndexEntry> &entries, const LmbLoadOptions &options);
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBPAGING_H
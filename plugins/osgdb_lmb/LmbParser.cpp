@@ -8,11 +8,30 @@
 #include <osg/Vec3>
 #include <osg/Vec4>
 #include <osg/MatrixTransform>
+#include <osg/LOD>
 #include <fstream>
 #include <iostream>
 #include <algorithm>
 #include <chrono>
 #include <filesystem>
+#include <unordered_map>
+#include <memory>
+#include <cstring>
+#include <cfloat>
+#include "LmbThreadPool.h"
+#include "LmbSimd.h"
+#include "LmbInstancing.h"
+#include "LmbShaders.h"
+#include "LmbStreamReader.h"
+#include "LmbMemory.h"
+#include "LmbIndex.h"
+#include "LmbPaging.h"
+#include "LmbBatching.h"
+#include "LmbGeometryCache.h"
+#include "LmbSimplify.h"
+#include "LmbArena.h"
+#include "LmbCompression.h"
+#include <osg/ValueObject>
 
 namespace LmbPlugin
 {
@@ -21,6 +40,9 @@ namespace LmbPlugin
     using Vec3Array = osg::Vec3Array;
     using DrawElementsUInt = osg::DrawElementsUInt;
 
+    const char *const LmbParser::PagedTargetCountName = "LmbPagedTargetCount";
+    const char *const LmbParser::ColorValueName = "LmbColor";
+
     osg::ref_ptr<osg::Group> LmbParser::parseFile(const std::string &filepath)
     {
         return parseFile(filepath, nullptr);
@@ -28,8 +50,17 @@ namespace LmbPlugin
 
     osg::ref_ptr<osg::Group> LmbParser::parseFile(const std::string &filepath,
                                                   std::function<void(const char *)> progressCb)
+    {
+        return parseFile(filepath, progressCb, LmbLoadOptions());
+    }
+
+    osg::ref_ptr<osg::Group> LmbParser::parseFile(const std::string &filepath,
+                                                  std::function<void(const char *)> progressCb,
+                                                  const LmbLoadOptions &options,
+                                                  LmbLoadStats *stats)
     {
         auto startTime = std::chrono::high_resolution_clock::now();
+        const uint64_t residentBefore = LmbMemory::residentBytes();
 
         try
         {
@@ -38,121 +69,409 @@ namespace LmbPlugin
 
             Vector3f scenePosition;
             std::vector<uint32_t> colors;
-            std::vector<Node> nodes;
+            std::vector<NodeRecord> records;
 
             PluginLogger::logFileLoadStart("LMB", filepath);
             if (progressCb)
                 progressCb("开始读取 LMB 文件...");
 
-            if (!ReadFile(filepath, scenePosition, colors, nodes, progressCb))
+            // 分阶段计时；设置了 trace 选项或环境变量时另外记录每个节点的事件
+            const std::string tracePath = LoadProfile::TracePath(options.tracePath, filepath);
+            osg::ref_ptr<LoadProfile> profile = new LoadProfile("LMB", filepath, !tracePath.empty());
+
+            // 映射整个文件，节点数组直接引用映射内存；构建完成前不能关闭
+            // .lmbz 保留压缩文件的映射：扫描逐块顺序解压，解码时各任务只解压自己一组节点所在的块，
+            // 节点构建完即释放，不生成整份解压镜像
+            LmbThreadPool pool(options.threadCount);
+            LmbMappedFile mappedFile;
             {
-                logError(LmbErrorType::CORRUPTED_DATA, "Failed to read LMB file data", filepath);
-                return nullptr;
+                LoadProfile::Scope scope(profile.get(), "map");
+                if (!mappedFile.open(filepath))
+                {
+                    logError(LmbErrorType::FILE_ACCESS_ERROR, "Cannot map file for reading", filepath);
+                    return nullptr;
+                }
+                scope.stage()->add(mappedFile.size(), 0, nullptr);
             }
+            const bool compressed = LmbCompression::IsCompressed(mappedFile.data(), mappedFile.size());
+            LmbCompression::BlockReader blockReader;
+            if (compressed)
+            {
+                std::string decompressError;
+                if (!blockReader.open(mappedFile, decompressError))
+                {
+                    logError(LmbErrorType::CORRUPTED_DATA, decompressError, filepath);
+                    return nullptr;
+                }
+            }
+            // 节点记录的偏移均指未压缩的 LMB 数据
+            const uint64_t dataSize = compressed ? blockReader.rawSize() : mappedFile.size();
 
-            // Validate loaded data
-            validateHeader(scenePosition, colors.size(), nodes.size());
-            validateColorData(colors, colors.size());
+            // 边车索引有效时直接取得节点记录与包围盒，跳过扫描
+            std::vector<LmbIndexEntry> indexEntries;
+            bool indexLoaded = false;
+            if (options.useIndex)
+            {
+                LoadProfile::Scope scope(profile.get(), "index");
+                indexLoaded = LmbIndex::Load(filepath, indexEntries, dataSize);
+                scope.stage()->add(0, indexEntries.size(), "nodes");
+            }
 
-            for (size_t i = 0; i < nodes.size(); ++i)
+            // 第一阶段：顺序扫描节点偏移（.lmbz 只解压含有文件头与节点头的块，跳过的数组所在的块不解压）
             {
-                validateNodeData(nodes[i], colors.size());
+                LoadProfile::Scope scope(profile.get(), "scan");
+                ByteCursor cursor(mappedFile.data(), mappedFile.size());
+                const std::vector<LmbIndexEntry> *index = indexLoaded ? &indexEntries : nullptr;
+                const bool scanned = compressed ? ReadFile(blockReader, filepath, scenePosition, colors, records, progressCb, index)
+                                                : ReadFile(cursor, filepath, scenePosition, colors, records, progressCb, index);
+                if (!scanned)
+                {
+                    logError(LmbErrorType::CORRUPTED_DATA,
+                             blockReader.corrupted() ? "Corrupted .lmbz block data" : "Failed to read LMB file data", filepath);
+                    return nullptr;
+                }
+                scope.stage()->add(0, records.size(), "nodes");
             }
+            const bool indexUsed = indexLoaded && indexEntries.size() == records.size();
+            if (indexUsed)
+                PluginLogger::logDebug("LMB", "Using node index " + LmbIndex::PathFor(filepath));
+            else
+                indexEntries.assign(records.size(), LmbIndexEntry());
 
-            // 创建根节点
-            osg::ref_ptr<osg::Group> root = new osg::Group;
-            root->setName("meshRoot");
+            // Validate loaded data
+            {
+                LoadProfile::Scope scope(profile.get(), "validate");
+                validateHeader(scenePosition, colors.size(), records.size());
+                validateColorData(colors, colors.size());
+            }
 
-            // 创建场景变换节点
-            osg::ref_ptr<osg::MatrixTransform> sceneTransform = new osg::MatrixTransform;
-            sceneTransform->setName("SceneTransform");
-            sceneTransform->setMatrix(osg::Matrix::translate(
-                scenePosition.x, scenePosition.y, scenePosition.z));
-            root->addChild(sceneTransform);
+            LmbLoadStats loadStats;
+            loadStats.residentBytesBefore = residentBefore;
+            osg::ref_ptr<osg::MatrixTransform> sceneTransform;
+            osg::ref_ptr<osg::Group> root;
+            SceneStates states;
+            {
+                LoadProfile::Scope scope(profile.get(), "states");
+                root = CreateSceneRoot(scenePosition, sceneTransform);
+                states = CreateSceneStates(colors, options, loadStats);
+                scope.stage()->add(0, loadStats.uniqueStateSets, "state sets");
+            }
 
-            // 设置场景状态
-            SetupSceneState(root);
+            // 有索引时按名称/包围盒预先筛选，只解码命中的节点；否则解码后再判断
+            std::vector<size_t> work;
+            work.reserve(records.size());
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                if (!indexUsed || !options.hasNodeFilter() ||
+                    IsSelected(options, indexEntries[i].name, i, indexEntries[i].bounds))
+                    work.push_back(i);
+            }
+            const bool computeEntries = !indexUsed && (options.useIndex || options.hasNodeFilter() || options.paged);
+            std::vector<char> selected(records.size(), 0);
+            if (indexUsed && options.paged)
+            {
+                // 分页模式只需要索引，几何由 DatabasePager 按需解码
+                for (size_t nodeIndex : work)
+                    selected[nodeIndex] = 1;
+                work.clear();
+            }
 
-            // 处理每个节点
-            const size_t totalNodes = nodes.size();
-            size_t nextReportBuild = 0;
-            for (size_t nodeIndex = 0; nodeIndex < totalNodes; ++nodeIndex)
+            // 第二阶段：多线程解码、校验并构建几何；结果按节点序号存放，保证子节点顺序确定
+            const size_t totalNodes = work.size();
+            std::vector<std::vector<BuiltNode>> builtNodes(records.size());
+            // 合批模式下非实例化节点先解码为合批部件，全部完成后再按颜色与空间合并
+            const bool batching = options.staticBatching && !options.paged;
+            if (options.staticBatching && options.paged)
+                PluginLogger::logWarning("LMB", "Static batching is ignored in paged mode");
+            std::vector<LmbBatchSource> batchSources(batching ? records.size() : 0);
+            std::vector<std::vector<LmbBatchPart>> batchParts(batching ? records.size() : 0);
+            // 去重条目引用映射内存中的数组，生命周期不超过 mappedFile；
+            // .lmbz 的解压块在每组节点构建后释放，条目改为保存数组的拷贝
+            std::unique_ptr<LmbGeometryCache> geometryCache;
+            if (options.deduplicate)
+                geometryCache.reset(new LmbGeometryCache(options.gpuDequantization ? QuantizedVertexBytes : FloatVertexBytes,
+                                                         compressed));
+            // 解码期的临时数据从各工作线程的 arena 分配：实例列表随节点复位，合批索引在合并后释放
+            LmbArena arena(pool.size());
+            PluginLogger::logDebug("LMB", "Decoding " + std::to_string(totalNodes) + " nodes on " +
+                                              std::to_string(pool.size()) + " threads (" +
+                                              LmbSimd::levelName(LmbSimd::activeLevel()) + " kernels)");
+
+            // 各工作线程分别累计解压/解码（含校验）/构建耗时，结束后合并到对应阶段
+            struct WorkerTimes
             {
-                const auto &node = nodes[nodeIndex];
+                LoadProfile::Clock::duration decompress{}, decode{}, build{};
+                uint64_t decompressedBytes = 0;
+                uint64_t bytes = 0;
+                uint64_t vertices = 0;
+            };
+            std::vector<WorkerTimes> workerTimes(pool.size());
+
+            // .lmbz 按节点起始所在的块分组，每组一个任务：解压覆盖该组记录的块，构建组内节点后即释放；
+            // 跨块的节点使下一组重复解压一个边界块，常驻的解压数据约为每个线程一组
+            struct BlockGroup
+            {
+                size_t begin = 0, end = 0; // work 中的下标范围
+                uint64_t offset = 0, size = 0;
+            };
+            std::vector<BlockGroup> blockGroups;
+            if (compressed)
+            {
+                uint64_t groupBlock = 0;
+                for (size_t w = 0; w < work.size(); ++w)
+                {
+                    const NodeRecord &record = records[work[w]];
+                    const uint64_t block = record.offset / blockReader.blockSize();
+                    if (blockGroups.empty() || block != groupBlock)
+                    {
+                        BlockGroup group;
+                        group.begin = w;
+                        group.offset = record.offset;
+                        blockGroups.push_back(group);
+                        groupBlock = block;
+                    }
+                    BlockGroup &group = blockGroups.back();
+                    group.end = w + 1;
+                    group.size = std::max(group.size, record.offset + record.byteSize - group.offset);
+                }
+            }
+            const size_t totalTasks = compressed ? blockGroups.size() : totalNodes;
 
-                // 设置节点名称
-                std::string nodeName = node.name.empty() ? ("Node_" + std::to_string(nodeIndex)) : node.name;
-                if (!node.instances.empty())
+            // 解码并构建一个节点；source 为映射文件或一组解压块（sourceOffset 为其首字节的文件偏移）
+            auto processNode = [&](size_t nodeIndex, unsigned worker, const LmbMappedFile &source, uint64_t sourceOffset)
+            {
+                WorkerTimes &times = workerTimes[worker];
+                const LoadProfile::Clock::time_point decodeBegin = LoadProfile::Clock::now();
+                LmbArena::Scope nodeScope(arena, worker);
+                Node node(arena.scratch(worker));
+                if (!DecodeNode(source, records[nodeIndex], node, DecodeValidation(options),
+                                static_cast<uint32_t>(colors.size()), sourceOffset))
+                {
+                    throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA,
+                                                     "Failed to decode node " + std::to_string(nodeIndex),
+                                                     filepath, static_cast<int64_t>(records[nodeIndex].offset)));
+                }
+                const LoadProfile::Clock::time_point buildBegin = LoadProfile::Clock::now();
+
+                LmbIndexEntry &entry = indexEntries[nodeIndex];
+                if (computeEntries)
                 {
-                    // 每个实例独立节点（不合并）
-                    // 先创建基础几何与原始节点的共享状态
-                    osg::ref_ptr<osg::Geometry> baseGeom = CreateGeometry(node);
-                    // 为主节点（自身）创建一个实例
+                    entry.name = NodeName(node, nodeIndex);
+                    entry.record = records[nodeIndex];
+                    entry.bounds = ComputeNodeBounds(node, scenePosition);
+                }
+                if (!options.hasNodeFilter() || IsSelected(options, entry.name, nodeIndex, entry.bounds))
+                {
+                    if (batching && !(options.hardwareInstancing && !node.instances.empty()))
+                        CollectBatchParts(node, nodeIndex, arena.resource(worker), batchSources[nodeIndex],
+                                          batchParts[nodeIndex]);
+                    else if (!options.paged)
+                        BuildNode(node, nodeIndex, options, builtNodes[nodeIndex], geometryCache.get());
+                    selected[nodeIndex] = 1;
+                }
+                // 几何已拷贝出映射内存，立即释放该节点的原始数据页，避免原始数据与场景图同时常驻
+                // （解压块是匿名内存，随所在的组整体释放）
+                source.release(records[nodeIndex].offset - sourceOffset, records[nodeIndex].byteSize);
+
+                const LoadProfile::Clock::time_point buildEnd = LoadProfile::Clock::now();
+                times.decode += buildBegin - decodeBegin;
+                times.build += buildEnd - buildBegin;
+                times.bytes += records[nodeIndex].byteSize;
+                times.vertices += records[nodeIndex].vertexCount;
+                if (profile->recordsEvents())
+                {
+                    profile->addEvent("decode", worker, decodeBegin, buildBegin, nodeIndex);
+                    profile->addEvent("build", worker, buildBegin, buildEnd, nodeIndex);
+                }
+            };
+
+            size_t nextReportBuild = 0;
+            LoadProfile::Scope nodesScope(profile.get(), "nodes");
+            pool.parallelForWorker(
+                totalTasks,
+                [&](size_t task, unsigned worker)
+                {
+                    if (!compressed)
                     {
-                        osg::ref_ptr<osg::MatrixTransform> nodeTransform = new osg::MatrixTransform;
-                        nodeTransform->setName(nodeName);
-                        nodeTransform->setMatrix(CreateTransformMatrix(node.matrix, node.position));
-
-                        osg::ref_ptr<osg::StateSet> state = CreateSharedState(colors[node.colorIndex]);
-                        osg::ref_ptr<osg::Geode> geode = new osg::Geode;
-                        geode->setName(nodeName + "_Geode");
-                        geode->addDrawable(baseGeom.get());
-                        geode->setStateSet(state.get());
-                        nodeTransform->addChild(geode.get());
-                        sceneTransform->addChild(nodeTransform.get());
+                        processNode(work[task], worker, mappedFile, 0);
+                        return;
                     }
-                    // 其他实例
-                    for (size_t i = 0; i < node.instances.size(); ++i)
+
+                    const BlockGroup &group = blockGroups[task];
+                    WorkerTimes &times = workerTimes[worker];
+                    const LoadProfile::Clock::time_point decompressBegin = LoadProfile::Clock::now();
+                    LmbMappedFile blocks;
+                    uint64_t blocksOffset = 0;
+                    std::string error;
+                    if (!LmbCompression::DecompressRange(mappedFile, group.offset, group.size, blocks, blocksOffset, error))
                     {
-                        const auto &inst = node.instances[i];
-                        osg::ref_ptr<osg::MatrixTransform> instTransform = new osg::MatrixTransform;
-                        std::string instName = nodeName + std::string("_inst_") + std::to_string(i);
-                        instTransform->setName(instName);
-                        instTransform->setMatrix(CreateTransformMatrix(inst.matrix, inst.position));
-
-                        osg::ref_ptr<osg::StateSet> state = CreateSharedState(colors[inst.colorIndex]);
-                        osg::ref_ptr<osg::Geode> geode = new osg::Geode;
-                        geode->setName(instName + "_Geode");
-                        geode->addDrawable(baseGeom.get());
-                        geode->setStateSet(state.get());
-                        instTransform->addChild(geode.get());
-                        sceneTransform->addChild(instTransform.get());
+                        throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA,
+                                                         "Failed to decompress node " + std::to_string(work[group.begin]) +
+                                                             ": " + error,
+                                                         filepath, static_cast<int64_t>(group.offset)));
                     }
-                }
-                else
+                    const LoadProfile::Clock::time_point decompressEnd = LoadProfile::Clock::now();
+                    times.decompress += decompressEnd - decompressBegin;
+                    times.decompressedBytes += blocks.size();
+                    if (profile->recordsEvents())
+                        profile->addEvent("decompress", worker, decompressBegin, decompressEnd, work[group.begin]);
+
+                    for (size_t w = group.begin; w < group.end; ++w)
+                        processNode(work[w], worker, blocks, blocksOffset);
+                },
+                [&](size_t done)
                 {
-                    // 处理非实例化节点
-                    osg::ref_ptr<osg::MatrixTransform> nodeTransform = new osg::MatrixTransform;
-                    nodeTransform->setName(nodeName);
-                    nodeTransform->setMatrix(CreateTransformMatrix(node.matrix, node.position));
+                    // 构建进度（不频繁）：每处理约2%的任务汇报一次
+                    if (progressCb && (done >= nextReportBuild || done == totalTasks))
+                    {
+                        int percent = 10 + int((double(done) / double(totalTasks)) * 90.0); // 读取占10%，构建占90%
+                        std::string msg = std::string("构建场景 ") + std::to_string(done) + "/" + std::to_string(totalTasks) +
+                                          " (" + std::to_string(percent) + "%)";
+                        progressCb(msg.c_str());
+                        nextReportBuild = done + std::max<size_t>(1, totalTasks / 50);
+                    }
+                });
 
-                    osg::ref_ptr<osg::Geometry> geometry = CreateGeometry(node);
-                    osg::ref_ptr<osg::StateSet> state = CreateSharedState(colors[node.colorIndex]);
+            nodesScope.end();
 
-                    osg::ref_ptr<osg::Geode> geode = new osg::Geode;
-                    geode->setName(nodeName + "_Geode");
-                    geode->addDrawable(geometry);
-                    geode->setStateSet(state);
+            // 合并各工作线程（含调用线程）的计时，阶段耗时为各线程之和，即 CPU 时间
+            uint64_t decompressedBytes = 0;
+            for (const WorkerTimes &times : workerTimes)
+            {
+                if (compressed)
+                {
+                    LoadProfile::Stage &decompress = profile->stage("decompress");
+                    decompress.workerMilliseconds += std::chrono::duration<double, std::milli>(times.decompress).count();
+                    decompress.add(times.decompressedBytes, 0, nullptr);
+                    decompressedBytes += times.decompressedBytes;
+                }
+                LoadProfile::Stage &decode = profile->stage("decode");
+                decode.workerMilliseconds += std::chrono::duration<double, std::milli>(times.decode).count();
+                decode.add(times.bytes, times.vertices, "vertices");
+                profile->stage("build").workerMilliseconds +=
+                    std::chrono::duration<double, std::milli>(times.build).count();
+            }
+            profile->stage("decode").allocations += arena.allocations();
+            if (compressed)
+            {
+                PluginLogger::logDebug("LMB", "Decompressed " + std::to_string(decompressedBytes / 1024) + " KB of " +
+                                                  std::to_string(dataSize / 1024) + " KB in " +
+                                                  std::to_string(blockGroups.size()) + " block groups");
+            }
+            PluginLogger::logDebug("LMB", "Parse arena: " + std::to_string(arena.allocations()) +
+                                              " allocations served from " + std::to_string(arena.blocks()) +
+                                              " heap blocks (" + std::to_string(arena.bytes() / 1024) + " KB, peak " +
+                                              std::to_string(arena.peakBytes() / 1024) + " KB)");
+
+            // StateSet 的父节点列表不是线程安全的，共享状态统一在调用线程上挂接
+            LoadProfile::Scope assembleScope(profile.get(), "assemble");
+            for (auto &nodeChildren : builtNodes)
+                AttachNodes(nodeChildren, states, sceneTransform.get(), loadStats);
+            if (geometryCache)
+            {
+                loadStats.dedupMeshes = geometryCache->sharedMeshes();
+                loadStats.dedupBytes = geometryCache->sharedBytes();
+                geometryCache.reset();
+                if (loadStats.dedupMeshes > 0)
+                {
+                    PluginLogger::logInfo("LMB", "Geometry deduplication: " + std::to_string(loadStats.dedupMeshes) +
+                                                     " meshes shared, " + std::to_string(loadStats.dedupBytes / 1024) + " KB saved");
+                }
+            }
+            if (batching)
+            {
+                LoadProfile::Scope scope(profile.get(), "batch");
+                std::vector<LmbBatchPart> parts;
+                for (auto &nodeParts : batchParts)
+                {
+                    for (auto &part : nodeParts)
+                        parts.push_back(std::move(part));
+                }
+                batchParts.clear();
 
-                    nodeTransform->addChild(geode);
-                    sceneTransform->addChild(nodeTransform);
+                std::vector<BuiltNode> batches = LmbBatching::CreateBatches(batchSources, parts, options.batchMaxVertices, pool);
+                batchSources.clear();
+                arena.release();
+                if (states.floatVertexState.valid())
+                {
+                    for (auto &batch : batches)
+                    {
+                        for (unsigned int i = 0; i < batch.geode->getNumDrawables(); ++i)
+                            batch.geode->getDrawable(i)->setStateSet(states.floatVertexState.get());
+                    }
                 }
+                loadStats.batchedParts = parts.size();
+                loadStats.batchCount = batches.size();
+                AttachNodes(batches, states, sceneTransform.get(), loadStats);
+                scope.stage()->add(0, loadStats.batchCount, "batches");
+                PluginLogger::logInfo("LMB", "Static batching: " + std::to_string(loadStats.batchedParts) +
+                                                 " draws merged into " + std::to_string(loadStats.batchCount) + " batches");
+            }
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                if (!selected[i])
+                    continue;
+                ++loadStats.nodeCount;
+                if (!options.paged)
+                    AccumulateStats(records[i], options, loadStats);
+            }
+            if (options.hasNodeFilter())
+            {
+                PluginLogger::logInfo("LMB", "Node filter selected " + std::to_string(loadStats.nodeCount) + " of " +
+                                                 std::to_string(records.size()) + " nodes");
+            }
 
-                // 构建进度（不频繁）：每处理约2%节点汇报一次
-                if (progressCb && nodeIndex >= nextReportBuild)
+            // 首次加载（或索引过期）后生成边车索引；目录不可写时忽略
+            if (!indexUsed && options.useIndex)
+            {
+                LoadProfile::Scope scope(profile.get(), "index");
+                if (LmbIndex::Save(filepath, indexEntries))
+                    PluginLogger::logDebug("LMB", "Wrote node index " + LmbIndex::PathFor(filepath));
+                else
+                    PluginLogger::logDebug("LMB", "Could not write node index " + LmbIndex::PathFor(filepath));
+            }
+
+            if (options.paged)
+            {
+                // 分页上下文接管映射，随场景图存活；.lmbz 的映射即压缩文件本身，
+                // 各页按需解压自己的块，常驻量仍受 pagedbudget 约束
+                osg::ref_ptr<LmbPagedContext> context = new LmbPagedContext;
+                context->filepath = filepath;
+                context->options = options;
+                context->colorCount = static_cast<uint32_t>(colors.size());
+                context->states = states;
+                context->records = records;
+                context->compressed = compressed;
+                context->file.swap(mappedFile);
+
+                std::vector<size_t> pagedNodes;
+                for (size_t i = 0; i < records.size(); ++i)
                 {
-                    int percent = 10 + int((double(nodeIndex + 1) / double(totalNodes)) * 90.0); // 读取占10%，构建占90%
-                    std::string msg = std::string("构建场景 ") + std::to_string(nodeIndex + 1) + "/" + std::to_string(totalNodes) +
-                                      " (" + std::to_string(percent) + "%)";
-                    progressCb(msg.c_str());
-                    nextReportBuild = nodeIndex + std::max<size_t>(1, totalNodes / 50);
+                    if (selected[i])
+                        pagedNodes.push_back(i);
                 }
+                sceneTransform->addChild(LmbPaging::CreatePagedScene(indexEntries, pagedNodes, scenePosition, context.get()));
+
+                const unsigned targetPages = LmbPaging::TargetPageCount(indexEntries, options);
+                if (targetPages > 0)
+                    root->setUserValue(PagedTargetCountName, static_cast<int>(targetPages));
+                PluginLogger::logInfo("LMB", "Paged mode: " + std::to_string(pagedNodes.size()) + " paged nodes" +
+                                                 (targetPages > 0 ? ", target " + std::to_string(targetPages) + " resident pages"
+                                                                  : std::string()));
             }
+            assembleScope.stage()->add(0, loadStats.nodeCount, "nodes");
+            assembleScope.end();
+
+            RecordMemoryStats(loadStats);
+            PluginLogger::logInfo("LMB", loadStats.summary());
+            if (stats)
+                *stats = loadStats;
+            PublishProfile(*profile, *root, tracePath);
 
             // Log successful loading
             auto endTime = std::chrono::high_resolution_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-            PluginLogger::logFileLoadSuccess("LMB", filepath, duration.count(), static_cast<int>(nodes.size()));
+            PluginLogger::logFileLoadSuccess("LMB", filepath, duration.count(), static_cast<int>(loadStats.nodeCount));
 
             return root;
         }
@@ -175,6 +494,517 @@ namespace LmbPlugin
         }
     }
 
+    osg::ref_ptr<osg::Group> LmbParser::parseStream(std::istream &stream, const std::string &streamName,
+                                                    std::function<void(const char *)> progressCb,
+                                                    const LmbLoadOptions &options,
+                                                    LmbLoadStats *stats)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        const uint64_t residentBefore = LmbMemory::residentBytes();
+
+        try
+        {
+            PluginLogger::logFileLoadStart("LMB", streamName);
+            if (progressCb)
+                progressCb("开始读取 LMB 数据流...");
+
+            if (options.paged)
+                PluginLogger::logWarning("LMB", "Paged mode needs a seekable file, loading stream " + streamName + " fully");
+            if (options.staticBatching)
+                PluginLogger::logWarning("LMB", "Static batching needs all nodes in memory, ignored for stream " + streamName);
+
+            // 流的计时与文件相同，trace 文件名取自 "stream"（流名称可能不是合法路径）
+            const std::string tracePath = LoadProfile::TracePath(options.tracePath, "stream");
+            osg::ref_ptr<LoadProfile> profile = new LoadProfile("LMB", streamName, !tracePath.empty());
+
+            // 不依赖 tellg/seekg，自行记录位置，单次顺序读取
+            LmbStreamReader reader(stream);
+            Vector3f scenePosition;
+            uint32_t colorCount, nodeCount;
+            if (!reader.read(scenePosition) || !reader.read(colorCount) || !reader.read(nodeCount))
+            {
+                logError(LmbErrorType::CORRUPTED_HEADER, "Failed to read stream header", streamName, reader.position());
+                return nullptr;
+            }
+            // .lmbz 的块表需要随机访问，流式读取只支持未压缩的 LMB
+            if (LmbCompression::IsCompressed(reinterpret_cast<const uint8_t *>(&scenePosition), sizeof(scenePosition)))
+            {
+                logError(LmbErrorType::INVALID_FORMAT, "Compressed LMB (.lmbz) cannot be read from a stream", streamName);
+                return nullptr;
+            }
+            // 先校验计数，再按计数读取
+            validateHeader(scenePosition, colorCount, nodeCount);
+
+            std::vector<uint32_t> colors;
+            colors.reserve(colorCount);
+            for (uint32_t i = 0; i < colorCount; ++i)
+            {
+                uint32_t color;
+                if (!reader.read(color))
+                {
+                    logError(LmbErrorType::CORRUPTED_DATA, "Failed to read color data", streamName, reader.position());
+                    return nullptr;
+                }
+                colors.push_back(color);
+            }
+            validateColorData(colors, colorCount);
+
+            LmbLoadStats loadStats;
+            loadStats.residentBytesBefore = residentBefore;
+            osg::ref_ptr<osg::MatrixTransform> sceneTransform;
+            osg::ref_ptr<osg::Group> root;
+            SceneStates states;
+            {
+                LoadProfile::Scope scope(profile.get(), "states");
+                root = CreateSceneRoot(scenePosition, sceneTransform);
+                states = CreateSceneStates(colors, options, loadStats);
+                scope.stage()->add(0, loadStats.uniqueStateSets, "state sets");
+            }
+
+            // 逐个节点：整条记录读入复用的缓冲，原地解码并构建，缓冲只保留最大节点的容量
+            std::vector<uint8_t> recordBuffer;
+            std::vector<BuiltNode> builtNodes;
+            uint32_t nextReport = 0;
+            for (uint32_t i = 0; i < nodeCount; ++i)
+            {
+                NodeRecord record;
+                bool scanned;
+                {
+                    LoadProfile::Scope scope(profile.get(), "read");
+                    reader.setRecordBuffer(&recordBuffer);
+                    scanned = ScanNode(reader, record);
+                    reader.setRecordBuffer(nullptr);
+                    scope.stage()->add(record.byteSize, 1, "nodes");
+                }
+
+                Node node;
+                {
+                    LoadProfile::Scope scope(profile.get(), "decode");
+                    ByteCursor cursor(recordBuffer.data(), recordBuffer.size(), record.offset);
+                    if (!scanned || !ReadNode(cursor, node, DecodeValidation(options), static_cast<uint32_t>(colors.size())))
+                    {
+                        std::ostringstream oss;
+                        oss << "Failed to read node " << i << " of " << nodeCount << " (unexpected end of stream)";
+                        logError(LmbErrorType::CORRUPTED_DATA, oss.str(), streamName, static_cast<int64_t>(record.offset));
+                        return nullptr;
+                    }
+                    scope.stage()->add(record.byteSize, record.vertexCount, "vertices");
+                }
+
+                // 流没有索引，过滤条件在解码后逐节点判断
+                LoadProfile::Scope buildScope(profile.get(), "build");
+                if (!options.hasNodeFilter() ||
+                    IsSelected(options, NodeName(node, i), i, ComputeNodeBounds(node, scenePosition)))
+                {
+                    ++loadStats.nodeCount;
+                    AccumulateStats(record, options, loadStats);
+                    BuildNode(node, i, options, builtNodes);
+                    LoadProfile::Scope assembleScope(profile.get(), "assemble");
+                    AttachNodes(builtNodes, states, sceneTransform.get(), loadStats);
+                }
+                buildScope.end();
+
+                if (progressCb && i >= nextReport)
+                {
+                    std::string msg = std::string("构建场景 ") + std::to_string(i + 1) + "/" + std::to_string(nodeCount) +
+                                      " (" + std::to_string(int((double(i + 1) / double(nodeCount)) * 100.0)) + "%)";
+                    progressCb(msg.c_str());
+                    nextReport = i + std::max<uint32_t>(1, nodeCount / 50);
+                }
+            }
+
+            RecordMemoryStats(loadStats);
+            PluginLogger::logInfo("LMB", loadStats.summary());
+            PluginLogger::logDebug("LMB", "Largest streamed node record: " +
+                                              std::to_string(recordBuffer.capacity() / 1024) + " KB");
+            if (stats)
+                *stats = loadStats;
+            PublishProfile(*profile, *root, tracePath);
+
+            auto endTime = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+            PluginLogger::logFileLoadSuccess("LMB", streamName, duration.count(), static_cast<int>(loadStats.nodeCount));
+
+            return root;
+        }
+        catch (const LmbParseException &e)
+        {
+            const LmbError &error = e.getError();
+            PluginLogger::logFileLoadFailure("LMB", streamName,
+                                             getErrorTypeString(error.type) + ": " + error.message);
+            return nullptr;
+        }
+        catch (const std::exception &e)
+        {
+            logError(LmbErrorType::UNKNOWN_ERROR, std::string("Standard exception: ") + e.what(), streamName);
+            return nullptr;
+        }
+        catch (...)
+        {
+            logError(LmbErrorType::UNKNOWN_ERROR, "Unknown exception occurred", streamName);
+            return nullptr;
+        }
+    }
+
+    osg::ref_ptr<osg::Group> LmbParser::loadPage(const LmbPagedContext &context, size_t nodeIndex)
+    {
+        if (nodeIndex >= context.records.size())
+            return nullptr;
+
+        const NodeRecord &record = context.records[nodeIndex];
+        // .lmbz 只解压该节点记录所在的块，用完即释放
+        LmbMappedFile blocks;
+        uint64_t blocksOffset = 0;
+        if (context.compressed)
+        {
+            std::string error;
+            if (!LmbCompression::DecompressRange(context.file, record.offset, record.byteSize, blocks, blocksOffset, error))
+            {
+                logError(LmbErrorType::CORRUPTED_DATA, "Failed to decompress paged node " + std::to_string(nodeIndex) +
+                                                           ": " + error,
+                         context.filepath, static_cast<int64_t>(record.offset));
+                return nullptr;
+            }
+        }
+        const LmbMappedFile &source = context.compressed ? blocks : context.file;
+
+        Node node;
+        if (!DecodeNode(source, record, node, DecodeValidation(context.options), context.colorCount, blocksOffset))
+        {
+            logError(LmbErrorType::CORRUPTED_DATA, "Failed to decode paged node " + std::to_string(nodeIndex),
+                     context.filepath, static_cast<int64_t>(record.offset));
+            return nullptr;
+        }
+
+        std::vector<BuiltNode> built;
+        BuildNode(node, nodeIndex, context.options, built);
+        if (!context.compressed)
+            context.file.release(record.offset, record.byteSize);
+
+        osg::ref_ptr<osg::Group> page = new LmbPage(&context);
+        page->setName(NodeName(node, nodeIndex) + "_Page");
+        LmbLoadStats pageStats;
+        {
+            // 共享 StateSet 的父节点列表只在持锁时修改；页面析构时同样持锁解除引用（见 LmbPage），
+            // 查看器高亮不替换加载器节点上的 StateSet
+            std::lock_guard<std::mutex> lock(context.attachMutex);
+            AttachNodes(built, context.states, page.get(), pageStats);
+        }
+        return page;
+    }
+
+    void LmbParser::CollectBatchParts(const Node &node, size_t nodeIndex, std::pmr::memory_resource *arena,
+                                      LmbBatchSource &source, std::vector<LmbBatchPart> &parts)
+    {
+        source.vertices = DecompressVertices(node);
+        source.normals = DecodeNormals(node.normals);
+        uint32_t *indices = static_cast<uint32_t *>(arena->allocate(node.indices.size() * sizeof(uint32_t), alignof(uint32_t)));
+        for (size_t i = 0; i < node.indices.size(); ++i)
+            indices[i] = node.indices[i];
+        source.indices = Span<uint32_t>(indices, node.indices.size());
+
+        const osg::BoundingBox local = ComputeQuantizedBound(node);
+        const std::string nodeName = NodeName(node, nodeIndex);
+        auto addPart = [&](const std::string &name, const osg::Matrix &matrix, uint32_t colorIndex)
+        {
+            LmbBatchPart part;
+            part.name = name;
+            part.matrix = matrix;
+            part.colorIndex = colorIndex;
+            part.source = nodeIndex;
+            part.center = local.center() * matrix;
+            parts.push_back(std::move(part));
+        };
+
+        parts.reserve(node.instances.size() + 1);
+        addPart(nodeName, CreateTransformMatrix(node.matrix, node.position), node.colorIndex);
+        for (size_t i = 0; i < node.instances.size(); ++i)
+        {
+            const auto &inst = node.instances[i];
+            addPart(nodeName + std::string("_inst_") + std::to_string(i),
+                    CreateTransformMatrix(inst.matrix, inst.position), inst.colorIndex);
+        }
+    }
+
+    std::string LmbParser::NodeName(const Node &node, size_t nodeIndex)
+    {
+        return node.name.empty() ? ("Node_" + std::to_string(nodeIndex)) : std::string(node.name);
+    }
+
+    osg::BoundingBox LmbParser::ComputeNodeBounds(const Node &node, const Vector3f &scenePosition)
+    {
+        const osg::BoundingBox local = ComputeQuantizedBound(node);
+        const osg::Vec3 sceneOffset(scenePosition.x, scenePosition.y, scenePosition.z);
+        osg::BoundingBox bounds;
+        auto expand = [&](const osg::Matrix &matrix)
+        {
+            for (unsigned int corner = 0; corner < 8; ++corner)
+                bounds.expandBy(local.corner(corner) * matrix + sceneOffset);
+        };
+        expand(CreateTransformMatrix(node.matrix, node.position));
+        for (const auto &inst : node.instances)
+            expand(CreateTransformMatrix(inst.matrix, inst.position));
+        return bounds;
+    }
+
+    bool LmbParser::IsSelected(const LmbLoadOptions &options, const std::string &name, size_t nodeIndex,
+                               const osg::BoundingBox &bounds)
+    {
+        if (options.boundsFilter.valid() && !options.boundsFilter.intersects(bounds))
+            return false;
+        if (options.nodeNames.empty())
+            return true;
+        const std::string indexName = "#" + std::to_string(nodeIndex);
+        for (const std::string &wanted : options.nodeNames)
+        {
+            if (wanted == name || wanted == indexName)
+                return true;
+        }
+        return false;
+    }
+
+    osg::ref_ptr<osg::Group> LmbParser::CreateSceneRoot(const Vector3f &position,
+                                                        osg::ref_ptr<osg::MatrixTransform> &sceneTransform)
+    {
+        // 创建根节点
+        osg::ref_ptr<osg::Group> root = new osg::Group;
+        root->setName("meshRoot");
+
+        // 创建场景变换节点
+        sceneTransform = new osg::MatrixTransform;
+        sceneTransform->setName("SceneTransform");
+        sceneTransform->setMatrix(osg::Matrix::translate(position.x, position.y, position.z));
+        root->addChild(sceneTransform);
+
+        // 设置场景状态
+        SetupSceneState(root);
+        return root;
+    }
+
+    SceneStates LmbParser::CreateSceneStates(const std::vector<uint32_t> &colors, const LmbLoadOptions &options,
+                                             LmbLoadStats &stats)
+    {
+        // 每个颜色只创建一次 StateSet，所有节点与实例共享，渲染排序时同色几何归为同一状态
+        SceneStates states;
+        states.colorStates = CreateColorStates(colors, stats.uniqueStateSets);
+
+        // GPU 路径（实例化 / 反量化）共用一个着色器程序，变体由 define 选择
+        osg::ref_ptr<osg::Program> gpuProgram;
+        if (options.hardwareInstancing || options.gpuDequantization)
+            gpuProgram = LmbShaders::CreateProgram();
+        // 量化变体的 define 放在共享状态上，每个几何只带自己的反量化参数（顶点属性）
+        if (options.gpuDequantization)
+        {
+            for (const auto &state : states.colorStates)
+            {
+                state->setAttributeAndModes(gpuProgram.get(), osg::StateAttribute::ON);
+                LmbShaders::SetQuantized(state.get(), true);
+            }
+            // 合批的几何是浮点顶点，在几何层面关闭量化变体；所有批次共用一个 StateSet
+            if (options.staticBatching)
+            {
+                states.floatVertexState = new osg::StateSet;
+                LmbShaders::SetQuantized(states.floatVertexState.get(), false);
+            }
+        }
+        if (options.hardwareInstancing)
+        {
+            states.instancingState = LmbInstancing::CreateSharedState(colors, gpuProgram.get());
+            if (options.gpuDequantization)
+                LmbShaders::SetQuantized(states.instancingState.get(), true);
+        }
+        return states;
+    }
+
+    void LmbParser::AccumulateStats(const NodeRecord &record, const LmbLoadOptions &options, LmbLoadStats &stats)
+    {
+        stats.instanceCount += record.instanceCount;
+        stats.vertexCount += record.vertexCount;
+        stats.indexCount += record.indexCount;
+        stats.indexBytes += uint64_t(record.indexCount) * IndexWidth(record.vertexCount);
+        stats.vertexBytes += uint64_t(record.vertexCount) * (options.gpuDequantization ? QuantizedVertexBytes : FloatVertexBytes);
+    }
+
+    void LmbParser::PublishProfile(LoadProfile &profile, osg::Group &root, const std::string &tracePath)
+    {
+        // 场景对象都在构建与状态阶段创建，加载结束后统一计数，避免在工作线程里逐个统计
+        const LoadProfile::SceneObjects objects = LoadProfile::CountSceneObjects(root);
+        profile.stage("build").allocations += objects.nodes + objects.arrays + objects.primitiveSets;
+        profile.stage("states").allocations += objects.stateSets + objects.stateAttributes;
+        profile.publish(root, tracePath);
+    }
+
+    void LmbParser::RecordMemoryStats(LmbLoadStats &stats)
+    {
+        stats.residentBytesAfter = LmbMemory::residentBytes();
+        stats.peakResidentBytes = LmbMemory::peakResidentBytes();
+    }
+
+    void LmbParser::AttachNodes(std::vector<BuiltNode> &nodes, const SceneStates &states,
+                                osg::Group *parent, LmbLoadStats &stats)
+    {
+        for (auto &child : nodes)
+        {
+            if (child.instanced)
+            {
+                child.transform->setStateSet(states.instancingState.get());
+                ++stats.instancedDraws;
+            }
+            else
+            {
+                child.geode->setStateSet(states.colorStates[child.colorIndex].get());
+                for (auto &lodGeode : child.lodGeodes)
+                    lodGeode->setStateSet(states.colorStates[child.colorIndex].get());
+                if (!child.lodGeodes.empty())
+                    ++stats.lodNodes;
+            }
+            if (child.optimization.triangles > 0)
+            {
+                ++stats.optimizedMeshes;
+                stats.optimization.add(child.optimization);
+            }
+            parent->addChild(child.transform.get());
+        }
+        nodes.clear();
+    }
+
+    void LmbParser::BuildNode(const Node &node, size_t nodeIndex, const LmbLoadOptions &options,
+                              std::vector<BuiltNode> &outNodes, LmbGeometryCache *cache)
+    {
+        // 设置节点名称
+        const std::string nodeName = NodeName(node, nodeIndex);
+
+        if (options.hardwareInstancing && !node.instances.empty())
+        {
+            // 节点自身作为第 0 个实例，与其余实例合并为一次实例化绘制
+            const size_t count = node.instances.size() + 1;
+            std::vector<osg::Matrixf> matrices;
+            std::vector<uint32_t> colorIndices;
+            std::vector<std::string> instanceNames;
+            matrices.reserve(count);
+            colorIndices.reserve(count);
+            instanceNames.reserve(count);
+
+            matrices.push_back(CreateTransformMatrix(node.matrix, node.position));
+            colorIndices.push_back(node.colorIndex);
+            instanceNames.push_back(nodeName);
+            for (size_t i = 0; i < node.instances.size(); ++i)
+            {
+                const auto &inst = node.instances[i];
+                matrices.push_back(CreateTransformMatrix(inst.matrix, inst.position));
+                colorIndices.push_back(inst.colorIndex);
+                instanceNames.push_back(nodeName + std::string("_inst_") + std::to_string(i));
+            }
+
+            // 实例矩阵相对场景变换，外层变换保持单位矩阵
+            BuiltNode built;
+            built.transform = new osg::MatrixTransform;
+            built.transform->setName(nodeName);
+            osg::ref_ptr<osg::Geometry> geometry = CreateGeometry(node, options.gpuDequantization);
+            if (options.optimizeMeshes)
+                OptimizeGeometry(geometry.get(), FloatPositions(node, geometry.get()).get(), nodeName, built.optimization);
+            built.geode = LmbInstancing::CreateInstancedGeode(geometry.get(), nodeName + "_Geode",
+                                                              matrices, colorIndices, instanceNames);
+            built.transform->addChild(built.geode.get());
+            built.colorIndex = node.colorIndex;
+            built.instanced = true;
+            outNodes.push_back(built);
+            return;
+        }
+
+        auto addTransform = [&outNodes, &options](const std::string &name, const osg::Matrix &matrix,
+                                                  const MeshLevels &levels, uint32_t colorIndex)
+        {
+            BuiltNode built;
+            built.transform = new osg::MatrixTransform;
+            built.transform->setName(name);
+            built.transform->setMatrix(matrix);
+            built.colorIndex = colorIndex;
+
+            // 每个层级一个同名 Geode，拾取与属性显示不受当前层级影响
+            auto createGeode = [&name](osg::Geometry *geometry)
+            {
+                osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+                geode->setName(name + "_Geode");
+                geode->addDrawable(geometry);
+                return geode;
+            };
+            built.geode = createGeode(levels[0].get());
+            if (levels.size() == 1)
+            {
+                built.transform->addChild(built.geode.get());
+                outNodes.push_back(built);
+                return;
+            }
+
+            // 按屏幕尺寸切换：完整几何覆盖 lodPixels 以上，之后每级阈值降为 1/4，最后一级到 0
+            osg::ref_ptr<osg::LOD> lod = new osg::LOD;
+            lod->setName(name + "_LOD");
+            lod->setRangeMode(osg::LOD::PIXEL_SIZE_ON_SCREEN);
+            float upper = FLT_MAX;
+            float lower = options.lodPixels;
+            for (size_t level = 0; level < levels.size(); ++level)
+            {
+                osg::ref_ptr<osg::Geode> geode = level == 0 ? built.geode : createGeode(levels[level].get());
+                if (level > 0)
+                    built.lodGeodes.push_back(geode);
+                lod->addChild(geode.get(), level + 1 == levels.size() ? 0.0f : lower, upper);
+                upper = lower;
+                lower *= 0.25f;
+            }
+            built.transform->addChild(lod.get());
+            outNodes.push_back(built);
+        };
+
+        // 实例化路径会原地修改几何，只有普通节点参与去重
+        MeshLevels levels;
+        MeshOptimizer::Result optimization;
+        const uint64_t hash = cache ? LmbGeometryCache::Hash(node) : 0;
+        if (!cache || !cache->find(node, hash, levels))
+        {
+            osg::ref_ptr<osg::Geometry> geometry = CreateGeometry(node, options.gpuDequantization);
+            const size_t triangleCount = node.indices.size() / 3;
+            const bool simplify = options.lodTriangles > 0 && triangleCount >= options.lodTriangles;
+            // 过度绘制排序与简化都在浮点位置上进行，量化路径同样适用
+            osg::ref_ptr<osg::Vec3Array> positions;
+            if (options.optimizeMeshes || simplify)
+                positions = FloatPositions(node, geometry.get());
+            if (options.optimizeMeshes)
+                OptimizeGeometry(geometry.get(), positions.get(), nodeName, optimization);
+            if (simplify)
+            {
+                // 索引取自几何本身：优化后已与文件中的顺序不同
+                const osg::PrimitiveSet *triangles = geometry->getPrimitiveSet(0);
+                std::vector<uint32_t> indices(triangles->getNumIndices());
+                for (size_t i = 0; i < indices.size(); ++i)
+                    indices[i] = triangles->index(static_cast<unsigned int>(i));
+                levels = LmbSimplify::CreateLevels(geometry.get(), *positions, indices, options.lodLevels);
+            }
+            else
+            {
+                levels.push_back(geometry);
+            }
+            if (cache)
+            {
+                cache->insert(node, hash, levels);
+                // 另一线程先插入了相同网格时，本次优化的几何被丢弃，不计入统计
+                if (levels[0] != geometry)
+                    optimization = MeshOptimizer::Result();
+            }
+        }
+        outNodes.reserve(node.instances.size() + 1);
+        addTransform(nodeName, CreateTransformMatrix(node.matrix, node.position), levels, node.colorIndex);
+        outNodes.back().optimization = optimization;
+
+        // 每个实例独立节点（不合并），共享主节点的几何
+        for (size_t i = 0; i < node.instances.size(); ++i)
+        {
+            const auto &inst = node.instances[i];
+            addTransform(nodeName + std::string("_inst_") + std::to_string(i),
+                         CreateTransformMatrix(inst.matrix, inst.position), levels, inst.colorIndex);
+        }
+    }
+
     void LmbParser::SetupSceneState(osg::ref_ptr<osg::Group> root)
     {
         osg::ref_ptr<osg::StateSet> stateSet = root->getOrCreateStateSet();
@@ -203,6 +1033,8 @@ namespace LmbPlugin
         osg::ref_ptr<osg::StateSet> stateSet = new osg::StateSet;
         osg::Vec4 colorVec = CreateColorFromRGB(color);
         stateSet->setAttribute(CreateMaterial(colorVec));
+        // 材质颜色经过明暗缩放，原始颜色另存一份，写回 LMB 时不会逐次变暗
+        stateSet->setUserValue(ColorValueName, static_cast<unsigned int>(color));
         stateSet->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
         stateSet->setMode(GL_BLEND, osg::StateAttribute::OFF);
         stateSet->setMode(GL_DEPTH_TEST, osg::StateAttribute::ON);
@@ -210,6 +1042,47 @@ namespace LmbPlugin
         return stateSet;
     }
 
+    std::vector<osg::ref_ptr<osg::StateSet>> LmbParser::CreateColorStates(const std::vector<uint32_t> &colors,
+                                                                          size_t &uniqueCount)
+    {
+        std::vector<osg::ref_ptr<osg::StateSet>> states(colors.size());
+        std::unordered_map<uint32_t, osg::ref_ptr<osg::StateSet>> byColor;
+        byColor.reserve(colors.size());
+        for (size_t i = 0; i < colors.size(); ++i)
+        {
+            osg::ref_ptr<osg::StateSet> &state = byColor[colors[i]];
+            if (!state.valid())
+                state = CreateSharedState(colors[i]);
+            states[i] = state;
+        }
+        uniqueCount = byColor.size();
+        return states;
+    }
+
+    std::string LmbLoadStats::summary() const
+    {
+        return "Load stats: " + std::to_string(nodeCount) + " nodes, " +
+               std::to_string(instanceCount) + " instances, " +
+               std::to_string(vertexCount) + " vertices (" + std::to_string(vertexBytes / 1024) + " KB), " +
+               std::to_string(indexCount) + " indices (" + std::to_string(indexBytes / 1024) + " KB, " +
+               std::to_string((uint64_t(indexCount) * 4 - indexBytes) / 1024) + " KB saved vs 32-bit), " +
+               std::to_string(uniqueStateSets) + " unique states, " +
+               std::to_string(instancedDraws) + " instanced draws" +
+               (dedupMeshes > 0 ? ", " + std::to_string(dedupMeshes) + " deduplicated meshes (" +
+                                      std::to_string(dedupBytes / 1024) + " KB)"
+                                : std::string()) +
+               (lodNodes > 0 ? ", " + std::to_string(lodNodes) + " LOD nodes" : std::string()) +
+               (optimizedMeshes > 0 ? ", " + std::to_string(optimizedMeshes) + " optimized meshes (" +
+                                          MeshOptimizer::Describe(optimization) + ")"
+                                    : std::string()) +
+               (batchCount > 0 ? ", " + std::to_string(batchedParts) + " parts in " + std::to_string(batchCount) + " batches"
+                               : std::string()) +
+               (peakResidentBytes > 0 ? ", RSS " + std::to_string(residentBytesBefore >> 20) + " MB -> " +
+                                            std::to_string(residentBytesAfter >> 20) + " MB (process peak " +
+                                            std::to_string(peakResidentBytes >> 20) + " MB)"
+                                      : std::string());
+    }
+
     osg::ref_ptr<osg::Material> LmbParser::CreateMaterial(const osg::Vec4 &color)
     {
         osg::ref_ptr<osg::Material> material = new osg::Material;
@@ -221,60 +1094,68 @@ namespace LmbPlugin
         return material;
     }
 
-    bool LmbParser::ReadFile(const std::string &filepath, Vector3f &scenePosition,
-                             std::vector<uint32_t> &colors, std::vector<Node> &nodes,
-                             std::function<void(const char *)> progressCb)
+    template <typename Cursor>
+    bool LmbParser::ReadFile(Cursor &cursor, const std::string &filepath, Vector3f &scenePosition,
+                             std::vector<uint32_t> &colors, std::vector<NodeRecord> &records,
+                             std::function<void(const char *)> progressCb,
+                             const std::vector<LmbIndexEntry> *index)
     {
-        std::ifstream file(filepath, std::ios::binary);
-        if (!file.is_open())
-        {
-            logError(LmbErrorType::FILE_ACCESS_ERROR, "Cannot open file for reading", filepath);
-            return false;
-        }
+        const uint64_t fileSize = cursor.remaining();
 
         try
         {
             // Read header
             uint32_t colorCount, nodeCount;
-            if (!ReadHeader(file, scenePosition, colorCount, nodeCount))
+            if (!ReadHeader(cursor, scenePosition, colorCount, nodeCount))
             {
-                logError(LmbErrorType::CORRUPTED_HEADER, "Failed to read file header", filepath, file.tellg());
+                logError(LmbErrorType::CORRUPTED_HEADER, "Failed to read file header", filepath, cursor.position());
                 return false;
             }
-            validateStreamState(file, "header reading", file.tellg());
             if (progressCb)
                 progressCb("已读取文件头...");
 
             // Read colors
-            colors.resize(colorCount);
-            if (!ReadColors(file, colorCount, colors))
+            if (!ReadColors(cursor, colorCount, colors))
             {
-                logError(LmbErrorType::CORRUPTED_DATA, "Failed to read color data", filepath, file.tellg());
+                logError(LmbErrorType::CORRUPTED_DATA, "Failed to read color data", filepath, cursor.position());
                 return false;
             }
-            validateStreamState(file, "color reading", file.tellg());
             if (progressCb)
                 progressCb("已读取颜色表...");
 
-            // Read nodes
-            nodes.resize(nodeCount);
+            // 索引与文件头一致时直接采用索引中的记录
+            if (index && index->size() == nodeCount)
+            {
+                records.resize(nodeCount);
+                for (uint32_t i = 0; i < nodeCount; ++i)
+                    records[i] = (*index)[i].record;
+                return true;
+            }
+
+            // Scan nodes：只记录偏移和大小，数组在第二阶段并行解码
+            if (static_cast<uint64_t>(nodeCount) * 4 > cursor.remaining())
+            {
+                logError(LmbErrorType::INVALID_NODE_COUNT, "Node count exceeds file size", filepath, cursor.position());
+                return false;
+            }
+            records.resize(nodeCount);
             uint32_t nextReport = 0;
             for (uint32_t i = 0; i < nodeCount; ++i)
             {
-                long nodeStartPos = file.tellg();
-                if (!ReadNode(file, nodes[i]))
+                const uint64_t nodeStartPos = cursor.position();
+                if (!ScanNode(cursor, records[i]))
                 {
                     std::ostringstream oss;
-                    oss << "Failed to read node " << i << " of " << nodeCount;
-                    logError(LmbErrorType::CORRUPTED_DATA, oss.str(), filepath, nodeStartPos);
+                    oss << "Failed to read node " << i << " of " << nodeCount
+                        << " (unexpected end of file, " << fileSize << " bytes)";
+                    logError(LmbErrorType::CORRUPTED_DATA, oss.str(), filepath, static_cast<int64_t>(nodeStartPos));
                     return false;
                 }
-                validateStreamState(file, "node " + std::to_string(i) + " reading", nodeStartPos);
 
                 if (progressCb && i >= nextReport)
                 {
                     int pct = int((double(i + 1) / double(nodeCount)) * 10.0); // 读取阶段最多10%
-                    std::string msg = std::string("读取节点 ") + std::to_string(i + 1) + "/" + std::to_string(nodeCount) +
+                    std::string msg = std::string("扫描节点 ") + std::to_string(i + 1) + "/" + std::to_string(nodeCount) +
                                       " (" + std::to_string(pct) + "%)";
                     progressCb(msg.c_str());
                     nextReport = i + std::max<uint32_t>(1, nodeCount / 50);
@@ -295,166 +1176,267 @@ namespace LmbPlugin
         }
     }
 
-    bool LmbParser::ReadColors(std::istream &stream,
+    template <typename Cursor>
+    bool LmbParser::ReadColors(Cursor &cursor,
                                uint32_t colorCount,
                                std::vector<uint32_t> &colors)
     {
-        stream.read(reinterpret_cast<char *>(colors.data()),
-                    colorCount * sizeof(uint32_t));
-        return stream.good();
+        // 先按剩余字节校验计数，避免异常计数导致巨量分配；BlockReader 不能跨块给出连续数组，逐个读取
+        if (uint64_t(colorCount) * sizeof(uint32_t) > cursor.remaining())
+            return false;
+        colors.resize(colorCount);
+        for (uint32_t &color : colors)
+        {
+            if (!cursor.read(color))
+                return false;
+        }
+        return true;
     }
 
-    bool LmbParser::ReadInstances(std::istream &stream, std::vector<Instance> &instances)
+    bool LmbParser::ReadInstances(ByteCursor &cursor, Node &node, LmbValidation validation, uint32_t colorCount)
     {
         uint32_t instanceCount;
-        stream.read(reinterpret_cast<char *>(&instanceCount), sizeof(uint32_t));
+        if (!cursor.read(instanceCount))
+            return false;
 
+        // 每个实例至少占 4 字节（名称长度+对齐）+ 52 字节矩阵/位置/颜色，先校验避免异常计数导致巨量分配
+        if (static_cast<uint64_t>(instanceCount) * 56 > cursor.remaining())
+            return false;
+
+        const uint64_t instancesOffset = cursor.position();
+        std::pmr::vector<Instance> &instances = node.instances;
         instances.resize(instanceCount);
+        bool finite = true;
+        uint32_t maxColorIndex = 0;
         for (uint32_t i = 0; i < instanceCount; ++i)
         {
             Instance &instance = instances[i];
 
             // Read name
             uint16_t nameLength;
-            stream.read(reinterpret_cast<char *>(&nameLength), sizeof(uint16_t));
-            std::vector<char> nameBuffer(nameLength);
-            stream.read(nameBuffer.data(), nameLength);
-            instance.name = std::string(nameBuffer.data(), nameLength);
-            AlignTo4Bytes(stream);
-
-            // 读取3x3变换矩阵
-            stream.read(reinterpret_cast<char *>(&instance.matrix), sizeof(float) * 9);
+            if (!cursor.read(nameLength) || !cursor.readString(nameLength, instance.name) || !cursor.alignTo4())
+                return false;
 
-            // 读取位置
-            stream.read(reinterpret_cast<char *>(&instance.position), sizeof(Vector3f));
+            // 读取3x3变换矩阵、位置（文件中连续 12 个 float）与颜色索引，校验只累计结果，不在循环中分支
+            Span<float> transform;
+            if (!cursor.readSpan(12, transform) || !cursor.read(instance.colorIndex))
+                return false;
+            std::memcpy(instance.matrix, transform.data(), sizeof(instance.matrix));
+            std::memcpy(&instance.position, transform.data() + 9, sizeof(instance.position));
+            if (validation == LmbValidation::FULL)
+                finite &= LmbSimd::AllFinite(transform.data(), transform.size());
+            maxColorIndex = std::max(maxColorIndex, instance.colorIndex);
+        }
 
-            // Read color index
-            stream.read(reinterpret_cast<char *>(&instance.colorIndex), sizeof(uint32_t));
+        // 以下只在出错时执行：定位第一个无效实例并生成错误信息
+        if (instanceCount > 0 && maxColorIndex >= colorCount)
+        {
+            for (uint32_t i = 0; i < instanceCount; ++i)
+            {
+                if (instances[i].colorIndex >= colorCount)
+                {
+                    std::ostringstream oss;
+                    oss << "Color index out of range in instance " << i << " of node " << node.name << ": "
+                        << instances[i].colorIndex << " >= " << colorCount;
+                    throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, oss.str(), "",
+                                                     static_cast<int64_t>(instancesOffset)));
+                }
+            }
+        }
+        if (!finite)
+        {
+            for (uint32_t i = 0; i < instanceCount; ++i)
+            {
+                const Instance &inst = instances[i];
+                const char *what = nullptr;
+                if (!LmbSimd::AllFinite(inst.matrix, 9))
+                    what = "Invalid transformation matrix";
+                else if (!std::isfinite(inst.position.x) || !std::isfinite(inst.position.y) || !std::isfinite(inst.position.z))
+                    what = "Invalid position";
+                if (what)
+                {
+                    std::ostringstream oss;
+                    oss << what << " in instance " << i << " of node: " << node.name;
+                    throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, oss.str(), "",
+                                                     static_cast<int64_t>(instancesOffset)));
+                }
+            }
         }
 
-        return stream.good();
+        return true;
     }
 
-    bool LmbParser::ReadHeader(std::istream &stream,
+    template <typename Cursor>
+    bool LmbParser::ReadHeader(Cursor &cursor,
                                Vector3f &position,
                                uint32_t &colorCount,
                                uint32_t &nodeCount)
     {
-        stream.read(reinterpret_cast<char *>(&position), sizeof(Vector3f));
-        stream.read(reinterpret_cast<char *>(&colorCount), sizeof(uint32_t));
-        stream.read(reinterpret_cast<char *>(&nodeCount), sizeof(uint32_t));
-        return stream.good();
+        return cursor.read(position) && cursor.read(colorCount) && cursor.read(nodeCount);
     }
 
-    bool LmbParser::ReadNode(std::istream &stream, Node &node)
+    bool LmbParser::ReadNode(ByteCursor &cursor, Node &node, LmbValidation validation, uint32_t colorCount)
     {
+        const uint64_t nodeOffset = cursor.position();
+
         // Read name
         uint16_t nameLength;
-        stream.read(reinterpret_cast<char *>(&nameLength), sizeof(uint16_t));
-        std::vector<char> nameBuffer(nameLength);
-        stream.read(nameBuffer.data(), nameLength);
-        node.name = std::string(nameBuffer.data(), nameLength);
-        AlignTo4Bytes(stream);
-
-        // 读取3x3变换矩阵
-        stream.read(reinterpret_cast<char *>(&node.matrix), sizeof(float) * 9);
-
-        // 读取位置
-        stream.read(reinterpret_cast<char *>(&node.position), sizeof(Vector3f));
-
-        // 读取压缩顶点数据
-        // baseVertex (3 floats)
-        stream.read(reinterpret_cast<char *>(&node.baseVertex), sizeof(Vector3f));
-
-        // vertexScale (3 floats)
-        stream.read(reinterpret_cast<char *>(&node.vertexScale), sizeof(Vector3f));
+        if (!cursor.read(nameLength) || !cursor.readString(nameLength, node.name) || !cursor.alignTo4())
+            return false;
+        if (validation == LmbValidation::FULL && node.name.length() > MaxNameLength)
+        {
+            throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, "Node name too long: " + std::string(node.name),
+                                             "", static_cast<int64_t>(nodeOffset)));
+        }
 
-        // 顶点数量
+        // 读取3x3变换矩阵、位置、baseVertex、vertexScale（文件中连续 18 个 float）与顶点数量
+        Span<float> header;
         uint32_t vertexCount;
-        stream.read(reinterpret_cast<char *>(&vertexCount), sizeof(uint32_t));
-
-        // 压缩顶点数据 (short数组，长度为(vertexCount-1)*3)
-        uint32_t compressedVertexCount = (vertexCount - 1) * 3;
-        node.compressVertices.resize(compressedVertexCount);
-        stream.read(reinterpret_cast<char *>(node.compressVertices.data()),
-                    compressedVertexCount * sizeof(int16_t));
-        AlignTo4Bytes(stream);
+        if (!cursor.readSpan(18, header) || !cursor.read(vertexCount))
+            return false;
+        if (vertexCount == 0)
+            return false;
+        std::memcpy(node.matrix, header.data(), sizeof(node.matrix));
+        std::memcpy(&node.position, header.data() + 9, sizeof(Vector3f));
+        std::memcpy(&node.baseVertex, header.data() + 12, sizeof(Vector3f));
+        std::memcpy(&node.vertexScale, header.data() + 15, sizeof(Vector3f));
+        if (validation == LmbValidation::FULL && !LmbSimd::AllFinite(header.data(), header.size()))
+            ThrowNonFiniteNode(node, nodeOffset);
+
+        // 压缩顶点数据 (short数组，长度为(vertexCount-1)*3)；法线数量与顶点数一致由布局保证
+        const uint64_t compressedVertexCount = (static_cast<uint64_t>(vertexCount) - 1) * 3;
+        if (!cursor.readSpan(compressedVertexCount, node.compressVertices) || !cursor.alignTo4())
+            return false;
 
         // 读取压缩法线数据
-        uint32_t normalCount = vertexCount;
-        node.normals.resize(normalCount);
-        stream.read(reinterpret_cast<char *>(node.normals.data()),
-                    normalCount * sizeof(int32_t));
-        AlignTo4Bytes(stream);
+        if (!cursor.readSpan(vertexCount, node.normals) || !cursor.alignTo4())
+            return false;
 
-        // Read indices
+        // Read indices（宽度由顶点数量决定）
         uint32_t indexCount;
-        stream.read(reinterpret_cast<char *>(&indexCount), sizeof(uint32_t));
-        node.indices.resize(indexCount);
-
-        if (vertexCount <= 255)
-        {
-            std::vector<uint8_t> tempIndices(indexCount);
-            stream.read(reinterpret_cast<char *>(tempIndices.data()), indexCount);
-            std::transform(tempIndices.begin(), tempIndices.end(),
-                           node.indices.begin(),
-                           [](uint8_t v)
-                           { return static_cast<uint32_t>(v); });
-            AlignTo4Bytes(stream);
-        }
-        else if (vertexCount <= 65535)
-        {
-            std::vector<uint16_t> tempIndices(indexCount);
-            stream.read(reinterpret_cast<char *>(tempIndices.data()),
-                        indexCount * sizeof(uint16_t));
-            std::transform(tempIndices.begin(), tempIndices.end(),
-                           node.indices.begin(),
-                           [](uint16_t v)
-                           { return static_cast<uint32_t>(v); });
-            AlignTo4Bytes(stream);
-        }
-        else
+        if (!cursor.read(indexCount))
+            return false;
+        const uint64_t indicesOffset = cursor.position();
+        const uint32_t indexWidth = IndexWidth(vertexCount);
+        if (!cursor.readIndices(indexCount, indexWidth, node.indices) || !cursor.alignTo4())
+            return false;
+        if (validation != LmbValidation::OFF)
+            ValidateIndices(node, vertexCount, indicesOffset);
+
+        // Read color index（颜色 StateSet 按下标取用，任何校验级别都检查）
+        if (!cursor.read(node.colorIndex))
+            return false;
+        if (node.colorIndex >= colorCount)
         {
-            stream.read(reinterpret_cast<char *>(node.indices.data()),
-                        indexCount * sizeof(uint32_t));
+            std::ostringstream oss;
+            oss << "Color index out of range in node " << node.name << ": " << node.colorIndex << " >= " << colorCount;
+            throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, oss.str(), "", static_cast<int64_t>(nodeOffset)));
         }
 
-        // Read color index
-        stream.read(reinterpret_cast<char *>(&node.colorIndex), sizeof(uint32_t));
-
         // Read instances
-        return ReadInstances(stream, node.instances);
+        return ReadInstances(cursor, node, validation, colorCount);
     }
 
-    void LmbParser::AlignTo4Bytes(std::istream &stream)
+    template <typename Cursor>
+    bool LmbParser::ScanNode(Cursor &cursor, NodeRecord &record)
     {
-        auto pos = stream.tellg();
-        auto padding = (4 - (pos % 4)) % 4;
-        if (padding > 0)
+        record.offset = cursor.position();
+
+        // 名称
+        uint16_t nameLength;
+        if (!cursor.read(nameLength) || !cursor.skip(nameLength) || !cursor.alignTo4())
+            return false;
+
+        // 矩阵(9) + 位置(3) + baseVertex(3) + vertexScale(3)
+        if (!cursor.skip(sizeof(float) * 18) || !cursor.read(record.vertexCount) || record.vertexCount == 0)
+            return false;
+
+        // 压缩顶点 + 法线
+        const uint64_t vertexCount = record.vertexCount;
+        if (!cursor.skip((vertexCount - 1) * 3 * sizeof(int16_t)) || !cursor.alignTo4() ||
+            !cursor.skip(vertexCount * sizeof(int32_t)))
+            return false;
+
+        // 索引
+        const uint32_t indexWidth = IndexWidth(vertexCount);
+        if (!cursor.read(record.indexCount) || !cursor.skip(uint64_t(record.indexCount) * indexWidth) || !cursor.alignTo4())
+            return false;
+
+        // 颜色索引 + 实例
+        if (!cursor.skip(sizeof(uint32_t)) || !cursor.read(record.instanceCount))
+            return false;
+        for (uint32_t i = 0; i < record.instanceCount; ++i)
         {
-            stream.seekg(padding, std::ios::cur);
+            uint16_t instNameLength;
+            if (!cursor.read(instNameLength) || !cursor.skip(instNameLength) || !cursor.alignTo4() ||
+                !cursor.skip(sizeof(float) * 12 + sizeof(uint32_t)))
+                return false;
         }
+
+        record.byteSize = cursor.position() - record.offset;
+        return true;
+    }
+
+    bool LmbParser::DecodeNode(const LmbMappedFile &file, const NodeRecord &record, Node &node,
+                               LmbValidation validation, uint32_t colorCount, uint64_t imageOffset)
+    {
+        if (record.offset < imageOffset || record.offset - imageOffset + record.byteSize > file.size())
+            return false;
+        ByteCursor cursor(file.data() + (record.offset - imageOffset), record.byteSize, record.offset);
+        return ReadNode(cursor, node, validation, colorCount);
     }
 
-    osg::ref_ptr<osg::Geometry> LmbParser::CreateGeometry(const Node &node)
+    osg::ref_ptr<osg::Geometry> LmbParser::CreateGeometry(const Node &node, bool gpuDequantization)
     {
         osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
 
-        // 解压顶点数据
-        osg::ref_ptr<osg::Vec3Array> vertices = DecompressVertices(node);
-        geometry->setVertexArray(vertices);
+        if (gpuDequantization)
+        {
+            // 顶点与法线按文件格式原样上传，反量化在顶点着色器中完成
+            geometry->setVertexArray(CreateQuantizedVertices(node));
+            osg::ref_ptr<PackedNormalArray> normals = new PackedNormalArray(static_cast<unsigned int>(node.normals.size()));
+            if (!node.normals.empty())
+                std::memcpy(&(*normals)[0], node.normals.data(), node.normals.size() * sizeof(int32_t));
+            normals->setNormalize(true);
+            geometry->setNormalArray(normals, osg::Array::BIND_PER_VERTEX);
+
+            // OSG 无法遍历 int16 顶点，包围盒由量化范围直接给出
+            geometry->setComputeBoundingBoxCallback(new LmbShaders::FixedBoundCallback(ComputeQuantizedBound(node)));
+            osg::Vec3 invScale;
+            DequantizationParams(node, invScale);
+            LmbShaders::ApplyQuantization(geometry.get(), osg::Vec3(node.baseVertex.x, node.baseVertex.y, node.baseVertex.z),
+                                          invScale);
+        }
+        else
+        {
+            // 解压顶点数据
+            osg::ref_ptr<osg::Vec3Array> vertices = DecompressVertices(node);
+            geometry->setVertexArray(vertices);
 
-        // 法线
-        osg::ref_ptr<osg::Vec3Array> normals = DecodeNormals(node.normals);
-        geometry->setNormalArray(normals, osg::Array::BIND_PER_VERTEX);
+            // 法线
+            osg::ref_ptr<osg::Vec3Array> normals = DecodeNormals(node.normals);
+            geometry->setNormalArray(normals, osg::Array::BIND_PER_VERTEX);
+        }
 
-        // 索引
-        osg::ref_ptr<osg::DrawElementsUInt> indices =
-            new osg::DrawElementsUInt(GL_TRIANGLES);
-        indices->insert(indices->end(),
-                        node.indices.begin(),
-                        node.indices.end());
-        geometry->addPrimitiveSet(indices);
+        // 索引：按文件中的宽度直接生成 8/16/32 位图元，一次拷贝且不放大显存
+        const unsigned int indexCount = static_cast<unsigned int>(node.indices.size());
+        osg::ref_ptr<osg::DrawElements> indices;
+        switch (node.indices.width())
+        {
+        case 1:
+            indices = new osg::DrawElementsUByte(GL_TRIANGLES, indexCount,
+                                                 static_cast<const GLubyte *>(node.indices.data()));
+            break;
+        case 2:
+            indices = new osg::DrawElementsUShort(GL_TRIANGLES, indexCount,
+                                                  static_cast<const GLushort *>(node.indices.data()));
+            break;
+        default:
+            indices = new osg::DrawElementsUInt(GL_TRIANGLES, indexCount,
+                                                static_cast<const GLuint *>(node.indices.data()));
+            break;
+        }
+        geometry->addPrimitiveSet(indices.get());
 
         // 启用显示列表以提高渲染性能
         geometry->setUseDisplayList(true);
@@ -463,34 +1445,12 @@ namespace LmbPlugin
         return geometry;
     }
 
-    osg::ref_ptr<osg::Vec3Array> LmbParser::DecodeNormals(const std::vector<int32_t> &encodedNormals)
+    osg::ref_ptr<osg::Vec3Array> LmbParser::DecodeNormals(const Span<int32_t> &encodedNormals)
     {
-        osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
-
-        for (size_t i = 0; i < encodedNormals.size(); i += 1)
-        {
-            uint32_t packed = static_cast<uint32_t>(encodedNormals[i]);
-
-            // 提取各个分量 (每个分量使用10位)
-            int x = (packed >> 20) & 0x3FF; // 取高10位
-            int y = (packed >> 10) & 0x3FF; // 取中间10位
-            int z = packed & 0x3FF;         // 取低10位
-
-            // 处理负数情况 (从0~1023转换回-512~511范围)
-            x = x >= 512 ? x - 1024 : x;
-            y = y >= 512 ? y - 1024 : y;
-            z = z >= 512 ? z - 1024 : z;
-
-            // 将整数值转换为浮点数并进行缩放
-            float nx = x / 511.0f;
-            float ny = y / 511.0f;
-            float nz = z / 511.0f;
-
-            osg::Vec3 normal(nx, ny, nz);
-            normal.normalize();
-            normals->push_back(normal);
-        }
-
+        // 每个分量 10 位有符号整数，解包与归一化由 SIMD 内核批量完成
+        osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array(static_cast<unsigned int>(encodedNormals.size()));
+        if (!encodedNormals.empty())
+            LmbSimd::DecodeNormals(encodedNormals.data(), encodedNormals.size(), (*normals)[0].ptr());
         return normals;
     }
 
@@ -526,26 +1486,78 @@ namespace LmbPlugin
     osg::ref_ptr<osg::Vec3Array> LmbParser::DecompressVertices(const Node &node)
     {
         // 按 OCC 规范：写入 q = (value - base) * scale；读取 value = base + q / scale
-        osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+        const size_t quantizedCount = node.compressVertices.size() / 3;
+        osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array(static_cast<unsigned int>(quantizedCount + 1));
         // 基准点
-        vertices->push_back(osg::Vec3(node.baseVertex.x, node.baseVertex.y, node.baseVertex.z));
+        (*vertices)[0].set(node.baseVertex.x, node.baseVertex.y, node.baseVertex.z);
+        // 预先求倒数，内核中只做乘加
+        const float base[3] = {node.baseVertex.x, node.baseVertex.y, node.baseVertex.z};
+        osg::Vec3 invScale;
+        DequantizationParams(node, invScale);
+        if (quantizedCount > 0)
+            LmbSimd::DequantizeVertices(node.compressVertices.data(), quantizedCount, base, invScale.ptr(), (*vertices)[1].ptr());
+        return vertices;
+    }
+
+    osg::ref_ptr<osg::Vec3Array> LmbParser::FloatPositions(const Node &node, osg::Geometry *geometry)
+    {
+        osg::ref_ptr<osg::Vec3Array> positions = dynamic_cast<osg::Vec3Array *>(geometry->getVertexArray());
+        return positions.valid() ? positions : DecompressVertices(node);
+    }
+
+    void LmbParser::OptimizeGeometry(osg::Geometry *geometry, osg::Vec3Array *positions, const std::string &name,
+                                     MeshOptimizer::Result &result)
+    {
+        MeshOptimizer::Optimize(geometry, positions, result);
+        if (result.triangles > 0)
+            PluginLogger::logDebug("LMB", "Optimized " + name + ": " + MeshOptimizer::Describe(result));
+    }
+
+    void LmbParser::DequantizationParams(const Node &node, osg::Vec3 &invScale)
+    {
         // 保护 scale 分量，避免除以 0
-        const float sx = (std::abs(node.vertexScale.x) > 1e-12f) ? node.vertexScale.x : 1.0f;
-        const float sy = (std::abs(node.vertexScale.y) > 1e-12f) ? node.vertexScale.y : 1.0f;
-        const float sz = (std::abs(node.vertexScale.z) > 1e-12f) ? node.vertexScale.z : 1.0f;
-        for (size_t i = 0; i < node.compressVertices.size(); i += 3)
-        {
-            float qx = static_cast<float>(node.compressVertices[i]);
-            float qy = static_cast<float>(node.compressVertices[i + 1]);
-            float qz = static_cast<float>(node.compressVertices[i + 2]);
-            float x = node.baseVertex.x + qx / sx;
-            float y = node.baseVertex.y + qy / sy;
-            float z = node.baseVertex.z + qz / sz;
-            vertices->push_back(osg::Vec3(x, y, z));
-        }
+        invScale.set((std::abs(node.vertexScale.x) > 1e-12f) ? 1.0f / node.vertexScale.x : 1.0f,
+                     (std::abs(node.vertexScale.y) > 1e-12f) ? 1.0f / node.vertexScale.y : 1.0f,
+                     (std::abs(node.vertexScale.z) > 1e-12f) ? 1.0f / node.vertexScale.z : 1.0f);
+    }
+
+    osg::ref_ptr<osg::Vec3sArray> LmbParser::CreateQuantizedVertices(const Node &node)
+    {
+        // 第 0 个顶点是基准点本身，对应量化值 (0, 0, 0)
+        const size_t quantizedCount = node.compressVertices.size() / 3;
+        osg::ref_ptr<osg::Vec3sArray> vertices = new osg::Vec3sArray(static_cast<unsigned int>(quantizedCount + 1));
+        (*vertices)[0].set(0, 0, 0);
+        if (quantizedCount > 0)
+            std::memcpy((*vertices)[1].ptr(), node.compressVertices.data(), quantizedCount * 3 * sizeof(int16_t));
         return vertices;
     }
 
+    osg::BoundingBox LmbParser::ComputeQuantizedBound(const Node &node)
+    {
+        int16_t lo[3] = {0, 0, 0};
+        int16_t hi[3] = {0, 0, 0};
+        for (size_t i = 0; i < node.compressVertices.size(); ++i)
+        {
+            const int16_t q = node.compressVertices[i];
+            const size_t axis = i % 3;
+            lo[axis] = std::min(lo[axis], q);
+            hi[axis] = std::max(hi[axis], q);
+        }
+        osg::Vec3 invScale;
+        DequantizationParams(node, invScale);
+        const osg::Vec3 base(node.baseVertex.x, node.baseVertex.y, node.baseVertex.z);
+        osg::BoundingBox box;
+        // 倒数可能为负，两端都要展开
+        box.expandBy(base + osg::Vec3(lo[0] * invScale.x(), lo[1] * invScale.y(), lo[2] * invScale.z()));
+        box.expandBy(base + osg::Vec3(hi[0] * invScale.x(), hi[1] * invScale.y(), hi[2] * invScale.z()));
+        return box;
+    }
+
+    uint32_t LmbParser::IndexWidth(uint32_t vertexCount)
+    {
+        return vertexCount <= 255 ? 1 : (vertexCount <= 65535 ? 2 : 4);
+    }
+
     osg::Vec4 LmbParser::CreateColorFromRGB(uint32_t color)
     {
         return osg::Vec4(
@@ -642,141 +1654,62 @@ namespace LmbPlugin
         }
     }
 
-    void LmbParser::validateNodeData(const Node &node, uint32_t colorCount)
+    LmbValidation LmbParser::DecodeValidation(const LmbLoadOptions &options)
     {
-        // Validate node name (allow empty names)
-        if (node.name.length() > 1000)
-        { // Reasonable limit
-            throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, "Node name too long: " + node.name));
-        }
-
-        // Validate transformation matrix
-        for (int i = 0; i < 9; ++i)
-        {
-            if (!std::isfinite(node.matrix[i]))
-            {
-                throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, "Invalid transformation matrix in node: " + node.name));
-            }
-        }
-
-        // Validate position
-        if (!std::isfinite(node.position.x) || !std::isfinite(node.position.y) || !std::isfinite(node.position.z))
-        {
-            throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, "Invalid position in node: " + node.name));
-        }
-
-        // Validate base vertex and scale
-        if (!std::isfinite(node.baseVertex.x) || !std::isfinite(node.baseVertex.y) || !std::isfinite(node.baseVertex.z))
-        {
-            throw LmbParseException(LmbError(LmbErrorType::INVALID_VERTEX_DATA, "Invalid base vertex in node: " + node.name));
-        }
-
-        if (!std::isfinite(node.vertexScale.x) || !std::isfinite(node.vertexScale.y) || !std::isfinite(node.vertexScale.z))
-        {
-            throw LmbParseException(LmbError(LmbErrorType::INVALID_VERTEX_DATA, "Invalid vertex scale in node: " + node.name));
-        }
-
-        // Validate vertex data consistency
-        if (node.compressVertices.size() % 3 != 0)
-        {
-            throw LmbParseException(LmbError(LmbErrorType::INVALID_VERTEX_DATA, "Compressed vertex data size not divisible by 3 in node: " + node.name));
-        }
-
-        size_t expectedVertexCount = (node.compressVertices.size() / 3) + 1; // +1 for base vertex
-        if (node.normals.size() != expectedVertexCount)
-        {
-            std::ostringstream oss;
-            oss << "Normal count mismatch in node " << node.name << ": expected " << expectedVertexCount << ", got " << node.normals.size();
-            throw LmbParseException(LmbError(LmbErrorType::INVALID_VERTEX_DATA, oss.str()));
-        }
+        // 越界索引在 GPU 上只影响渲染，在 LmbSimplify 中则是进程内的越界读取
+        if (options.validation == LmbValidation::OFF && options.lodTriangles > 0)
+            return LmbValidation::FAST;
+        return options.validation;
+    }
 
-        // Validate indices
+    void LmbParser::ValidateIndices(const Node &node, uint32_t vertexCount, uint64_t offset)
+    {
         if (node.indices.empty())
         {
-            throw LmbParseException(LmbError(LmbErrorType::INVALID_INDEX_DATA, "No indices in node: " + node.name));
+            throw LmbParseException(LmbError(LmbErrorType::INVALID_INDEX_DATA, "No indices in node: " + std::string(node.name),
+                                             "", static_cast<int64_t>(offset)));
         }
 
         if (node.indices.size() % 3 != 0)
         {
-            throw LmbParseException(LmbError(LmbErrorType::INVALID_INDEX_DATA, "Index count not divisible by 3 in node: " + node.name));
+            throw LmbParseException(LmbError(LmbErrorType::INVALID_INDEX_DATA,
+                                             "Index count not divisible by 3 in node: " + std::string(node.name),
+                                             "", static_cast<int64_t>(offset)));
         }
 
-        // Validate index values
+        // 向量化求最大索引，只有越界时才逐个查找第一个越界位置
+        if (LmbSimd::MaxIndex(node.indices.data(), node.indices.size(), node.indices.width()) < vertexCount)
+            return;
         for (size_t i = 0; i < node.indices.size(); ++i)
         {
-            if (node.indices[i] >= expectedVertexCount)
-            {
-                std::ostringstream oss;
-                oss << "Index out of range in node " << node.name << ": index " << node.indices[i] << " >= vertex count " << expectedVertexCount;
-                throw LmbParseException(LmbError(LmbErrorType::INVALID_INDEX_DATA, oss.str()));
-            }
-        }
-
-        // Validate color index
-        if (node.colorIndex >= colorCount)
-        {
-            std::ostringstream oss;
-            oss << "Color index out of range in node " << node.name << ": " << node.colorIndex << " >= " << colorCount;
-            throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, oss.str()));
-        }
-
-        // Validate instances
-        for (size_t i = 0; i < node.instances.size(); ++i)
-        {
-            const Instance &inst = node.instances[i];
-
-            // Validate instance transformation matrix
-            for (int j = 0; j < 9; ++j)
-            {
-                if (!std::isfinite(inst.matrix[j]))
-                {
-                    std::ostringstream oss;
-                    oss << "Invalid transformation matrix in instance " << i << " of node: " << node.name;
-                    throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, oss.str()));
-                }
-            }
-
-            // Validate instance position
-            if (!std::isfinite(inst.position.x) || !std::isfinite(inst.position.y) || !std::isfinite(inst.position.z))
+            if (node.indices[i] >= vertexCount)
             {
                 std::ostringstream oss;
-                oss << "Invalid position in instance " << i << " of node: " << node.name;
-                throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, oss.str()));
-            }
-
-            // Validate instance color index
-            if (inst.colorIndex >= colorCount)
-            {
-                std::ostringstream oss;
-                oss << "Color index out of range in instance " << i << " of node " << node.name << ": " << inst.colorIndex << " >= " << colorCount;
-                throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, oss.str()));
+                oss << "Index out of range in node " << node.name << ": index " << node.indices[i] << " at position " << i
+                    << " >= vertex count " << vertexCount;
+                throw LmbParseException(LmbError(LmbErrorType::INVALID_INDEX_DATA, oss.str(), "",
+                                                 static_cast<int64_t>(offset + uint64_t(i) * node.indices.width())));
             }
         }
     }
 
-    void LmbParser::validateStreamState(std::istream &stream, const std::string &operation, long position)
+    void LmbParser::ThrowNonFiniteNode(const Node &node, uint64_t offset)
     {
-        if (stream.fail())
-        {
-            std::ostringstream oss;
-            oss << "Stream error during " << operation;
-            if (position >= 0)
-            {
-                oss << " at position " << position;
-            }
-            throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, oss.str(), "", position));
-        }
-
-        if (stream.eof())
+        const auto finite = [](const Vector3f &v)
+        { return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z); };
+
+        LmbErrorType type = LmbErrorType::CORRUPTED_DATA;
+        std::string what;
+        if (!LmbSimd::AllFinite(node.matrix, 9))
+            what = "Invalid transformation matrix";
+        else if (!finite(node.position))
+            what = "Invalid position";
+        else
         {
-            std::ostringstream oss;
-            oss << "Unexpected end of file during " << operation;
-            if (position >= 0)
-            {
-                oss << " at position " << position;
-            }
-            throw LmbParseException(LmbError(LmbErrorType::CORRUPTED_DATA, oss.str(), "", position));
+            type = LmbErrorType::INVALID_VERTEX_DATA;
+            what = finite(node.baseVertex) ? "Invalid vertex scale" : "Invalid base vertex";
         }
+        throw LmbParseException(LmbError(type, what + " in node: " + std::string(node.name), "", static_cast<int64_t>(offset)));
     }
 
     std::string LmbParser::getErrorTypeString(LmbErrorType type)
@@ -810,7 +1743,7 @@ namespace LmbPlugin
         }
     }
 
-    void LmbParser::logError(LmbErrorType type, const std::string &message, const std::string &fileName, long position)
+    void LmbParser::logError(LmbErrorType type, const std::string &message, const std::string &fileName, int64_t position)
     {
         std::ostringstream oss;
         oss << getErrorTypeString(type) << ": " << message;
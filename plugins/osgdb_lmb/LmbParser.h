@@ -12,11 +12,17 @@
 #include <osg/Matrix>
 #include <osg/Geode>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory_resource>
+#include <cstdint>
 #include <iostream>
 #include <functional>
 #include <stdexcept>
 #include "../PluginLogger.h"
+#include "../MeshOptimizer.h"
+#include "../LoadProfile.h"
+#include "LmbMappedFile.h"
 
 namespace LmbPlugin
 {
@@ -47,9 +53,9 @@ namespace LmbPlugin
         LmbErrorType type;
         std::string message;
         std::string fileName;
-        long filePosition;
+        int64_t filePosition;
 
-        LmbError(LmbErrorType t, const std::string &msg, const std::string &file = "", long pos = -1)
+        LmbError(LmbErrorType t, const std::string &msg, const std::string &file = "", int64_t pos = -1)
             : type(t), message(msg), fileName(file), filePosition(pos) {}
     };
 
@@ -73,9 +79,10 @@ namespace LmbPlugin
         float x, y, z;
     };
 
+    // 以下结构中的 name / 数组字段均直接指向映射的文件内存，不做拷贝
     struct Instance
     {
-        std::string name;
+        std::string_view name;
         float matrix[9]; // 3x3变换矩阵
         Vector3f position;
         uint32_t colorIndex;
@@ -83,53 +90,261 @@ namespace LmbPlugin
 
     struct Node
     {
-        std::string name;
+        std::string_view name;
         float matrix[9]; // 3x3变换矩阵
         Vector3f position;
 
         // 压缩顶点数据
         Vector3f baseVertex;
         Vector3f vertexScale;
-        std::vector<int16_t> compressVertices;
+        Span<int16_t> compressVertices;
 
-        std::vector<int32_t> normals; // 压缩法线
-        std::vector<uint32_t> indices;
+        Span<int32_t> normals; // 压缩法线
+        IndexSpan indices;     // 保留文件中的索引宽度（1/2/4 字节）
         uint32_t colorIndex;
-        std::vector<Instance> instances;
+        std::pmr::vector<Instance> instances; // 批量解码时分配在工作线程的 LmbArena 暂存区，节点处理完即复位
+
+        explicit Node(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : instances(resource) {}
+    };
+
+    /**
+     * @brief Result of the offset scan: where a node lives in the file and how big it is
+     */
+    struct NodeRecord
+    {
+        uint64_t offset = 0;   // 节点记录起始的文件偏移
+        uint64_t byteSize = 0; // 节点记录字节数（含对齐与实例）
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        uint32_t instanceCount = 0;
+    };
+
+    /**
+     * @brief One node in the sidecar index (see LmbIndex)
+     */
+    struct LmbIndexEntry
+    {
+        std::string name;         // 有效节点名（无名节点为 Node_<序号>）
+        NodeRecord record;
+        osg::BoundingBox bounds;  // 节点及全部实例的世界包围盒（含场景平移）
+    };
+
+    /**
+     * @brief How much of each node record is checked while it is decoded ("validate" option)
+     *
+     * Color indices are always checked because the loader itself indexes its
+     * color StateSets with them.
+     */
+    enum class LmbValidation
+    {
+        OFF,  // 仅检查颜色下标（开启 LOD 简化时按 FAST 处理），用于可信的生产管线
+        FAST, // 另外检查索引数量与索引范围（越界索引会让渲染器崩溃）
+        FULL  // 另外检查名称长度与节点/实例的矩阵、位置、量化参数均为有限值
+    };
+
+    /**
+     * @brief Load options, parsed from the ReaderWriterLMB option string
+     */
+    struct LmbLoadOptions
+    {
+        unsigned threadCount = 0;        // 解码/构建线程数，0 = 硬件并发数
+        bool hardwareInstancing = false; // 带实例列表的节点用一次 glDrawElementsInstanced 绘制
+        bool gpuDequantization = false;  // 顶点/法线以 int16 与 10:10:10 原样上传，着色器中反量化
+        bool useIndex = true;            // 读取/生成 .lmbi 边车索引
+        std::vector<std::string> nodeNames; // 只加载这些节点（"#N" 表示第 N 个），空 = 不按名称过滤
+        osg::BoundingBox boundsFilter;      // 只加载世界包围盒与之相交的节点，无效 = 不过滤
+        bool paged = false;                 // 每个节点一个 PagedLOD，由 DatabasePager 按需解码
+        float pagedMinPixels = 40.0f;       // 节点屏幕尺寸（像素）达到该值才加载
+        unsigned pagedBudgetMB = 0;         // 常驻分页几何的内存预算，0 = DatabasePager 默认
+        bool staticBatching = false;        // 非实例化节点按颜色合并为预变换的大顶点缓冲
+        uint32_t batchMaxVertices = 65536;  // 每个合批几何的顶点数上限
+        bool deduplicate = true;            // 内容完全相同的节点网格共享同一个 Geometry
+        uint32_t lodTriangles = 0;          // 三角形数达到该值的节点生成简化 LOD，0 = 关闭
+        float lodPixels = 300.0f;           // 屏幕尺寸（像素）低于该值切换到第一级简化
+        unsigned lodLevels = 3;             // 最多生成的简化层级数
+        bool optimizeMeshes = false;        // 重排三角形与顶点以提高顶点缓存命中率、减少过度绘制
+        std::string tracePath;              // 分阶段计时写为 Chrome trace，空 = 仅由环境变量决定
+        LmbValidation validation = LmbValidation::FULL; // 解码时逐节点校验的级别
+
+        bool hasNodeFilter() const { return !nodeNames.empty() || boundsFilter.valid(); }
+    };
+
+    /**
+     * @brief Counters collected while loading, logged as a summary after each load
+     */
+    struct LmbLoadStats
+    {
+        size_t nodeCount = 0;        // 文件中的节点数
+        size_t instanceCount = 0;    // 额外实例数（不含节点自身）
+        size_t vertexCount = 0;      // 解码的顶点总数
+        size_t indexCount = 0;       // 索引总数
+        uint64_t indexBytes = 0;     // 按文件原始宽度（8/16/32 位）保存的索引字节数
+        uint64_t vertexBytes = 0;    // 顶点 + 法线数组字节数
+        size_t uniqueStateSets = 0;  // 创建的颜色 StateSet 数（按颜色值去重）
+        size_t instancedDraws = 0;   // 硬件实例化绘制的节点数
+        size_t batchedParts = 0;     // 合批的节点/实例数
+        size_t batchCount = 0;       // 合批后的几何（绘制调用）数
+        size_t dedupMeshes = 0;      // 复用已有 Geometry 的节点数（内容去重）
+        uint64_t dedupBytes = 0;     // 去重节省的顶点 + 索引字节数
+        size_t lodNodes = 0;         // 带简化 LOD 的变换节点数
+        size_t optimizedMeshes = 0;  // 经过索引优化的网格数
+        MeshOptimizer::Result optimization; // 优化前后模拟的顶点变换次数（所有优化网格之和）
+        uint64_t residentBytesBefore = 0; // 加载前进程常驻内存
+        uint64_t residentBytesAfter = 0;  // 加载后进程常驻内存
+        uint64_t peakResidentBytes = 0;   // 进程常驻内存峰值（平台不支持时为 0）
+
+        std::string summary() const;
+    };
+
+    /**
+     * @brief One transform produced by BuildNode; the color StateSet is attached later on the calling thread
+     */
+    struct BuiltNode
+    {
+        osg::ref_ptr<osg::MatrixTransform> transform;
+        osg::ref_ptr<osg::Geode> geode;
+        uint32_t colorIndex = 0;
+        bool instanced = false; // 实例化节点自带着色器状态，不使用颜色 StateSet
+        std::vector<osg::ref_ptr<osg::Geode>> lodGeodes; // 简化层级的 Geode，与 geode 共用颜色 StateSet
+        MeshOptimizer::Result optimization; // 仅新构建网格的第一个变换节点填写，共享该网格的节点不重复统计
     };
 
+    // 节点网格的各细节层级，[0] 为完整几何，其余为逐级简化（共享顶点数组）
+    typedef std::vector<osg::ref_ptr<osg::Geometry>> MeshLevels;
+
+    /**
+     * @brief Render state shared by all nodes of one load, attached to built nodes on the calling thread
+     */
+    struct SceneStates
+    {
+        std::vector<osg::ref_ptr<osg::StateSet>> colorStates; // 与颜色表下标一一对应
+        osg::ref_ptr<osg::StateSet> instancingState;          // 仅开启硬件实例化时创建
+        osg::ref_ptr<osg::StateSet> floatVertexState;         // gpudequant 与合批同时开启时，合批几何关闭量化变体
+    };
+
+    class LmbPagedContext;
+    struct LmbBatchSource;
+    struct LmbBatchPart;
+    class LmbGeometryCache;
+
     class LmbParser
     {
     public:
+        // 每顶点字节数：float 位置 + float 法线，或 int16 位置 + 打包法线
+        static const uint32_t FloatVertexBytes = 24;
+        static const uint32_t QuantizedVertexBytes = 10;
+        // 分页模式下根节点上记录建议的 DatabasePager 常驻页数（int）
+        static const char *const PagedTargetCountName;
+        // 颜色 StateSet 上记录的文件原始颜色（unsigned int，0xRRGGBB），LmbWriter 写回时据此还原颜色表
+        static const char *const ColorValueName;
+        // 完整校验时允许的最长节点名
+        static const size_t MaxNameLength = 1000;
+
         static osg::ref_ptr<osg::Group> parseFile(const std::string &filepath);
         // 支持进度回调的重载（文本提示），回调不要太频繁
         static osg::ref_ptr<osg::Group> parseFile(const std::string &filepath,
                                                   std::function<void(const char *)> progressCb);
+        static osg::ref_ptr<osg::Group> parseFile(const std::string &filepath,
+                                                  std::function<void(const char *)> progressCb,
+                                                  const LmbLoadOptions &options,
+                                                  LmbLoadStats *stats = nullptr);
+
+        /**
+         * @brief Parse LMB data from a forward-only stream (archives, pipes)
+         *
+         * Nodes are decoded and built one at a time as they arrive, so peak
+         * memory is bounded by the largest single node record, not the file.
+         * @param stream Input stream, read once from its current position
+         * @param streamName Name used in log and error messages
+         */
+        static osg::ref_ptr<osg::Group> parseStream(std::istream &stream, const std::string &streamName,
+                                                    std::function<void(const char *)> progressCb,
+                                                    const LmbLoadOptions &options,
+                                                    LmbLoadStats *stats = nullptr);
+
+        /**
+         * @brief Decode and build one node of a paged scene (called from DatabasePager threads)
+         * @return Group with the node's transforms, or nullptr if the record cannot be decoded
+         */
+        static osg::ref_ptr<osg::Group> loadPage(const LmbPagedContext &context, size_t nodeIndex);
+
+        // 索引宽度由顶点数决定：<=255 为 1 字节，<=65535 为 2 字节，否则 4 字节
+        static uint32_t IndexWidth(uint32_t vertexCount);
 
     private:
         // Error handling methods
         static void validateFileAccess(const std::string &filepath);
         static void validateHeader(const Vector3f &position, uint32_t colorCount, uint32_t nodeCount);
         static void validateColorData(const std::vector<uint32_t> &colors, uint32_t expectedCount);
-        static void validateNodeData(const Node &node, uint32_t colorCount);
-        static void validateStreamState(std::istream &stream, const std::string &operation, long position = -1);
+        // 解码时的节点校验，只在出错时生成错误信息；offset 为出错数据的文件偏移
+        static void ValidateIndices(const Node &node, uint32_t vertexCount, uint64_t offset);
+        // 实际使用的校验级别：LOD 简化在 CPU 上按索引读取顶点，off 时仍检查索引范围
+        static LmbValidation DecodeValidation(const LmbLoadOptions &options);
+        [[noreturn]] static void ThrowNonFiniteNode(const Node &node, uint64_t offset);
         static std::string getErrorTypeString(LmbErrorType type);
-        static void logError(LmbErrorType type, const std::string &message, const std::string &fileName = "", long position = -1);
+        static void logError(LmbErrorType type, const std::string &message, const std::string &fileName = "", int64_t position = -1);
         static void SetupSceneState(osg::ref_ptr<osg::Group> root);
         static osg::ref_ptr<osg::StateSet> CreateSharedState(uint32_t color);
+        // 按颜色表构建共享 StateSet，相同颜色值复用同一个对象；返回值与颜色表下标一一对应
+        static std::vector<osg::ref_ptr<osg::StateSet>> CreateColorStates(const std::vector<uint32_t> &colors,
+                                                                          size_t &uniqueCount);
         static osg::ref_ptr<osg::Material> CreateMaterial(const osg::Vec4 &color);
-        static bool ReadFile(const std::string &filepath, Vector3f &scenePosition,
-                             std::vector<uint32_t> &colors, std::vector<Node> &nodes,
-                             std::function<void(const char *)> progressCb = nullptr);
-
-        static bool ReadColors(std::istream &stream, uint32_t colorCount, std::vector<uint32_t> &colors);
-        static bool ReadInstances(std::istream &stream, std::vector<Instance> &instances);
-        static bool ReadHeader(std::istream &stream, Vector3f &position, uint32_t &colorCount, uint32_t &nodeCount);
-        static bool ReadNode(std::istream &stream, Node &node);
-        static void AlignTo4Bytes(std::istream &stream);
-        static osg::ref_ptr<osg::Geometry> CreateGeometry(const Node &node);
-        static osg::ref_ptr<osg::Vec3Array> DecodeNormals(const std::vector<int32_t> &encodedNormals);
+        // 文件/流两条路径共用的场景骨架、共享状态与统计
+        static osg::ref_ptr<osg::Group> CreateSceneRoot(const Vector3f &position,
+                                                        osg::ref_ptr<osg::MatrixTransform> &sceneTransform);
+        static SceneStates CreateSceneStates(const std::vector<uint32_t> &colors, const LmbLoadOptions &options,
+                                             LmbLoadStats &stats);
+        static void AccumulateStats(const NodeRecord &record, const LmbLoadOptions &options, LmbLoadStats &stats);
+        static void RecordMemoryStats(LmbLoadStats &stats);
+        static void AttachNodes(std::vector<BuiltNode> &nodes, const SceneStates &states,
+                                osg::Group *parent, LmbLoadStats &stats);
+        // 统计场景对象数记入 build/states 阶段的分配次数，然后输出并挂接计时结果
+        static void PublishProfile(LoadProfile &profile, osg::Group &root, const std::string &tracePath);
+        // 第一阶段：读取文件头、颜色表，并扫描每个节点的偏移与大小（不解码数组）
+        // index 与文件节点数一致时直接采用其中的记录，跳过扫描
+        // Cursor 为 ByteCursor（映射的 .lmb）或 LmbCompression::BlockReader（.lmbz，逐块解压）
+        template <typename Cursor>
+        static bool ReadFile(Cursor &cursor, const std::string &filepath, Vector3f &scenePosition,
+                             std::vector<uint32_t> &colors, std::vector<NodeRecord> &records,
+                             std::function<void(const char *)> progressCb = nullptr,
+                             const std::vector<LmbIndexEntry> *index = nullptr);
+        // 第二阶段：在 record 处解码单个节点，节点数据指向 file 的映射内存
+        // 解码的同时按 validation 级别校验，数据无效时抛出 LmbParseException，记录不完整时返回 false
+        // imageOffset 为 file 首字节在文件中的偏移（分页解压的局部块镜像），对齐仍按文件偏移计算
+        static bool DecodeNode(const LmbMappedFile &file, const NodeRecord &record, Node &node,
+                               LmbValidation validation, uint32_t colorCount, uint64_t imageOffset = 0);
+        // cache 非空时，非实例化节点与内容相同的已构建节点共享 Geometry
+        static void BuildNode(const Node &node, size_t nodeIndex, const LmbLoadOptions &options,
+                              std::vector<BuiltNode> &outNodes, LmbGeometryCache *cache = nullptr);
+        // 合批模式：解码节点几何并为节点及其实例各生成一个合批部件；索引拷贝分配在 arena 中
+        static void CollectBatchParts(const Node &node, size_t nodeIndex, std::pmr::memory_resource *arena,
+                                      LmbBatchSource &source, std::vector<LmbBatchPart> &parts);
+        static std::string NodeName(const Node &node, size_t nodeIndex);
+        // 节点及其实例在世界坐标（含场景平移）下的包围盒
+        static osg::BoundingBox ComputeNodeBounds(const Node &node, const Vector3f &scenePosition);
+        static bool IsSelected(const LmbLoadOptions &options, const std::string &name, size_t nodeIndex,
+                               const osg::BoundingBox &bounds);
+
+        template <typename Cursor>
+        static bool ReadColors(Cursor &cursor, uint32_t colorCount, std::vector<uint32_t> &colors);
+        static bool ReadInstances(ByteCursor &cursor, Node &node, LmbValidation validation, uint32_t colorCount);
+        template <typename Cursor>
+        static bool ReadHeader(Cursor &cursor, Vector3f &position, uint32_t &colorCount, uint32_t &nodeCount);
+        static bool ReadNode(ByteCursor &cursor, Node &node, LmbValidation validation, uint32_t colorCount);
+        // Cursor 为 ByteCursor（映射文件）或 LmbStreamReader（顺序流）
+        template <typename Cursor>
+        static bool ScanNode(Cursor &cursor, NodeRecord &record);
+        static osg::ref_ptr<osg::Geometry> CreateGeometry(const Node &node, bool gpuDequantization);
+        static osg::ref_ptr<osg::Vec3Array> DecodeNormals(const Span<int32_t> &encodedNormals);
         static osg::ref_ptr<osg::Vec3Array> DecompressVertices(const Node &node);
+        // geometry 的浮点顶点数组；量化布局时另行解码一份（顺序与 geometry 一致）
+        static osg::ref_ptr<osg::Vec3Array> FloatPositions(const Node &node, osg::Geometry *geometry);
+        // "optimize" 选项：重排索引与逐顶点数组（positions 一并重排），并记录优化前后的 ACMR
+        static void OptimizeGeometry(osg::Geometry *geometry, osg::Vec3Array *positions, const std::string &name,
+                                     MeshOptimizer::Result &result);
+        static osg::ref_ptr<osg::Vec3sArray> CreateQuantizedVertices(const Node &node);
+        static osg::BoundingBox ComputeQuantizedBound(const Node &node);
+        static void DequantizationParams(const Node &node, osg::Vec3 &invScale);
         static osg::Matrix CreateTransformMatrix(const float matrix[9], const Vector3f &position);
         static osg::Vec4 CreateColorFromRGB(uint32_t color);
     };
@@ -0,0 +1,125 @@
+#include "LmbShaders.h"
+#include "../PluginShaders.h"
+#include <osg/Shader>
+#include <string>
+
+namespace LmbPlugin
+{
+
+    namespace
+    {
+        const char *VertexShaderSource =
+            "#version 120\n"
+            "#extension GL_EXT_gpu_shader4 : enable\n"
+            "#pragma import_defines(LMB_INSTANCED, LMB_QUANTIZED)\n"
+            "#ifdef LMB_QUANTIZED\n"
+            "attribute vec3 lmbBase;\n"
+            "attribute vec3 lmbInvScale;\n"
+            "#endif\n"
+            "#ifdef LMB_INSTANCED\n"
+            "uniform samplerBuffer lmbInstanceData;\n"
+            "uniform samplerBuffer lmbPalette;\n"
+            "#endif\n"
+            "varying vec3 lmbEyeNormal;\n"
+            "varying vec3 lmbEyePosition;\n"
+            "varying vec3 lmbColor;\n"
+            "void main()\n"
+            "{\n"
+            "#ifdef LMB_QUANTIZED\n"
+            // int16 原样上传，第 0 个顶点即基准点（量化值为 0）；法线按 GL 布局解包后交换 x/z
+            "    vec4 vertex = vec4(lmbBase + gl_Vertex.xyz * lmbInvScale, 1.0);\n"
+            "    vec3 normal = gl_Normal.zyx;\n"
+            "#else\n"
+            "    vec4 vertex = gl_Vertex;\n"
+            "    vec3 normal = gl_Normal;\n"
+            "#endif\n"
+            "#ifdef LMB_INSTANCED\n"
+            // 每实例 4 个 texel：矩阵三列 + (颜色下标, 0, 0, 0)
+            "    int base = gl_InstanceID * 4;\n"
+            "    vec4 r0 = texelFetchBuffer(lmbInstanceData, base);\n"
+            "    vec4 r1 = texelFetchBuffer(lmbInstanceData, base + 1);\n"
+            "    vec4 r2 = texelFetchBuffer(lmbInstanceData, base + 2);\n"
+            "    int colorIndex = int(texelFetchBuffer(lmbInstanceData, base + 3).x);\n"
+            "    vertex = vec4(dot(r0, vertex), dot(r1, vertex), dot(r2, vertex), 1.0);\n"
+            // 法线用 3x3 部分的余子式矩阵变换，等价于逆转置（长度随后归一化）
+            "    vec3 c0 = cross(r1.xyz, r2.xyz);\n"
+            "    vec3 c1 = cross(r2.xyz, r0.xyz);\n"
+            "    vec3 c2 = cross(r0.xyz, r1.xyz);\n"
+            "    float detSign = dot(r0.xyz, c0) < 0.0 ? -1.0 : 1.0;\n"
+            "    normal = detSign * vec3(dot(c0, normal), dot(c1, normal), dot(c2, normal));\n"
+            "    lmbColor = texelFetchBuffer(lmbPalette, colorIndex).rgb * 0.8;\n"
+            "#else\n"
+            "    lmbColor = gl_FrontMaterial.diffuse.rgb;\n"
+            "#endif\n"
+            "    vec4 eyePosition = gl_ModelViewMatrix * vertex;\n"
+            "    lmbEyePosition = eyePosition.xyz;\n"
+            "    lmbEyeNormal = gl_NormalMatrix * normal;\n"
+            "    gl_Position = gl_ProjectionMatrix * eyePosition;\n"
+            "}\n";
+
+        // 近似 LmbParser::CreateMaterial 的固定管线效果：环境/漫反射同色，镜面 0.2，双面光照，累加全部光源；
+        // 关闭光照（PluginShaders::LightingUniform）时与固定管线一样直接输出材质色。#version 行与开关的声明由 CreateProgram 拼接
+        const char *FragmentShaderBody =
+            "varying vec3 lmbEyeNormal;\n"
+            "varying vec3 lmbEyePosition;\n"
+            "varying vec3 lmbColor;\n"
+            "void main()\n"
+            "{\n"
+            "    if (!pluginLighting)\n"
+            "    {\n"
+            "        gl_FragColor = vec4(lmbColor, 1.0);\n"
+            "        return;\n"
+            "    }\n"
+            "    vec3 N = normalize(lmbEyeNormal);\n"
+            "    if (!gl_FrontFacing) N = -N;\n"
+            "    vec3 color = gl_LightModel.ambient.rgb * lmbColor;\n"
+            "    for (int i = 0; i < gl_MaxLights; ++i)\n"
+            "    {\n"
+            "        vec4 lightPosition = gl_LightSource[i].position;\n"
+            "        vec3 L = lightPosition.w == 0.0 ? normalize(lightPosition.xyz)\n"
+            "                                        : normalize(lightPosition.xyz - lmbEyePosition);\n"
+            "        float NdotL = max(dot(N, L), 0.0);\n"
+            "        color += gl_LightSource[i].ambient.rgb * lmbColor + gl_LightSource[i].diffuse.rgb * lmbColor * NdotL;\n"
+            "        if (NdotL > 0.0) color += gl_LightSource[i].specular.rgb * 0.2;\n"
+            "    }\n"
+            "    gl_FragColor = vec4(color, 1.0);\n"
+            "}\n";
+    }
+
+    osg::ref_ptr<osg::Program> LmbShaders::CreateProgram()
+    {
+        osg::ref_ptr<osg::Program> program = new osg::Program;
+        program->setName("LmbShaders");
+        program->addShader(new osg::Shader(osg::Shader::VERTEX, VertexShaderSource));
+        const std::string fragmentSource = std::string("#version 120\n") + PluginShaders::LightingDeclaration + FragmentShaderBody;
+        program->addShader(new osg::Shader(osg::Shader::FRAGMENT, fragmentSource));
+        program->addBindAttribLocation("lmbBase", BaseAttribute);
+        program->addBindAttribLocation("lmbInvScale", InvScaleAttribute);
+        return program;
+    }
+
+    void LmbShaders::SetQuantized(osg::StateSet *stateSet, bool quantized)
+    {
+        stateSet->setDefine("LMB_QUANTIZED", quantized ? osg::StateAttribute::ON : osg::StateAttribute::OFF);
+    }
+
+    void LmbShaders::ApplyQuantization(osg::Geometry *geometry, const osg::Vec3 &base, const osg::Vec3 &invScale)
+    {
+        // 整个几何一个值：不需要自己的 StateSet，同色几何留在同一个 StateGraph 叶子里
+        geometry->setVertexAttribArray(BaseAttribute, new osg::Vec3Array(1, &base), osg::Array::BIND_OVERALL);
+        geometry->setVertexAttribArray(InvScaleAttribute, new osg::Vec3Array(1, &invScale), osg::Array::BIND_OVERALL);
+    }
+
+    bool LmbShaders::ReadQuantization(const osg::Geometry &geometry, osg::Vec3 &base, osg::Vec3 &invScale)
+    {
+        const osg::Vec3Array *baseArray = dynamic_cast<const osg::Vec3Array *>(geometry.getVertexAttribArray(BaseAttribute));
+        const osg::Vec3Array *invScaleArray =
+            dynamic_cast<const osg::Vec3Array *>(geometry.getVertexAttribArray(InvScaleAttribute));
+        if (!baseArray || !invScaleArray || baseArray->empty() || invScaleArray->empty())
+            return false;
+        base = baseArray->front();
+        invScale = invScaleArray->front();
+        return true;
+    }
+
+} // namespace LmbPlugin
@@ -0,0 +1,80 @@
+#ifndef LMBSHADERS_H
+#define LMBSHADERS_H
+
+#include <osg/Array>
+#include <osg/Drawable>
+#include <osg/Geometry>
+#include <osg/Program>
+#include <osg/StateSet>
+#include <osg/Vec3>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Packed 10:10:10:2 normals uploaded as-is (GL_INT_2_10_10_10_REV, one int per vertex)
+     *
+     * LMB stores x in bits 20-29 and z in bits 0-9, the reverse of the GL
+     * layout, so the shader swizzles the attribute back with .zyx.
+     */
+    typedef osg::TemplateArray<GLint, osg::Array::IntArrayType, 4, GL_INT_2_10_10_10_REV> PackedNormalArray;
+
+    /**
+     * @brief Shader program shared by the GPU render paths of the LMB loader
+     *
+     * One program with two optional defines:
+     * - LMB_QUANTIZED: gl_Vertex holds the raw int16 LMB positions and gl_Normal
+     *   the packed normals; the per-drawable lmbBase / lmbInvScale attributes
+     *   (BIND_OVERALL, no StateSet of their own) dequantize them.
+     * - LMB_INSTANCED: per-instance transforms and colors come from texture buffers.
+     * Without LMB_INSTANCED the color is taken from the fixed-function material.
+     * Lighting is per fragment over all light sources and follows
+     * PluginShaders::LightingUniform instead of GL_LIGHTING.
+     */
+    class LmbShaders
+    {
+    public:
+        static osg::ref_ptr<osg::Program> CreateProgram();
+
+        // 反量化参数的顶点属性位置（0/2/3/8 以上为固定管线属性的别名）
+        static const unsigned int BaseAttribute = 6;
+        static const unsigned int InvScaleAttribute = 7;
+
+        /**
+         * @brief Select the quantized shader variant for everything below a shared state
+         * @param stateSet Shared (per-color or instancing) state
+         * @param quantized false switches the variant off again, e.g. for float batches below a quantized state
+         */
+        static void SetQuantized(osg::StateSet *stateSet, bool quantized);
+
+        /**
+         * @brief Attach a drawable's dequantization parameters as two BIND_OVERALL vertex attributes
+         * @param geometry Geometry with int16 positions
+         * @param base Base vertex (position of quantized value 0)
+         * @param invScale Reciprocal of the per-axis quantization scale
+         */
+        static void ApplyQuantization(osg::Geometry *geometry, const osg::Vec3 &base, const osg::Vec3 &invScale);
+
+        /**
+         * @brief Read back the dequantization parameters set by ApplyQuantization
+         * @return false if the geometry is not quantized
+         */
+        static bool ReadQuantization(const osg::Geometry &geometry, osg::Vec3 &base, osg::Vec3 &invScale);
+
+        /**
+         * @brief Fixed bounding box for drawables whose vertex array OSG cannot walk (int16 positions)
+         */
+        class FixedBoundCallback : public osg::Drawable::ComputeBoundingBoxCallback
+        {
+        public:
+            explicit FixedBoundCallback(const osg::BoundingBox &box) : box_(box) {}
+            osg::BoundingBox computeBound(const osg::Drawable &) const override { return box_; }
+
+        private:
+            osg::BoundingBox box_;
+        };
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBSHADERS_H
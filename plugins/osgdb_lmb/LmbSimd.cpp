@@ -0,0 +1,448 @@
+#include "LmbSimd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define LMB_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define LMB_TARGET_AVX2
+#else
+#define LMB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace LmbPlugin
+{
+
+    namespace
+    {
+        // 10 位有符号分量：移到最高位后算术右移完成符号扩展
+        inline int32_t unpack10(uint32_t packed, int shift)
+        {
+            return static_cast<int32_t>(packed << (22 - shift)) >> 22;
+        }
+
+        void dequantizeScalar(const int16_t *q, size_t count, const float base[3], const float inv[3], float *out)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i * 3 + 0] = base[0] + static_cast<float>(q[i * 3 + 0]) * inv[0];
+                out[i * 3 + 1] = base[1] + static_cast<float>(q[i * 3 + 1]) * inv[1];
+                out[i * 3 + 2] = base[2] + static_cast<float>(q[i * 3 + 2]) * inv[2];
+            }
+        }
+
+        void decodeNormalsScalar(const int32_t *packed, size_t count, float *out)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint32_t p = static_cast<uint32_t>(packed[i]);
+                float x = static_cast<float>(unpack10(p, 20));
+                float y = static_cast<float>(unpack10(p, 10));
+                float z = static_cast<float>(unpack10(p, 0));
+                const float len2 = x * x + y * y + z * z;
+                const float inv = len2 > 0.0f ? 1.0f / std::sqrt(len2) : 0.0f;
+                out[i * 3 + 0] = x * inv;
+                out[i * 3 + 1] = y * inv;
+                out[i * 3 + 2] = z * inv;
+            }
+        }
+
+        // 指数位全 1 即 NaN 或 inf；按位判断，不受 -ffast-math 影响
+        const uint32_t FloatExponentMask = 0x7F800000u;
+
+        bool allFiniteScalar(const float *values, size_t count)
+        {
+            uint32_t bad = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32_t bits;
+                std::memcpy(&bits, values + i, sizeof(bits));
+                bad |= static_cast<uint32_t>((bits & FloatExponentMask) == FloatExponentMask);
+            }
+            return bad == 0;
+        }
+
+        template <typename T>
+        uint32_t maxIndexScalar(const T *indices, size_t count, uint32_t current)
+        {
+            for (size_t i = 0; i < count; ++i)
+                current = std::max<uint32_t>(current, indices[i]);
+            return current;
+        }
+
+#ifdef LMB_SIMD_X86
+        // 4 个 int16 符号扩展为 4 个 float（SSE2 没有 cvtepi16）
+        inline __m128 load4xI16(const int16_t *p)
+        {
+            __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+            v = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            return _mm_cvtepi32_ps(v);
+        }
+
+        // SoA (x0..x3, y0..y3, z0..z3) -> AoS x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+        inline void storeXyz4(float *out, __m128 x, __m128 y, __m128 z)
+        {
+            const __m128 xy01 = _mm_unpacklo_ps(x, y); // x0 y0 x1 y1
+            const __m128 xy23 = _mm_unpackhi_ps(x, y); // x2 y2 x3 y3
+            const __m128 zx01 = _mm_unpacklo_ps(z, x); // z0 x0 z1 x1
+            const __m128 yz01 = _mm_unpacklo_ps(y, z); // y0 z0 y1 z1
+            const __m128 zx23 = _mm_unpackhi_ps(z, x); // z2 x2 z3 x3
+            const __m128 yz23 = _mm_unpackhi_ps(y, z); // y2 z2 y3 z3
+            _mm_storeu_ps(out + 0, _mm_shuffle_ps(xy01, zx01, _MM_SHUFFLE(3, 0, 1, 0)));
+            _mm_storeu_ps(out + 4, _mm_shuffle_ps(yz01, xy23, _MM_SHUFFLE(1, 0, 3, 2)));
+            _mm_storeu_ps(out + 8, _mm_shuffle_ps(zx23, yz23, _MM_SHUFFLE(3, 2, 3, 0)));
+        }
+
+        inline __m128i unpack10x4(__m128i p, int leftShift)
+        {
+            return _mm_srai_epi32(_mm_sll_epi32(p, _mm_cvtsi32_si128(leftShift)), 22);
+        }
+
+        size_t dequantizeSse2(const int16_t *q, size_t count, const float base[3], const float inv[3], float *out)
+        {
+            // 每次 4 个顶点 = 12 个分量，三组 xyz 周期模式
+            const __m128 s0 = _mm_setr_ps(inv[0], inv[1], inv[2], inv[0]);
+            const __m128 s1 = _mm_setr_ps(inv[1], inv[2], inv[0], inv[1]);
+            const __m128 s2 = _mm_setr_ps(inv[2], inv[0], inv[1], inv[2]);
+            const __m128 b0 = _mm_setr_ps(base[0], base[1], base[2], base[0]);
+            const __m128 b1 = _mm_setr_ps(base[1], base[2], base[0], base[1]);
+            const __m128 b2 = _mm_setr_ps(base[2], base[0], base[1], base[2]);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const int16_t *src = q + i * 3;
+                float *dst = out + i * 3;
+                _mm_storeu_ps(dst + 0, _mm_add_ps(b0, _mm_mul_ps(load4xI16(src + 0), s0)));
+                _mm_storeu_ps(dst + 4, _mm_add_ps(b1, _mm_mul_ps(load4xI16(src + 4), s1)));
+                _mm_storeu_ps(dst + 8, _mm_add_ps(b2, _mm_mul_ps(load4xI16(src + 8), s2)));
+            }
+            return i;
+        }
+
+        size_t decodeNormalsSse2(const int32_t *packed, size_t count, float *out)
+        {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i *>(packed + i));
+                __m128 x = _mm_cvtepi32_ps(unpack10x4(p, 2));
+                __m128 y = _mm_cvtepi32_ps(unpack10x4(p, 12));
+                __m128 z = _mm_cvtepi32_ps(unpack10x4(p, 22));
+                const __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+                // 零向量的 1/0 = inf 被掩码清零
+                const __m128 inv = _mm_and_ps(_mm_div_ps(one, _mm_sqrt_ps(len2)), _mm_cmpgt_ps(len2, zero));
+                storeXyz4(out + i * 3, _mm_mul_ps(x, inv), _mm_mul_ps(y, inv), _mm_mul_ps(z, inv));
+            }
+            return i;
+        }
+
+        size_t allFiniteSse2(const float *values, size_t count, bool &finite)
+        {
+            const __m128i mask = _mm_set1_epi32(static_cast<int>(FloatExponentMask));
+            __m128i bad = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128i bits = _mm_castps_si128(_mm_loadu_ps(values + i));
+                bad = _mm_or_si128(bad, _mm_cmpeq_epi32(_mm_and_si128(bits, mask), mask));
+            }
+            finite = _mm_movemask_epi8(bad) == 0;
+            return i;
+        }
+
+        uint32_t horizontalMax(const uint32_t *lanes, size_t count)
+        {
+            uint32_t result = 0;
+            for (size_t i = 0; i < count; ++i)
+                result = std::max(result, lanes[i]);
+            return result;
+        }
+
+        // SSE2 没有无符号 16/32 位 max：翻转符号位后用有符号比较，结果再翻转回来
+        size_t maxIndexSse2(const void *indices, size_t count, uint32_t width, uint32_t &result)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t *>(indices);
+            const size_t perVector = 16 / width;
+            size_t i = 0;
+            if (width == 1)
+            {
+                __m128i acc = _mm_setzero_si128();
+                for (; i + perVector <= count; i += perVector)
+                    acc = _mm_max_epu8(acc, _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i)));
+                alignas(16) uint8_t bytesMax[16];
+                _mm_store_si128(reinterpret_cast<__m128i *>(bytesMax), acc);
+                result = *std::max_element(bytesMax, bytesMax + 16);
+            }
+            else if (width == 2)
+            {
+                const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+                __m128i acc = bias; // 0 翻转后的值
+                for (; i + perVector <= count; i += perVector)
+                {
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i * 2));
+                    acc = _mm_max_epi16(acc, _mm_xor_si128(v, bias));
+                }
+                acc = _mm_xor_si128(acc, bias);
+                alignas(16) uint16_t shortsMax[8];
+                _mm_store_si128(reinterpret_cast<__m128i *>(shortsMax), acc);
+                result = *std::max_element(shortsMax, shortsMax + 8);
+            }
+            else
+            {
+                const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+                __m128i acc = bias;
+                for (; i + perVector <= count; i += perVector)
+                {
+                    const __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i * 4)), bias);
+                    const __m128i greater = _mm_cmpgt_epi32(v, acc);
+                    acc = _mm_or_si128(_mm_and_si128(greater, v), _mm_andnot_si128(greater, acc));
+                }
+                alignas(16) uint32_t lanes[4];
+                _mm_store_si128(reinterpret_cast<__m128i *>(lanes), _mm_xor_si128(acc, bias));
+                result = horizontalMax(lanes, 4);
+            }
+            return i;
+        }
+
+        LMB_TARGET_AVX2 size_t dequantizeAvx2(const int16_t *q, size_t count, const float base[3], const float inv[3], float *out)
+        {
+            // 每次 8 个顶点 = 24 个分量，三组 8 宽的 xyz 周期模式
+            const __m256 s0 = _mm256_setr_ps(inv[0], inv[1], inv[2], inv[0], inv[1], inv[2], inv[0], inv[1]);
+            const __m256 s1 = _mm256_setr_ps(inv[2], inv[0], inv[1], inv[2], inv[0], inv[1], inv[2], inv[0]);
+            const __m256 s2 = _mm256_setr_ps(inv[1], inv[2], inv[0], inv[1], inv[2], inv[0], inv[1], inv[2]);
+            const __m256 b0 = _mm256_setr_ps(base[0], base[1], base[2], base[0], base[1], base[2], base[0], base[1]);
+            const __m256 b1 = _mm256_setr_ps(base[2], base[0], base[1], base[2], base[0], base[1], base[2], base[0]);
+            const __m256 b2 = _mm256_setr_ps(base[1], base[2], base[0], base[1], base[2], base[0], base[1], base[2]);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const int16_t *src = q + i * 3;
+                float *dst = out + i * 3;
+                const __m256 q0 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 0))));
+                const __m256 q1 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 8))));
+                const __m256 q2 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16))));
+                _mm256_storeu_ps(dst + 0, _mm256_add_ps(b0, _mm256_mul_ps(q0, s0)));
+                _mm256_storeu_ps(dst + 8, _mm256_add_ps(b1, _mm256_mul_ps(q1, s1)));
+                _mm256_storeu_ps(dst + 16, _mm256_add_ps(b2, _mm256_mul_ps(q2, s2)));
+            }
+            return i;
+        }
+
+        LMB_TARGET_AVX2 size_t decodeNormalsAvx2(const int32_t *packed, size_t count, float *out)
+        {
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(packed + i));
+                __m256 x = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(p, 2), 22));
+                __m256 y = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(p, 12), 22));
+                __m256 z = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(p, 22), 22));
+                const __m256 len2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+                const __m256 inv = _mm256_and_ps(_mm256_div_ps(one, _mm256_sqrt_ps(len2)), _mm256_cmp_ps(len2, zero, _CMP_GT_OQ));
+                x = _mm256_mul_ps(x, inv);
+                y = _mm256_mul_ps(y, inv);
+                z = _mm256_mul_ps(z, inv);
+                // 两个 128 位半区分别转置为 AoS
+                storeXyz4(out + i * 3, _mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z));
+                storeXyz4(out + i * 3 + 12, _mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1));
+            }
+            return i;
+        }
+
+        LMB_TARGET_AVX2 size_t allFiniteAvx2(const float *values, size_t count, bool &finite)
+        {
+            const __m256i mask = _mm256_set1_epi32(static_cast<int>(FloatExponentMask));
+            __m256i bad = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i bits = _mm256_castps_si256(_mm256_loadu_ps(values + i));
+                bad = _mm256_or_si256(bad, _mm256_cmpeq_epi32(_mm256_and_si256(bits, mask), mask));
+            }
+            finite = _mm256_testz_si256(bad, bad) != 0;
+            return i;
+        }
+
+        LMB_TARGET_AVX2 size_t maxIndexAvx2(const void *indices, size_t count, uint32_t width, uint32_t &result)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t *>(indices);
+            const size_t perVector = 32 / width;
+            __m256i acc = _mm256_setzero_si256();
+            size_t i = 0;
+            if (width == 1)
+            {
+                for (; i + perVector <= count; i += perVector)
+                    acc = _mm256_max_epu8(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i)));
+                alignas(32) uint8_t bytesMax[32];
+                _mm256_store_si256(reinterpret_cast<__m256i *>(bytesMax), acc);
+                result = *std::max_element(bytesMax, bytesMax + 32);
+            }
+            else if (width == 2)
+            {
+                for (; i + perVector <= count; i += perVector)
+                    acc = _mm256_max_epu16(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i * 2)));
+                alignas(32) uint16_t shortsMax[16];
+                _mm256_store_si256(reinterpret_cast<__m256i *>(shortsMax), acc);
+                result = *std::max_element(shortsMax, shortsMax + 16);
+            }
+            else
+            {
+                for (; i + perVector <= count; i += perVector)
+                    acc = _mm256_max_epu32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i * 4)));
+                alignas(32) uint32_t lanes[8];
+                _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+                result = horizontalMax(lanes, 8);
+            }
+            return i;
+        }
+
+        LmbSimd::Level detectLevel()
+        {
+            LmbSimd::Level level = LmbSimd::SCALAR;
+#ifdef _MSC_VER
+            int info[4] = {0, 0, 0, 0};
+            __cpuid(info, 0);
+            const int maxLeaf = info[0];
+            __cpuid(info, 1);
+            const bool sse2 = (info[3] & (1 << 26)) != 0;
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx = (info[2] & (1 << 28)) != 0;
+            bool avx2 = false;
+            if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6)
+            {
+                __cpuidex(info, 7, 0);
+                avx2 = (info[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            const bool sse2 = __builtin_cpu_supports("sse2");
+            const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+            if (sse2)
+                level = LmbSimd::SSE2;
+            if (sse2 && avx2)
+                level = LmbSimd::AVX2;
+            return level;
+        }
+#else
+        LmbSimd::Level detectLevel()
+        {
+            return LmbSimd::SCALAR;
+        }
+#endif
+
+        LmbSimd::Level resolveLevel()
+        {
+            LmbSimd::Level level = detectLevel();
+            if (const char *env = std::getenv("LMB_SIMD"))
+            {
+                const std::string requested(env);
+                LmbSimd::Level cap = level;
+                if (requested == "scalar")
+                    cap = LmbSimd::SCALAR;
+                else if (requested == "sse2")
+                    cap = LmbSimd::SSE2;
+                else if (requested == "avx2")
+                    cap = LmbSimd::AVX2;
+                if (cap < level)
+                    level = cap;
+            }
+            return level;
+        }
+    }
+
+    LmbSimd::Level LmbSimd::activeLevel()
+    {
+        static const Level level = resolveLevel();
+        return level;
+    }
+
+    const char *LmbSimd::levelName(Level level)
+    {
+        switch (level)
+        {
+        case AVX2:
+            return "AVX2";
+        case SSE2:
+            return "SSE2";
+        default:
+            return "scalar";
+        }
+    }
+
+    void LmbSimd::DequantizeVertices(const int16_t *quantized, size_t vertexCount,
+                                     const float base[3], const float invScale[3], float *out)
+    {
+        size_t done = 0;
+#ifdef LMB_SIMD_X86
+        const Level level = activeLevel();
+        if (level == AVX2)
+            done = dequantizeAvx2(quantized, vertexCount, base, invScale, out);
+        else if (level == SSE2)
+            done = dequantizeSse2(quantized, vertexCount, base, invScale, out);
+#endif
+        dequantizeScalar(quantized + done * 3, vertexCount - done, base, invScale, out + done * 3);
+    }
+
+    void LmbSimd::DecodeNormals(const int32_t *packed, size_t count, float *out)
+    {
+        size_t done = 0;
+#ifdef LMB_SIMD_X86
+        const Level level = activeLevel();
+        if (level == AVX2)
+            done = decodeNormalsAvx2(packed, count, out);
+        else if (level == SSE2)
+            done = decodeNormalsSse2(packed, count, out);
+#endif
+        decodeNormalsScalar(packed + done, count - done, out + done * 3);
+    }
+
+    bool LmbSimd::AllFinite(const float *values, size_t count)
+    {
+        size_t done = 0;
+        bool finite = true;
+#ifdef LMB_SIMD_X86
+        const Level level = activeLevel();
+        if (level == AVX2)
+            done = allFiniteAvx2(values, count, finite);
+        else if (level == SSE2)
+            done = allFiniteSse2(values, count, finite);
+#endif
+        return finite && allFiniteScalar(values + done, count - done);
+    }
+
+    uint32_t LmbSimd::MaxIndex(const void *indices, size_t count, uint32_t width)
+    {
+        size_t done = 0;
+        uint32_t result = 0;
+#ifdef LMB_SIMD_X86
+        const Level level = activeLevel();
+        if (level == AVX2)
+            done = maxIndexAvx2(indices, count, width, result);
+        else if (level == SSE2)
+            done = maxIndexSse2(indices, count, width, result);
+#endif
+        switch (width)
+        {
+        case 1:
+            return maxIndexScalar(static_cast<const uint8_t *>(indices) + done, count - done, result);
+        case 2:
+            return maxIndexScalar(static_cast<const uint16_t *>(indices) + done, count - done, result);
+        default:
+            return maxIndexScalar(static_cast<const uint32_t *>(indices) + done, count - done, result);
+        }
+    }
+
+} // namespace LmbPlugin
@@ -0,0 +1,68 @@
+#ifndef LMBSIMD_H
+#define LMBSIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Vectorized decode and validation kernels for LMB node data
+     *
+     * The instruction set is picked once at runtime (AVX2, SSE2 or scalar).
+     * Setting the environment variable LMB_SIMD=scalar|sse2|avx2 caps the
+     * level, which is handy when comparing decode throughput.
+     */
+    class LmbSimd
+    {
+    public:
+        enum Level
+        {
+            SCALAR = 0,
+            SSE2 = 1,
+            AVX2 = 2
+        };
+
+        /**
+         * @brief Instruction set used by the kernels on this machine
+         */
+        static Level activeLevel();
+        static const char *levelName(Level level);
+
+        /**
+         * @brief Dequantize interleaved int16 xyz triples: out = base + q * invScale
+         * @param quantized vertexCount * 3 int16 values
+         * @param vertexCount Number of vertices
+         * @param base Base vertex (x, y, z)
+         * @param invScale Precomputed reciprocal of the per-axis scale
+         * @param out vertexCount * 3 floats, must be pre-sized
+         */
+        static void DequantizeVertices(const int16_t *quantized, size_t vertexCount,
+                                       const float base[3], const float invScale[3], float *out);
+
+        /**
+         * @brief Unpack signed 10:10:10 normals (x in bits 20-29) and normalize them
+         * @param packed count packed normals
+         * @param count Number of normals
+         * @param out count * 3 floats, must be pre-sized; zero vectors stay zero
+         */
+        static void DecodeNormals(const int32_t *packed, size_t count, float *out);
+
+        /**
+         * @brief True if none of the values is NaN or infinite (exponent bits all set)
+         */
+        static bool AllFinite(const float *values, size_t count);
+
+        /**
+         * @brief Largest value of an 8/16/32-bit unsigned index buffer
+         * @param indices count indices of the given width
+         * @param width Bytes per index (1, 2 or 4)
+         * @return 0 for an empty buffer
+         */
+        static uint32_t MaxIndex(const void *indices, size_t count, uint32_t width);
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBSIMD_H
@@ -0,0 +1,331 @@
+#include "LmbSimplify.h"
+#include <osg/PrimitiveSet>
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace LmbPlugin
+{
+
+    namespace
+    {
+        // 边界约束平面相对面积权重的倍数，越大开放边界越不易收缩
+        const double BoundaryWeight = 10.0;
+        // 每轮收缩后重建拓扑，轮数上限防止病态网格空转
+        const unsigned MaxPasses = 32;
+        // 收缩后相邻三角形法线的最大转角（余弦），超过视为翻面
+        const double MinNormalCosine = 0.25;
+        // 简化层级的三角形数下限
+        const size_t MinLevelTriangles = 32;
+
+        struct Quadric
+        {
+            double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+            double b0 = 0, b1 = 0, b2 = 0, c = 0;
+
+            // 平面 n·p + d = 0 的距离平方误差
+            void addPlane(const osg::Vec3d &n, double d, double weight)
+            {
+                a00 += weight * n.x() * n.x();
+                a01 += weight * n.x() * n.y();
+                a02 += weight * n.x() * n.z();
+                a11 += weight * n.y() * n.y();
+                a12 += weight * n.y() * n.z();
+                a22 += weight * n.z() * n.z();
+                b0 += weight * d * n.x();
+                b1 += weight * d * n.y();
+                b2 += weight * d * n.z();
+                c += weight * d * d;
+            }
+
+            void add(const Quadric &q)
+            {
+                a00 += q.a00; a01 += q.a01; a02 += q.a02;
+                a11 += q.a11; a12 += q.a12; a22 += q.a22;
+                b0 += q.b0; b1 += q.b1; b2 += q.b2;
+                c += q.c;
+            }
+
+            double error(const osg::Vec3d &p) const
+            {
+                const double x = p.x(), y = p.y(), z = p.z();
+                return a00 * x * x + a11 * y * y + a22 * z * z +
+                       2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                       2.0 * (b0 * x + b1 * y + b2 * z) + c;
+            }
+        };
+
+        struct Candidate
+        {
+            double cost;
+            uint32_t from;
+            uint32_t to;
+        };
+
+        inline uint64_t EdgeKey(uint32_t a, uint32_t b)
+        {
+            return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+        }
+
+        inline uint32_t Find(std::vector<uint32_t> &parent, uint32_t v)
+        {
+            while (parent[v] != v)
+            {
+                parent[v] = parent[parent[v]];
+                v = parent[v];
+            }
+            return v;
+        }
+
+        osg::ref_ptr<osg::Geometry> CreateLevelGeometry(const osg::Geometry *geometry, const std::vector<uint32_t> &indices)
+        {
+            // 浅拷贝：顶点、法线、状态与包围盒回调都与完整层级共用
+            osg::ref_ptr<osg::Geometry> level = new osg::Geometry(*geometry, osg::CopyOp::SHALLOW_COPY);
+            level->removePrimitiveSet(0, level->getNumPrimitiveSets());
+
+            osg::ref_ptr<osg::DrawElements> elements;
+            switch (LmbParser::IndexWidth(geometry->getVertexArray()->getNumElements()))
+            {
+            case 1:
+                elements = new osg::DrawElementsUByte(GL_TRIANGLES, indices.begin(), indices.end());
+                break;
+            case 2:
+                elements = new osg::DrawElementsUShort(GL_TRIANGLES, indices.begin(), indices.end());
+                break;
+            default:
+                elements = new osg::DrawElementsUInt(GL_TRIANGLES, indices.begin(), indices.end());
+                break;
+            }
+            level->addPrimitiveSet(elements.get());
+            return level;
+        }
+    }
+
+    std::vector<uint32_t> LmbSimplify::Simplify(const osg::Vec3Array &positions, const std::vector<uint32_t> &indices,
+                                                size_t targetTriangles)
+    {
+        const uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+        if (indices.size() / 3 <= targetTriangles || vertexCount == 0)
+            return indices;
+
+        // 法线接缝处位置相同的顶点焊接为一个拓扑顶点，代表为其中下标最小者
+        std::vector<uint32_t> order(vertexCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(),
+                  [&positions](uint32_t a, uint32_t b)
+                  { return positions[a] < positions[b] || (!(positions[b] < positions[a]) && a < b); });
+        std::vector<uint32_t> weld(vertexCount);
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            const bool same = i > 0 && positions[order[i]] == positions[order[i - 1]];
+            weld[order[i]] = same ? weld[order[i - 1]] : order[i];
+        }
+        auto position = [&positions](uint32_t v)
+        { return osg::Vec3d(positions[v]); };
+
+        std::vector<uint32_t> triangles;
+        triangles.reserve(indices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const uint32_t a = weld[indices[i]], b = weld[indices[i + 1]], c = weld[indices[i + 2]];
+            if (a != b && b != c && a != c)
+                triangles.insert(triangles.end(), {a, b, c});
+        }
+
+        // 每个顶点累加相邻三角形平面（按面积加权）的二次误差
+        std::vector<Quadric> quadrics(vertexCount);
+        std::unordered_map<uint64_t, uint32_t> edgeUse;
+        edgeUse.reserve(triangles.size());
+        for (size_t t = 0; t < triangles.size(); t += 3)
+        {
+            const uint32_t *tri = &triangles[t];
+            osg::Vec3d normal = (position(tri[1]) - position(tri[0])) ^ (position(tri[2]) - position(tri[0]));
+            const double doubleArea = normal.normalize();
+            if (doubleArea > 0.0)
+            {
+                const double d = -(normal * position(tri[0]));
+                for (int k = 0; k < 3; ++k)
+                    quadrics[tri[k]].addPlane(normal, d, doubleArea * 0.5);
+            }
+            for (int k = 0; k < 3; ++k)
+                ++edgeUse[EdgeKey(tri[k], tri[(k + 1) % 3])];
+        }
+
+        // 开放边界：过边且垂直于三角形的约束平面，防止轮廓向内塌缩
+        for (size_t t = 0; t < triangles.size(); t += 3)
+        {
+            const uint32_t *tri = &triangles[t];
+            osg::Vec3d faceNormal = (position(tri[1]) - position(tri[0])) ^ (position(tri[2]) - position(tri[0]));
+            if (faceNormal.normalize() <= 0.0)
+                continue;
+            for (int k = 0; k < 3; ++k)
+            {
+                const uint32_t a = tri[k], b = tri[(k + 1) % 3];
+                if (edgeUse[EdgeKey(a, b)] != 1)
+                    continue;
+                const osg::Vec3d edge = position(b) - position(a);
+                osg::Vec3d planeNormal = edge ^ faceNormal;
+                if (planeNormal.normalize() <= 0.0)
+                    continue;
+                const double d = -(planeNormal * position(a));
+                quadrics[a].addPlane(planeNormal, d, BoundaryWeight * edge.length2());
+                quadrics[b].addPlane(planeNormal, d, BoundaryWeight * edge.length2());
+            }
+        }
+
+        std::vector<uint32_t> parent(vertexCount);
+        std::iota(parent.begin(), parent.end(), 0u);
+        std::vector<uint32_t> adjacencyOffsets, adjacency, cursor;
+        std::vector<uint64_t> edges;
+        std::vector<Candidate> candidates;
+        std::vector<char> locked;
+
+        for (unsigned pass = 0; pass < MaxPasses && triangles.size() / 3 > targetTriangles; ++pass)
+        {
+            // 顶点 -> 相邻三角形（CSR）
+            adjacencyOffsets.assign(vertexCount + 1, 0);
+            for (uint32_t v : triangles)
+                ++adjacencyOffsets[v + 1];
+            for (uint32_t v = 0; v < vertexCount; ++v)
+                adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+            adjacency.resize(triangles.size());
+            cursor.assign(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < triangles.size(); ++i)
+                adjacency[cursor[triangles[i]]++] = static_cast<uint32_t>(i / 3);
+
+            // 候选边：取两个收缩方向中误差较小者
+            edges.clear();
+            for (size_t t = 0; t < triangles.size(); t += 3)
+            {
+                for (int k = 0; k < 3; ++k)
+                    edges.push_back(EdgeKey(triangles[t + k], triangles[t + (k + 1) % 3]));
+            }
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+            candidates.clear();
+            candidates.reserve(edges.size());
+            for (uint64_t key : edges)
+            {
+                const uint32_t a = static_cast<uint32_t>(key >> 32), b = static_cast<uint32_t>(key);
+                Quadric q = quadrics[a];
+                q.add(quadrics[b]);
+                const double toB = q.error(position(b));
+                const double toA = q.error(position(a));
+                candidates.push_back(toB <= toA ? Candidate{toB, a, b} : Candidate{toA, b, a});
+            }
+            std::sort(candidates.begin(), candidates.end(),
+                      [](const Candidate &x, const Candidate &y)
+                      { return x.cost < y.cost; });
+
+            // 贪心收缩；被收缩顶点的一环邻域本轮锁定，翻面检测所用的位置因此保持有效
+            locked.assign(vertexCount, 0);
+            const size_t excess = triangles.size() / 3 - targetTriangles;
+            size_t removed = 0;
+            size_t collapses = 0;
+            for (const Candidate &candidate : candidates)
+            {
+                if (removed >= excess)
+                    break;
+                if (locked[candidate.from] || locked[candidate.to])
+                    continue;
+
+                const osg::Vec3d target = position(candidate.to);
+                size_t shared = 0;
+                bool flips = false;
+                for (uint32_t i = adjacencyOffsets[candidate.from]; i < adjacencyOffsets[candidate.from + 1] && !flips; ++i)
+                {
+                    const uint32_t *tri = &triangles[size_t(adjacency[i]) * 3];
+                    if (tri[0] == candidate.to || tri[1] == candidate.to || tri[2] == candidate.to)
+                    {
+                        ++shared;
+                        continue;
+                    }
+                    osg::Vec3d before[3], after[3];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        before[k] = position(tri[k]);
+                        after[k] = tri[k] == candidate.from ? target : before[k];
+                    }
+                    const osg::Vec3d n0 = (before[1] - before[0]) ^ (before[2] - before[0]);
+                    const osg::Vec3d n1 = (after[1] - after[0]) ^ (after[2] - after[0]);
+                    flips = n0 * n1 <= MinNormalCosine * n0.length() * n1.length();
+                }
+                if (flips)
+                    continue;
+
+                parent[candidate.from] = candidate.to;
+                quadrics[candidate.to].add(quadrics[candidate.from]);
+                locked[candidate.to] = 1;
+                for (uint32_t i = adjacencyOffsets[candidate.from]; i < adjacencyOffsets[candidate.from + 1]; ++i)
+                {
+                    const uint32_t *tri = &triangles[size_t(adjacency[i]) * 3];
+                    locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+                }
+                removed += shared;
+                ++collapses;
+            }
+            if (collapses == 0)
+                break;
+
+            // 应用收缩并去掉退化三角形
+            size_t write = 0;
+            for (size_t t = 0; t < triangles.size(); t += 3)
+            {
+                const uint32_t a = Find(parent, triangles[t]);
+                const uint32_t b = Find(parent, triangles[t + 1]);
+                const uint32_t c = Find(parent, triangles[t + 2]);
+                if (a == b || b == c || a == c)
+                    continue;
+                triangles[write++] = a;
+                triangles[write++] = b;
+                triangles[write++] = c;
+            }
+            triangles.resize(write);
+        }
+
+        // 映射回原始顶点：未被收缩的角保留原下标（保留法线接缝），否则指向收缩目标
+        std::vector<uint32_t> result;
+        result.reserve(triangles.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            uint32_t corner[3];
+            for (int k = 0; k < 3; ++k)
+            {
+                const uint32_t welded = weld[indices[i + k]];
+                const uint32_t root = Find(parent, welded);
+                corner[k] = root == welded ? indices[i + k] : root;
+            }
+            if (Find(parent, weld[corner[0]]) == Find(parent, weld[corner[1]]) ||
+                Find(parent, weld[corner[1]]) == Find(parent, weld[corner[2]]) ||
+                Find(parent, weld[corner[0]]) == Find(parent, weld[corner[2]]))
+                continue;
+            result.insert(result.end(), corner, corner + 3);
+        }
+        return result;
+    }
+
+    MeshLevels LmbSimplify::CreateLevels(osg::Geometry *geometry, const osg::Vec3Array &positions,
+                                         const std::vector<uint32_t> &indices, unsigned maxLevels)
+    {
+        MeshLevels levels;
+        levels.push_back(geometry);
+
+        // 每层在上一层基础上简化到约 1/4
+        std::vector<uint32_t> current = indices;
+        for (unsigned level = 0; level < maxLevels; ++level)
+        {
+            const size_t target = current.size() / 3 / 4;
+            if (target < MinLevelTriangles)
+                break;
+            std::vector<uint32_t> simplified = Simplify(positions, current, target);
+            // 受拓扑/翻面限制减少不到 1/4 时，再加层级已无意义
+            if (simplified.size() * 4 > current.size() * 3)
+                break;
+            levels.push_back(CreateLevelGeometry(geometry, simplified));
+            current.swap(simplified);
+        }
+        return levels;
+    }
+
+} // namespace LmbPlugin
@@ -0,0 +1,48 @@
+#ifndef LMBSIMPLIFY_H
+#define LMBSIMPLIFY_H
+
+#include "LmbParser.h"
+#include <osg/Array>
+#include <osg/Geometry>
+#include <vector>
+#include <cstdint>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Quadric-error mesh simplification for screen-size LODs (the "lod" load option)
+     *
+     * Edges are collapsed cheapest-first by the Garland-Heckbert quadric error,
+     * with extra boundary planes so open borders keep their outline and a
+     * normal-flip test per collapse. A collapse always merges a vertex into an
+     * existing neighbour, so every level indexes the original vertex and normal
+     * arrays: a level only costs its index buffer.
+     */
+    class LmbSimplify
+    {
+    public:
+        /**
+         * @brief Simplify an indexed triangle list towards targetTriangles
+         * @param positions Vertex positions (normal seams may duplicate positions; they are welded internally)
+         * @param indices Triangle list
+         * @return Triangle list into the same vertices; larger than the target when no valid collapse is left
+         */
+        static std::vector<uint32_t> Simplify(const osg::Vec3Array &positions, const std::vector<uint32_t> &indices,
+                                              size_t targetTriangles);
+
+        /**
+         * @brief Build progressively coarser levels of geometry (each about a quarter of the previous)
+         * @param geometry Full-detail geometry, returned as level 0
+         * @param positions Decoded positions of geometry's vertices
+         * @param indices Triangle list of geometry
+         * @param maxLevels Number of simplified levels to add at most
+         * @return Level 0 followed by the simplified levels; levels share geometry's arrays and state
+         */
+        static MeshLevels CreateLevels(osg::Geometry *geometry, const osg::Vec3Array &positions,
+                                       const std::vector<uint32_t> &indices, unsigned maxLevels);
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBSIMPLIFY_H
@@ -0,0 +1,74 @@
+#include "LmbStreamReader.h"
+#include <algorithm>
+
+namespace LmbPlugin
+{
+
+    namespace
+    {
+        // 分块读取：损坏的计数值只会在流结束时失败，而不会先分配巨大的缓冲
+        const uint64_t ChunkBytes = 1 << 20;
+    }
+
+    bool LmbStreamReader::consume(void *out, uint64_t bytes)
+    {
+        if (failed_)
+            return false;
+
+        uint8_t *dst = static_cast<uint8_t *>(out);
+        while (bytes > 0)
+        {
+            const size_t chunk = static_cast<size_t>(std::min(bytes, ChunkBytes));
+            uint8_t *target = dst;
+            size_t recordStart = 0;
+            if (record_)
+            {
+                recordStart = record_->size();
+                record_->resize(recordStart + chunk);
+                target = record_->data() + recordStart;
+            }
+
+            stream_.read(reinterpret_cast<char *>(target), static_cast<std::streamsize>(chunk));
+            if (static_cast<size_t>(stream_.gcount()) != chunk)
+            {
+                if (record_)
+                    record_->resize(recordStart);
+                failed_ = true;
+                return false;
+            }
+
+            if (dst && record_)
+                std::memcpy(dst, target, chunk);
+            if (dst)
+                dst += chunk;
+            position_ += chunk;
+            bytes -= chunk;
+        }
+        return true;
+    }
+
+    bool LmbStreamReader::skip(uint64_t bytes)
+    {
+        if (record_)
+            return consume(nullptr, bytes);
+
+        // 不记录时用小缓冲丢弃
+        char scratch[4096];
+        while (bytes > 0 && !failed_)
+        {
+            const size_t chunk = static_cast<size_t>(std::min<uint64_t>(bytes, sizeof(scratch)));
+            if (!consume(scratch, chunk))
+                return false;
+            bytes -= chunk;
+        }
+        return !failed_;
+    }
+
+    void LmbStreamReader::setRecordBuffer(std::vector<uint8_t> *buffer)
+    {
+        record_ = buffer;
+        if (record_)
+            record_->clear();
+    }
+
+} // namespace LmbPlugin
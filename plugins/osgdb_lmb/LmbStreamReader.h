@@ -0,0 +1,64 @@
+#ifndef LMBSTREAMREADER_H
+#define LMBSTREAMREADER_H
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <vector>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Forward-only reader over a (possibly non-seekable) std::istream
+     *
+     * Tracks its own byte position instead of using tellg/seekg, so archives and
+     * pipes can be consumed in a single pass. Exposes the same read / skip /
+     * alignTo4 / position interface as ByteCursor so the node scanner works on both.
+     *
+     * While a record buffer is set, every consumed byte (including skipped ones)
+     * is appended to it; the buffer then holds one complete node record that
+     * ByteCursor can decode without copying.
+     */
+    class LmbStreamReader
+    {
+    public:
+        explicit LmbStreamReader(std::istream &stream) : stream_(stream) {}
+
+        template <typename T>
+        bool read(T &value)
+        {
+            return consume(&value, sizeof(T));
+        }
+
+        /**
+         * @brief Consume bytes; they are kept in the record buffer if one is set
+         */
+        bool skip(uint64_t bytes);
+
+        bool alignTo4()
+        {
+            const uint64_t padding = (4 - (position_ % 4)) % 4;
+            return padding == 0 || skip(padding);
+        }
+
+        /**
+         * @brief Start capturing consumed bytes into buffer (cleared first); nullptr stops capturing
+         */
+        void setRecordBuffer(std::vector<uint8_t> *buffer);
+
+        uint64_t position() const { return position_; }
+        bool good() const { return !failed_; }
+
+    private:
+        bool consume(void *out, uint64_t bytes);
+
+        std::istream &stream_;
+        std::vector<uint8_t> *record_ = nullptr;
+        uint64_t position_ = 0;
+        bool failed_ = false;
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBSTREAMREADER_H
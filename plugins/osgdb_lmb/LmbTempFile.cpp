@@ -0,0 +1,25 @@
+#include "LmbTempFile.h"
+#include <functional>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace LmbPlugin
+{
+
+    std::string LmbTempFile::PathFor(const std::string &path)
+    {
+#ifdef _WIN32
+        const long processId = static_cast<long>(_getpid());
+#else
+        const long processId = static_cast<long>(getpid());
+#endif
+        const size_t threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+        return path + "." + std::to_string(processId) + "-" + std::to_string(threadId) + ".tmp";
+    }
+
+} // namespace LmbPlugin
@@ -0,0 +1,28 @@
+#ifndef LMBTEMPFILE_H
+#define LMBTEMPFILE_H
+
+#include <string>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Names for the temporary files that LMB outputs are written through
+     *
+     * Outputs (.lmb, .lmbz, .lmbi) are written to a temporary file and renamed
+     * into place. The same target can be written by several processes, or by
+     * several threads of one process, at the same time, so the temporary name
+     * carries the process and thread id instead of a fixed suffix.
+     */
+    class LmbTempFile
+    {
+    public:
+        /**
+         * @brief "<path>.<pid>-<thread>.tmp", unique per writing thread
+         */
+        static std::string PathFor(const std::string &path);
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBTEMPFILE_H
@@ -0,0 +1,87 @@
+#include "LmbThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LmbPlugin
+{
+
+    LmbThreadPool::LmbThreadPool(unsigned threadCount)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        threadCount_ = threadCount;
+    }
+
+    void LmbThreadPool::parallelFor(size_t count,
+                                    const std::function<void(size_t)> &task,
+                                    const std::function<void(size_t)> &progress) const
+    {
+        parallelForWorker(count, [&task](size_t i, unsigned) { task(i); }, progress);
+    }
+
+    void LmbThreadPool::parallelForWorker(size_t count,
+                                          const std::function<void(size_t, unsigned)> &task,
+                                          const std::function<void(size_t)> &progress) const
+    {
+        if (count == 0)
+            return;
+
+        // 小批量领取任务：节点大小差异很大，按批动态分配以均衡负载
+        const size_t batchSize = std::max<size_t>(1, std::min<size_t>(64, count / (size_t(threadCount_) * 16)));
+        std::atomic<size_t> nextIndex{0};
+        std::atomic<size_t> finished{0};
+        std::atomic<bool> aborted{false};
+        std::exception_ptr firstError;
+        std::mutex errorMutex;
+
+        auto worker = [&](unsigned workerIndex)
+        {
+            const bool isCaller = workerIndex == 0;
+            while (!aborted.load(std::memory_order_relaxed))
+            {
+                const size_t begin = nextIndex.fetch_add(batchSize);
+                if (begin >= count)
+                    break;
+                const size_t end = std::min(count, begin + batchSize);
+                try
+                {
+                    for (size_t i = begin; i < end; ++i)
+                        task(i, workerIndex);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!firstError)
+                        firstError = std::current_exception();
+                    aborted = true;
+                    break;
+                }
+                const size_t done = finished.fetch_add(end - begin) + (end - begin);
+                if (isCaller && progress)
+                    progress(done);
+            }
+        };
+
+        const unsigned extraThreads = static_cast<unsigned>(std::min<size_t>(threadCount_ - 1, (count + batchSize - 1) / batchSize));
+        std::vector<std::thread> threads;
+        threads.reserve(extraThreads);
+        for (unsigned t = 0; t < extraThreads; ++t)
+            threads.emplace_back(worker, t + 1);
+
+        worker(0);
+
+        for (auto &thread : threads)
+            thread.join();
+
+        if (firstError)
+            std::rethrow_exception(firstError);
+
+        if (progress)
+            progress(finished.load());
+    }
+
+} // namespace LmbPlugin
@@ -0,0 +1,53 @@
+#ifndef LMBTHREADPOOL_H
+#define LMBTHREADPOOL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Minimal fork/join worker pool used by the LMB loader
+     *
+     * parallelFor() hands out indices in small batches to worker threads and to
+     * the calling thread. The first exception thrown by a task stops the
+     * remaining work and is rethrown on the calling thread.
+     */
+    class LmbThreadPool
+    {
+    public:
+        /**
+         * @param threadCount Number of threads including the caller, 0 = hardware concurrency
+         */
+        explicit LmbThreadPool(unsigned threadCount = 0);
+
+        unsigned size() const { return threadCount_; }
+
+        /**
+         * @brief Run task(i) for every i in [0, count)
+         * @param count Number of items
+         * @param task Work item, must be thread-safe
+         * @param progress Optional callback with the number of finished items,
+         *                 only ever invoked on the calling thread
+         */
+        void parallelFor(size_t count,
+                         const std::function<void(size_t)> &task,
+                         const std::function<void(size_t)> &progress = nullptr) const;
+
+        /**
+         * @brief Like parallelFor, but task also receives the worker number in [0, size()) (0 = calling thread)
+         *
+         * A worker runs its items one after another, so per-worker scratch state needs no locking.
+         */
+        void parallelForWorker(size_t count,
+                               const std::function<void(size_t, unsigned)> &task,
+                               const std::function<void(size_t)> &progress = nullptr) const;
+
+    private:
+        unsigned threadCount_;
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBTHREADPOOL_H
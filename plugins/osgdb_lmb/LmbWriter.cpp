@@ -0,0 +1,763 @@
+#include "LmbWriter.h"
+#include "LmbInstancing.h"
+#include "LmbParser.h"
+#include "LmbShaders.h"
+#include "LmbSimd.h"
+#include "LmbTempFile.h"
+#include <osg/Geometry>
+#include <osg/Geode>
+#include <osg/LOD>
+#include <osg/Material>
+#include <osg/PagedLOD>
+#include <osg/Transform>
+#include <osg/NodeVisitor>
+#include <osg/TriangleIndexFunctor>
+#include <osg/UserDataContainer>
+#include <osg/ValueObject>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace LmbPlugin
+{
+
+    namespace
+    {
+        const uint32_t DefaultColor = 0xBFBFBF;
+        // 完整校验（validate=full）时 LmbParser 拒绝更长的名称
+        const size_t MaxNameLength = LmbParser::MaxNameLength;
+        const char GeodeSuffix[] = "_Geode";
+        const uint64_t HashMultiplier = 0x9E3779B97F4A7C15ull;
+
+        // 节点或实例在场景中的一次出现
+        struct Placement
+        {
+            std::string name;
+            osg::Matrixd matrix; // 相对场景原点的世界矩阵
+            uint32_t color;
+        };
+
+        // 一个唯一网格，写为一个 LMB 节点；重复出现写为其实例
+        struct Mesh
+        {
+            osg::ref_ptr<const osg::Vec3Array> positions;
+            osg::ref_ptr<const osg::Vec3Array> normals; // 空 = 由三角形生成
+            std::vector<uint32_t> indices;
+            uint64_t hash = 0;
+            Placement node;
+            std::vector<Placement> instances;
+        };
+
+        // 量化法线（如 glTF 的 KHR_mesh_quantization）：PackNormal 会归一化，这里只需还原方向
+        template <typename ArrayT>
+        osg::ref_ptr<osg::Vec3Array> UnpackNormals(const ArrayT &packed)
+        {
+            osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array(static_cast<unsigned int>(packed.size()));
+            for (size_t i = 0; i < packed.size(); ++i)
+                (*normals)[i].set(packed[i].x(), packed[i].y(), packed[i].z());
+            return normals;
+        }
+
+        struct TriangleCollector
+        {
+            std::vector<uint32_t> *indices = nullptr;
+            unsigned int vertexCount = 0;
+
+            void operator()(unsigned int a, unsigned int b, unsigned int c)
+            {
+                // 条带中的退化三角形与越界索引不写入
+                if (a >= vertexCount || b >= vertexCount || c >= vertexCount || a == b || b == c || a == c)
+                    return;
+                indices->push_back(a);
+                indices->push_back(b);
+                indices->push_back(c);
+            }
+        };
+
+        inline uint64_t Mix(uint64_t h, uint64_t word)
+        {
+            h = (h ^ word) * HashMultiplier;
+            return h ^ (h >> 29);
+        }
+
+        uint64_t HashBytes(uint64_t h, const void *data, size_t size)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t *>(data);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, bytes + i, sizeof(word));
+                h = Mix(h, word);
+            }
+            uint64_t tail = 0;
+            if (i < size)
+                std::memcpy(&tail, bytes + i, size - i);
+            return Mix(h, tail ^ (uint64_t(size) << 56));
+        }
+
+        template <typename T>
+        bool SameArray(const T *a, const T *b)
+        {
+            if (a == b)
+                return true;
+            if (!a || !b || a->size() != b->size())
+                return false;
+            return a->empty() || std::memcmp(&a->front(), &b->front(), a->size() * sizeof(a->front())) == 0;
+        }
+
+        uint32_t PackColor(const osg::Vec4 &color)
+        {
+            auto channel = [](float value)
+            {
+                return static_cast<uint32_t>(std::lround(std::min(std::max(value, 0.0f), 1.0f) * 255.0f));
+            };
+            return (channel(color.r()) << 16) | (channel(color.g()) << 8) | channel(color.b());
+        }
+
+        // 与 LmbSimd 的解码对应：x 在 20 位、y 在 10 位、z 在 0 位，各 10 位有符号
+        uint32_t PackNormal(osg::Vec3 normal)
+        {
+            if (normal.normalize() <= 0.0f)
+                normal.set(0.0f, 0.0f, 1.0f);
+            auto component = [](float value)
+            {
+                const int32_t q = static_cast<int32_t>(std::lround(std::min(std::max(value, -1.0f), 1.0f) * 511.0f));
+                return static_cast<uint32_t>(q) & 0x3FF;
+            };
+            return (component(normal.x()) << 20) | (component(normal.y()) << 10) | component(normal.z());
+        }
+
+        // 读取端为 transform(r, c) = matrix[r * 3 + c]，平移在第 3 行
+        void ToLmbTransform(const osg::Matrixd &m, float matrix[9], Vector3f &position)
+        {
+            for (int r = 0; r < 3; ++r)
+            {
+                for (int c = 0; c < 3; ++c)
+                    matrix[r * 3 + c] = static_cast<float>(m(r, c));
+            }
+            position = Vector3f{static_cast<float>(m(3, 0)), static_cast<float>(m(3, 1)), static_cast<float>(m(3, 2))};
+        }
+
+        /**
+         * @brief Sequential writer that tracks the absolute offset for LMB's 4-byte alignment (mirror of ByteCursor)
+         */
+        class ByteWriter
+        {
+        public:
+            explicit ByteWriter(std::ostream &out) : out_(out) {}
+
+            template <typename T>
+            void write(const T &value)
+            {
+                writeBytes(&value, sizeof(T));
+            }
+
+            void writeBytes(const void *data, size_t size)
+            {
+                out_.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+                position_ += size;
+            }
+
+            void writeName(const std::string &name)
+            {
+                const uint16_t length = static_cast<uint16_t>(std::min(name.size(), MaxNameLength));
+                write(length);
+                writeBytes(name.data(), length);
+                alignTo4();
+            }
+
+            void alignTo4()
+            {
+                static const uint8_t zeros[4] = {0, 0, 0, 0};
+                const uint64_t padding = (4 - position_ % 4) % 4;
+                writeBytes(zeros, static_cast<size_t>(padding));
+            }
+
+            uint64_t position() const { return position_; }
+
+        private:
+            std::ostream &out_;
+            uint64_t position_ = 0;
+        };
+
+        // 有未加载级别（有文件名但没有对应子节点）的 PagedLOD 数，例如以 "paged" 加载的场景中未常驻的页
+        class UnloadedPageCounter : public osg::NodeVisitor
+        {
+        public:
+            UnloadedPageCounter() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+            void apply(osg::PagedLOD &lod) override
+            {
+                for (unsigned int i = lod.getNumChildren(); i < lod.getNumFileNames(); ++i)
+                {
+                    if (!lod.getFileName(i).empty())
+                    {
+                        ++count;
+                        break;
+                    }
+                }
+                traverse(lod);
+            }
+
+            size_t count = 0;
+        };
+
+        class SceneCollector : public osg::NodeVisitor
+        {
+        public:
+            SceneCollector(const osg::Vec3d &origin, const LmbWriteOptions &options, LmbWriteStats &stats)
+                : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN), origin_(origin), options_(options), stats_(stats)
+            {
+                matrices_.push_back(osg::Matrixd());
+            }
+
+            void apply(osg::Node &node) override
+            {
+                enter(node);
+                traverse(node);
+                leave();
+            }
+
+            void apply(osg::Transform &transform) override
+            {
+                osg::Matrixd matrix = matrices_.back();
+                transform.computeLocalToWorldMatrix(matrix, this);
+                matrices_.push_back(matrix);
+                enter(transform);
+                traverse(transform);
+                leave();
+                matrices_.pop_back();
+            }
+
+            void apply(osg::LOD &lod) override
+            {
+                // 只写最精细的一级：距离模式取最小可见距离最小的子节点，像素模式取最大像素范围最大的
+                const unsigned int count = std::min(lod.getNumChildren(), lod.getNumRanges());
+                unsigned int best = 0;
+                for (unsigned int i = 1; i < count; ++i)
+                {
+                    const bool finer = lod.getRangeMode() == osg::LOD::DISTANCE_FROM_EYE_POINT
+                                           ? lod.getMinRange(i) < lod.getMinRange(best)
+                                           : lod.getMaxRange(i) > lod.getMaxRange(best);
+                    if (finer)
+                        best = i;
+                }
+                enter(lod);
+                if (best < lod.getNumChildren())
+                    lod.getChild(best)->accept(*this);
+                else if (lod.getNumRanges() > 0)
+                {
+                    // 没有已加载的子节点（未常驻的 PagedLOD）：不能静默丢掉
+                    PluginLogger::logWarning("LMB", "Skipping LOD " + lod.getName() + ": no level is loaded");
+                    ++stats_.skippedDrawables;
+                }
+                leave();
+            }
+
+            void apply(osg::Geometry &geometry) override
+            {
+                enter(geometry);
+                addGeometry(geometry);
+                leave();
+            }
+
+            std::vector<Mesh> &meshes() { return meshes_; }
+            std::vector<uint32_t> &colors() { return colors_; }
+
+        private:
+            void enter(const osg::Node &node)
+            {
+                nodes_.push_back(&node);
+                names_.push_back(node.getName());
+                uint32_t color = colorStack_.empty() ? DefaultColor : colorStack_.back();
+                bool found = !colorStack_.empty() && hasColor_.back();
+                if (const osg::StateSet *stateSet = node.getStateSet())
+                {
+                    unsigned int lmbColor;
+                    const osg::Material *material =
+                        dynamic_cast<const osg::Material *>(stateSet->getAttribute(osg::StateAttribute::MATERIAL));
+                    if (stateSet->getUserValue(LmbParser::ColorValueName, lmbColor))
+                    {
+                        color = lmbColor & 0xFFFFFF;
+                        found = true;
+                    }
+                    else if (material)
+                    {
+                        color = PackColor(material->getDiffuse(osg::Material::FRONT));
+                        found = true;
+                    }
+                }
+                colorStack_.push_back(color);
+                hasColor_.push_back(found);
+                palettes_.push_back(palettes_.empty() ? nullptr : palettes_.back());
+                if (const osg::UserDataContainer *container = node.getStateSet() ? node.getStateSet()->getUserDataContainer() : nullptr)
+                {
+                    if (const osg::UIntArray *palette =
+                            dynamic_cast<const osg::UIntArray *>(container->getUserObject(LmbInstancing::PaletteName)))
+                        palettes_.back() = palette;
+                }
+            }
+
+            void leave()
+            {
+                nodes_.pop_back();
+                names_.pop_back();
+                colorStack_.pop_back();
+                hasColor_.pop_back();
+                palettes_.pop_back();
+            }
+
+            // 最近的非空名称；本插件读入的场景中 Geode 名为 "<节点名>_Geode"，还原为节点名
+            std::string currentName() const
+            {
+                for (auto it = names_.rbegin(); it != names_.rend(); ++it)
+                {
+                    if (it->empty())
+                        continue;
+                    const size_t suffix = sizeof(GeodeSuffix) - 1;
+                    if (it->size() > suffix && it->compare(it->size() - suffix, suffix, GeodeSuffix) == 0)
+                        return it->substr(0, it->size() - suffix);
+                    return *it;
+                }
+                return std::string();
+            }
+
+            uint32_t colorIndex(const osg::Geometry &geometry)
+            {
+                uint32_t color = colorStack_.back();
+                if (!hasColor_.back())
+                {
+                    // 没有材质时取几何的（首个）颜色
+                    const osg::Array *colorArray = geometry.getColorArray();
+                    if (const osg::Vec4Array *colors = dynamic_cast<const osg::Vec4Array *>(colorArray))
+                    {
+                        if (!colors->empty())
+                            color = PackColor(colors->front());
+                    }
+                    else if (const osg::Vec4ubArray *colors = dynamic_cast<const osg::Vec4ubArray *>(colorArray))
+                    {
+                        if (!colors->empty())
+                            color = (uint32_t(colors->front().r()) << 16) | (uint32_t(colors->front().g()) << 8) |
+                                    uint32_t(colors->front().b());
+                    }
+                }
+
+                return colorSlot(color);
+            }
+
+            uint32_t colorSlot(uint32_t color)
+            {
+                auto inserted = colorIndices_.emplace(color, static_cast<uint32_t>(colors_.size()));
+                if (inserted.second)
+                    colors_.push_back(color);
+                return inserted.first->second;
+            }
+
+            // 硬件实例化的 Geode（本插件与 glTF 插件）只画一份几何，实例矩阵在用户对象中，相对 Geode 所在的变换
+            const osg::MatrixfArray *instanceMatrices(const osg::Geode *&geode) const
+            {
+                geode = nodes_.size() >= 2 ? dynamic_cast<const osg::Geode *>(nodes_[nodes_.size() - 2]) : nullptr;
+                const osg::UserDataContainer *container = geode ? geode->getUserDataContainer() : nullptr;
+                return container ? dynamic_cast<const osg::MatrixfArray *>(
+                                       container->getUserObject(LmbInstancing::InstanceMatricesName))
+                                 : nullptr;
+            }
+
+            // 几何在场景中的各次出现：普通几何一次，实例化几何每个实例一次，名称取自 Geode 的描述
+            std::vector<Placement> collectPlacements(const osg::Geometry &geometry)
+            {
+                Placement placement;
+                placement.name = currentName();
+                placement.matrix = matrices_.back() * osg::Matrixd::translate(-origin_);
+                placement.color = colorIndex(geometry);
+
+                const osg::Geode *geode = nullptr;
+                const osg::MatrixfArray *matrices = instanceMatrices(geode);
+                if (!matrices || matrices->empty())
+                    return std::vector<Placement>(1, placement);
+
+                // 本插件的实例各有颜色（颜色表的下标），glTF 的实例与节点同色
+                const osg::UserDataContainer *container = geode->getUserDataContainer();
+                const osg::UIntArray *colors =
+                    dynamic_cast<const osg::UIntArray *>(container->getUserObject(LmbInstancing::InstanceColorsName));
+                const osg::UIntArray *palette = palettes_.back();
+
+                const std::vector<std::string> &names = geode->getDescriptions();
+                std::vector<Placement> placements(matrices->size(), placement);
+                for (size_t i = 0; i < placements.size(); ++i)
+                {
+                    placements[i].matrix = osg::Matrixd((*matrices)[i]) * placement.matrix;
+                    if (i < names.size() && !names[i].empty())
+                        placements[i].name = names[i];
+                    else if (i > 0)
+                        placements[i].name = placement.name + "_inst_" + std::to_string(i - 1);
+                    if (colors && palette && i < colors->size() && (*colors)[i] < palette->size())
+                        placements[i].color = colorSlot((*palette)[(*colors)[i]] & 0xFFFFFF);
+                }
+                return placements;
+            }
+
+            // 全部出现都成为已有网格的实例
+            void shareMesh(Mesh &mesh, const std::vector<Placement> &placements)
+            {
+                mesh.instances.insert(mesh.instances.end(), placements.begin(), placements.end());
+                stats_.instanceCount += placements.size();
+            }
+
+            void addGeometry(osg::Geometry &geometry)
+            {
+                const std::vector<Placement> placements = collectPlacements(geometry);
+                const Placement &placement = placements.front();
+
+                // 同一几何对象再次出现（共享子图、实例化的导出结果）
+                if (options_.detectInstances)
+                {
+                    auto found = byGeometry_.find(&geometry);
+                    if (found != byGeometry_.end())
+                    {
+                        shareMesh(meshes_[found->second], placements);
+                        return;
+                    }
+                }
+
+                Mesh mesh;
+                const osg::Array *vertexArray = geometry.getVertexArray();
+                if (const osg::Vec3Array *vertices = dynamic_cast<const osg::Vec3Array *>(vertexArray))
+                {
+                    mesh.positions = vertices;
+                }
+                else if (const osg::Vec3dArray *vertices = dynamic_cast<const osg::Vec3dArray *>(vertexArray))
+                {
+                    osg::ref_ptr<osg::Vec3Array> converted = new osg::Vec3Array(vertices->begin(), vertices->end());
+                    mesh.positions = converted.get();
+                }
+                else if (const osg::Vec3sArray *vertices = dynamic_cast<const osg::Vec3sArray *>(vertexArray))
+                {
+                    // 本插件 gpudequant 读入的 int16 顶点，按着色器的公式还原
+                    osg::Vec3 base, invScale;
+                    if (!vertices->empty() && LmbShaders::ReadQuantization(geometry, base, invScale))
+                    {
+                        osg::ref_ptr<osg::Vec3Array> converted = new osg::Vec3Array(vertices->size());
+                        LmbSimd::DequantizeVertices(reinterpret_cast<const int16_t *>(&vertices->front()), vertices->size(),
+                                                    base.ptr(), invScale.ptr(), (*converted)[0].ptr());
+                        mesh.positions = converted.get();
+                    }
+                }
+                if (!mesh.positions.valid() || mesh.positions->empty())
+                {
+                    if (vertexArray)
+                        PluginLogger::logWarning("LMB", "Skipping geometry " + placement.name + ": unsupported vertex array type");
+                    ++stats_.skippedDrawables;
+                    return;
+                }
+
+                osg::TriangleIndexFunctor<TriangleCollector> triangles;
+                triangles.indices = &mesh.indices;
+                triangles.vertexCount = mesh.positions->size();
+                geometry.accept(triangles);
+                if (mesh.indices.empty())
+                {
+                    PluginLogger::logDebug("LMB", "Skipping geometry " + placement.name + ": no triangles");
+                    ++stats_.skippedDrawables;
+                    return;
+                }
+
+                const osg::Array *normalArray = geometry.getNormalArray();
+                if (normalArray && normalArray->getBinding() == osg::Array::BIND_PER_VERTEX &&
+                    normalArray->getNumElements() == mesh.positions->size())
+                {
+                    if (const osg::Vec3Array *normals = dynamic_cast<const osg::Vec3Array *>(normalArray))
+                        mesh.normals = normals;
+                    else if (const osg::Vec3bArray *normals = dynamic_cast<const osg::Vec3bArray *>(normalArray))
+                        mesh.normals = UnpackNormals(*normals);
+                    else if (const osg::Vec3sArray *normals = dynamic_cast<const osg::Vec3sArray *>(normalArray))
+                        mesh.normals = UnpackNormals(*normals);
+                    else if (const PackedNormalArray *normals = dynamic_cast<const PackedNormalArray *>(normalArray))
+                    {
+                        osg::ref_ptr<osg::Vec3Array> unpacked = new osg::Vec3Array(normals->size());
+                        LmbSimd::DecodeNormals(&normals->front(), normals->size(), (*unpacked)[0].ptr());
+                        mesh.normals = unpacked.get();
+                    }
+                }
+
+                // 内容相同的不同几何对象（例如逐个复制的导出结果）
+                if (options_.detectInstances)
+                {
+                    mesh.hash = HashBytes(0, &mesh.positions->front(), mesh.positions->size() * sizeof(osg::Vec3));
+                    if (mesh.normals.valid())
+                        mesh.hash = HashBytes(mesh.hash, &mesh.normals->front(), mesh.normals->size() * sizeof(osg::Vec3));
+                    mesh.hash = HashBytes(mesh.hash, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+
+                    auto range = byContent_.equal_range(mesh.hash);
+                    for (auto it = range.first; it != range.second; ++it)
+                    {
+                        Mesh &existing = meshes_[it->second];
+                        if (existing.indices == mesh.indices && SameArray(existing.positions.get(), mesh.positions.get()) &&
+                            SameArray(existing.normals.get(), mesh.normals.get()))
+                        {
+                            shareMesh(existing, placements);
+                            byGeometry_[&geometry] = it->second;
+                            stats_.sharedByContent += placements.size();
+                            return;
+                        }
+                    }
+                    byContent_.emplace(mesh.hash, meshes_.size());
+                    byGeometry_[&geometry] = meshes_.size();
+                }
+
+                mesh.node = placement;
+                mesh.instances.assign(placements.begin() + 1, placements.end());
+                stats_.instanceCount += placements.size() - 1;
+                meshes_.push_back(std::move(mesh));
+            }
+
+            osg::Vec3d origin_;
+            const LmbWriteOptions &options_;
+            LmbWriteStats &stats_;
+            std::vector<osg::Matrixd> matrices_;
+            std::vector<const osg::Node *> nodes_;
+            std::vector<std::string> names_;
+            std::vector<uint32_t> colorStack_;
+            std::vector<bool> hasColor_;
+            std::vector<const osg::UIntArray *> palettes_;
+            std::vector<Mesh> meshes_;
+            std::unordered_map<const osg::Geometry *, size_t> byGeometry_;
+            std::unordered_multimap<uint64_t, size_t> byContent_;
+            std::vector<uint32_t> colors_;
+            std::unordered_map<uint32_t, uint32_t> colorIndices_;
+        };
+
+        osg::ref_ptr<osg::Vec3Array> GenerateNormals(const Mesh &mesh)
+        {
+            // 面积加权的顶点法线
+            const osg::Vec3Array &positions = *mesh.positions;
+            osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array(positions.size());
+            for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+            {
+                const uint32_t a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+                const osg::Vec3 faceNormal = (positions[b] - positions[a]) ^ (positions[c] - positions[a]);
+                (*normals)[a] += faceNormal;
+                (*normals)[b] += faceNormal;
+                (*normals)[c] += faceNormal;
+            }
+            return normals;
+        }
+
+        void WriteNode(ByteWriter &out, const Mesh &mesh, const osg::Vec3Array &normals)
+        {
+            const osg::Vec3Array &positions = *mesh.positions;
+            const uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+
+            // 基准点取最接近包围盒中心的顶点，换到第 0 位（文件中第 0 个顶点即基准点本身），量化范围减半
+            osg::BoundingBox bounds;
+            for (const osg::Vec3 &p : positions)
+                bounds.expandBy(p);
+            uint32_t baseIndex = 0;
+            float nearest = FLT_MAX;
+            for (uint32_t i = 0; i < vertexCount; ++i)
+            {
+                const float distance = (positions[i] - bounds.center()).length2();
+                if (distance < nearest)
+                {
+                    nearest = distance;
+                    baseIndex = i;
+                }
+            }
+            // 交换 0 与 baseIndex，其余顶点不动；该映射是自身的逆
+            auto remap = [baseIndex](uint32_t i) { return i == 0 ? baseIndex : (i == baseIndex ? 0 : i); };
+
+            const osg::Vec3 base = positions[baseIndex];
+            float scale[3];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const float extent = std::max(bounds._max[axis] - base[axis], base[axis] - bounds._min[axis]);
+                scale[axis] = extent > 1e-20f ? 32767.0f / extent : 1.0f;
+            }
+
+            float matrix[9];
+            Vector3f position;
+            ToLmbTransform(mesh.node.matrix, matrix, position);
+            out.writeName(mesh.node.name);
+            out.write(matrix);
+            out.write(position);
+            out.write(Vector3f{base.x(), base.y(), base.z()});
+            out.write(Vector3f{scale[0], scale[1], scale[2]});
+            out.write(vertexCount);
+
+            // 写入 q = (value - base) * scale，读取端 value = base + q / scale
+            std::vector<int16_t> quantized;
+            quantized.reserve((size_t(vertexCount) - 1) * 3);
+            for (uint32_t i = 1; i < vertexCount; ++i)
+            {
+                const osg::Vec3 &p = positions[remap(i)];
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    const long q = std::lround((p[axis] - base[axis]) * scale[axis]);
+                    quantized.push_back(static_cast<int16_t>(std::min(std::max(q, -32767L), 32767L)));
+                }
+            }
+            out.writeBytes(quantized.data(), quantized.size() * sizeof(int16_t));
+            out.alignTo4();
+
+            std::vector<uint32_t> packedNormals(vertexCount);
+            for (uint32_t i = 0; i < vertexCount; ++i)
+                packedNormals[i] = PackNormal(normals[remap(i)]);
+            out.writeBytes(packedNormals.data(), packedNormals.size() * sizeof(uint32_t));
+            out.alignTo4();
+
+            // 索引宽度由顶点数决定，与读取端一致
+            const uint32_t indexCount = static_cast<uint32_t>(mesh.indices.size());
+            out.write(indexCount);
+            switch (LmbParser::IndexWidth(vertexCount))
+            {
+            case 1:
+                for (uint32_t index : mesh.indices)
+                    out.write(static_cast<uint8_t>(remap(index)));
+                break;
+            case 2:
+                for (uint32_t index : mesh.indices)
+                    out.write(static_cast<uint16_t>(remap(index)));
+                break;
+            default:
+                for (uint32_t index : mesh.indices)
+                    out.write(remap(index));
+                break;
+            }
+            out.alignTo4();
+
+            out.write(mesh.node.color);
+            out.write(static_cast<uint32_t>(mesh.instances.size()));
+            for (const Placement &instance : mesh.instances)
+            {
+                ToLmbTransform(instance.matrix, matrix, position);
+                out.writeName(instance.name);
+                out.write(matrix);
+                out.write(position);
+                out.write(instance.color);
+            }
+        }
+    }
+
+    std::string LmbWriteStats::summary() const
+    {
+        return "Write stats: " + std::to_string(nodeCount) + " nodes, " +
+               std::to_string(instanceCount) + " instances (" + std::to_string(sharedByContent) + " by content), " +
+               std::to_string(vertexCount) + " vertices, " + std::to_string(indexCount) + " indices, " +
+               std::to_string(colorCount) + " colors, " + std::to_string(bytes / 1024) + " KB" +
+               (generatedNormals > 0 ? ", " + std::to_string(generatedNormals) + " meshes with generated normals" : std::string()) +
+               (skippedDrawables > 0 ? ", " + std::to_string(skippedDrawables) + " geometries or LODs skipped" : std::string());
+    }
+
+    bool LmbWriter::WriteStream(const osg::Node &scene, std::ostream &stream, const std::string &streamName,
+                                const LmbWriteOptions &options, LmbWriteStats *stats)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        LmbWriteStats writeStats;
+
+        // 场景中心作为文件的场景位置，节点平移相对该点存储，大坐标场景不损失 float 精度
+        const osg::BoundingSphere &bound = scene.getBound();
+        const osg::Vec3d origin = bound.valid() ? osg::Vec3d(bound.center()) : osg::Vec3d();
+
+        // 分页场景只有常驻的页在场景图中，写出的文件会缺少其余部分
+        UnloadedPageCounter unloaded;
+        const_cast<osg::Node &>(scene).accept(unloaded);
+        if (unloaded.count > 0)
+        {
+            PluginLogger::logError("LMB", "Cannot write " + streamName + ": " + std::to_string(unloaded.count) +
+                                              " PagedLOD nodes have levels that are not loaded; load the scene without paging first");
+            return false;
+        }
+
+        SceneCollector collector(origin, options, writeStats);
+        const_cast<osg::Node &>(scene).accept(collector);
+        std::vector<Mesh> &meshes = collector.meshes();
+        const std::vector<uint32_t> &colors = collector.colors();
+        if (meshes.empty())
+        {
+            PluginLogger::logError("LMB", "Nothing to write to " + streamName + ": the scene has no triangle geometry");
+            return false;
+        }
+
+        ByteWriter out(stream);
+        out.write(Vector3f{static_cast<float>(origin.x()), static_cast<float>(origin.y()), static_cast<float>(origin.z())});
+        out.write(static_cast<uint32_t>(colors.size()));
+        out.write(static_cast<uint32_t>(meshes.size()));
+        out.writeBytes(colors.data(), colors.size() * sizeof(uint32_t));
+
+        for (Mesh &mesh : meshes)
+        {
+            osg::ref_ptr<const osg::Vec3Array> normals = mesh.normals;
+            if (!normals.valid())
+            {
+                normals = GenerateNormals(mesh).get();
+                ++writeStats.generatedNormals;
+            }
+            WriteNode(out, mesh, *normals);
+
+            writeStats.vertexCount += mesh.positions->size();
+            writeStats.indexCount += mesh.indices.size();
+            // 写完即释放，转换大场景时不同时保留全部索引副本
+            std::vector<uint32_t>().swap(mesh.indices);
+            mesh.positions = nullptr;
+            mesh.normals = nullptr;
+        }
+        if (!stream)
+        {
+            PluginLogger::logError("LMB", "Failed to write " + streamName);
+            return false;
+        }
+
+        writeStats.nodeCount = meshes.size();
+        writeStats.colorCount = colors.size();
+        writeStats.bytes = out.position();
+        PluginLogger::logInfo("LMB", writeStats.summary());
+        if (stats)
+            *stats = writeStats;
+
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
+        PluginLogger::logInfo("LMB", "Wrote " + streamName + " in " + std::to_string(duration.count()) + "ms");
+        return true;
+    }
+
+    bool LmbWriter::WriteFile(const osg::Node &scene, const std::string &filepath, const LmbWriteOptions &options,
+                              LmbWriteStats *stats)
+    {
+        // 先写临时文件再改名，失败时不留下半个文件，也不破坏已有的同名文件；
+        // 同一目标可能被并发导出，临时文件名各不相同，最后一次改名的结果生效
+        const std::string tempPath = LmbTempFile::PathFor(filepath);
+        bool written;
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                PluginLogger::logError("LMB", "Cannot create " + tempPath);
+                return false;
+            }
+            written = WriteStream(scene, out, filepath, options, stats);
+            out.close();
+            written = written && !out.fail();
+        }
+
+        std::error_code ec;
+        if (written)
+        {
+            std::filesystem::rename(tempPath, filepath, ec);
+            if (ec)
+                PluginLogger::logError("LMB", "Cannot replace " + filepath + ": " + ec.message());
+        }
+        if (!written || ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+} // namespace LmbPlugin
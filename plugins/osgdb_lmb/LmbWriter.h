@@ -0,0 +1,78 @@
+#ifndef LMBWRITER_H
+#define LMBWRITER_H
+
+#include <osg/Node>
+#include <string>
+#include <iosfwd>
+#include <cstdint>
+
+namespace LmbPlugin
+{
+
+    /**
+     * @brief Options for writing LMB files, parsed from the ReaderWriterLMB option string
+     */
+    struct LmbWriteOptions
+    {
+        bool detectInstances = true; // 重复出现的几何（同一对象或内容相同）写为实例而非独立节点
+    };
+
+    /**
+     * @brief Counters of one write, logged as a summary
+     */
+    struct LmbWriteStats
+    {
+        size_t nodeCount = 0;        // 写出的节点（唯一网格）数
+        size_t instanceCount = 0;    // 写为实例的重复几何数
+        size_t sharedByContent = 0;  // 其中按内容（而非同一对象）识别的实例数
+        size_t vertexCount = 0;      // 写出的顶点数（不含实例）
+        size_t indexCount = 0;       // 写出的索引数（不含实例）
+        size_t colorCount = 0;       // 颜色表大小
+        size_t generatedNormals = 0; // 缺少逐顶点法线、由三角形生成法线的网格数
+        size_t skippedDrawables = 0; // 没有三角形、顶点格式不支持而跳过的几何数，以及没有已加载级别的 LOD 数
+        uint64_t bytes = 0;          // 文件字节数
+
+        std::string summary() const;
+    };
+
+    /**
+     * @brief Converts an OSG scene graph to the LMB format read by LmbParser
+     *
+     * Every osg::Geometry with triangles becomes one LMB node whose transform is
+     * the geometry's accumulated world matrix (relative to the scene center,
+     * which is stored as the file's scene position). Positions are quantized to
+     * int16 per node: the vertex nearest the bounding box center becomes the
+     * base vertex and each axis gets the largest scale that keeps the farthest
+     * vertex in range. Normals are packed to 10:10:10 (generated from the
+     * triangles when missing); the index width follows from the vertex count.
+     * A geometry that appears again, either as the same object or with
+     * identical vertex, normal and index data, is written as an instance of
+     * the first node. Node colors come from the nearest osg::Material diffuse
+     * color, else the geometry's color array, and form the file's color table.
+     *
+     * Of an osg::LOD only the most detailed child is written. A scene with
+     * osg::PagedLOD levels that are not loaded (e.g. loaded with "paged") is
+     * refused, since the file would silently lack them. Geometries whose
+     * vertices are not Vec3Array/Vec3dArray (e.g. scenes loaded with
+     * "gpudequant") are skipped with a warning.
+     */
+    class LmbWriter
+    {
+    public:
+        /**
+         * @brief Write the scene to an LMB file (via a temporary file and rename)
+         * @return false if the scene has no triangles or the file cannot be written
+         */
+        static bool WriteFile(const osg::Node &scene, const std::string &filepath,
+                              const LmbWriteOptions &options = LmbWriteOptions(), LmbWriteStats *stats = nullptr);
+
+        /**
+         * @brief Write the scene to a stream; streamName is only used in log messages
+         */
+        static bool WriteStream(const osg::Node &scene, std::ostream &stream, const std::string &streamName,
+                                const LmbWriteOptions &options = LmbWriteOptions(), LmbWriteStats *stats = nullptr);
+    };
+
+} // namespace LmbPlugin
+
+#endif // LMBWRITER_H
@@ -1,5 +1,9 @@
 #include "ReaderWriterLMB.h"
 #include "LmbParser.h"
+#include "LmbPaging.h"
+#include "LmbWriter.h"
+#include "LmbCompression.h"
+#include "LmbTempFile.h"
 #include "../PluginLogger.h"
 #include <osgDB/FileNameUtils>
 #include <osgDB/Registry>
@@ -7,74 +11,60 @@
 #include <fstream>
 #include <sstream>
 #include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <cstdio>
 
-ReaderWriterLMB::ReaderWriterLMB()
+namespace
 {
-    supportsExtension("lmb", "LMB model format");
-
-    // Check for debug mode environment variable
-    const char *debugEnv = std::getenv("OSG_PLUGIN_DEBUG");
-    if (debugEnv && (std::string(debugEnv) == "1" || std::string(debugEnv) == "true"))
+    // 从选项字符串中查找 key=value 形式的选项
+    bool getOptionValue(const std::string &optionString, const std::string &key, std::string &value)
     {
-        PluginLogger::setLogLevel(PluginLogger::LOG_DEBUG);
+        std::istringstream iss(optionString);
+        std::string token;
+        const std::string prefix = key + "=";
+        while (iss >> token)
+        {
+            if (token.compare(0, prefix.size(), prefix) == 0)
+            {
+                value = token.substr(prefix.size());
+                return true;
+            }
+        }
+        return false;
     }
 
-    // Log plugin initialization
-    std::vector<std::string> formats = {"lmb"};
-    PluginLogger::logPluginInit("LMB", "1.0.0", formats);
-
-    // Log additional initialization details in debug mode
-    PluginLogger::logDebug("LMB", "Plugin constructor called");
-
-    // Log plugin capabilities
-    std::vector<std::string> capabilities = {
-        "Binary format parsing",
-        "Progress callbacks",
-        "Comprehensive error handling",
-        "Vertex compression support",
-        "Instance rendering support",
-        "Material color mapping"};
-    PluginLogger::logPluginCapabilities("LMB", capabilities);
-
-    // Log system information in debug mode
-    PluginLogger::logSystemInfo("LMB");
-
-    PluginLogger::logDebug("LMB", "Plugin loaded successfully - ready to handle LMB files");
-}
-
-const char *ReaderWriterLMB::className() const
-{
-    return "LMB Reader/Writer";
-}
-
-osgDB::ReaderWriter::ReadResult ReaderWriterLMB::readNode(const std::string &fileName, const osgDB::Options *options) const
-{
-    std::string ext = osgDB::getLowerCaseFileExtension(fileName);
-    if (!acceptsExtension(ext))
+    // 选项字符串中是否包含独立的开关 token
+    bool hasOption(const std::string &optionString, const std::string &key)
     {
-        PluginLogger::logDebug("LMB", "File extension not supported: " + ext);
-        return ReadResult::FILE_NOT_HANDLED;
+        std::istringstream iss(optionString);
+        std::string token;
+        while (iss >> token)
+        {
+            if (token == key)
+                return true;
+        }
+        return false;
     }
 
-    std::string localFileName = fileName;
-
-    // Check if file exists
-    std::ifstream testFile(localFileName);
-    if (!testFile.good())
+    // 按逗号拆分选项值
+    std::vector<std::string> splitList(const std::string &value)
     {
-        PluginLogger::logError("LMB", "File not found: " + fileName);
-        return ReadResult::FILE_NOT_FOUND;
+        std::vector<std::string> items;
+        std::istringstream iss(value);
+        std::string item;
+        while (std::getline(iss, item, ','))
+        {
+            if (!item.empty())
+                items.push_back(item);
+        }
+        return items;
     }
-    testFile.close();
-
-    auto startTime = std::chrono::high_resolution_clock::now();
-    PluginLogger::logInfo("LMB", "Starting to load file: " + localFileName);
 
-    try
+    // 从 OSG 选项中解析进度回调与 LMB 加载选项（文件与流读取共用）
+    void parseLoadOptions(const osgDB::Options *options, std::function<void(const char *)> &progressCallback,
+                          LmbPlugin::LmbLoadOptions &loadOptions)
     {
-        // Extract progress callback from OSG options
-        std::function<void(const char *)> progressCallback = nullptr;
-
         if (options)
         {
             // For now, we'll use a simple approach since OSG progress callback API varies by version
@@ -111,8 +101,147 @@ osgDB::ReaderWriter::ReadResult ReaderWriterLMB::readNode(const std::string &fil
                     }
                 }
 
+                // Check for thread count option
+                std::string value;
+                if (getOptionValue(optionString, "threads", value))
+                {
+                    loadOptions.threadCount = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+                    PluginLogger::logInfo("LMB", "Decode thread count set via options: " + value);
+                }
+
+                // Check for hardware instancing option
+                if (hasOption(optionString, "instancing"))
+                {
+                    loadOptions.hardwareInstancing = true;
+                    PluginLogger::logInfo("LMB", "Hardware instancing enabled via options");
+                }
+
+                // Check for GPU dequantization option
+                if (hasOption(optionString, "gpudequant"))
+                {
+                    loadOptions.gpuDequantization = true;
+                    PluginLogger::logInfo("LMB", "GPU vertex dequantization enabled via options");
+                }
+
+                // Check for node index / partial loading options
+                if (hasOption(optionString, "noindex"))
+                {
+                    loadOptions.useIndex = false;
+                    PluginLogger::logInfo("LMB", "Sidecar node index disabled via options");
+                }
+                if (getOptionValue(optionString, "nodes", value))
+                {
+                    loadOptions.nodeNames = splitList(value);
+                    PluginLogger::logInfo("LMB", "Node filter set via options: " + value);
+                }
+                if (getOptionValue(optionString, "bbox", value))
+                {
+                    const std::vector<std::string> coords = splitList(value);
+                    if (coords.size() == 6)
+                    {
+                        float v[6];
+                        for (int i = 0; i < 6; ++i)
+                            v[i] = std::strtof(coords[i].c_str(), nullptr);
+                        loadOptions.boundsFilter.set(std::min(v[0], v[3]), std::min(v[1], v[4]), std::min(v[2], v[5]),
+                                                     std::max(v[0], v[3]), std::max(v[1], v[4]), std::max(v[2], v[5]));
+                        PluginLogger::logInfo("LMB", "Bounding box filter set via options: " + value);
+                    }
+                    else
+                    {
+                        PluginLogger::logWarning("LMB", "Ignoring bbox option, expected bbox=minX,minY,minZ,maxX,maxY,maxZ: " + value);
+                    }
+                }
+
+                // Check for paged loading options
+                if (hasOption(optionString, "paged"))
+                {
+                    loadOptions.paged = true;
+                    PluginLogger::logInfo("LMB", "Paged loading enabled via options");
+                }
+                if (getOptionValue(optionString, "pagedpixels", value))
+                {
+                    loadOptions.pagedMinPixels = std::strtof(value.c_str(), nullptr);
+                    PluginLogger::logInfo("LMB", "Paged node pixel threshold set via options: " + value);
+                }
+                if (getOptionValue(optionString, "pagedbudget", value))
+                {
+                    loadOptions.pagedBudgetMB = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+                    PluginLogger::logInfo("LMB", "Paged memory budget set via options: " + value + " MB");
+                }
+
+                // Check for static batching options
+                if (hasOption(optionString, "batch"))
+                {
+                    loadOptions.staticBatching = true;
+                    PluginLogger::logInfo("LMB", "Static batching enabled via options");
+                }
+                if (getOptionValue(optionString, "batchsize", value))
+                {
+                    loadOptions.batchMaxVertices = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+                    PluginLogger::logInfo("LMB", "Static batch vertex limit set via options: " + value);
+                }
+
+                // Check for geometry deduplication option
+                if (hasOption(optionString, "nodedup"))
+                {
+                    loadOptions.deduplicate = false;
+                    PluginLogger::logInfo("LMB", "Geometry deduplication disabled via options");
+                }
+
+                // Check for simplification LOD options
+                if (hasOption(optionString, "lod") && loadOptions.lodTriangles == 0)
+                {
+                    loadOptions.lodTriangles = 20000;
+                    PluginLogger::logInfo("LMB", "Simplification LODs enabled via options");
+                }
+                if (getOptionValue(optionString, "lodtriangles", value))
+                {
+                    loadOptions.lodTriangles = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+                    PluginLogger::logInfo("LMB", "LOD triangle threshold set via options: " + value);
+                }
+                if (getOptionValue(optionString, "lodpixels", value))
+                {
+                    loadOptions.lodPixels = std::strtof(value.c_str(), nullptr);
+                    PluginLogger::logInfo("LMB", "LOD switch pixel size set via options: " + value);
+                }
+                if (getOptionValue(optionString, "lodlevels", value))
+                {
+                    loadOptions.lodLevels = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+                    PluginLogger::logInfo("LMB", "LOD level count set via options: " + value);
+                }
+
+                // Check for index buffer optimization option
+                if (hasOption(optionString, "optimize"))
+                {
+                    loadOptions.optimizeMeshes = true;
+                    PluginLogger::logInfo("LMB", "Vertex cache / overdraw optimization enabled via options");
+                }
+
+                // Check for load profiling trace option
+                if (getOptionValue(optionString, "trace", value))
+                {
+                    loadOptions.tracePath = value;
+                    PluginLogger::logInfo("LMB", "Load trace will be written to " + value);
+                }
+
+                // Check for node validation level option
+                if (getOptionValue(optionString, "validate", value))
+                {
+                    if (value == "off" || value == "fast" || value == "full")
+                    {
+                        loadOptions.validation = value == "off"    ? LmbPlugin::LmbValidation::OFF
+                                                 : value == "fast" ? LmbPlugin::LmbValidation::FAST
+                                                                   : LmbPlugin::LmbValidation::FULL;
+                        PluginLogger::logInfo("LMB", "Node validation level set via options: " + value);
+                    }
+                    else
+                        PluginLogger::logWarning("LMB", "Ignoring validate option, expected validate=off|fast|full: " + value);
+                }
+
                 // Check for unsupported options and warn
-                std::vector<std::string> knownOptions = {"debug", "verbose"};
+                std::vector<std::string> knownOptions = {"debug", "verbose", "threads", "instancing", "gpudequant",
+                                                         "noindex", "nodes", "bbox", "paged", "batch", "nodedup", "lod",
+                                                         "optimize", "trace", "validate", "noinstances"};
                 std::istringstream iss(optionString);
                 std::string option;
                 while (iss >> option)
@@ -133,9 +262,143 @@ osgDB::ReaderWriter::ReadResult ReaderWriterLMB::readNode(const std::string &fil
                 }
             }
         }
+    }
+
+    // 从 OSG 选项中解析写出选项（文件与流写出共用）；threads 仅用于 .lmbz 压缩
+    void parseWriteOptions(const osgDB::Options *options, LmbPlugin::LmbWriteOptions &writeOptions, unsigned &threads)
+    {
+        if (!options)
+            return;
+        const std::string optionString = options->getOptionString();
+        if (hasOption(optionString, "noinstances"))
+        {
+            writeOptions.detectInstances = false;
+            PluginLogger::logInfo("LMB", "Instance detection disabled via options");
+        }
+        std::string value;
+        if (getOptionValue(optionString, "threads", value))
+            threads = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+    }
+}
+
+ReaderWriterLMB::ReaderWriterLMB()
+{
+    supportsExtension("lmb", "LMB model format");
+    supportsExtension("lmbz", "Block-compressed LMB model format");
+    supportsExtension(LmbPlugin::LmbPaging::PageExtension, "LMB paged node (internal, requested by PagedLOD)");
+
+    // osgDB 按扩展名查找 osgdb_<ext> 插件；.lmbz 与分页节点都由 osgdb_lmb 处理，
+    // 需要显式登记别名，否则独立的 osgviewer/osgconv 会去找不存在的 osgdb_lmbz
+    osgDB::Registry::instance()->addFileExtensionAlias("lmbz", "lmb");
+    osgDB::Registry::instance()->addFileExtensionAlias(LmbPlugin::LmbPaging::PageExtension, "lmb");
+
+    supportsOption("threads=<n>", "Number of decode threads (0 = hardware concurrency)");
+    supportsOption("instancing", "Draw LMB instance lists with hardware instancing (one draw per node)");
+    supportsOption("gpudequant", "Upload int16 positions and packed normals as-is and dequantize them in the vertex shader");
+    supportsOption("nodes=<a,b,#n>", "Load only the named nodes (#n = node index)");
+    supportsOption("bbox=<x0,y0,z0,x1,y1,z1>", "Load only nodes whose world bounds intersect the box");
+    supportsOption("noindex", "Do not read or write the .lmbi sidecar node index");
+    supportsOption("paged", "Page nodes in and out with PagedLOD as they become visible");
+    supportsOption("pagedpixels=<n>", "Screen size in pixels at which a paged node is loaded (default 40)");
+    supportsOption("pagedbudget=<MB>", "Memory budget for resident paged geometry");
+    supportsOption("batch", "Merge non-instanced nodes by color into pre-transformed batches");
+    supportsOption("batchsize=<n>", "Maximum vertices per static batch (default 65536)");
+    supportsOption("nodedup", "Do not share geometry between nodes with identical mesh data");
+    supportsOption("lod", "Generate simplified LOD levels for nodes with 20000+ triangles");
+    supportsOption("lodtriangles=<n>", "Triangle count from which a node gets simplified LOD levels (enables LODs)");
+    supportsOption("lodpixels=<n>", "Screen size in pixels below which the first simplified level is drawn (default 300)");
+    supportsOption("lodlevels=<n>", "Maximum number of simplified levels per node (default 3)");
+    supportsOption("optimize", "Reorder triangles and vertices for the vertex cache, overdraw and fetch locality");
+    supportsOption("trace=<file>", "Write per-stage load timings as a Chrome trace (also OSG_PLUGIN_TRACE=<dir>)");
+    supportsOption("validate=<off|fast|full>", "Per-node checks while decoding: off = color indices only, fast = also index ranges, full = also non-finite transforms (default)");
+    supportsOption("noinstances", "Write: store repeated geometry as separate nodes instead of instances");
+
+    // Check for debug mode environment variable
+    const char *debugEnv = std::getenv("OSG_PLUGIN_DEBUG");
+    if (debugEnv && (std::string(debugEnv) == "1" || std::string(debugEnv) == "true"))
+    {
+        PluginLogger::setLogLevel(PluginLogger::LOG_DEBUG);
+    }
+
+    // Log plugin initialization
+    std::vector<std::string> formats = {"lmb", "lmbz"};
+    PluginLogger::logPluginInit("LMB", "1.0.0", formats);
+
+    // Log additional initialization details in debug mode
+    PluginLogger::logDebug("LMB", "Plugin constructor called");
+
+    // Log plugin capabilities
+    std::vector<std::string> capabilities = {
+        "Binary format parsing",
+        "Memory-mapped zero-copy reading",
+        "Block-compressed .lmbz with parallel decompression",
+        "Forward-only stream reading",
+        "Sidecar node index and partial loading",
+        "View-dependent paged loading (option)",
+        "Parallel node decoding",
+        "Progress callbacks",
+        "Comprehensive error handling",
+        "Vertex compression support",
+        "Instance rendering support",
+        "Hardware instancing (option)",
+        "GPU vertex dequantization (option)",
+        "Static batching (option)",
+        "Content-hash geometry deduplication",
+        "Quadric simplification LODs (option)",
+        "Vertex cache / overdraw optimization (option)",
+        "Per-stage load profiling and Chrome trace (option)",
+        "Single-pass vectorized node validation (off/fast/full)",
+        "Material color mapping",
+        "LMB/LMBZ writer (int16 quantization, instance detection)"};
+    PluginLogger::logPluginCapabilities("LMB", capabilities);
+
+    // Log system information in debug mode
+    PluginLogger::logSystemInfo("LMB");
+
+    PluginLogger::logDebug("LMB", "Plugin loaded successfully - ready to handle LMB files");
+}
+
+const char *ReaderWriterLMB::className() const
+{
+    return "LMB Reader/Writer";
+}
+
+osgDB::ReaderWriter::ReadResult ReaderWriterLMB::readNode(const std::string &fileName, const osgDB::Options *options) const
+{
+    std::string ext = osgDB::getLowerCaseFileExtension(fileName);
+    if (!acceptsExtension(ext))
+    {
+        PluginLogger::logDebug("LMB", "File extension not supported: " + ext);
+        return ReadResult::FILE_NOT_HANDLED;
+    }
+
+    // DatabasePager 对分页节点的请求："<n>.lmbpage"，上下文在 Options 的 user data 中
+    if (ext == LmbPlugin::LmbPaging::PageExtension)
+        return readPage(fileName, options);
+
+    std::string localFileName = fileName;
+
+    // Check if file exists
+    std::ifstream testFile(localFileName);
+    if (!testFile.good())
+    {
+        PluginLogger::logError("LMB", "File not found: " + fileName);
+        return ReadResult::FILE_NOT_FOUND;
+    }
+    testFile.close();
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    PluginLogger::logInfo("LMB", "Starting to load file: " + localFileName);
+
+    try
+    {
+        // Extract progress callback and load options from OSG options
+        std::function<void(const char *)> progressCallback = nullptr;
+        LmbPlugin::LmbLoadOptions loadOptions;
+        parseLoadOptions(options, progressCallback, loadOptions);
 
         // 使用独立的 LmbParser 加载文件，传递进度回调
-        osg::ref_ptr<osg::Group> result = LmbPlugin::LmbParser::parseFile(localFileName, progressCallback);
+        osg::ref_ptr<osg::Group> result = LmbPlugin::LmbParser::parseFile(localFileName, progressCallback, loadOptions);
 
         if (result.valid())
         {
@@ -170,10 +433,67 @@ osgDB::ReaderWriter::ReadResult ReaderWriterLMB::readNode(const std::string &fil
     }
 }
 
+osgDB::ReaderWriter::ReadResult ReaderWriterLMB::readPage(const std::string &fileName, const osgDB::Options *options) const
+{
+    const LmbPlugin::LmbPagedContext *context =
+        options ? dynamic_cast<const LmbPlugin::LmbPagedContext *>(options->getUserData()) : nullptr;
+    size_t nodeIndex = 0;
+    if (!context || !LmbPlugin::LmbPaging::ParsePageFileName(fileName, nodeIndex))
+    {
+        PluginLogger::logDebug("LMB", "Paged node request without LMB context: " + fileName);
+        return ReadResult::FILE_NOT_HANDLED;
+    }
+
+    try
+    {
+        osg::ref_ptr<osg::Group> page = LmbPlugin::LmbParser::loadPage(*context, nodeIndex);
+        if (page.valid())
+            return ReadResult(page.release());
+        return ReadResult::ERROR_IN_READING_FILE;
+    }
+    catch (const std::exception &e)
+    {
+        PluginLogger::logError("LMB", "Exception while paging node " + fileName + ": " + e.what());
+        return ReadResult::ERROR_IN_READING_FILE;
+    }
+}
+
 osgDB::ReaderWriter::ReadResult ReaderWriterLMB::readNode(std::istream &stream, const osgDB::Options *options) const
 {
-    // LMB 格式需要随机访问，不支持流读取
-    return ReadResult::FILE_NOT_HANDLED;
+    // 流可能不可定位（归档、管道），解析器只做一次顺序读取
+    const std::string streamName = "<stream>";
+    auto startTime = std::chrono::high_resolution_clock::now();
+    PluginLogger::logInfo("LMB", "Starting to load from stream");
+
+    try
+    {
+        std::function<void(const char *)> progressCallback = nullptr;
+        LmbPlugin::LmbLoadOptions loadOptions;
+        parseLoadOptions(options, progressCallback, loadOptions);
+
+        osg::ref_ptr<osg::Group> result =
+            LmbPlugin::LmbParser::parseStream(stream, streamName, progressCallback, loadOptions);
+        if (result.valid())
+        {
+            auto endTime = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+            PluginLogger::logInfo("LMB", "Successfully loaded stream in " + std::to_string(duration.count()) + "ms");
+            return ReadResult(result.release());
+        }
+
+        PluginLogger::logError("LMB", "Failed to load stream - parser returned null");
+        return ReadResult::ERROR_IN_READING_FILE;
+    }
+    catch (const std::exception &e)
+    {
+        PluginLogger::logError("LMB", std::string("Standard exception while loading stream: ") + e.what());
+        return ReadResult::ERROR_IN_READING_FILE;
+    }
+    catch (...)
+    {
+        PluginLogger::logError("LMB", "Unknown exception while loading stream");
+        return ReadResult::ERROR_IN_READING_FILE;
+    }
 }
 
 osgDB::ReaderWriter::WriteResult ReaderWriterLMB::writeNode(const osg::Node &node, const std::string &fileName, const osgDB::Options *options) const
@@ -185,9 +505,71 @@ osgDB::ReaderWriter::WriteResult ReaderWriterLMB::writeNode(const osg::Node &nod
         return WriteResult::FILE_NOT_HANDLED;
     }
 
-    // LMB 格式目前不支持写入
-    PluginLogger::logWarning("LMB", "Writing LMB files is not currently supported");
-    return WriteResult::FILE_NOT_HANDLED;
+    // 分页节点只在读取时由 DatabasePager 请求
+    if (ext == LmbPlugin::LmbPaging::PageExtension)
+        return WriteResult::FILE_NOT_HANDLED;
+
+    LmbPlugin::LmbWriteOptions writeOptions;
+    unsigned threads = 0;
+    parseWriteOptions(options, writeOptions, threads);
+
+    // .lmbz 的未压缩中间文件；名称按进程与线程区分，任何出错路径都会删除
+    std::string rawFileName;
+    try
+    {
+        if (ext != "lmbz")
+        {
+            if (LmbPlugin::LmbWriter::WriteFile(node, fileName, writeOptions))
+                return WriteResult::FILE_SAVED;
+            return WriteResult::ERROR_IN_WRITING_FILE;
+        }
+
+        // .lmbz：先写出未压缩的临时 .lmb，再分块压缩
+        rawFileName = LmbPlugin::LmbTempFile::PathFor(fileName);
+        if (!LmbPlugin::LmbWriter::WriteFile(node, rawFileName, writeOptions))
+            return WriteResult::ERROR_IN_WRITING_FILE;
+
+        LmbPlugin::LmbThreadPool pool(threads);
+        LmbPlugin::LmbCompression::Result result;
+        std::string error;
+        const bool compressed = LmbPlugin::LmbCompression::CompressFile(
+            rawFileName, fileName, LmbPlugin::LmbCompression::DefaultBlockSize, pool, result, error);
+        std::remove(rawFileName.c_str());
+        if (!compressed)
+        {
+            PluginLogger::logError("LMB", "Failed to compress " + fileName + ": " + error);
+            return WriteResult::ERROR_IN_WRITING_FILE;
+        }
+        PluginLogger::logInfo("LMB", "Compressed " + fileName + ": " + std::to_string(result.rawSize / 1024) + " KB -> " +
+                                         std::to_string(result.compressedSize / 1024) + " KB");
+        return WriteResult::FILE_SAVED;
+    }
+    catch (const std::exception &e)
+    {
+        if (!rawFileName.empty())
+            std::remove(rawFileName.c_str());
+        PluginLogger::logError("LMB", "Standard exception while writing " + fileName + ": " + e.what());
+        return WriteResult::ERROR_IN_WRITING_FILE;
+    }
+}
+
+osgDB::ReaderWriter::WriteResult ReaderWriterLMB::writeNode(const osg::Node &node, std::ostream &stream, const osgDB::Options *options) const
+{
+    LmbPlugin::LmbWriteOptions writeOptions;
+    unsigned threads = 0;
+    parseWriteOptions(options, writeOptions, threads);
+
+    try
+    {
+        if (LmbPlugin::LmbWriter::WriteStream(node, stream, "<stream>", writeOptions))
+            return WriteResult::FILE_SAVED;
+        return WriteResult::ERROR_IN_WRITING_FILE;
+    }
+    catch (const std::exception &e)
+    {
+        PluginLogger::logError("LMB", std::string("Standard exception while writing stream: ") + e.what());
+        return WriteResult::ERROR_IN_WRITING_FILE;
+    }
 }
 
 // 注册插件
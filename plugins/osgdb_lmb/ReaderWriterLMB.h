@@ -7,10 +7,11 @@
 #include <string>
 
 /**
- * @brief OSG plugin for reading LMB files
+ * @brief OSG plugin for reading and writing LMB files
  *
  * This plugin provides support for loading LMB files
- * using the independent LmbParser implementation.
+ * using the independent LmbParser implementation, and
+ * for writing scene graphs as LMB/LMBZ with LmbWriter.
  */
 class ReaderWriterLMB : public osgDB::ReaderWriter
 {
@@ -23,6 +24,11 @@ public:
     virtual ReadResult readNode(const std::string &fileName, const osgDB::Options *options) const override;
     virtual ReadResult readNode(std::istream &stream, const osgDB::Options *options) const override;
     virtual WriteResult writeNode(const osg::Node &node, const std::string &fileName, const osgDB::Options *options) const override;
+    virtual WriteResult writeNode(const osg::Node &node, std::ostream &stream, const osgDB::Options *options) const override;
+
+private:
+    // 加载分页场景中的单个节点（PagedLOD 请求的 "<n>.lmbpage"）
+    ReadResult readPage(const std::string &fileName, const osgDB::Options *options) const;
 };
 
 #endif // READERWRITERLMB_H
\ No newline at end of file
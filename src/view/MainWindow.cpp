@@ -37,7 +37,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     auto* fileMenu = menuBar()->addMenu(QString("文件"));
     auto* openAct = fileMenu->addAction(QString("打开..."));
     connect(openAct, &QAction::triggered, this, [this]() {
-        QString filters = QString("3D 模型文件 (*.osg *.osgt *.ive *.obj *.gltf *.glb *.lmb);;所有文件 (*.*)");
+        QString filters = QString("3D 模型文件 (*.osg *.osgt *.ive *.obj *.gltf *.glb *.lmb *.lmbz);;所有文件 (*.*)");
         QString path = QFileDialog::getOpenFileName(this, QString("打开模型"), QString(), filters);
         if (path.isEmpty()) return;
         if (auto* v = qobject_cast<OSGWidget*>(centralWidget())) {
@@ -15,9 +15,221 @@
 #include <osg/Material>
 #include <osg/ComputeBoundsVisitor>
 #include <osg/CullFace>
+#include <osg/PolygonOffset>
+#include <osg/Uniform>
 #include <osgViewer/ViewerEventHandlers>
+#include <osg/UserDataContainer>
+#include <osg/ValueObject>
+#include <osgDB/DatabasePager>
+#include <algorithm>
+#include <cfloat>
 #include <cmath>
 
+namespace {
+// LMB 插件硬件实例化时写入 Geode 的实例矩阵（见 LmbInstancing）
+const char* kInstanceMatricesName = "LmbInstanceMatrices";
+// LMB 插件 GPU 反量化时挂在几何上的 BIND_OVERALL 顶点属性（见 LmbShaders）
+const unsigned int kQuantBaseAttribute = 6;
+const unsigned int kQuantInvScaleAttribute = 7;
+// LMB 插件分页模式写在根节点上的建议常驻页数（见 LmbParser::PagedTargetCountName）
+const char* kPagedTargetCountName = "LmbPagedTargetCount";
+// 插件着色器（LMB 实例化/GPU 反量化、glTF 实例化）的光照开关，GL_LIGHTING 对它们无效（见 PluginShaders.h）
+const char* kPluginLightingUniform = "pluginLighting";
+// LMB 插件合批时写入 Geode 的各部件起始三角形（见 LmbBatching）
+const char* kBatchTriangleStartsName = "LmbBatchTriangleStarts";
+
+const osg::MatrixfArray* instanceMatrices(const osg::Node* node) {
+    const osg::UserDataContainer* udc = node ? node->getUserDataContainer() : nullptr;
+    return udc ? dynamic_cast<const osg::MatrixfArray*>(udc->getUserObject(kInstanceMatricesName)) : nullptr;
+}
+
+const osg::UIntArray* batchTriangleStarts(const osg::Node* node) {
+    const osg::UserDataContainer* udc = node ? node->getUserDataContainer() : nullptr;
+    return udc ? dynamic_cast<const osg::UIntArray*>(udc->getUserObject(kBatchTriangleStartsName)) : nullptr;
+}
+
+const osg::Vec3Array* quantizationParameter(const osg::Geometry* geometry, unsigned int index) {
+    const osg::Vec3Array* values = dynamic_cast<const osg::Vec3Array*>(geometry->getVertexAttribArray(index));
+    return values && !values->empty() ? values : nullptr;
+}
+
+bool isQuantized(const osg::Drawable* drawable) {
+    const osg::Geometry* geometry = drawable->asGeometry();
+    return geometry && quantizationParameter(geometry, kQuantBaseAttribute)
+        && quantizationParameter(geometry, kQuantInvScaleAttribute)
+        && dynamic_cast<const osg::Vec3sArray*>(geometry->getVertexArray());
+}
+
+// 实例化或量化的几何 OSG 自带求交无法处理，由 pickCustom 负责
+bool needsCustomPick(const osg::Node* node) {
+    const osg::Geode* geode = node ? node->asGeode() : nullptr;
+    if (!geode) return false;
+    if (instanceMatrices(geode)) return true;
+    for (unsigned int i = 0; i < geode->getNumDrawables(); ++i) {
+        if (isQuantized(geode->getDrawable(i))) return true;
+    }
+    return false;
+}
+
+class SceneIntersectionVisitor : public osgUtil::IntersectionVisitor {
+public:
+    explicit SceneIntersectionVisitor(osgUtil::Intersector* intersector) : osgUtil::IntersectionVisitor(intersector) {}
+    void apply(osg::Geode& geode) override {
+        if (needsCustomPick(&geode)) return;
+        osgUtil::IntersectionVisitor::apply(geode);
+    }
+};
+
+class CustomPickGeodeCollector : public osg::NodeVisitor {
+public:
+    CustomPickGeodeCollector() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+    void apply(osg::Geode& geode) override {
+        if (needsCustomPick(&geode)) geodes.push_back(&geode);
+    }
+    std::vector<osg::Geode*> geodes;
+};
+
+// 单份、非实例化、浮点顶点的几何副本，用于求交和实例高亮代理
+osg::ref_ptr<osg::Geometry> createPickableGeometry(const osg::Geometry* source) {
+    osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry(*source, osg::CopyOp::SHALLOW_COPY);
+    for (unsigned int i = 0; i < geometry->getNumPrimitiveSets(); ++i) {
+        osg::ref_ptr<osg::PrimitiveSet> primitives = osg::clone(source->getPrimitiveSet(i), osg::CopyOp::SHALLOW_COPY);
+        primitives->setNumInstances(0);
+        geometry->setPrimitiveSet(i, primitives.get());
+    }
+
+    if (isQuantized(source)) {
+        // v = base + q * invScale，与 LMB 着色器一致
+        const osg::Vec3 base = quantizationParameter(source, kQuantBaseAttribute)->front();
+        const osg::Vec3 invScale = quantizationParameter(source, kQuantInvScaleAttribute)->front();
+        const osg::Vec3sArray* quantized = static_cast<const osg::Vec3sArray*>(source->getVertexArray());
+        osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array(quantized->size());
+        for (size_t i = 0; i < quantized->size(); ++i) {
+            const osg::Vec3s& q = (*quantized)[i];
+            (*vertices)[i].set(base.x() + q.x() * invScale.x(), base.y() + q.y() * invScale.y(), base.z() + q.z() * invScale.z());
+        }
+        geometry->setVertexArray(vertices.get());
+
+        // 10:10:10:2 打包法线，LMB 的 x 在高位
+        const osg::Array* packed = source->getNormalArray();
+        if (packed && packed->getDataType() == GL_INT_2_10_10_10_REV) {
+            const GLint* data = static_cast<const GLint*>(packed->getDataPointer());
+            osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array(packed->getNumElements());
+            for (unsigned int i = 0; i < packed->getNumElements(); ++i) {
+                const uint32_t p = static_cast<uint32_t>(data[i]);
+                auto field = [p](int shift) { return static_cast<float>(static_cast<int32_t>(p << (22 - shift)) >> 22); };
+                osg::Vec3 n(field(20), field(10), field(0));
+                n.normalize();
+                (*normals)[i] = n;
+            }
+            geometry->setNormalArray(normals.get(), osg::Array::BIND_PER_VERTEX);
+        }
+        // 反量化参数只对着色器有意义
+        geometry->setVertexAttribArray(kQuantBaseAttribute, nullptr);
+        geometry->setVertexAttribArray(kQuantInvScaleAttribute, nullptr);
+    }
+
+    geometry->setComputeBoundingBoxCallback(nullptr);
+    geometry->setInitialBound(osg::BoundingBox());
+    geometry->setUseDisplayList(false);
+    geometry->dirtyBound();
+    return geometry;
+}
+
+// 高亮代理：单独的变换 + Geode，命名与加载器生成的节点一致
+osg::ref_ptr<osg::MatrixTransform> createProxy(osg::Geometry* geometry, const std::string& name, const osg::Matrixd& world) {
+    osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+    geode->setName(name + "_Geode");
+    geode->addDrawable(geometry);
+
+    osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform(world);
+    transform->setName(name);
+    transform->addChild(geode.get());
+    return transform;
+}
+
+// 普通 Geode 的高亮代理：逐个几何生成浮点副本，原节点保持不变
+osg::ref_ptr<osg::MatrixTransform> createGeodeProxy(const osg::Geode* source, const osg::Matrixd& world) {
+    osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+    geode->setName(source->getName());
+    for (unsigned int i = 0; i < source->getNumDrawables(); ++i) {
+        const osg::Geometry* geometry = source->getDrawable(i)->asGeometry();
+        if (geometry) geode->addDrawable(createPickableGeometry(geometry).get());
+    }
+    if (geode->getNumDrawables() == 0) return nullptr;
+
+    osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform(world);
+    transform->setName(source->getName());
+    transform->addChild(geode.get());
+    return transform;
+}
+
+struct CustomHit {
+    osg::Geode* geode = nullptr;
+    unsigned int drawableIndex = 0;
+    unsigned int instanceIndex = 0;
+    bool instanced = false;
+    osg::Matrixd world;
+    double distance = DBL_MAX;
+};
+
+// 实例化几何只有一份顶点，逐实例把射线变换到局部空间求交；量化几何先解码为浮点副本
+void pickCustom(osg::Node* scene, osg::Node* haltAt, const osg::Vec3d& start, const osg::Vec3d& end, CustomHit& best) {
+    osg::Vec3d dir = end - start;
+    const double length = dir.normalize();
+    if (length <= 0.0) return;
+    CustomPickGeodeCollector collector;
+    scene->accept(collector);
+    const osg::Matrixf identity;
+    for (osg::Geode* geode : collector.geodes) {
+        const osg::MatrixfArray* matrices = instanceMatrices(geode);
+        const unsigned int instanceCount = matrices ? static_cast<unsigned int>(matrices->size()) : 1u;
+        osg::MatrixList worlds = geode->getWorldMatrices(haltAt);
+        const osg::Matrixd parentWorld = worlds.empty() ? osg::Matrixd() : worlds.front();
+        for (unsigned int d = 0; d < geode->getNumDrawables(); ++d) {
+            osg::Drawable* drawable = geode->getDrawable(d);
+            // 包围盒可能已扩展为全部实例，这里取单份几何的包围球做粗筛
+            const osg::Drawable::ComputeBoundingBoxCallback* boundCallback = drawable->getComputeBoundingBoxCallback();
+            const osg::BoundingSphere bs(boundCallback ? boundCallback->computeBound(*drawable) : drawable->computeBoundingBox());
+            osg::ref_ptr<osg::Drawable> pickable;
+            for (unsigned int i = 0; i < instanceCount; ++i) {
+                const osg::Matrixd world = osg::Matrixd(matrices ? (*matrices)[i] : identity) * parentWorld;
+                const osg::Vec3d center = osg::Vec3d(bs.center()) * world;
+                const double scale = std::max(osg::Vec3d(world(0, 0), world(0, 1), world(0, 2)).length(),
+                                     std::max(osg::Vec3d(world(1, 0), world(1, 1), world(1, 2)).length(),
+                                              osg::Vec3d(world(2, 0), world(2, 1), world(2, 2)).length()));
+                const double radius = bs.radius() * scale;
+                const osg::Vec3d toCenter = center - start;
+                const double t = toCenter * dir;
+                if (toCenter.length2() - t * t > radius * radius) continue;
+                if (t + radius < 0.0 || t - radius > best.distance) continue;
+
+                if (!pickable.valid()) {
+                    if (isQuantized(drawable)) pickable = createPickableGeometry(drawable->asGeometry());
+                    else pickable = drawable;
+                }
+                const osg::Matrixd inverse = osg::Matrixd::inverse(world);
+                osg::ref_ptr<osgUtil::LineSegmentIntersector> picker =
+                    new osgUtil::LineSegmentIntersector(start * inverse, end * inverse);
+                osgUtil::IntersectionVisitor iv(picker.get());
+                pickable->accept(iv);
+                if (!picker->containsIntersections()) continue;
+                const osg::Vec3d hitPoint = picker->getFirstIntersection().getLocalIntersectPoint() * world;
+                const double distance = (hitPoint - start).length();
+                if (distance < best.distance) {
+                    best.geode = geode;
+                    best.drawableIndex = d;
+                    best.instanceIndex = i;
+                    best.instanced = matrices != nullptr;
+                    best.world = world;
+                    best.distance = distance;
+                }
+            }
+        }
+    }
+}
+}
+
 OSGWidget::OSGWidget(QWidget* parent) : QOpenGLWidget(parent) {
     setFocusPolicy(Qt::StrongFocus);
     QSurfaceFormat fmt = format();
@@ -219,6 +431,11 @@ void OSGWidget::resizeEvent(QResizeEvent* event) {
 bool OSGWidget::loadModel(const QString& path) {
     osg::ref_ptr<osg::Node> node = osgDB::readNodeFile(path.toStdString());
     if (!node) return false;
+    // LMB 分页模式：按加载器估算的常驻页数限制 DatabasePager
+    int pagedTarget = 0;
+    if (_viewer && _viewer->getDatabasePager() && node->getUserValue(kPagedTargetCountName, pagedTarget) && pagedTarget > 0) {
+        _viewer->getDatabasePager()->setTargetMaximumNumberOfPageLOD(static_cast<unsigned int>(pagedTarget));
+    }
     _sceneRoot->removeChildren(0, _sceneRoot->getNumChildren());
     _sceneRoot->addChild(node.get());
     clearHighlight();
@@ -235,20 +452,74 @@ void OSGWidget::pickAt(int x, int y) {
     if (!_viewer) return;
     osg::ref_ptr<osgUtil::LineSegmentIntersector> picker =
         new osgUtil::LineSegmentIntersector(osgUtil::Intersector::WINDOW, x, height() - y);
-    osgUtil::IntersectionVisitor iv(picker.get());
+    SceneIntersectionVisitor iv(picker.get());
     _viewer->getCamera()->accept(iv);
-    if (picker->containsIntersections()) {
-        const auto& isect = picker->getIntersections().begin()->nodePath;
-        osg::Node* hitNode = nullptr;
+
+    // 与窗口拾取相同的世界空间射线
+    osg::Camera* cam = _viewer->getCamera();
+    const osg::Matrixd windowToWorld = osg::Matrixd::inverse(
+        cam->getViewMatrix() * cam->getProjectionMatrix() * cam->getViewport()->computeWindowMatrix());
+    const osg::Vec3d rayStart = osg::Vec3d(x, height() - y, 0.0) * windowToWorld;
+    const osg::Vec3d rayEnd = osg::Vec3d(x, height() - y, 1.0) * windowToWorld;
+
+    osg::Node* hitNode = nullptr;
+    double hitDistance = DBL_MAX;
+    unsigned int hitDrawableIndex = 0;
+    unsigned int hitTriangle = 0;
+    for (const auto& hit : picker->getIntersections()) {
+        const auto& isect = hit.nodePath;
+        osg::Node* geodeNode = nullptr;
         for (auto it = isect.rbegin(); it != isect.rend(); ++it) {
-            if ((*it)->asGeode()) { hitNode = *it; break; }
+            if ((*it)->asGeode()) { geodeNode = *it; break; }
         }
+        // 上一次的高亮代理会在重新拾取时移除，不参与命中
+        if (_highlightProxy.valid() && std::find(isect.begin(), isect.end(), _highlightProxy.get()) != isect.end()) continue;
+        hitNode = geodeNode;
         if (!hitNode && !isect.empty()) hitNode = isect.back();
-        if (hitNode) {
-            applyHighlight(hitNode);
-            emit nodePicked(hitNode);
-            emit propertiesUpdated(buildProperties(hitNode));
+        hitDistance = (hit.getWorldIntersectPoint() - rayStart).length();
+        if (geodeNode && hit.drawable.valid()) {
+            hitDrawableIndex = geodeNode->asGeode()->getDrawableIndex(hit.drawable.get());
+            hitTriangle = hit.primitiveIndex;
+        }
+        break;
+    }
+
+    // 实例化/量化几何被 SceneIntersectionVisitor 跳过，在这里单独求交
+    CustomHit customHit;
+    customHit.distance = hitDistance;
+    pickCustom(_sceneRoot.get(), _root.get(), rayStart, rayEnd, customHit);
+    osg::ref_ptr<osg::MatrixTransform> proxy;
+    if (customHit.geode && customHit.instanced) {
+        proxy = createInstanceProxy(customHit.geode, customHit.drawableIndex,
+                                    customHit.instanceIndex, customHit.world);
+        if (proxy.valid()) hitNode = proxy->getChild(0);
+    } else if (customHit.geode) {
+        hitNode = customHit.geode;
+        proxy = createGeodeProxy(customHit.geode, customHit.world);
+    } else if (batchTriangleStarts(hitNode)) {
+        // 合批几何按命中三角形找回原节点，单独生成代理用于高亮和属性显示
+        osg::Geode* batchGeode = hitNode->asGeode();
+        osg::MatrixList worlds = batchGeode->getWorldMatrices(_root.get());
+        proxy = createBatchPartProxy(batchGeode, hitDrawableIndex, hitTriangle,
+                                     worlds.empty() ? osg::Matrixd() : worlds.front());
+        if (proxy.valid()) hitNode = proxy->getChild(0);
+    } else if (hitNode && hitNode->asGeode()) {
+        // 普通节点同样用代理高亮：加载器的颜色 StateSet 在同色节点间共享，分页时数据库线程
+        // 会同时挂接、释放它（修改其父节点列表），界面线程不能替换节点上的 StateSet
+        osg::Geode* geode = hitNode->asGeode();
+        osg::MatrixList worlds = geode->getWorldMatrices(_root.get());
+        proxy = createGeodeProxy(geode, worlds.empty() ? osg::Matrixd() : worlds.front());
+    }
+
+    if (hitNode) {
+        clearHighlight();
+        if (proxy.valid()) {
+            applyHighlight(proxy->getChild(0));
+            _root->addChild(proxy.get());
+            _highlightProxy = proxy;
         }
+        emit nodePicked(hitNode);
+        emit propertiesUpdated(buildProperties(hitNode));
     } else {
         clearHighlight();
         emit nodePicked(nullptr);
@@ -256,36 +527,66 @@ void OSGWidget::pickAt(int x, int y) {
     }
 }
 
-void OSGWidget::applyHighlight(osg::Node* node) {
-    if (!node) return;
-    clearHighlight();
-    _selected = node;
-    osg::Geode* geode = node->asGeode();
-    if (geode) {
-        osg::StateSet* ss = geode->getOrCreateStateSet();
-        _savedMaterial = ss->getAttribute(osg::StateAttribute::MATERIAL);
-        
-        osg::ref_ptr<osg::Material> mat = new osg::Material;
-        mat->setDiffuse(osg::Material::FRONT_AND_BACK, osg::Vec4(1.0f, 0.0f, 0.0f, 1.0f));
-        mat->setAmbient(osg::Material::FRONT_AND_BACK, osg::Vec4(1.0f, 0.0f, 0.0f, 1.0f));
-        ss->setAttributeAndModes(mat.get(), osg::StateAttribute::ON | osg::StateAttribute::OVERRIDE);
-    }
+osg::ref_ptr<osg::MatrixTransform> OSGWidget::createInstanceProxy(osg::Geode* instancedGeode, unsigned int drawableIndex,
+                                                                  unsigned int instanceIndex, const osg::Matrixd& world) const {
+    const osg::Geometry* source = instancedGeode->getDrawable(drawableIndex)->asGeometry();
+    if (!source) return nullptr;
+
+    // 图元改为普通绘制（量化顶点解码为浮点），在实例位置单独画一份用于高亮和属性显示
+    osg::ref_ptr<osg::Geometry> geometry = createPickableGeometry(source);
+
+    const osg::Node::DescriptionList& names = instancedGeode->getDescriptions();
+    const std::string name = instanceIndex < names.size()
+        ? names[instanceIndex]
+        : instancedGeode->getName() + "_inst_" + std::to_string(instanceIndex);
+
+    return createProxy(geometry.get(), name, world);
+}
+
+osg::ref_ptr<osg::MatrixTransform> OSGWidget::createBatchPartProxy(osg::Geode* batchGeode, unsigned int drawableIndex,
+                                                                   unsigned int triangleIndex, const osg::Matrixd& world) const {
+    const osg::UIntArray* starts = batchTriangleStarts(batchGeode);
+    const osg::Geometry* source = batchGeode->getDrawable(drawableIndex)->asGeometry();
+    if (!starts || starts->empty() || !source || source->getNumPrimitiveSets() == 0) return nullptr;
+    const osg::DrawElements* elements = source->getPrimitiveSet(0)->getDrawElements();
+    if (!elements) return nullptr;
+
+    // 命中三角形所在的部件：起始三角形不大于它的最后一个
+    const size_t part = std::upper_bound(starts->begin(), starts->end(), triangleIndex) - starts->begin() - 1;
+    const unsigned int first = (*starts)[part] * 3;
+    const unsigned int last = part + 1 < starts->size() ? (*starts)[part + 1] * 3 : elements->getNumIndices();
+
+    // 共享合批顶点数组，只取该部件的索引区间
+    osg::ref_ptr<osg::DrawElementsUInt> indices = new osg::DrawElementsUInt(GL_TRIANGLES);
+    indices->reserve(last - first);
+    for (unsigned int i = first; i < last; ++i) indices->push_back(elements->index(i));
+    osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry(*source, osg::CopyOp::SHALLOW_COPY);
+    geometry->removePrimitiveSet(0, geometry->getNumPrimitiveSets());
+    geometry->addPrimitiveSet(indices.get());
+    geometry->setInitialBound(osg::BoundingBox());
+    geometry->dirtyBound();
+
+    const osg::Node::DescriptionList& names = batchGeode->getDescriptions();
+    const std::string name = part < names.size() ? names[part] : batchGeode->getName() + "_part_" + std::to_string(part);
+    return createProxy(geometry.get(), name, world);
+}
+
+void OSGWidget::applyHighlight(osg::Node* proxyGeode) {
+    // 代理只属于界面，直接设置自己的 StateSet；多边形偏移让它盖住原几何
+    osg::ref_ptr<osg::StateSet> ss = new osg::StateSet;
+    osg::ref_ptr<osg::Material> mat = new osg::Material;
+    mat->setDiffuse(osg::Material::FRONT_AND_BACK, osg::Vec4(1.0f, 0.0f, 0.0f, 1.0f));
+    mat->setAmbient(osg::Material::FRONT_AND_BACK, osg::Vec4(1.0f, 0.0f, 0.0f, 1.0f));
+    ss->setAttributeAndModes(mat.get(), osg::StateAttribute::ON | osg::StateAttribute::OVERRIDE);
+    ss->setAttributeAndModes(new osg::PolygonOffset(-1.0f, -1.0f), osg::StateAttribute::ON);
+    proxyGeode->setStateSet(ss.get());
 }
 
 void OSGWidget::clearHighlight() {
-    if (!_selected.valid()) return;
-    osg::Geode* geode = _selected->asGeode();
-    if (geode) {
-        osg::StateSet* ss = geode->getStateSet();
-        if (ss) {
-            ss->removeAttribute(osg::StateAttribute::MATERIAL);
-            if (_savedMaterial.valid()) {
-                ss->setAttributeAndModes(_savedMaterial.get(), osg::StateAttribute::ON);
-            }
-        }
+    if (_highlightProxy.valid()) {
+        _root->removeChild(_highlightProxy.get());
+        _highlightProxy = nullptr;
     }
-    _selected = nullptr;
-    _savedMaterial = nullptr;
 }
 
 QString OSGWidget::buildProperties(osg::Node* node) const {
@@ -365,6 +666,8 @@ void OSGWidget::applyRenderStates() {
         ss->removeAttribute(osg::StateAttribute::CULLFACE);
     }
     ss->setMode(GL_LIGHTING, _lighting ? osg::StateAttribute::ON : osg::StateAttribute::OFF);
+    osg::ref_ptr<osg::Uniform> lighting = new osg::Uniform(kPluginLightingUniform, _lighting);
+    ss->addUniform(lighting.get(), osg::StateAttribute::ON | osg::StateAttribute::OVERRIDE);
 }
 
 void OSGWidget::toggleWireframe() {
@@ -17,6 +17,7 @@
 #include <osg/PolygonMode>
 #include <osg/StateSet>
 #include <osg/Geometry>
+#include <osg/MatrixTransform>
 #include <osg/Geode>
 
 class OSGWidget : public QOpenGLWidget {
@@ -63,8 +64,7 @@ private:
     osg::ref_ptr<osg::Group> _sceneRoot;
     osg::ref_ptr<osg::Camera> _hudCamera;
     osg::ref_ptr<osgText::Text> _hudText;
-    osg::observer_ptr<osg::Node> _selected;
-    osg::ref_ptr<osg::StateAttribute> _savedMaterial;
+    osg::ref_ptr<osg::Node> _highlightProxy; // 选中节点的高亮代理，临时加入场景，不修改加载器生成的节点
     bool _ortho = true;
     double _orthoScale = 1.0;
     QPoint _pressPos;
@@ -80,7 +80,11 @@ private:
     void createHud();
     osgGA::EventQueue* eventQueue() const;
     void pickAt(int x, int y);
-    void applyHighlight(osg::Node* node);
+    osg::ref_ptr<osg::MatrixTransform> createInstanceProxy(osg::Geode* instancedGeode, unsigned int drawableIndex,
+                                                           unsigned int instanceIndex, const osg::Matrixd& world) const;
+    osg::ref_ptr<osg::MatrixTransform> createBatchPartProxy(osg::Geode* batchGeode, unsigned int drawableIndex,
+                                                            unsigned int triangleIndex, const osg::Matrixd& world) const;
+    void applyHighlight(osg::Node* proxyGeode);
     void clearHighlight();
     QString buildProperties(osg::Node* node) const;
     void updateProjection();
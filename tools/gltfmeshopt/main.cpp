@@ -0,0 +1,1007 @@
+// gltfmeshopt：glTF 插件内置 meshopt 解码器的检查（ctest 目标 gltf_meshopt 与 gltf_meshopt_fixture）
+//
+// 用法：gltfmeshopt [rounds]
+//       gltfmeshopt source <dir>
+//       gltfmeshopt fixture <compressed.glb> [workdir]
+//
+// 默认模式始终运行：按 EXT_meshopt_compression 规范编码已知数据（顶点流取各组能容纳差分的最小位宽，
+// 三角形与索引序列用显式的自由索引），要求内置解码器还原原数据，并检查截断流与错误版本被拒绝；
+// OCTAHEDRAL、QUATERNION 过滤器按规范的量化公式编码已知的单位向量与四元数，解码结果在量化误差内，
+// EXPONENTIAL 过滤器的结果与 ldexp 逐位一致。
+// 提供 third-party/meshoptimizer 时另外用 meshoptimizer 的编码器（gltfpack -cc 使用的同一组函数）编码随机数据：
+// ATTRIBUTES（各种顶点大小）、TRIANGLES（version 0/1，16/32 位索引）、INDICES 及三种过滤器，
+// 要求内置解码器与 meshopt_decode* 逐字节一致。
+//
+// source 模式写出固定的未压缩样例 meshopt_source.gltf（外部 .bin），由 make_fixture.sh 交给 gltfpack -cc；
+// fixture 模式重新写出该样例，与 gltfpack 的压缩结果一起经 GltfParser 读入，按世界坐标比较全部三角形
+// （gltfpack 会重排顶点、旋转三角形并合并网格，因此比较的是三角形集合）。样例不存在时返回 77（ctest 记为跳过）。
+// 有任何不一致时逐条打印并返回非零
+
+#include "GltfMeshopt.h"
+#include "GltfParser.h"
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/NodeVisitor>
+#include <osg/Transform>
+#include <osg/TriangleIndexFunctor>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef GLTFMESHOPT_REFERENCE
+#include <meshoptimizer.h>
+
+#if MESHOPTIMIZER_VERSION < 190
+#error "gltfmeshopt needs meshoptimizer 0.19 or later (meshopt_encodeFilterExp with a mode argument)"
+#endif
+#endif
+
+namespace
+{
+    const int SkipReturnCode = 77;
+
+    int failures = 0;
+    int checks = 0;
+
+    void Fail(const std::string &context, const std::string &message)
+    {
+        std::cerr << "FAIL [" << context << "] " << message << "\n";
+        ++failures;
+    }
+
+    void Compare(const std::string &context, const std::vector<unsigned char> &decoded,
+                 const std::vector<unsigned char> &expected)
+    {
+        ++checks;
+        if (decoded == expected)
+            return;
+
+        size_t first = 0;
+        while (first < decoded.size() && first < expected.size() && decoded[first] == expected[first])
+            ++first;
+        Fail(context, "first differing byte " + std::to_string(first) + " of " + std::to_string(expected.size()));
+    }
+
+    // 顶点数据：平滑变化的字节加少量噪声，使 0/2/4/8 位各种分组模式都会出现
+    std::vector<unsigned char> MakeVertices(std::mt19937 &rng, size_t count, size_t vertexSize)
+    {
+        std::vector<unsigned char> data(count * vertexSize);
+        std::uniform_int_distribution<int> noise(0, 255);
+        const int mode = noise(rng) % 3;
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (size_t k = 0; k < vertexSize; ++k)
+            {
+                int value;
+                if (mode == 0)
+                    value = static_cast<int>(i * (k + 1));
+                else if (mode == 1)
+                    value = static_cast<int>(i / 7 + k) + (noise(rng) & 3);
+                else
+                    value = noise(rng);
+                data[i * vertexSize + k] = static_cast<unsigned char>(value);
+            }
+        }
+        return data;
+    }
+
+    // 三角形：网格条带（边 FIFO 命中多）与随机三角形（自由索引多）混合
+    std::vector<unsigned int> MakeTriangles(std::mt19937 &rng, size_t vertexCount)
+    {
+        std::vector<unsigned int> indices;
+        const size_t columns = 16;
+        const size_t rows = vertexCount / columns;
+        for (size_t y = 0; y + 1 < rows; ++y)
+        {
+            for (size_t x = 0; x + 1 < columns; ++x)
+            {
+                const unsigned int a = static_cast<unsigned int>(y * columns + x);
+                const unsigned int b = a + 1;
+                const unsigned int c = static_cast<unsigned int>(a + columns);
+                const unsigned int d = c + 1;
+                indices.insert(indices.end(), {a, c, b, b, c, d});
+            }
+        }
+
+        std::uniform_int_distribution<unsigned int> pick(0, static_cast<unsigned int>(vertexCount - 1));
+        const size_t extra = vertexCount / 4;
+        for (size_t i = 0; i < extra; ++i)
+        {
+            const unsigned int a = pick(rng);
+            const unsigned int b = pick(rng);
+            const unsigned int c = pick(rng);
+            if (a != b && b != c && a != c)
+                indices.insert(indices.end(), {a, b, c});
+        }
+        return indices;
+    }
+
+    // 大多为小步长（两条交替的递增序列），偶尔跳到任意值；
+    // 32 位索引限制在 2^30 以内：编码时差分的 zigzag 值还要左移一位记录基准，更大的跳跃会丢掉最高位
+    std::vector<unsigned int> MakeSequence(std::mt19937 &rng, size_t count, size_t indexSize)
+    {
+        std::uniform_int_distribution<unsigned int> values(0, indexSize == 2 ? 65535 : 0x3fffffff);
+        std::uniform_int_distribution<int> steps(-3, 3);
+        std::vector<unsigned int> indices(count);
+        unsigned int last[2] = {0, 0};
+        for (size_t i = 0; i < count; ++i)
+        {
+            unsigned int &base = last[i & 1];
+            base = (i % 97 == 0) ? values(rng) : base + steps(rng);
+            if (indexSize == 2)
+                base &= 0xffff;
+            indices[i] = base;
+        }
+        return indices;
+    }
+
+    std::vector<unsigned char> Narrow(const std::vector<unsigned int> &indices, size_t indexSize)
+    {
+        std::vector<unsigned char> data(indices.size() * indexSize);
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            if (indexSize == 2)
+            {
+                const unsigned short value = static_cast<unsigned short>(indices[i]);
+                std::memcpy(&data[i * 2], &value, 2);
+            }
+            else
+                std::memcpy(&data[i * 4], &indices[i], 4);
+        }
+        return data;
+    }
+
+    std::vector<float> MakeUnitVectors(std::mt19937 &rng, size_t count)
+    {
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+        std::vector<float> data(count * 4);
+        for (size_t i = 0; i < count; ++i)
+        {
+            float *v = &data[i * 4];
+            float length = 0.0f;
+            while (length < 1e-3f)
+            {
+                v[0] = normal(rng);
+                v[1] = normal(rng);
+                v[2] = normal(rng);
+                length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+            }
+            v[0] /= length;
+            v[1] /= length;
+            v[2] /= length;
+            v[3] = (i & 1) ? 1.0f : -1.0f; // 切线的 w 分量
+        }
+        return data;
+    }
+
+    std::vector<float> MakeQuaternions(std::mt19937 &rng, size_t count)
+    {
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+        std::vector<float> data(count * 4);
+        for (size_t i = 0; i < count; ++i)
+        {
+            float *q = &data[i * 4];
+            float length = 0.0f;
+            while (length < 1e-3f)
+            {
+                for (int k = 0; k < 4; ++k)
+                    q[k] = normal(rng);
+                length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+            }
+            for (int k = 0; k < 4; ++k)
+                q[k] /= length;
+        }
+        return data;
+    }
+
+    // ---- 按规范编码：与解码器相互独立，只依赖 EXT_meshopt_compression 的格式描述 ----
+
+    unsigned char Zigzag8(unsigned char delta)
+    {
+        return static_cast<unsigned char>((delta << 1) ^ static_cast<unsigned char>(static_cast<signed char>(delta) >> 7));
+    }
+
+    unsigned int Zigzag32(unsigned int delta)
+    {
+        return (delta << 1) ^ static_cast<unsigned int>(static_cast<int>(delta) >> 31);
+    }
+
+    void AppendVByte(std::vector<unsigned char> &out, unsigned int value)
+    {
+        while (value >= 128)
+        {
+            out.push_back(static_cast<unsigned char>((value & 127) | 128));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    // 一组 16 个值的编码长度：bits 为 1/2 时 2/4 位一个值，放不下的值写全 1 后跟原值字节
+    size_t GroupSize(const unsigned char *group, int bits)
+    {
+        if (bits == 0)
+            return 0;
+        if (bits == 3)
+            return 16;
+        const unsigned int sentinel = bits == 1 ? 3 : 15;
+        size_t size = bits == 1 ? 4 : 8;
+        for (int i = 0; i < 16; ++i)
+            size += group[i] >= sentinel ? 1 : 0;
+        return size;
+    }
+
+    void AppendGroup(std::vector<unsigned char> &out, const unsigned char *group, int bits)
+    {
+        if (bits == 0)
+            return;
+        if (bits == 3)
+        {
+            out.insert(out.end(), group, group + 16);
+            return;
+        }
+        const int width = bits == 1 ? 2 : 4;
+        const unsigned int sentinel = (1u << width) - 1;
+        const int perByte = 8 / width;
+        std::vector<unsigned char> literals;
+        for (int i = 0; i < 16; i += perByte)
+        {
+            unsigned char packed = 0;
+            for (int k = 0; k < perByte; ++k)
+            {
+                const unsigned int value = group[i + k] >= sentinel ? sentinel : group[i + k];
+                if (value == sentinel)
+                    literals.push_back(group[i + k]);
+                packed = static_cast<unsigned char>(packed | (value << (8 - width * (k + 1))));
+            }
+            out.push_back(packed);
+        }
+        out.insert(out.end(), literals.begin(), literals.end());
+    }
+
+    // 顶点流：头字节 0xa0，逐块逐字节平面写 2 位的分组模式表与各组，尾部至少 32 字节，以基准顶点结束
+    std::vector<unsigned char> EncodeVertexStream(const std::vector<unsigned char> &vertices, size_t count,
+                                                  size_t vertexSize)
+    {
+        std::vector<unsigned char> out(1, 0xa0);
+        const size_t blockSize = std::min<size_t>((8192 / vertexSize) & ~size_t(15), 256);
+        std::vector<unsigned char> base(vertexSize, 0);
+        if (count > 0)
+            std::copy(vertices.begin(), vertices.begin() + vertexSize, base.begin());
+        std::vector<unsigned char> last = base;
+
+        for (size_t offset = 0; offset < count; offset += blockSize)
+        {
+            const size_t blockCount = std::min(blockSize, count - offset);
+            const size_t aligned = (blockCount + 15) & ~size_t(15);
+            for (size_t k = 0; k < vertexSize; ++k)
+            {
+                std::vector<unsigned char> deltas(aligned, 0);
+                for (size_t i = 0; i < blockCount; ++i)
+                {
+                    const unsigned char value = vertices[(offset + i) * vertexSize + k];
+                    deltas[i] = Zigzag8(static_cast<unsigned char>(value - last[k]));
+                    last[k] = value;
+                }
+
+                const size_t headerOffset = out.size();
+                out.resize(out.size() + (aligned / 16 + 3) / 4, 0);
+                for (size_t group = 0; group < aligned / 16; ++group)
+                {
+                    const unsigned char *values = &deltas[group * 16];
+                    int bits = std::all_of(values, values + 16, [](unsigned char v) { return v == 0; }) ? 0 : 3;
+                    for (int candidate = 1; bits != 0 && candidate < 3; ++candidate)
+                        if (GroupSize(values, candidate) < GroupSize(values, bits))
+                            bits = candidate;
+                    out[headerOffset + group / 4] |= static_cast<unsigned char>(bits << ((group % 4) * 2));
+                    AppendGroup(out, values, bits);
+                }
+            }
+        }
+
+        const size_t tailSize = std::max<size_t>(32, vertexSize);
+        out.resize(out.size() + tailSize - vertexSize, 0);
+        out.insert(out.end(), base.begin(), base.end());
+        return out;
+    }
+
+    // 三角形流：头字节 0xe1，每个三角形的编码字节为 0xff（三个顶点都是显式的自由索引），
+    // 数据区为 codeaux 字节 0xff 与三个相对上一自由索引的 zigzag 差分，末尾是 16 字节的 codeaux 表
+    std::vector<unsigned char> EncodeTriangleStream(const std::vector<unsigned int> &indices)
+    {
+        const size_t triangles = indices.size() / 3;
+        std::vector<unsigned char> out(1, 0xe1);
+        out.resize(1 + triangles, 0xff);
+        unsigned int last = 0;
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            out.push_back(0xff);
+            for (size_t k = 0; k < 3; ++k)
+            {
+                AppendVByte(out, Zigzag32(indices[i + k] - last));
+                last = indices[i + k];
+            }
+        }
+        out.resize(out.size() + 16, 0);
+        return out;
+    }
+
+    // 索引序列：头字节 0xd1，每个索引取差分较小的基准，最低位记录基准，4 字节尾部
+    std::vector<unsigned char> EncodeIndexSequenceStream(const std::vector<unsigned int> &indices)
+    {
+        std::vector<unsigned char> out(1, 0xd1);
+        unsigned int last[2] = {0, 0};
+        for (unsigned int index : indices)
+        {
+            const unsigned int d0 = Zigzag32(index - last[0]);
+            const unsigned int d1 = Zigzag32(index - last[1]);
+            const unsigned int current = d1 < d0 ? 1 : 0;
+            AppendVByte(out, ((current ? d1 : d0) << 1) | current);
+            last[current] = index;
+        }
+        out.resize(out.size() + 4, 0);
+        return out;
+    }
+
+    int QuantizeSnorm(float value, int bits)
+    {
+        const float scale = static_cast<float>((1 << (bits - 1)) - 1);
+        const float clamped = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+        return static_cast<int>(std::lround(clamped * scale));
+    }
+
+    template <typename T>
+    void StoreComponents(unsigned char *element, const int (&values)[4])
+    {
+        T narrow[4];
+        for (int k = 0; k < 4; ++k)
+            narrow[k] = static_cast<T>(values[k]);
+        std::memcpy(element, narrow, sizeof(narrow));
+    }
+
+    template <typename T>
+    void LoadComponents(const unsigned char *element, float (&values)[4])
+    {
+        T narrow[4];
+        std::memcpy(narrow, element, sizeof(narrow));
+        for (int k = 0; k < 4; ++k)
+            values[k] = static_cast<float>(narrow[k]);
+    }
+
+    void CheckSpecVertexBuffer(std::mt19937 &rng, const std::string &round)
+    {
+        std::uniform_int_distribution<size_t> sizes(1, 16);
+        std::uniform_int_distribution<size_t> counts(1, 3000);
+        const size_t vertexSize = sizes(rng) * 4;
+        const size_t count = counts(rng);
+        const std::string context = round + " spec ATTRIBUTES size " + std::to_string(vertexSize) + " count " +
+                                    std::to_string(count);
+
+        const std::vector<unsigned char> vertices = MakeVertices(rng, count, vertexSize);
+        const std::vector<unsigned char> encoded = EncodeVertexStream(vertices, count, vertexSize);
+        std::vector<unsigned char> decoded(vertices.size());
+        if (!GltfMeshopt::DecodeVertexBuffer(decoded.data(), count, vertexSize, encoded.data(), encoded.size()))
+            Fail(context, "decoder rejected the stream");
+        Compare(context, decoded, vertices);
+
+        // 截断的流与 version 1 的头字节都必须被拒绝
+        ++checks;
+        if (GltfMeshopt::DecodeVertexBuffer(decoded.data(), count, vertexSize, encoded.data(), encoded.size() - 1))
+            Fail(context, "truncated stream accepted");
+        std::vector<unsigned char> version1 = encoded;
+        version1[0] = 0xa1;
+        if (GltfMeshopt::DecodeVertexBuffer(decoded.data(), count, vertexSize, version1.data(), version1.size()))
+            Fail(context, "vertex codec version 1 accepted");
+    }
+
+    void CheckSpecIndexBuffer(std::mt19937 &rng, const std::string &round, size_t indexSize)
+    {
+        std::uniform_int_distribution<size_t> counts(48, 20000);
+        const std::vector<unsigned int> indices = MakeTriangles(rng, counts(rng));
+        const std::string context = round + " spec TRIANGLES " + std::to_string(indexSize * 8) + "-bit count " +
+                                    std::to_string(indices.size());
+
+        const std::vector<unsigned char> encoded = EncodeTriangleStream(indices);
+        std::vector<unsigned char> decoded(indices.size() * indexSize);
+        if (!GltfMeshopt::DecodeIndexBuffer(decoded.data(), indices.size(), indexSize, encoded.data(), encoded.size()))
+            Fail(context, "decoder rejected the stream");
+        Compare(context, decoded, Narrow(indices, indexSize));
+
+        ++checks;
+        if (GltfMeshopt::DecodeIndexBuffer(decoded.data(), indices.size() - 3, indexSize, encoded.data(), encoded.size()))
+            Fail(context, "stream accepted with a smaller triangle count");
+    }
+
+    void CheckSpecIndexSequence(std::mt19937 &rng, const std::string &round, size_t indexSize)
+    {
+        std::uniform_int_distribution<size_t> counts(1, 20000);
+        const std::vector<unsigned int> indices = MakeSequence(rng, counts(rng), indexSize);
+        const std::string context = round + " spec INDICES " + std::to_string(indexSize * 8) + "-bit count " +
+                                    std::to_string(indices.size());
+
+        const std::vector<unsigned char> encoded = EncodeIndexSequenceStream(indices);
+        std::vector<unsigned char> decoded(indices.size() * indexSize);
+        if (!GltfMeshopt::DecodeIndexSequence(decoded.data(), indices.size(), indexSize, encoded.data(), encoded.size()))
+            Fail(context, "decoder rejected the stream");
+        Compare(context, decoded, Narrow(indices, indexSize));
+    }
+
+    // 八面体：x、y 为 L1 归一化后折叠到上半球的坐标，z 存放 1.0 的量化值，第 4 个分量原样保留
+    void CheckSpecOctahedral(std::mt19937 &rng, const std::string &round, size_t stride, int bits)
+    {
+        const std::string context = round + " spec OCTAHEDRAL stride " + std::to_string(stride) + " bits " +
+                                    std::to_string(bits);
+        const size_t count = 1000;
+        const std::vector<float> vectors = MakeUnitVectors(rng, count);
+        const int componentBits = stride == 4 ? 8 : 16;
+
+        std::vector<unsigned char> data(count * stride);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float *v = &vectors[i * 4];
+            const float l1 = std::fabs(v[0]) + std::fabs(v[1]) + std::fabs(v[2]);
+            float u = v[0] / l1;
+            float w = v[1] / l1;
+            if (v[2] < 0.0f)
+            {
+                const float fu = (1.0f - std::fabs(w)) * (u >= 0.0f ? 1.0f : -1.0f);
+                const float fw = (1.0f - std::fabs(u)) * (w >= 0.0f ? 1.0f : -1.0f);
+                u = fu;
+                w = fw;
+            }
+            const int components[4] = {QuantizeSnorm(u, bits), QuantizeSnorm(w, bits), (1 << (bits - 1)) - 1,
+                                       QuantizeSnorm(v[3], componentBits)};
+            if (stride == 4)
+                StoreComponents<int8_t>(&data[i * stride], components);
+            else
+                StoreComponents<int16_t>(&data[i * stride], components);
+        }
+        const std::vector<unsigned char> encoded = data;
+
+        ++checks;
+        if (!GltfMeshopt::DecodeFilterOctahedral(data.data(), count, stride))
+        {
+            Fail(context, "decoder rejected the stride");
+            return;
+        }
+
+        const float scale = static_cast<float>((1 << (componentBits - 1)) - 1);
+        const float tolerance = 2.5f / static_cast<float>((1 << (bits - 1)) - 1) + 1.0f / scale;
+        for (size_t i = 0; i < count; ++i)
+        {
+            float decoded[4], original[4];
+            if (stride == 4)
+            {
+                LoadComponents<int8_t>(&data[i * stride], decoded);
+                LoadComponents<int8_t>(&encoded[i * stride], original);
+            }
+            else
+            {
+                LoadComponents<int16_t>(&data[i * stride], decoded);
+                LoadComponents<int16_t>(&encoded[i * stride], original);
+            }
+            const float *v = &vectors[i * 4];
+            for (int k = 0; k < 3; ++k)
+            {
+                if (std::fabs(decoded[k] / scale - v[k]) > tolerance)
+                {
+                    Fail(context, "element " + std::to_string(i) + " component " + std::to_string(k) + " decoded as " +
+                                      std::to_string(decoded[k] / scale) + ", expected " + std::to_string(v[k]));
+                    return;
+                }
+            }
+            if (decoded[3] != original[3])
+            {
+                Fail(context, "element " + std::to_string(i) + " changed the 4th component");
+                return;
+            }
+        }
+    }
+
+    // 四元数：省略绝对值最大的分量（解码时由单位长度恢复为非负值），其余三个乘 √2 后量化，
+    // 第 4 个分量的高位为量化比例，低 2 位为省略分量的位置
+    void CheckSpecQuaternion(std::mt19937 &rng, const std::string &round, int bits)
+    {
+        const std::string context = round + " spec QUATERNION bits " + std::to_string(bits);
+        const size_t count = 1000;
+        const std::vector<float> quaternions = MakeQuaternions(rng, count);
+        const int scale = (1 << (bits - 1)) - 1;
+
+        std::vector<unsigned char> data(count * 8);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float *q = &quaternions[i * 4];
+            int qc = 0;
+            for (int k = 1; k < 4; ++k)
+                if (std::fabs(q[k]) > std::fabs(q[qc]))
+                    qc = k;
+            const float sign = q[qc] < 0.0f ? -1.0f : 1.0f;
+
+            int components[4];
+            for (int k = 0; k < 3; ++k)
+                components[k] = static_cast<int>(std::lround(q[(qc + 1 + k) & 3] * sign * std::sqrt(2.0f) * scale));
+            components[3] = (scale & ~3) | qc;
+            StoreComponents<int16_t>(&data[i * 8], components);
+        }
+
+        ++checks;
+        if (!GltfMeshopt::DecodeFilterQuaternion(data.data(), count, 8))
+        {
+            Fail(context, "decoder rejected the stride");
+            return;
+        }
+
+        const float tolerance = 3.0f / static_cast<float>(scale) + 1.0f / 32767.0f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            float decoded[4];
+            LoadComponents<int16_t>(&data[i * 8], decoded);
+            const float *q = &quaternions[i * 4];
+            int qc = 0;
+            for (int k = 1; k < 4; ++k)
+                if (std::fabs(q[k]) > std::fabs(q[qc]))
+                    qc = k;
+            const float sign = q[qc] < 0.0f ? -1.0f : 1.0f;
+            for (int k = 0; k < 4; ++k)
+            {
+                if (std::fabs(decoded[k] / 32767.0f - q[k] * sign) > tolerance)
+                {
+                    Fail(context, "element " + std::to_string(i) + " component " + std::to_string(k) + " decoded as " +
+                                      std::to_string(decoded[k] / 32767.0f) + ", expected " +
+                                      std::to_string(q[k] * sign));
+                    return;
+                }
+            }
+        }
+    }
+
+    // 指数：高 8 位为有符号指数，低 24 位为有符号尾数，解码值必须与 ldexp 逐位一致
+    void CheckSpecExponential(std::mt19937 &rng, const std::string &round)
+    {
+        const std::string context = round + " spec EXPONENTIAL";
+        const size_t count = 1000;
+        const size_t stride = 12;
+        std::uniform_int_distribution<int> mantissas(-(1 << 23) + 1, (1 << 23) - 1);
+        std::uniform_int_distribution<int> exponents(-100, 100);
+
+        std::vector<unsigned char> data(count * stride);
+        std::vector<float> expected(count * 3);
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            const int mantissa = (i % 31 == 0) ? 0 : mantissas(rng);
+            const int exponent = exponents(rng);
+            const uint32_t packed = (static_cast<uint32_t>(exponent) << 24) | (static_cast<uint32_t>(mantissa) & 0xffffff);
+            std::memcpy(&data[i * 4], &packed, 4);
+            expected[i] = static_cast<float>(std::ldexp(static_cast<double>(mantissa), exponent));
+        }
+
+        if (!GltfMeshopt::DecodeFilterExponential(data.data(), count, stride))
+        {
+            Fail(context, "decoder rejected the stride");
+            return;
+        }
+        std::vector<unsigned char> reference(expected.size() * 4);
+        std::memcpy(reference.data(), expected.data(), reference.size());
+        Compare(context, data, reference);
+    }
+
+#ifdef GLTFMESHOPT_REFERENCE
+    // ---- 与 meshoptimizer 参考实现逐字节比较 ----
+
+    void CheckVertexBuffer(std::mt19937 &rng, const std::string &round)
+    {
+        std::uniform_int_distribution<size_t> sizes(1, 16);
+        std::uniform_int_distribution<size_t> counts(1, 3000);
+        const size_t vertexSize = sizes(rng) * 4;
+        const size_t count = counts(rng);
+        const std::string context = round + " ATTRIBUTES size " + std::to_string(vertexSize) + " count " +
+                                    std::to_string(count);
+
+        const std::vector<unsigned char> vertices = MakeVertices(rng, count, vertexSize);
+        std::vector<unsigned char> encoded(meshopt_encodeVertexBufferBound(count, vertexSize));
+        encoded.resize(meshopt_encodeVertexBuffer(encoded.data(), encoded.size(), vertices.data(), count, vertexSize));
+
+        std::vector<unsigned char> builtin(vertices.size());
+        std::vector<unsigned char> reference(vertices.size());
+        if (!GltfMeshopt::DecodeVertexBuffer(builtin.data(), count, vertexSize, encoded.data(), encoded.size()))
+            Fail(context, "built-in decoder rejected the stream");
+        if (meshopt_decodeVertexBuffer(reference.data(), count, vertexSize, encoded.data(), encoded.size()) != 0)
+            Fail(context, "meshoptimizer rejected the stream");
+        Compare(context, builtin, reference);
+        if (reference != vertices)
+            Fail(context, "meshoptimizer round trip is not lossless");
+    }
+
+    void CheckIndexBuffer(std::mt19937 &rng, const std::string &round, int version, size_t indexSize)
+    {
+        std::uniform_int_distribution<size_t> counts(48, indexSize == 2 ? 60000 : 200000);
+        const size_t vertexCount = counts(rng);
+        const std::vector<unsigned int> indices = MakeTriangles(rng, vertexCount);
+        const std::string context = round + " TRIANGLES v" + std::to_string(version) + " " +
+                                    std::to_string(indexSize * 8) + "-bit count " + std::to_string(indices.size());
+
+        meshopt_encodeIndexVersion(version);
+        std::vector<unsigned char> encoded(meshopt_encodeIndexBufferBound(indices.size(), vertexCount));
+        encoded.resize(meshopt_encodeIndexBuffer(encoded.data(), encoded.size(), indices.data(), indices.size()));
+
+        std::vector<unsigned char> builtin(indices.size() * indexSize);
+        std::vector<unsigned char> reference(indices.size() * indexSize);
+        if (!GltfMeshopt::DecodeIndexBuffer(builtin.data(), indices.size(), indexSize, encoded.data(), encoded.size()))
+            Fail(context, "built-in decoder rejected the stream");
+        if (meshopt_decodeIndexBuffer(reference.data(), indices.size(), indexSize, encoded.data(), encoded.size()) != 0)
+            Fail(context, "meshoptimizer rejected the stream");
+        Compare(context, builtin, reference);
+    }
+
+    void CheckIndexSequence(std::mt19937 &rng, const std::string &round, size_t indexSize)
+    {
+        std::uniform_int_distribution<size_t> counts(1, 20000);
+        const std::vector<unsigned int> indices = MakeSequence(rng, counts(rng), indexSize);
+        const size_t count = indices.size();
+        const std::string context = round + " INDICES " + std::to_string(indexSize * 8) + "-bit count " +
+                                    std::to_string(count);
+
+        std::vector<unsigned char> encoded(meshopt_encodeIndexSequenceBound(count, indexSize == 2 ? 65536 : ~0u));
+        encoded.resize(meshopt_encodeIndexSequence(encoded.data(), encoded.size(), indices.data(), count));
+
+        std::vector<unsigned char> builtin(count * indexSize);
+        std::vector<unsigned char> reference(count * indexSize);
+        if (!GltfMeshopt::DecodeIndexSequence(builtin.data(), count, indexSize, encoded.data(), encoded.size()))
+            Fail(context, "built-in decoder rejected the stream");
+        if (meshopt_decodeIndexSequence(reference.data(), count, indexSize, encoded.data(), encoded.size()) != 0)
+            Fail(context, "meshoptimizer rejected the stream");
+        Compare(context, builtin, reference);
+        if (reference != Narrow(indices, indexSize))
+            Fail(context, "meshoptimizer round trip is not lossless");
+    }
+
+    // 过滤器编码的数据用两种解码器原地解码后比较
+    template <typename DecodeBuiltin, typename DecodeReference>
+    void CompareFilter(const std::string &context, const std::vector<unsigned char> &encoded, size_t count,
+                       size_t stride, DecodeBuiltin builtinDecode, DecodeReference referenceDecode)
+    {
+        std::vector<unsigned char> builtin = encoded;
+        std::vector<unsigned char> reference = encoded;
+        if (!builtinDecode(builtin.data(), count, stride))
+            Fail(context, "built-in decoder rejected the stride");
+        referenceDecode(reference.data(), count, stride);
+        Compare(context, builtin, reference);
+    }
+
+    void CheckFilters(std::mt19937 &rng, const std::string &round)
+    {
+        std::uniform_int_distribution<size_t> counts(1, 5000);
+        const size_t count = counts(rng);
+
+        const std::vector<float> vectors = MakeUnitVectors(rng, count);
+        for (size_t stride : {size_t(4), size_t(8)})
+        {
+            for (int bits : {4, 8, 12, 16})
+            {
+                if (bits > static_cast<int>(stride) * 2)
+                    continue;
+                std::vector<unsigned char> encoded(count * stride);
+                meshopt_encodeFilterOct(encoded.data(), count, stride, bits, vectors.data());
+                CompareFilter(round + " OCTAHEDRAL stride " + std::to_string(stride) + " bits " + std::to_string(bits),
+                              encoded, count, stride, GltfMeshopt::DecodeFilterOctahedral,
+                              [](void *data, size_t n, size_t s) { meshopt_decodeFilterOct(data, n, s); });
+            }
+        }
+
+        const std::vector<float> quaternions = MakeQuaternions(rng, count);
+        for (int bits : {4, 9, 12, 16})
+        {
+            std::vector<unsigned char> encoded(count * 8);
+            meshopt_encodeFilterQuat(encoded.data(), count, 8, bits, quaternions.data());
+            CompareFilter(round + " QUATERNION bits " + std::to_string(bits), encoded, count, 8,
+                          GltfMeshopt::DecodeFilterQuaternion,
+                          [](void *data, size_t n, size_t s) { meshopt_decodeFilterQuat(data, n, s); });
+        }
+
+        // 位置、缩放等任意浮点：包含 0、负数与跨多个数量级的值
+        std::uniform_real_distribution<float> mantissa(-1.0f, 1.0f);
+        std::uniform_int_distribution<int> exponent(-20, 20);
+        std::vector<float> values(count * 3);
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = (i % 31 == 0) ? 0.0f : std::ldexp(mantissa(rng), exponent(rng));
+        for (int bits : {8, 15, 24})
+        {
+            for (meshopt_EncodeExpMode mode : {meshopt_EncodeExpSeparate, meshopt_EncodeExpSharedVector,
+                                               meshopt_EncodeExpSharedComponent})
+            {
+                std::vector<unsigned char> encoded(count * 12);
+                meshopt_encodeFilterExp(encoded.data(), count, 12, bits, values.data(), mode);
+                CompareFilter(round + " EXPONENTIAL bits " + std::to_string(bits) + " mode " +
+                                  std::to_string(static_cast<int>(mode)),
+                              encoded, count, 12, GltfMeshopt::DecodeFilterExponential,
+                              [](void *data, size_t n, size_t s) { meshopt_decodeFilterExp(data, n, s); });
+            }
+        }
+    }
+#endif
+
+    // ---- gltfpack 样例 ----
+
+    const char *const SourceName = "meshopt_source.gltf";
+    const char *const SourceBinName = "meshopt_source.bin";
+    const int GridSize = 24;
+
+    // 24x24 的起伏网格：坐标都是 1/64 的整数倍，经整数平移后仍可精确表示
+    std::vector<float> GridPositions()
+    {
+        std::vector<float> positions;
+        for (int y = 0; y < GridSize; ++y)
+        {
+            for (int x = 0; x < GridSize; ++x)
+            {
+                positions.push_back(static_cast<float>(x) * 0.25f);
+                positions.push_back(static_cast<float>(y) * 0.25f);
+                positions.push_back(static_cast<float>((x * 7 + y * 3) % 16) / 64.0f);
+            }
+        }
+        return positions;
+    }
+
+    std::vector<uint16_t> GridIndices()
+    {
+        std::vector<uint16_t> indices;
+        for (int y = 0; y + 1 < GridSize; ++y)
+        {
+            for (int x = 0; x + 1 < GridSize; ++x)
+            {
+                const uint16_t a = static_cast<uint16_t>(y * GridSize + x);
+                const uint16_t b = static_cast<uint16_t>(a + 1);
+                const uint16_t c = static_cast<uint16_t>(a + GridSize);
+                const uint16_t d = static_cast<uint16_t>(c + 1);
+                indices.insert(indices.end(), {a, b, c, b, d, c});
+            }
+        }
+        return indices;
+    }
+
+    // 一个网格被两个节点引用，第二个节点平移到 x = 10
+    void WriteSource(const std::filesystem::path &dir)
+    {
+        const std::vector<float> positions = GridPositions();
+        const std::vector<uint16_t> indices = GridIndices();
+        const size_t positionBytes = positions.size() * sizeof(float);
+        const size_t indexBytes = indices.size() * sizeof(uint16_t);
+        const float extent = static_cast<float>(GridSize - 1) * 0.25f;
+
+        std::ofstream bin(dir / SourceBinName, std::ios::binary);
+        bin.write(reinterpret_cast<const char *>(positions.data()), static_cast<std::streamsize>(positionBytes));
+        bin.write(reinterpret_cast<const char *>(indices.data()), static_cast<std::streamsize>(indexBytes));
+        bin.close();
+
+        std::ostringstream json;
+        json << "{\n  \"asset\": {\"version\": \"2.0\"},\n"
+             << "  \"buffers\": [{\"uri\": \"" << SourceBinName << "\", \"byteLength\": " << positionBytes + indexBytes
+             << "}],\n"
+             << "  \"bufferViews\": [\n"
+             << "    {\"buffer\": 0, \"byteOffset\": 0, \"byteLength\": " << positionBytes << ", \"target\": 34962},\n"
+             << "    {\"buffer\": 0, \"byteOffset\": " << positionBytes << ", \"byteLength\": " << indexBytes
+             << ", \"target\": 34963}\n"
+             << "  ],\n"
+             << "  \"accessors\": [\n"
+             << "    {\"bufferView\": 0, \"componentType\": 5126, \"count\": " << positions.size() / 3
+             << ", \"type\": \"VEC3\", \"min\": [0, 0, 0], \"max\": [" << extent << ", " << extent << ", 0.234375]},\n"
+             << "    {\"bufferView\": 1, \"componentType\": 5123, \"count\": " << indices.size()
+             << ", \"type\": \"SCALAR\"}\n"
+             << "  ],\n"
+             << "  \"meshes\": [{\"name\": \"Grid\", \"primitives\": [{\"attributes\": {\"POSITION\": 0}, \"indices\": 1}]}],\n"
+             << "  \"nodes\": [\n"
+             << "    {\"name\": \"Grid_0\", \"mesh\": 0},\n"
+             << "    {\"name\": \"Grid_1\", \"mesh\": 0, \"translation\": [10, 0, 0]}\n"
+             << "  ],\n"
+             << "  \"scenes\": [{\"nodes\": [0, 1]}],\n  \"scene\": 0\n}\n";
+        std::ofstream(dir / SourceName) << json.str();
+    }
+
+    // 世界坐标的三角形，坐标按 1/1024 取整；旋转到最小顶点在前（保持绕向），便于排序比较
+    using Point = std::array<long long, 3>;
+    using Triangle = std::array<Point, 3>;
+
+    class TriangleCollector : public osg::NodeVisitor
+    {
+    public:
+        TriangleCollector() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+        void apply(osg::Geode &geode) override
+        {
+            const osg::Matrix world = osg::computeLocalToWorld(getNodePath());
+            for (unsigned int i = 0; i < geode.getNumDrawables(); ++i)
+            {
+                const osg::Geometry *geometry = geode.getDrawable(i)->asGeometry();
+                const osg::Vec3Array *vertices =
+                    geometry ? dynamic_cast<const osg::Vec3Array *>(geometry->getVertexArray()) : nullptr;
+                if (!vertices)
+                    continue;
+
+                osg::TriangleIndexFunctor<IndexCollector> functor;
+                functor.indices = &indices_;
+                indices_.clear();
+                geometry->accept(functor);
+                for (size_t t = 0; t + 2 < indices_.size(); t += 3)
+                {
+                    Triangle triangle;
+                    for (int k = 0; k < 3; ++k)
+                        triangle[k] = Snap((*vertices)[indices_[t + k]] * world);
+                    const int first = static_cast<int>(std::min_element(triangle.begin(), triangle.end()) - triangle.begin());
+                    std::rotate(triangle.begin(), triangle.begin() + first, triangle.end());
+                    triangles.push_back(triangle);
+                }
+            }
+        }
+
+        std::vector<Triangle> triangles;
+
+    private:
+        struct IndexCollector
+        {
+            std::vector<unsigned int> *indices = nullptr;
+
+            void operator()(unsigned int a, unsigned int b, unsigned int c)
+            {
+                indices->push_back(a);
+                indices->push_back(b);
+                indices->push_back(c);
+            }
+        };
+
+        static Point Snap(const osg::Vec3 &v)
+        {
+            return {std::llround(v.x() * 1024.0), std::llround(v.y() * 1024.0), std::llround(v.z() * 1024.0)};
+        }
+
+        std::vector<unsigned int> indices_;
+    };
+
+    bool LoadTriangles(const std::string &path, std::vector<Triangle> &triangles)
+    {
+        osg::ref_ptr<osg::Group> root;
+        try
+        {
+            root = GltfParser::parseFile(path);
+        }
+        catch (const std::exception &e)
+        {
+            Fail(path, e.what());
+            return false;
+        }
+        if (!root.valid())
+        {
+            Fail(path, "GltfParser could not load the file");
+            return false;
+        }
+
+        TriangleCollector collector;
+        root->accept(collector);
+        triangles = std::move(collector.triangles);
+        std::sort(triangles.begin(), triangles.end());
+        return true;
+    }
+
+    int RunFixture(const std::filesystem::path &compressed, const std::filesystem::path &workDir)
+    {
+        if (!std::filesystem::exists(compressed))
+        {
+            std::cout << "SKIP " << compressed.string()
+                      << " not found; run tools/gltfmeshopt/make_fixture.sh with gltfpack to create it\n";
+            return SkipReturnCode;
+        }
+
+        // 样例必须确实使用了压缩，否则比较的只是未压缩的读取路径
+        std::ifstream file(compressed, std::ios::binary);
+        const std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (bytes.find(GltfMeshopt::ExtensionName) == std::string::npos)
+        {
+            Fail(compressed.string(), std::string("does not use ") + GltfMeshopt::ExtensionName);
+            return 1;
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(workDir, ec);
+        WriteSource(workDir);
+
+        std::vector<Triangle> expected, decoded;
+        if (!LoadTriangles((workDir / SourceName).string(), expected) || !LoadTriangles(compressed.string(), decoded))
+            return 1;
+
+        const std::string context = compressed.filename().string();
+        if (expected.size() != 2 * GridIndices().size() / 3)
+            Fail(context, "source has " + std::to_string(expected.size()) + " triangles");
+        if (decoded.size() != expected.size())
+            Fail(context, std::to_string(decoded.size()) + " triangles, expected " + std::to_string(expected.size()));
+        else
+        {
+            const auto mismatch = std::mismatch(decoded.begin(), decoded.end(), expected.begin());
+            if (mismatch.first != decoded.end())
+                Fail(context, "triangle " + std::to_string(mismatch.first - decoded.begin()) +
+                                  " (sorted) differs from the uncompressed source");
+        }
+
+        std::cout << context << ": " << decoded.size() << " triangles, "
+                  << (failures == 0 ? "positions and indices match the source" : std::to_string(failures) + " failures")
+                  << "\n";
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const std::string command = argc > 1 ? argv[1] : "";
+    if (command == "source")
+    {
+        const std::filesystem::path dir = argc > 2 ? std::filesystem::path(argv[2]) : std::filesystem::current_path();
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        WriteSource(dir);
+        std::cout << (dir / SourceName).string() << "\n";
+        return 0;
+    }
+    if (command == "fixture")
+    {
+        if (argc < 3)
+        {
+            std::cerr << "usage: gltfmeshopt fixture <compressed.glb> [workdir]\n";
+            return 1;
+        }
+        const std::filesystem::path workDir =
+            argc > 3 ? std::filesystem::path(argv[3]) : std::filesystem::temp_directory_path() / "gltfmeshopt";
+        return RunFixture(argv[2], workDir);
+    }
+
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 20;
+
+#ifdef GLTFMESHOPT_REFERENCE
+    // EXT_meshopt_compression 只允许顶点编码 version 0；较新的 meshoptimizer 默认可能编码为 version 1
+    meshopt_encodeVertexVersion(0);
+#endif
+
+    std::mt19937 rng(12345);
+    for (int i = 0; i < rounds; ++i)
+    {
+        const std::string round = "round " + std::to_string(i);
+        CheckSpecVertexBuffer(rng, round);
+        CheckSpecIndexBuffer(rng, round, 2);
+        CheckSpecIndexBuffer(rng, round, 4);
+        CheckSpecIndexSequence(rng, round, 2);
+        CheckSpecIndexSequence(rng, round, 4);
+        CheckSpecOctahedral(rng, round, 4, 8);
+        CheckSpecOctahedral(rng, round, 8, 12);
+        CheckSpecOctahedral(rng, round, 8, 16);
+        CheckSpecQuaternion(rng, round, 9);
+        CheckSpecQuaternion(rng, round, 16);
+        CheckSpecExponential(rng, round);
+
+#ifdef GLTFMESHOPT_REFERENCE
+        CheckVertexBuffer(rng, round);
+        for (int version : {0, 1})
+        {
+            CheckIndexBuffer(rng, round, version, 2);
+            CheckIndexBuffer(rng, round, version, 4);
+        }
+        CheckIndexSequence(rng, round, 2);
+        CheckIndexSequence(rng, round, 4);
+        CheckFilters(rng, round);
+#endif
+    }
+
+#ifdef GLTFMESHOPT_REFERENCE
+    std::cout << checks << " streams checked against the specification and meshoptimizer, ";
+#else
+    std::cout << checks << " streams checked against the specification (meshoptimizer not available), ";
+#endif
+    std::cout << failures << " failure(s)\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+#!/bin/sh
+# 重新生成 gltf_meshopt_fixture 的样例 data/meshopt_cc.glb
+#
+# 用法：make_fixture.sh <gltfmeshopt 可执行文件> [gltfpack 可执行文件]
+# gltfmeshopt 写出固定的未压缩源，gltfpack 以 -cc 压缩（-noq 保持 float 位置，三角形可与源逐个比较）。
+# 生成后请提交 data/meshopt_cc.glb；换用其他 gltfpack 版本重新生成时结果应仍能通过检查
+
+set -e
+
+TOOL=${1:?usage: make_fixture.sh <gltfmeshopt> [gltfpack]}
+GLTFPACK=${2:-gltfpack}
+DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+mkdir -p "$DIR/data"
+"$TOOL" source "$WORK"
+"$GLTFPACK" -i "$WORK/meshopt_source.gltf" -o "$DIR/data/meshopt_cc.glb" -cc -noq
+"$TOOL" fixture "$DIR/data/meshopt_cc.glb" "$WORK/check"
@@ -0,0 +1,218 @@
+// gltfsharedmesh：GLTF 网格缓存的共享检查（ctest 目标 gltf_shared_mesh）
+//
+// 用法：gltfsharedmesh [workdir] [nodes]
+// 写出一个 .gltf（外部 .bin）：单图元网格 Beam 被 nodes 个节点引用，六个图元的网格 Panel（走分批路径）
+// 被两个节点引用，其中一个是另一节点的子节点。由 GltfParser 读回后检查：
+// - 每个引用节点有自己的 Geode，Geode 只有一个父节点（高亮与拾取只作用于该节点）；
+// - 引用同一网格的全部 Geode 共用同一批 osg::Geometry，材质共用同一个 StateSet。
+// 有任何不满足时逐条打印并返回非零
+// 省略 workdir 时使用系统临时目录
+
+#include "GltfParser.h"
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/NodeVisitor>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const size_t PanelPrimitives = 6;
+    const size_t PanelReferences = 2;
+
+    int failures = 0;
+
+    void Fail(const std::string &message)
+    {
+        std::cerr << "FAIL " << message << "\n";
+        ++failures;
+    }
+
+    // 缓冲区布局：三角形 3 个顶点、四边形 4 个顶点、四边形与三角形的 ushort 索引
+    struct BufferLayout
+    {
+        static const size_t TrianglePositions = 0;
+        static const size_t QuadPositions = TrianglePositions + 3 * 12;
+        static const size_t QuadIndices = QuadPositions + 4 * 12;
+        static const size_t TriangleIndices = QuadIndices + 6 * 2;
+        static const size_t Size = TriangleIndices + 8; // 3 个索引补齐到 4 字节
+    };
+
+    std::vector<unsigned char> CreateBuffer()
+    {
+        std::vector<unsigned char> buffer(BufferLayout::Size, 0);
+        const float triangle[9] = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+        const float quad[12] = {0, 0, 0, 2, 0, 0, 2, 1, 0, 0, 1, 0};
+        const uint16_t quadIndices[6] = {0, 1, 2, 0, 2, 3};
+        const uint16_t triangleIndices[3] = {0, 1, 2};
+        std::memcpy(&buffer[BufferLayout::TrianglePositions], triangle, sizeof(triangle));
+        std::memcpy(&buffer[BufferLayout::QuadPositions], quad, sizeof(quad));
+        std::memcpy(&buffer[BufferLayout::QuadIndices], quadIndices, sizeof(quadIndices));
+        std::memcpy(&buffer[BufferLayout::TriangleIndices], triangleIndices, sizeof(triangleIndices));
+        return buffer;
+    }
+
+    // 网格 0 为 Beam（三角形，材质 0），网格 1 为 Panel（四边形 x6，材质 1）；
+    // 节点 0..beamNodes-1 引用 Beam，随后一个 Panel 节点带一个同样引用 Panel 的子节点
+    std::string CreateJson(const std::string &binName, size_t beamNodes)
+    {
+        std::ostringstream json;
+        json << "{\n  \"asset\": {\"version\": \"2.0\"},\n";
+        json << "  \"buffers\": [{\"uri\": \"" << binName << "\", \"byteLength\": " << BufferLayout::Size << "}],\n";
+        json << "  \"bufferViews\": [\n"
+             << "    {\"buffer\": 0, \"byteOffset\": " << BufferLayout::TrianglePositions << ", \"byteLength\": 36, \"target\": 34962},\n"
+             << "    {\"buffer\": 0, \"byteOffset\": " << BufferLayout::QuadPositions << ", \"byteLength\": 48, \"target\": 34962},\n"
+             << "    {\"buffer\": 0, \"byteOffset\": " << BufferLayout::QuadIndices << ", \"byteLength\": 12, \"target\": 34963},\n"
+             << "    {\"buffer\": 0, \"byteOffset\": " << BufferLayout::TriangleIndices << ", \"byteLength\": 6, \"target\": 34963}\n"
+             << "  ],\n";
+        json << "  \"accessors\": [\n"
+             << "    {\"bufferView\": 0, \"componentType\": 5126, \"count\": 3, \"type\": \"VEC3\", \"min\": [0, 0, 0], \"max\": [1, 1, 0]},\n"
+             << "    {\"bufferView\": 1, \"componentType\": 5126, \"count\": 4, \"type\": \"VEC3\", \"min\": [0, 0, 0], \"max\": [2, 1, 0]},\n"
+             << "    {\"bufferView\": 2, \"componentType\": 5123, \"count\": 6, \"type\": \"SCALAR\"},\n"
+             << "    {\"bufferView\": 3, \"componentType\": 5123, \"count\": 3, \"type\": \"SCALAR\"}\n"
+             << "  ],\n";
+        json << "  \"materials\": [\n"
+             << "    {\"name\": \"Steel\", \"pbrMetallicRoughness\": {\"baseColorFactor\": [0.6, 0.6, 0.7, 1.0]}},\n"
+             << "    {\"name\": \"Glass\", \"pbrMetallicRoughness\": {\"baseColorFactor\": [0.2, 0.5, 0.8, 1.0]}}\n"
+             << "  ],\n";
+        json << "  \"meshes\": [\n"
+             << "    {\"name\": \"Beam\", \"primitives\": [{\"attributes\": {\"POSITION\": 0}, \"indices\": 3, \"material\": 0}]},\n"
+             << "    {\"name\": \"Panel\", \"primitives\": [";
+        for (size_t i = 0; i < PanelPrimitives; ++i)
+            json << (i ? ", " : "") << "{\"attributes\": {\"POSITION\": 1}, \"indices\": 2, \"material\": 1}";
+        json << "]}\n  ],\n";
+
+        const size_t panelNode = beamNodes;
+        json << "  \"nodes\": [\n";
+        for (size_t i = 0; i < beamNodes; ++i)
+            json << "    {\"name\": \"Beam_" << i << "\", \"mesh\": 0, \"translation\": [" << i * 3 << ", 0, 0]},\n";
+        json << "    {\"name\": \"Panel_0\", \"mesh\": 1, \"translation\": [0, 5, 0], \"children\": [" << panelNode + 1 << "]},\n"
+             << "    {\"name\": \"Panel_1\", \"mesh\": 1, \"translation\": [0, 0, 2]}\n"
+             << "  ],\n";
+        json << "  \"scenes\": [{\"nodes\": [";
+        for (size_t i = 0; i <= panelNode; ++i)
+            json << (i ? ", " : "") << i;
+        json << "]}],\n  \"scene\": 0\n}\n";
+        return json.str();
+    }
+
+    class GeodeCollector : public osg::NodeVisitor
+    {
+    public:
+        GeodeCollector() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+        void apply(osg::Geode &geode) override
+        {
+            geodes.push_back(&geode);
+            traverse(geode);
+        }
+
+        std::vector<osg::Geode *> geodes;
+    };
+
+    // 引用同一网格的 Geode：数量、各自独立、几何与状态集共用
+    void CheckMesh(const std::string &meshName, const std::vector<osg::Geode *> &geodes, size_t references,
+                   size_t primitives)
+    {
+        if (geodes.size() != references * primitives)
+        {
+            Fail(meshName + ": " + std::to_string(geodes.size()) + " geodes, expected " +
+                 std::to_string(references * primitives));
+            return;
+        }
+
+        std::map<const osg::Geometry *, size_t> users;
+        std::set<const osg::StateSet *> stateSets;
+        for (osg::Geode *geode : geodes)
+        {
+            if (geode->getNumParents() != 1)
+                Fail(meshName + ": geode has " + std::to_string(geode->getNumParents()) + " parents");
+            if (geode->getNumDrawables() != 1 || !geode->getDrawable(0)->asGeometry())
+            {
+                Fail(meshName + ": geode does not hold exactly one geometry");
+                continue;
+            }
+            ++users[geode->getDrawable(0)->asGeometry()];
+            stateSets.insert(geode->getStateSet());
+        }
+
+        if (users.size() != primitives)
+            Fail(meshName + ": " + std::to_string(users.size()) + " distinct geometries, expected " +
+                 std::to_string(primitives));
+        for (const auto &[geometry, count] : users)
+        {
+            if (count != references)
+                Fail(meshName + ": geometry used by " + std::to_string(count) + " geodes, expected " +
+                     std::to_string(references));
+            if (geometry->getNumParents() != references)
+                Fail(meshName + ": geometry has " + std::to_string(geometry->getNumParents()) + " parents, expected " +
+                     std::to_string(references));
+        }
+        if (stateSets.size() != 1 || *stateSets.begin() == nullptr)
+            Fail(meshName + ": " + std::to_string(stateSets.size()) + " state sets, expected one shared material");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::filesystem::path workDir = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::temp_directory_path();
+    const size_t beamNodes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16;
+    std::error_code ec;
+    std::filesystem::create_directories(workDir, ec);
+    const std::string gltfPath = (workDir / "sharedmesh.gltf").string();
+    const std::string binName = "sharedmesh.bin";
+
+    const std::vector<unsigned char> buffer = CreateBuffer();
+    std::ofstream bin(workDir / binName, std::ios::binary);
+    bin.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    bin.close();
+    std::ofstream(gltfPath) << CreateJson(binName, beamNodes);
+
+    osg::ref_ptr<osg::Group> root;
+    try
+    {
+        root = GltfParser::parseFile(gltfPath);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "FAIL " << gltfPath << ": " << e.what() << "\n";
+        return 1;
+    }
+    if (!root.valid())
+    {
+        std::cerr << "FAIL GltfParser could not load " << gltfPath << "\n";
+        return 1;
+    }
+
+    // 按顶点数区分两个网格的 Geode（Beam 为三角形，Panel 为四边形）
+    GeodeCollector collector;
+    root->accept(collector);
+    std::vector<osg::Geode *> beamGeodes, panelGeodes;
+    for (osg::Geode *geode : collector.geodes)
+    {
+        const osg::Geometry *geometry = geode->getNumDrawables() ? geode->getDrawable(0)->asGeometry() : nullptr;
+        const unsigned int vertices = geometry && geometry->getVertexArray() ? geometry->getVertexArray()->getNumElements() : 0;
+        if (vertices == 3)
+            beamGeodes.push_back(geode);
+        else if (vertices == 4)
+            panelGeodes.push_back(geode);
+        else
+            Fail("geode " + geode->getName() + " with " + std::to_string(vertices) + " vertices");
+    }
+    CheckMesh("Beam", beamGeodes, beamNodes, 1);
+    CheckMesh("Panel", panelGeodes, PanelReferences, PanelPrimitives);
+
+    std::cout << beamNodes << " nodes sharing Beam, " << PanelReferences << " sharing Panel: " << collector.geodes.size()
+              << " geodes, " << (failures == 0 ? "geometries and state sets shared" : std::to_string(failures) + " failures")
+              << "\n";
+    return failures == 0 ? 0 : 1;
+}
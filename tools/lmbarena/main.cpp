@@ -0,0 +1,173 @@
+// lmbarena：LmbArena 的分配计数检查（ctest 目标 lmb_arena）
+//
+// 用法：lmbarena [nodes]
+// 按解析器的用法在线程池上逐节点使用 LmbArena：每个节点一个 Scope，实例列表分配在暂存区，
+// 部分节点另在保留区拷贝一份索引。全局 operator new 被替换为按线程计数的版本，检查：
+// - 预热一轮后，节点作用域内不再有任何堆分配（暂存区已扩到最大节点）；
+// - 暂存区的堆内存峰值与单个节点的大小同量级，而不是全部节点之和；
+// - release() 之后保留区可以继续使用。
+// 有任何不满足时逐条打印并返回非零
+
+#include "LmbArena.h"
+#include "LmbThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+    thread_local uint64_t threadAllocations = 0;
+
+    int failures = 0;
+
+    void Fail(const std::string &message)
+    {
+        std::cerr << "FAIL " << message << "\n";
+        ++failures;
+    }
+
+    // 与 LmbParser::Instance 同样大小的实例记录
+    struct Instance
+    {
+        const char *name;
+        size_t nameLength;
+        float matrix[9];
+        float position[3];
+        uint32_t colorIndex;
+    };
+
+    // 节点的实例数：多数节点没有或只有少量实例，少数节点很多
+    size_t InstanceCount(size_t node)
+    {
+        if (node % 97 == 0)
+            return 4000 + node % 1000;
+        if (node % 5 == 0)
+            return node % 300;
+        return node % 3;
+    }
+
+    // 在一个工作线程上按解析器的方式处理一个节点，返回节点作用域内的堆分配次数
+    uint64_t ProcessNode(LmbPlugin::LmbArena &arena, unsigned worker, size_t node, bool batch)
+    {
+        const uint64_t before = threadAllocations;
+        {
+            LmbPlugin::LmbArena::Scope scope(arena, worker);
+            std::pmr::vector<Instance> instances(arena.scratch(worker));
+            const size_t count = InstanceCount(node);
+            for (size_t i = 0; i < count; ++i)
+                instances.push_back(Instance{nullptr, 0, {1, 0, 0, 0, 1, 0, 0, 0, 1}, {float(i), 0, 0}, 0});
+            if (batch)
+            {
+                std::pmr::memory_resource *retained = arena.resource(worker);
+                uint32_t *indices = static_cast<uint32_t *>(retained->allocate(count * 3 * sizeof(uint32_t) + 4, alignof(uint32_t)));
+                indices[0] = static_cast<uint32_t>(node);
+            }
+        }
+        return threadAllocations - before;
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    ++threadAllocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++threadAllocations;
+    const size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    if (void *p = _aligned_malloc(size ? size : 1, align))
+        return p;
+#else
+    if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align + (size ? 0 : align)))
+        return p;
+#endif
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(p, alignment);
+}
+
+int main(int argc, char **argv)
+{
+    const size_t nodes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+
+    LmbPlugin::LmbThreadPool pool;
+    LmbPlugin::LmbArena arena(pool.size(), 4 * 1024);
+
+    size_t largestIndex = 0;
+    uint64_t totalBytes = 0;
+    for (size_t i = 0; i < nodes; ++i)
+    {
+        if (InstanceCount(i) > InstanceCount(largestIndex))
+            largestIndex = i;
+        totalBytes += InstanceCount(i) * sizeof(Instance);
+    }
+    const size_t largestNode = InstanceCount(largestIndex) * sizeof(Instance);
+
+    // 预热：每个工作线程依次遇到最大的节点，暂存区扩容
+    std::atomic<uint64_t> warmupAllocations{0};
+    pool.parallelForWorker(nodes, [&](size_t node, unsigned worker)
+                           { warmupAllocations += ProcessNode(arena, worker, node, false); });
+
+    // 稳定状态：同样的节点不应再向堆申请内存。节点分给哪个工作线程不确定，
+    // 因此先在调用线程上让每个工作线程的暂存区各处理一遍最大的节点（此时池空闲，不会并发）
+    for (unsigned worker = 0; worker < pool.size(); ++worker)
+        ProcessNode(arena, worker, largestIndex, false);
+    std::atomic<uint64_t> steadyAllocations{0};
+    pool.parallelForWorker(nodes, [&](size_t node, unsigned worker)
+                           { steadyAllocations += ProcessNode(arena, worker, node, false); });
+    if (steadyAllocations != 0)
+        Fail(std::to_string(steadyAllocations.load()) + " heap allocations inside node scopes after warm-up");
+
+    // 暂存区峰值：每个工作线程不超过最大节点的若干倍（vector 扩容与溢出块），与节点总数无关
+    const uint64_t scratchPeak = arena.peakBytes();
+    const uint64_t scratchLimit = static_cast<uint64_t>(pool.size()) * (8 * largestNode + 64 * 1024);
+    if (scratchPeak > scratchLimit)
+        Fail("scratch peak " + std::to_string(scratchPeak) + " bytes exceeds " + std::to_string(scratchLimit));
+
+    // 保留区：合批索引跨节点保留，release() 后可再次使用
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        pool.parallelForWorker(nodes, [&](size_t node, unsigned worker) { ProcessNode(arena, worker, node, true); });
+        arena.release();
+    }
+
+    std::cout << nodes << " nodes on " << pool.size() << " threads: " << warmupAllocations.load()
+              << " warm-up heap allocations, " << steadyAllocations.load() << " after warm-up, " << arena.allocations()
+              << " arena allocations from " << arena.blocks() << " heap blocks, scratch peak "
+              << scratchPeak / 1024 << " KB for " << totalBytes / 1024 << " KB of node data\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,335 @@
+// lmbroundtrip：LmbWriter 写出、LmbParser 读回的往返检查（ctest 目标 lmb_roundtrip）
+//
+// 用法：lmbroundtrip [workdir]
+// 构造覆盖 8/16/32 位索引、同一对象的实例、按内容识别的实例、材质色与顶点色的场景，
+// 写为 .lmb 并压缩为 .lmbz，分别读回后比较节点数、名称、颜色、索引宽度、实例与世界坐标。
+// 另检查带未加载页的 PagedLOD 的场景被拒绝写出。有任何不一致时逐条打印并返回非零
+// 省略 workdir 时使用系统临时目录
+
+#include "LmbCompression.h"
+#include "LmbParser.h"
+#include "LmbThreadPool.h"
+#include "LmbWriter.h"
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Material>
+#include <osg/MatrixTransform>
+#include <osg/NodeVisitor>
+#include <osg/PagedLOD>
+#include <osg/Transform>
+#include <osg/ValueObject>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace LmbPlugin;
+
+namespace
+{
+    const char GeodeSuffix[] = "_Geode";
+
+    // 写出前的一次出现，名称按读取端的命名（实例为 "<节点名>_inst_<序号>"）
+    struct ExpectedPlacement
+    {
+        std::string name;
+        osg::ref_ptr<const osg::Geometry> geometry;
+        osg::Matrixd world;
+        uint32_t color;
+        unsigned indexWidth;
+    };
+
+    // 读回场景中的一次出现
+    struct LoadedPlacement
+    {
+        osg::ref_ptr<const osg::Geometry> geometry;
+        osg::Matrixd world;
+        unsigned int color = 0;
+        bool hasColor = false;
+    };
+
+    int failures = 0;
+
+    void Fail(const std::string &context, const std::string &message)
+    {
+        std::cerr << "FAIL [" << context << "] " << message << "\n";
+        ++failures;
+    }
+
+    // columns x rows 顶点的起伏网格，顶点数决定文件中的索引宽度
+    osg::ref_ptr<osg::Geometry> CreateGrid(unsigned columns, unsigned rows)
+    {
+        osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+        osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
+        vertices->reserve(columns * rows);
+        normals->reserve(columns * rows);
+        for (unsigned y = 0; y < rows; ++y)
+        {
+            for (unsigned x = 0; x < columns; ++x)
+            {
+                vertices->push_back(osg::Vec3(x * 0.5f, y * 0.25f, std::sin(x * 0.3f) * std::cos(y * 0.2f)));
+                osg::Vec3 normal(-std::cos(x * 0.3f) * 0.3f, std::sin(y * 0.2f) * 0.2f, 1.0f);
+                normal.normalize();
+                normals->push_back(normal);
+            }
+        }
+
+        osg::ref_ptr<osg::DrawElementsUInt> triangles = new osg::DrawElementsUInt(GL_TRIANGLES);
+        for (unsigned y = 0; y + 1 < rows; ++y)
+        {
+            for (unsigned x = 0; x + 1 < columns; ++x)
+            {
+                const unsigned i = y * columns + x;
+                triangles->push_back(i);
+                triangles->push_back(i + 1);
+                triangles->push_back(i + columns);
+                triangles->push_back(i + 1);
+                triangles->push_back(i + columns + 1);
+                triangles->push_back(i + columns);
+            }
+        }
+
+        osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+        geometry->setVertexArray(vertices.get());
+        geometry->setNormalArray(normals.get(), osg::Array::BIND_PER_VERTEX);
+        geometry->addPrimitiveSet(triangles.get());
+        return geometry;
+    }
+
+    void SetMaterialColor(osg::Node &node, const osg::Vec4 &color)
+    {
+        osg::ref_ptr<osg::Material> material = new osg::Material;
+        material->setDiffuse(osg::Material::FRONT_AND_BACK, color);
+        node.getOrCreateStateSet()->setAttributeAndModes(material.get(), osg::StateAttribute::ON);
+    }
+
+    osg::ref_ptr<osg::Geode> AddNode(osg::Group &root, const std::string &name, const osg::Matrixd &matrix,
+                                     osg::Geometry *geometry)
+    {
+        osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform(matrix);
+        transform->setName(name);
+        osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+        geode->setName(name + GeodeSuffix);
+        geode->addDrawable(geometry);
+        transform->addChild(geode.get());
+        root.addChild(transform.get());
+        return geode;
+    }
+
+    class PlacementCollector : public osg::NodeVisitor
+    {
+    public:
+        PlacementCollector() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+        void apply(osg::Geode &geode) override
+        {
+            std::string name = geode.getName();
+            const size_t suffix = sizeof(GeodeSuffix) - 1;
+            if (name.size() > suffix && name.compare(name.size() - suffix, suffix, GeodeSuffix) == 0)
+                name.resize(name.size() - suffix);
+
+            LoadedPlacement placement;
+            placement.geometry = geode.getNumDrawables() > 0 ? geode.getDrawable(0)->asGeometry() : nullptr;
+            placement.world = osg::computeLocalToWorld(getNodePath());
+            if (const osg::StateSet *stateSet = geode.getStateSet())
+                placement.hasColor = stateSet->getUserValue(LmbParser::ColorValueName, placement.color);
+            if (!placements.emplace(name, placement).second)
+                Fail(name, "appears more than once in the loaded scene");
+        }
+
+        std::map<std::string, LoadedPlacement> placements;
+    };
+
+    unsigned IndexWidth(const osg::PrimitiveSet &primitives)
+    {
+        switch (primitives.getType())
+        {
+        case osg::PrimitiveSet::DrawElementsUBytePrimitiveType:
+            return 1;
+        case osg::PrimitiveSet::DrawElementsUShortPrimitiveType:
+            return 2;
+        case osg::PrimitiveSet::DrawElementsUIntPrimitiveType:
+            return 4;
+        default:
+            return 0;
+        }
+    }
+
+    // 写出端交换了基准顶点的位置但保持三角形顺序，逐个三角形角点比较世界坐标
+    void ComparePlacement(const std::string &context, const ExpectedPlacement &expected, const LoadedPlacement &loaded)
+    {
+        if (!loaded.hasColor)
+            Fail(context, "no LMB color on the loaded StateSet");
+        else if ((loaded.color & 0xFFFFFF) != expected.color)
+            Fail(context, "color " + std::to_string(loaded.color) + ", expected " + std::to_string(expected.color));
+
+        const osg::Geometry *geometry = loaded.geometry.get();
+        const osg::Vec3Array *vertices = geometry ? dynamic_cast<const osg::Vec3Array *>(geometry->getVertexArray()) : nullptr;
+        if (!vertices || geometry->getNumPrimitiveSets() != 1)
+        {
+            Fail(context, "loaded geometry has no float vertices or not exactly one primitive set");
+            return;
+        }
+        const osg::PrimitiveSet &loadedTriangles = *geometry->getPrimitiveSet(0);
+        if (IndexWidth(loadedTriangles) != expected.indexWidth)
+        {
+            Fail(context, "index width " + std::to_string(IndexWidth(loadedTriangles)) + ", expected " +
+                              std::to_string(expected.indexWidth));
+        }
+
+        const osg::Vec3Array &sourceVertices = *static_cast<const osg::Vec3Array *>(expected.geometry->getVertexArray());
+        const osg::PrimitiveSet &sourceTriangles = *expected.geometry->getPrimitiveSet(0);
+        if (loadedTriangles.getNumIndices() != sourceTriangles.getNumIndices())
+        {
+            Fail(context, "index count " + std::to_string(loadedTriangles.getNumIndices()) + ", expected " +
+                              std::to_string(sourceTriangles.getNumIndices()));
+            return;
+        }
+
+        // int16 量化：每轴步长为（基准点到包围盒边界的距离）/ 32767，另加浮点变换误差
+        osg::BoundingBox bounds;
+        for (const osg::Vec3 &v : sourceVertices)
+            bounds.expandBy(v);
+        const double tolerance = 2.0 * (bounds._max - bounds._min).length() / 32767.0 + 1e-3;
+        double worst = 0.0;
+        for (unsigned int i = 0; i < sourceTriangles.getNumIndices(); ++i)
+        {
+            const osg::Vec3d source = osg::Vec3d(sourceVertices[sourceTriangles.index(i)]) * expected.world;
+            const unsigned int loadedIndex = loadedTriangles.index(i);
+            if (loadedIndex >= vertices->size())
+            {
+                Fail(context, "index " + std::to_string(loadedIndex) + " out of range");
+                return;
+            }
+            const osg::Vec3d loadedPosition = osg::Vec3d((*vertices)[loadedIndex]) * loaded.world;
+            worst = std::max(worst, (loadedPosition - source).length());
+        }
+        if (worst > tolerance)
+            Fail(context, "position error " + std::to_string(worst) + " exceeds " + std::to_string(tolerance));
+    }
+
+    void CheckFile(const std::string &path, const std::vector<ExpectedPlacement> &expected,
+                   size_t expectedNodes, size_t expectedInstances)
+    {
+        LmbLoadOptions options;
+        options.useIndex = false; // 不在工作目录留下 .lmbi
+        LmbLoadStats stats;
+        osg::ref_ptr<osg::Group> scene = LmbParser::parseFile(path, nullptr, options, &stats);
+        if (!scene.valid())
+        {
+            Fail(path, "LmbParser could not read the file");
+            return;
+        }
+        if (stats.nodeCount != expectedNodes)
+            Fail(path, "node count " + std::to_string(stats.nodeCount) + ", expected " + std::to_string(expectedNodes));
+        if (stats.instanceCount != expectedInstances)
+        {
+            Fail(path, "instance count " + std::to_string(stats.instanceCount) + ", expected " +
+                           std::to_string(expectedInstances));
+        }
+
+        PlacementCollector collector;
+        scene->accept(collector);
+        if (collector.placements.size() != expected.size())
+        {
+            Fail(path, std::to_string(collector.placements.size()) + " placements loaded, expected " +
+                           std::to_string(expected.size()));
+        }
+        for (const ExpectedPlacement &placement : expected)
+        {
+            auto found = collector.placements.find(placement.name);
+            if (found == collector.placements.end())
+                Fail(path, "missing node " + placement.name);
+            else
+                ComparePlacement(path + ": " + placement.name, placement, found->second);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::filesystem::path workDir = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::temp_directory_path();
+    std::error_code ec;
+    std::filesystem::create_directories(workDir, ec);
+    const std::string lmbPath = (workDir / "roundtrip.lmb").string();
+    const std::string lmbzPath = (workDir / "roundtrip.lmbz").string();
+
+    // 顶点数 225 / 1600 / 75000 分别对应 8 / 16 / 32 位索引
+    osg::ref_ptr<osg::Geometry> beam = CreateGrid(15, 15);
+    osg::ref_ptr<osg::Geometry> slab = CreateGrid(40, 40);
+    osg::ref_ptr<osg::Geometry> slabCopy = osg::clone(slab.get(), osg::CopyOp::DEEP_COPY_ALL);
+    osg::ref_ptr<osg::Geometry> terrain = CreateGrid(300, 250);
+    osg::ref_ptr<osg::Vec4Array> blue = new osg::Vec4Array(1, osg::Vec4(0.0f, 0.0f, 1.0f, 1.0f));
+    slab->setColorArray(blue.get(), osg::Array::BIND_OVERALL);
+    slabCopy->setColorArray(blue.get(), osg::Array::BIND_OVERALL);
+
+    osg::ref_ptr<osg::Group> root = new osg::Group;
+    const osg::Matrixd beamMatrix = osg::Matrixd::translate(100.0, 50.0, 0.0);
+    const osg::Matrixd beamCopyMatrix = osg::Matrixd::rotate(0.5, osg::Z_AXIS) * osg::Matrixd::translate(120.0, 40.0, 5.0);
+    const osg::Matrixd slabMatrix = osg::Matrixd::translate(-30.0, 10.0, 2.0);
+    const osg::Matrixd slabCopyMatrix = osg::Matrixd::rotate(1.2, osg::X_AXIS) * osg::Matrixd::translate(-30.0, 10.0, 20.0);
+    const osg::Matrixd terrainMatrix = osg::Matrixd::translate(0.0, 0.0, -10.0);
+    SetMaterialColor(*AddNode(*root, "Beam", beamMatrix, beam.get()), osg::Vec4(1.0f, 0.0f, 0.0f, 1.0f));
+    // 同一几何对象再次出现：写为 Beam 的实例，颜色各自保留
+    SetMaterialColor(*AddNode(*root, "BeamCopy", beamCopyMatrix, beam.get()), osg::Vec4(0.0f, 1.0f, 0.0f, 1.0f));
+    AddNode(*root, "Slab", slabMatrix, slab.get());
+    // 深拷贝的几何：按内容识别为 Slab 的实例
+    AddNode(*root, "SlabCopy", slabCopyMatrix, slabCopy.get());
+    SetMaterialColor(*AddNode(*root, "Terrain", terrainMatrix, terrain.get()), osg::Vec4(128.0f / 255.0f, 128.0f / 255.0f, 128.0f / 255.0f, 1.0f));
+
+    const std::vector<ExpectedPlacement> expected = {
+        {"Beam", beam.get(), beamMatrix, 0xFF0000, 1},
+        {"Beam_inst_0", beam.get(), beamCopyMatrix, 0x00FF00, 1},
+        {"Slab", slab.get(), slabMatrix, 0x0000FF, 2},
+        {"Slab_inst_0", slabCopy.get(), slabCopyMatrix, 0x0000FF, 2},
+        {"Terrain", terrain.get(), terrainMatrix, 0x808080, 4},
+    };
+    const size_t expectedNodes = 3;
+    const size_t expectedInstances = 2;
+
+    LmbWriteStats writeStats;
+    if (!LmbWriter::WriteFile(*root, lmbPath, LmbWriteOptions(), &writeStats))
+    {
+        std::cerr << "FAIL LmbWriter could not write " << lmbPath << "\n";
+        return 1;
+    }
+    if (writeStats.nodeCount != expectedNodes || writeStats.instanceCount != expectedInstances ||
+        writeStats.sharedByContent != 1)
+    {
+        Fail(lmbPath, "writer stats: " + writeStats.summary());
+    }
+    CheckFile(lmbPath, expected, expectedNodes, expectedInstances);
+
+    // 小块压缩，读回时跨多个块解压
+    LmbThreadPool pool(0);
+    LmbCompression::Result result;
+    std::string error;
+    if (!LmbCompression::CompressFile(lmbPath, lmbzPath, 4096, pool, result, error))
+        Fail(lmbzPath, error);
+    else
+        CheckFile(lmbzPath, expected, expectedNodes, expectedInstances);
+
+    // 带未加载页的 PagedLOD（如 "paged" 加载的场景）：拒绝写出，目标文件不被创建
+    const std::string pagedPath = (workDir / "roundtrip_paged.lmb").string();
+    osg::ref_ptr<osg::PagedLOD> page = new osg::PagedLOD;
+    page->setFileName(0, "0.lmbpage");
+    page->setRange(0, 0.0f, 1000.0f);
+    root->addChild(page.get());
+    std::filesystem::remove(pagedPath, ec);
+    if (LmbWriter::WriteFile(*root, pagedPath))
+        Fail(pagedPath, "scene with an unloaded PagedLOD level was written");
+    else if (std::filesystem::exists(pagedPath))
+        Fail(pagedPath, "refused write left a file behind");
+
+    std::filesystem::remove(lmbPath, ec);
+    std::filesystem::remove(lmbzPath, ec);
+    if (failures > 0)
+    {
+        std::cerr << failures << " round-trip check(s) failed\n";
+        return 1;
+    }
+    std::cout << "LMB round trip OK: " << expected.size() << " placements in .lmb and .lmbz\n";
+    return 0;
+}
@@ -0,0 +1,143 @@
+// lmbzip：把 .lmb 转换为块压缩的 .lmbz（或用 -d 还原）
+//
+// 用法：lmbzip [-d] [-b <KB>] [-t <threads>] <input> [output]
+//   -d          解压 .lmbz 为 .lmb
+//   -b <KB>     压缩块大小，默认 1024 KB
+//   -t <n>      线程数，默认 0 = 硬件并发数
+// 省略 output 时按输入文件名替换扩展名
+
+#include "LmbCompression.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace LmbPlugin;
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cerr << "Usage: lmbzip [-d] [-b <KB>] [-t <threads>] <input> [output]\n"
+                  << "  -d           decompress .lmbz to .lmb\n"
+                  << "  -b <KB>      block size in KB (default " << LmbCompression::DefaultBlockSize / 1024 << ")\n"
+                  << "  -t <n>       worker threads (default 0 = hardware concurrency)\n";
+    }
+
+    std::string ReplaceExtension(const std::string &path, const std::string &extension)
+    {
+        const size_t dot = path.find_last_of('.');
+        const size_t slash = path.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            return path + extension;
+        return path.substr(0, dot) + extension;
+    }
+
+    bool Decompress(const std::string &input, const std::string &output, const LmbThreadPool &pool)
+    {
+        LmbMappedFile image;
+        if (!image.open(input))
+        {
+            std::cerr << "Cannot map " << input << "\n";
+            return false;
+        }
+        if (!LmbCompression::IsCompressed(image.data(), image.size()))
+        {
+            std::cerr << input << " is not a .lmbz file\n";
+            return false;
+        }
+        std::string error;
+        if (!LmbCompression::Decompress(image, pool, error))
+        {
+            std::cerr << input << ": " << error << "\n";
+            return false;
+        }
+
+        std::ofstream out(output, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(image.data()), static_cast<std::streamsize>(image.size()));
+        out.close();
+        if (!out)
+        {
+            std::remove(output.c_str());
+            std::cerr << "Failed to write " << output << "\n";
+            return false;
+        }
+        std::cout << input << " -> " << output << ": " << image.size() << " bytes\n";
+        return true;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    bool decompress = false;
+    unsigned long blockKB = LmbCompression::DefaultBlockSize / 1024;
+    unsigned long threads = 0;
+    std::string input, output;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "-d")
+            decompress = true;
+        else if ((arg == "-b" || arg == "-t") && i + 1 < argc)
+            (arg == "-b" ? blockKB : threads) = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "-h" || arg == "--help")
+        {
+            PrintUsage();
+            return 0;
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            PrintUsage();
+            return 1;
+        }
+        else if (input.empty())
+            input = arg;
+        else if (output.empty())
+            output = arg;
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (input.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+    if (output.empty())
+        output = ReplaceExtension(input, decompress ? ".lmb" : ".lmbz");
+    if (output == input)
+    {
+        std::cerr << "Output would overwrite the input file\n";
+        return 1;
+    }
+
+    LmbThreadPool pool(static_cast<unsigned>(threads));
+    if (decompress)
+        return Decompress(input, output, pool) ? 0 : 1;
+
+    if (blockKB == 0 || blockKB > (1u << 20))
+    {
+        std::cerr << "Block size must be between 1 and " << (1u << 20) << " KB\n";
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    LmbCompression::Result result;
+    std::string error;
+    if (!LmbCompression::CompressFile(input, output, static_cast<uint32_t>(blockKB * 1024), pool, result, error))
+    {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+
+    std::cout << input << " -> " << output << ": " << result.rawSize << " -> " << result.compressedSize << " bytes ("
+              << (result.rawSize ? 100.0 * double(result.compressedSize) / double(result.rawSize) : 0.0) << "%), "
+              << result.blockCount << " blocks (" << result.storedBlocks << " stored), "
+              << pool.size() << " threads, " << duration.count() << " ms\n";
+    return 0;
+}
@@ -0,0 +1,793 @@
+// loadbench：模型加载与渲染相关优化的基准测试，输出耗时与计数
+//
+// 用法：loadbench <command> [-n <nodes>] [-g <grid>] [-r <repeats>] [-f <frames>] [-w <workdir>] [files...]
+//   kernels     LMB 顶点反量化与法线解码：逐元素 push_back 的原实现与 LmbSimd 内核的吞吐量
+//               （LMB_SIMD=scalar|sse2|avx2 限制内核的指令集）
+//   decode      用 LmbWriter 生成合成 .lmb，分别以 1 个线程和全部线程加载，输出加速比与常驻内存
+//   render      离屏渲染合成场景，比较默认、合批（batch）与硬件实例化（hwinstancing）的绘制调用数与帧时间
+//   acmr        MeshOptimizer 对合成网格及 files（.lmb 直接解析，其余格式经 osgDB 插件）中每个网格的 ACMR 前后对比
+//   gltf        glTF 访问器转换吞吐量：逐元素 push_back 与 GltfAccessorView 批量转换（紧密/交错/归一化整数），
+//               以及 files 中 .gltf/.glb 全部图元属性的转换
+//   -n <nodes>  合成场景的节点数，默认 2000
+//   -g <grid>   每个节点网格的边长（顶点数 = grid * grid），默认 40
+//   -r <n>      每项测量重复次数，取最快一次，默认 3
+//   -f <n>      render 每种配置计时的帧数，默认 200
+//   -w <dir>    合成文件所在目录，默认系统临时目录
+
+#include "LmbMemory.h"
+#include "LmbParser.h"
+#include "LmbSimd.h"
+#include "LmbWriter.h"
+#include "MeshOptimizer.h"
+#include "GltfAccessor.h"
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Material>
+#include <osg/MatrixTransform>
+#include <osg/GL>
+#include <osg/NodeVisitor>
+#include <osgDB/ReadFile>
+#include <osgViewer/Viewer>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace LmbPlugin;
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    struct BenchOptions
+    {
+        size_t nodes = 2000;
+        unsigned grid = 40;
+        unsigned repeats = 3;
+        unsigned frames = 200;
+        std::vector<std::string> files;
+        std::filesystem::path workDir = std::filesystem::temp_directory_path();
+    };
+
+    void PrintUsage()
+    {
+        std::cerr << "Usage: loadbench <command> [-n <nodes>] [-g <grid>] [-r <repeats>] [-f <frames>] [-w <workdir>] [files...]\n"
+                  << "  kernels      LMB dequantization / normal decoding throughput, before and after LmbSimd\n"
+                  << "  decode       load a synthetic .lmb on 1 thread and on all threads\n"
+                  << "  render       draw calls and frame time: default, batch and hwinstancing loads\n"
+                  << "  acmr         ACMR before/after MeshOptimizer for synthetic meshes and every mesh in files\n"
+                  << "  gltf         glTF accessor conversion throughput, synthetic and for every primitive in files\n"
+                  << "  -n <nodes>   nodes in the synthetic scene (default 2000)\n"
+                  << "  -g <grid>    grid size per node, grid * grid vertices (default 40)\n"
+                  << "  -r <n>       repeats per measurement, the fastest is reported (default 3)\n"
+                  << "  -f <n>       frames timed per render configuration (default 200)\n"
+                  << "  -w <dir>     directory for the synthetic files (default: system temp)\n";
+    }
+
+    // 重复 repeats 次，返回最快一次的毫秒数
+    double BestOf(unsigned repeats, const std::function<void()> &run)
+    {
+        double best = 0.0;
+        for (unsigned i = 0; i < std::max(1u, repeats); ++i)
+        {
+            const Clock::time_point begin = Clock::now();
+            run();
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+            best = i == 0 ? ms : std::min(best, ms);
+        }
+        return best;
+    }
+
+    std::string Megabytes(uint64_t bytes)
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1) << double(bytes) / (1024.0 * 1024.0) << " MB";
+        return out.str();
+    }
+
+    // grid x grid 顶点的起伏网格；seed 让每个节点的几何各不相同（不被写为实例或去重）
+    osg::ref_ptr<osg::Geometry> CreateGrid(unsigned grid, unsigned seed)
+    {
+        const float phase = static_cast<float>(seed) * 0.37f;
+        osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+        osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
+        vertices->reserve(grid * grid);
+        normals->reserve(grid * grid);
+        for (unsigned y = 0; y < grid; ++y)
+        {
+            for (unsigned x = 0; x < grid; ++x)
+            {
+                vertices->push_back(osg::Vec3(x * 0.1f, y * 0.1f, 0.2f * std::sin(x * 0.3f + phase) * std::cos(y * 0.2f)));
+                osg::Vec3 normal(-0.06f * std::cos(x * 0.3f + phase), 0.04f * std::sin(y * 0.2f), 1.0f);
+                normal.normalize();
+                normals->push_back(normal);
+            }
+        }
+
+        osg::ref_ptr<osg::DrawElementsUInt> triangles = new osg::DrawElementsUInt(GL_TRIANGLES);
+        triangles->reserve((grid - 1) * (grid - 1) * 6);
+        for (unsigned y = 0; y + 1 < grid; ++y)
+        {
+            for (unsigned x = 0; x + 1 < grid; ++x)
+            {
+                const unsigned i = y * grid + x;
+                triangles->push_back(i);
+                triangles->push_back(i + 1);
+                triangles->push_back(i + grid);
+                triangles->push_back(i + 1);
+                triangles->push_back(i + grid + 1);
+                triangles->push_back(i + grid);
+            }
+        }
+
+        osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+        geometry->setVertexArray(vertices.get());
+        geometry->setNormalArray(normals.get(), osg::Array::BIND_PER_VERTEX);
+        geometry->addPrimitiveSet(triangles.get());
+        return geometry;
+    }
+
+    // 节点排成方阵，颜色在 8 种之间循环；shared 时所有节点共用一个几何（写为实例）
+    osg::ref_ptr<osg::Group> CreateScene(const BenchOptions &options, bool shared)
+    {
+        osg::ref_ptr<osg::Group> root = new osg::Group;
+        osg::ref_ptr<osg::Geometry> sharedGeometry = shared ? CreateGrid(options.grid, 0) : nullptr;
+        const unsigned columns = static_cast<unsigned>(std::ceil(std::sqrt(double(options.nodes))));
+        const float spacing = options.grid * 0.1f + 1.0f;
+        for (size_t i = 0; i < options.nodes; ++i)
+        {
+            const osg::Matrixd matrix = osg::Matrixd::translate((i % columns) * spacing, (i / columns) * spacing, 0.0);
+            osg::ref_ptr<osg::MatrixTransform> transform = new osg::MatrixTransform(matrix);
+            transform->setName("Part_" + std::to_string(i));
+            osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+            geode->addDrawable(shared ? sharedGeometry.get() : CreateGrid(options.grid, static_cast<unsigned>(i)).get());
+
+            osg::ref_ptr<osg::Material> material = new osg::Material;
+            const unsigned color = static_cast<unsigned>(i % 8);
+            material->setDiffuse(osg::Material::FRONT_AND_BACK,
+                                 osg::Vec4((color & 1) ? 0.9f : 0.3f, (color & 2) ? 0.9f : 0.3f, (color & 4) ? 0.9f : 0.3f, 1.0f));
+            geode->getOrCreateStateSet()->setAttributeAndModes(material.get(), osg::StateAttribute::ON);
+
+            transform->addChild(geode.get());
+            root->addChild(transform.get());
+        }
+        return root;
+    }
+
+    // 写出合成场景，文件名包含规模参数，已存在时直接复用
+    std::string WriteScene(const BenchOptions &options, bool shared)
+    {
+        const std::string suffix = shared ? "_shared" : "";
+        std::error_code ec;
+        std::filesystem::create_directories(options.workDir, ec);
+        const std::string path = (options.workDir / ("loadbench_" + std::to_string(options.nodes) + "x" +
+                                                     std::to_string(options.grid) + suffix + ".lmb")).string();
+        if (std::filesystem::exists(path, ec))
+            return path;
+
+        LmbWriteStats stats;
+        if (!LmbWriter::WriteFile(*CreateScene(options, shared), path, LmbWriteOptions(), &stats))
+            return std::string();
+        std::cout << "Wrote " << path << ": " << stats.summary() << "\n";
+        return path;
+    }
+
+    int RunKernels(const BenchOptions &options)
+    {
+        const size_t count = options.nodes * options.grid * options.grid;
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<int> quantized(-32767, 32767);
+        std::uniform_int_distribution<int> packed(0, 0x3FFFFFFF);
+        std::vector<int16_t> vertices(count * 3);
+        for (int16_t &v : vertices)
+            v = static_cast<int16_t>(quantized(rng));
+        std::vector<int32_t> normals(count);
+        for (int32_t &n : normals)
+            n = packed(rng);
+
+        const float base[3] = {10.0f, -5.0f, 2.0f};
+        const float scale[3] = {3276.7f, 1638.35f, 6553.4f};
+        const float invScale[3] = {1.0f / scale[0], 1.0f / scale[1], 1.0f / scale[2]};
+
+        // 原实现：逐分量除法、push_back 到未预留的数组、逐个 normalize
+        const double vertexBefore = BestOf(options.repeats, [&]()
+        {
+            osg::ref_ptr<osg::Vec3Array> out = new osg::Vec3Array;
+            for (size_t i = 0; i < count; ++i)
+            {
+                out->push_back(osg::Vec3(base[0] + vertices[i * 3 + 0] / scale[0],
+                                         base[1] + vertices[i * 3 + 1] / scale[1],
+                                         base[2] + vertices[i * 3 + 2] / scale[2]));
+            }
+        });
+        const double normalBefore = BestOf(options.repeats, [&]()
+        {
+            osg::ref_ptr<osg::Vec3Array> out = new osg::Vec3Array;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const uint32_t p = static_cast<uint32_t>(normals[i]);
+                int x = (p >> 20) & 0x3FF, y = (p >> 10) & 0x3FF, z = p & 0x3FF;
+                x = x >= 512 ? x - 1024 : x;
+                y = y >= 512 ? y - 1024 : y;
+                z = z >= 512 ? z - 1024 : z;
+                osg::Vec3 normal(x / 511.0f, y / 511.0f, z / 511.0f);
+                normal.normalize();
+                out->push_back(normal);
+            }
+        });
+
+        // 现实现：预先定大小的数组，LmbSimd 内核一次处理整个节点
+        const double vertexAfter = BestOf(options.repeats, [&]()
+        {
+            osg::ref_ptr<osg::Vec3Array> out = new osg::Vec3Array(static_cast<unsigned int>(count));
+            LmbSimd::DequantizeVertices(vertices.data(), count, base, invScale, &(*out)[0].x());
+        });
+        const double normalAfter = BestOf(options.repeats, [&]()
+        {
+            osg::ref_ptr<osg::Vec3Array> out = new osg::Vec3Array(static_cast<unsigned int>(count));
+            LmbSimd::DecodeNormals(normals.data(), count, &(*out)[0].x());
+        });
+
+        auto rate = [count](double ms) { return double(count) / (ms / 1000.0) / 1e6; };
+        std::cout << std::fixed << std::setprecision(1)
+                  << "kernels: " << count << " elements, LmbSimd level " << LmbSimd::levelName(LmbSimd::activeLevel()) << "\n"
+                  << "  dequantize  before " << vertexBefore << " ms (" << rate(vertexBefore) << " M vertices/s), after "
+                  << vertexAfter << " ms (" << rate(vertexAfter) << " M vertices/s), x" << vertexBefore / vertexAfter << "\n"
+                  << "  normals     before " << normalBefore << " ms (" << rate(normalBefore) << " M normals/s), after "
+                  << normalAfter << " ms (" << rate(normalAfter) << " M normals/s), x" << normalBefore / normalAfter << "\n";
+        return 0;
+    }
+
+    int RunDecode(const BenchOptions &options)
+    {
+        const std::string path = WriteScene(options, false);
+        if (path.empty())
+        {
+            std::cerr << "Cannot write the synthetic scene to " << options.workDir.string() << "\n";
+            return 1;
+        }
+        const uint64_t fileBytes = std::filesystem::file_size(path);
+
+        auto load = [&](unsigned threads, LmbLoadStats &stats)
+        {
+            LmbLoadOptions loadOptions;
+            loadOptions.threadCount = threads;
+            loadOptions.useIndex = false;
+            stats = LmbLoadStats();
+            osg::ref_ptr<osg::Group> scene = LmbParser::parseFile(path, nullptr, loadOptions, &stats);
+            if (!scene.valid())
+                throw std::runtime_error("cannot load " + path);
+        };
+
+        LmbLoadStats single, parallel;
+        const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        const double singleMs = BestOf(options.repeats, [&]() { load(1, single); });
+        const double parallelMs = BestOf(options.repeats, [&]() { load(0, parallel); });
+
+        // 加载后映射页已逐节点释放：常驻内存增量应接近场景图本身，而非文件大小 + 场景图
+        std::cout << std::fixed << std::setprecision(1)
+                  << "decode: " << path << " (" << Megabytes(fileBytes) << ", " << parallel.nodeCount << " nodes, "
+                  << parallel.vertexCount << " vertices)\n"
+                  << "  1 thread    " << singleMs << " ms (" << double(parallel.vertexCount) / (singleMs / 1000.0) / 1e6
+                  << " M vertices/s)\n"
+                  << "  " << threads << " threads   " << parallelMs << " ms ("
+                  << double(parallel.vertexCount) / (parallelMs / 1000.0) / 1e6 << " M vertices/s), speedup x"
+                  << singleMs / parallelMs << "\n"
+                  << "  resident    +" << Megabytes(parallel.residentBytesAfter - std::min(parallel.residentBytesAfter, parallel.residentBytesBefore))
+                  << " after load (geometry " << Megabytes(parallel.vertexBytes + parallel.indexBytes) << "), peak "
+                  << Megabytes(parallel.peakResidentBytes) << ", " << Megabytes(LmbMemory::residentBytes())
+                  << " after the scene is released\n";
+        return 0;
+    }
+
+    // 每帧的绘制调用数：遍历到的每个图元集一次（不计视锥剔除，场景整体在视野内）
+    class DrawCallCounter : public osg::NodeVisitor
+    {
+    public:
+        DrawCallCounter() : osg::NodeVisitor(TRAVERSE_ACTIVE_CHILDREN) {}
+
+        void apply(osg::Geometry &geometry) override
+        {
+            drawCalls += geometry.getNumPrimitiveSets();
+            for (unsigned int i = 0; i < geometry.getNumPrimitiveSets(); ++i)
+                instancedDrawCalls += geometry.getPrimitiveSet(i)->getNumInstances() > 0 ? 1 : 0;
+        }
+
+        size_t drawCalls = 0;
+        size_t instancedDrawCalls = 0;
+    };
+
+    // 每帧结束时等待 GPU 完成，帧时间包含绘制本身而不只是命令提交
+    struct FinishCallback : public osg::Camera::DrawCallback
+    {
+        void operator()(osg::RenderInfo &) const override { glFinish(); }
+    };
+
+    struct RenderResult
+    {
+        size_t drawCalls = 0;
+        size_t instancedDrawCalls = 0;
+        double loadMs = 0.0;
+        double frameMs = 0.0;
+    };
+
+    RenderResult RenderFile(const BenchOptions &options, const std::string &path, const LmbLoadOptions &loadOptions)
+    {
+        RenderResult result;
+        const Clock::time_point loadBegin = Clock::now();
+        osg::ref_ptr<osg::Group> scene = LmbParser::parseFile(path, nullptr, loadOptions);
+        result.loadMs = std::chrono::duration<double, std::milli>(Clock::now() - loadBegin).count();
+        if (!scene.valid())
+            throw std::runtime_error("cannot load " + path);
+
+        DrawCallCounter counter;
+        scene->accept(counter);
+        result.drawCalls = counter.drawCalls;
+        result.instancedDrawCalls = counter.instancedDrawCalls;
+
+        osg::ref_ptr<osg::GraphicsContext::Traits> traits = new osg::GraphicsContext::Traits;
+        traits->width = 1280;
+        traits->height = 720;
+        traits->pbuffer = true;
+        traits->doubleBuffer = false;
+        osg::ref_ptr<osg::GraphicsContext> context = osg::GraphicsContext::createGraphicsContext(traits.get());
+        if (!context.valid())
+            throw std::runtime_error("cannot create an offscreen OpenGL context");
+
+        osgViewer::Viewer viewer;
+        viewer.setThreadingModel(osgViewer::ViewerBase::SingleThreaded);
+        osg::Camera *camera = viewer.getCamera();
+        camera->setGraphicsContext(context.get());
+        camera->setViewport(0, 0, traits->width, traits->height);
+        camera->setDrawBuffer(GL_FRONT);
+        camera->setReadBuffer(GL_FRONT);
+        camera->setFinalDrawCallback(new FinishCallback);
+        viewer.setSceneData(scene.get());
+
+        // 从斜上方看整个场景
+        const osg::BoundingSphere bound = scene->getBound();
+        const osg::Vec3d eye = bound.center() + osg::Vec3d(0.0, -1.2, 1.0) * bound.radius() * 1.5;
+        camera->setViewMatrixAsLookAt(eye, bound.center(), osg::Z_AXIS);
+        camera->setProjectionMatrixAsPerspective(45.0, double(traits->width) / traits->height, bound.radius() * 0.05,
+                                                 bound.radius() * 6.0);
+        viewer.realize();
+
+        // 前几帧包含显示列表/VBO 上传与着色器编译，不计时
+        for (int i = 0; i < 10; ++i)
+            viewer.frame();
+        const Clock::time_point begin = Clock::now();
+        for (unsigned i = 0; i < std::max(1u, options.frames); ++i)
+            viewer.frame();
+        result.frameMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count() / std::max(1u, options.frames);
+        return result;
+    }
+
+    int RunRender(const BenchOptions &options)
+    {
+        const std::string unique = WriteScene(options, false);
+        const std::string shared = WriteScene(options, true);
+        if (unique.empty() || shared.empty())
+        {
+            std::cerr << "Cannot write the synthetic scenes to " << options.workDir.string() << "\n";
+            return 1;
+        }
+
+        struct Configuration
+        {
+            const char *name;
+            const std::string *path;
+            bool batch;
+            bool instancing;
+        };
+        const Configuration configurations[] = {
+            {"unique  default", &unique, false, false},
+            {"unique  batch", &unique, true, false},
+            {"shared  default", &shared, false, false},
+            {"shared  batch", &shared, true, false},
+            {"shared  hwinstancing", &shared, false, true},
+        };
+
+        std::cout << "render: " << options.nodes << " nodes of " << options.grid * options.grid << " vertices, "
+                  << options.frames << " frames at 1280x720\n";
+        for (const Configuration &configuration : configurations)
+        {
+            LmbLoadOptions loadOptions;
+            loadOptions.useIndex = false;
+            loadOptions.staticBatching = configuration.batch;
+            loadOptions.hardwareInstancing = configuration.instancing;
+            const RenderResult result = RenderFile(options, *configuration.path, loadOptions);
+            std::cout << std::fixed << std::setprecision(2) << "  " << std::left << std::setw(22) << configuration.name
+                      << std::right << result.drawCalls << " draw calls (" << result.instancedDrawCalls
+                      << " instanced), " << result.frameMs << " ms/frame, load " << std::setprecision(1)
+                      << result.loadMs << " ms\n";
+        }
+        return 0;
+    }
+
+    // 场景中的全部 Geometry（共享的只计一次）
+    class GeometryCollector : public osg::NodeVisitor
+    {
+    public:
+        GeometryCollector() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) {}
+
+        void apply(osg::Geometry &geometry) override
+        {
+            if (seen_.insert(&geometry).second)
+                geometries.push_back(&geometry);
+        }
+
+        std::vector<osg::ref_ptr<osg::Geometry>> geometries;
+
+    private:
+        std::set<const osg::Geometry *> seen_;
+    };
+
+    // 优化每个网格的副本，返回汇总；verbose 时逐网格输出
+    MeshOptimizer::Result OptimizeAll(const std::string &name, const std::vector<osg::ref_ptr<osg::Geometry>> &geometries,
+                                      bool verbose)
+    {
+        MeshOptimizer::Result total;
+        size_t eligible = 0;
+        double ms = 0.0;
+        for (size_t i = 0; i < geometries.size(); ++i)
+        {
+            osg::ref_ptr<osg::Geometry> copy = osg::clone(geometries[i].get(), osg::CopyOp::DEEP_COPY_ALL);
+            MeshOptimizer::Result result;
+            const Clock::time_point begin = Clock::now();
+            MeshOptimizer::Optimize(copy.get(), nullptr, result);
+            ms += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+            if (result.triangles == 0)
+                continue;
+            ++eligible;
+            total.add(result);
+            if (verbose)
+                std::cout << "    " << name << " #" << i << ": " << MeshOptimizer::Describe(result) << "\n";
+        }
+        std::cout << std::fixed << std::setprecision(1) << "  " << name << ": " << eligible << " of "
+                  << geometries.size() << " meshes, " << MeshOptimizer::Describe(total) << ", " << ms << " ms ("
+                  << (ms > 0.0 ? double(total.triangles) / (ms / 1000.0) / 1e6 : 0.0) << " M triangles/s)\n";
+        return total;
+    }
+
+    // 打乱三角形顺序（保持每个三角形的顶点顺序），模拟不考虑缓存的导出顺序
+    osg::ref_ptr<osg::Geometry> ShuffleTriangles(const osg::Geometry &source, unsigned seed)
+    {
+        osg::ref_ptr<osg::Geometry> geometry = osg::clone(&source, osg::CopyOp::DEEP_COPY_ALL);
+        osg::DrawElementsUInt *triangles = static_cast<osg::DrawElementsUInt *>(geometry->getPrimitiveSet(0));
+        std::vector<size_t> order(triangles->size() / 3);
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::mt19937 rng(seed);
+        std::shuffle(order.begin(), order.end(), rng);
+        osg::ref_ptr<osg::DrawElementsUInt> shuffled = new osg::DrawElementsUInt(GL_TRIANGLES);
+        shuffled->reserve(triangles->size());
+        for (size_t triangle : order)
+        {
+            for (size_t k = 0; k < 3; ++k)
+                shuffled->push_back((*triangles)[triangle * 3 + k]);
+        }
+        geometry->setPrimitiveSet(0, shuffled.get());
+        return geometry;
+    }
+
+    int RunAcmr(const BenchOptions &options)
+    {
+        std::cout << "acmr: FIFO cache of " << MeshOptimizer::FifoCacheSize << " vertices\n";
+
+        // 合成语料：行序网格（导出器常见顺序）与打乱三角形顺序的同一网格，各几种大小
+        std::vector<osg::ref_ptr<osg::Geometry>> rowOrder, shuffled;
+        for (unsigned grid : {16u, 64u, 256u})
+        {
+            rowOrder.push_back(CreateGrid(grid, grid));
+            shuffled.push_back(ShuffleTriangles(*rowOrder.back(), grid));
+        }
+        MeshOptimizer::Result corpus;
+        corpus.add(OptimizeAll("synthetic row order", rowOrder, true));
+        corpus.add(OptimizeAll("synthetic shuffled", shuffled, true));
+
+        for (const std::string &file : options.files)
+        {
+            // .lmb 直接解析（不经插件目录），关闭加载器自身的优化以得到原始顺序
+            osg::ref_ptr<osg::Node> scene;
+            const std::string extension = std::filesystem::path(file).extension().string();
+            if (extension == ".lmb" || extension == ".lmbz")
+            {
+                LmbLoadOptions loadOptions;
+                loadOptions.useIndex = false;
+                loadOptions.deduplicate = false;
+                scene = LmbParser::parseFile(file, nullptr, loadOptions);
+            }
+            else
+                scene = osgDB::readNodeFile(file);
+            if (!scene.valid())
+            {
+                std::cerr << "  " << file << ": cannot load, skipped\n";
+                continue;
+            }
+            GeometryCollector collector;
+            scene->accept(collector);
+            corpus.add(OptimizeAll(file, collector.geometries, false));
+        }
+
+        std::cout << "  corpus total: " << MeshOptimizer::Describe(corpus) << "\n";
+        return 0;
+    }
+
+    // 合成 glTF 模型：同一 count 个顶点分别存为交错（位置/法线/纹理坐标，步长 32）、
+    // 紧密排列的 float 位置与归一化 ushort 纹理坐标三种布局
+    enum SyntheticAccessor
+    {
+        InterleavedPosition,
+        InterleavedNormal,
+        InterleavedTexCoord,
+        PackedPosition,
+        NormalizedTexCoord
+    };
+
+    tinygltf::Model CreateAccessorModel(size_t count)
+    {
+        const size_t interleavedBytes = count * 32;
+        const size_t packedBytes = count * 12;
+        const size_t normalizedBytes = count * 4;
+
+        tinygltf::Model model;
+        model.buffers.resize(1);
+        std::vector<unsigned char> &data = model.buffers[0].data;
+        data.resize(interleavedBytes + packedBytes + normalizedBytes);
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+        for (size_t i = 0; i < count; ++i)
+        {
+            float vertex[8];
+            for (float &v : vertex)
+                v = value(rng);
+            std::memcpy(&data[i * 32], vertex, sizeof(vertex));
+            std::memcpy(&data[interleavedBytes + i * 12], vertex, 12);
+            const uint16_t uv[2] = {static_cast<uint16_t>(rng()), static_cast<uint16_t>(rng())};
+            std::memcpy(&data[interleavedBytes + packedBytes + i * 4], uv, sizeof(uv));
+        }
+
+        auto addView = [&](size_t offset, size_t length, int stride)
+        {
+            tinygltf::BufferView view;
+            view.buffer = 0;
+            view.byteOffset = offset;
+            view.byteLength = length;
+            view.byteStride = stride;
+            model.bufferViews.push_back(view);
+            return static_cast<int>(model.bufferViews.size() - 1);
+        };
+        auto addAccessor = [&](int view, size_t offset, int type, int componentType, bool normalized)
+        {
+            tinygltf::Accessor accessor;
+            accessor.bufferView = view;
+            accessor.byteOffset = offset;
+            accessor.count = count;
+            accessor.type = type;
+            accessor.componentType = componentType;
+            accessor.normalized = normalized;
+            model.accessors.push_back(accessor);
+        };
+        const int interleaved = addView(0, interleavedBytes, 32);
+        const int packed = addView(interleavedBytes, packedBytes, 0);
+        const int normalized = addView(interleavedBytes + packedBytes, normalizedBytes, 0);
+        addAccessor(interleaved, 0, TINYGLTF_TYPE_VEC3, TINYGLTF_COMPONENT_TYPE_FLOAT, false);
+        addAccessor(interleaved, 12, TINYGLTF_TYPE_VEC3, TINYGLTF_COMPONENT_TYPE_FLOAT, false);
+        addAccessor(interleaved, 24, TINYGLTF_TYPE_VEC2, TINYGLTF_COMPONENT_TYPE_FLOAT, false);
+        addAccessor(packed, 0, TINYGLTF_TYPE_VEC3, TINYGLTF_COMPONENT_TYPE_FLOAT, false);
+        addAccessor(normalized, 0, TINYGLTF_TYPE_VEC2, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, true);
+        return model;
+    }
+
+    const unsigned char *AccessorData(const tinygltf::Model &model, int accessorIndex, size_t &stride)
+    {
+        const tinygltf::Accessor &accessor = model.accessors[accessorIndex];
+        const tinygltf::BufferView &view = model.bufferViews[accessor.bufferView];
+        stride = view.byteStride;
+        return model.buffers[view.buffer].data.data() + view.byteOffset + accessor.byteOffset;
+    }
+
+    void PrintRate(const char *name, size_t bytes, double before, double after)
+    {
+        auto rate = [bytes](double ms) { return double(bytes) / (ms / 1000.0) / (1024.0 * 1024.0); };
+        std::cout << std::fixed << std::setprecision(1) << "  " << std::left << std::setw(24) << name << std::right
+                  << "per element " << rate(before) << " MB/s, GltfAccessorView " << rate(after) << " MB/s, x"
+                  << before / after << "\n";
+    }
+
+    // 整个文件：每个网格图元的全部属性与索引各转换一次
+    void ConvertFile(const BenchOptions &options, const std::string &file)
+    {
+        tinygltf::TinyGLTF loader;
+        tinygltf::Model model;
+        std::string error, warning;
+        const bool binary = std::filesystem::path(file).extension() == ".glb";
+        const bool loaded = binary ? loader.LoadBinaryFromFile(&model, &error, &warning, file)
+                                   : loader.LoadASCIIFromFile(&model, &error, &warning, file);
+        if (!loaded)
+        {
+            std::cerr << "  " << file << ": " << error << ", skipped\n";
+            return;
+        }
+
+        size_t bytes = 0;
+        size_t accessors = 0;
+        std::vector<float> floats;
+        std::vector<uint32_t> indices;
+        const double ms = BestOf(options.repeats, [&]()
+        {
+            bytes = 0;
+            accessors = 0;
+            for (const tinygltf::Mesh &mesh : model.meshes)
+            {
+                for (const tinygltf::Primitive &primitive : mesh.primitives)
+                {
+                    for (const auto &attribute : primitive.attributes)
+                    {
+                        GltfAccessorView view(model, attribute.second);
+                        if (!view.valid())
+                            continue;
+                        floats.resize(view.count() * view.components());
+                        view.readFloats(floats.data(), view.components());
+                        bytes += view.byteSize();
+                        ++accessors;
+                    }
+                    if (primitive.indices < 0)
+                        continue;
+                    GltfAccessorView view(model, primitive.indices);
+                    if (view.valid())
+                    {
+                        indices.resize(view.count());
+                        view.readUInts(indices.data());
+                        bytes += view.byteSize();
+                        ++accessors;
+                    }
+                }
+            }
+        });
+        std::cout << std::fixed << std::setprecision(1) << "  " << file << ": " << accessors << " accessors, "
+                  << Megabytes(bytes) << " in " << ms << " ms (" << double(bytes) / (ms / 1000.0) / (1024.0 * 1024.0)
+                  << " MB/s)\n";
+    }
+
+    int RunGltf(const BenchOptions &options)
+    {
+        const size_t count = options.nodes * options.grid * options.grid;
+        const tinygltf::Model model = CreateAccessorModel(count);
+        std::cout << "gltf: " << count << " vertices per accessor\n";
+
+        // 原实现只处理紧密排列的 float：逐元素 push_back 到未预留的数组
+        size_t stride = 0;
+        const unsigned char *packed = AccessorData(model, PackedPosition, stride);
+        const double packedBefore = BestOf(options.repeats, [&]()
+        {
+            osg::ref_ptr<osg::Vec3Array> out = new osg::Vec3Array;
+            const float *data = reinterpret_cast<const float *>(packed);
+            for (size_t i = 0; i < count; ++i)
+                out->push_back(osg::Vec3(data[i * 3 + 0], data[i * 3 + 1], data[i * 3 + 2]));
+        });
+        const double packedAfter = BestOf(options.repeats, [&]()
+        {
+            GltfAccessorView(model, PackedPosition).toArray<osg::Vec3Array>();
+        });
+        PrintRate("packed VEC3 float", count * 12, packedBefore, packedAfter);
+
+        // 交错与归一化数据原实现读错，对照用按步长逐元素读取的正确写法
+        const unsigned char *interleaved = AccessorData(model, InterleavedPosition, stride);
+        const double interleavedBefore = BestOf(options.repeats, [&]()
+        {
+            osg::ref_ptr<osg::Vec3Array> positions = new osg::Vec3Array;
+            osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
+            osg::ref_ptr<osg::Vec2Array> texCoords = new osg::Vec2Array;
+            for (size_t i = 0; i < count; ++i)
+            {
+                float vertex[8];
+                std::memcpy(vertex, interleaved + i * stride, sizeof(vertex));
+                positions->push_back(osg::Vec3(vertex[0], vertex[1], vertex[2]));
+                normals->push_back(osg::Vec3(vertex[3], vertex[4], vertex[5]));
+                texCoords->push_back(osg::Vec2(vertex[6], vertex[7]));
+            }
+        });
+        const double interleavedAfter = BestOf(options.repeats, [&]()
+        {
+            GltfAccessorView(model, InterleavedPosition).toArray<osg::Vec3Array>();
+            GltfAccessorView(model, InterleavedNormal).toArray<osg::Vec3Array>();
+            GltfAccessorView(model, InterleavedTexCoord).toArray<osg::Vec2Array>();
+        });
+        PrintRate("interleaved stride 32", count * 32, interleavedBefore, interleavedAfter);
+
+        const unsigned char *normalized = AccessorData(model, NormalizedTexCoord, stride);
+        const double normalizedBefore = BestOf(options.repeats, [&]()
+        {
+            osg::ref_ptr<osg::Vec2Array> out = new osg::Vec2Array;
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint16_t uv[2];
+                std::memcpy(uv, normalized + i * 4, sizeof(uv));
+                out->push_back(osg::Vec2(uv[0] / 65535.0f, uv[1] / 65535.0f));
+            }
+        });
+        const double normalizedAfter = BestOf(options.repeats, [&]()
+        {
+            GltfAccessorView(model, NormalizedTexCoord).toArray<osg::Vec2Array>();
+        });
+        PrintRate("normalized VEC2 ushort", count * 4, normalizedBefore, normalizedAfter);
+
+        for (const std::string &file : options.files)
+            ConvertFile(options, file);
+        return 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return 2;
+    }
+    const std::string command = argv[1];
+    BenchOptions options;
+    for (int i = 2; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg.empty() || arg[0] != '-')
+        {
+            options.files.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 2;
+        }
+        if (arg == "-n")
+            options.nodes = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "-g")
+            options.grid = std::max(2u, static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10)));
+        else if (arg == "-r")
+            options.repeats = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "-f")
+            options.frames = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "-w")
+            options.workDir = argv[++i];
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    try
+    {
+        if (command == "kernels")
+            return RunKernels(options);
+        if (command == "decode")
+            return RunDecode(options);
+        if (command == "render")
+            return RunRender(options);
+        if (command == "acmr")
+            return RunAcmr(options);
+        if (command == "gltf")
+            return RunGltf(options);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << command << ": " << e.what() << "\n";
+        return 1;
+    }
+    PrintUsage();
+    return 2;
+}